@@ -127,14 +127,19 @@ class Predictor(object):
         >>> predictor.forward(data=mydata)
         >>> out = predictor.get_output(0)
         """
+        keys = []
+        values = []
         for k, v in kwargs.items():
             if not isinstance(v, np.ndarray):
                 raise ValueError("Expect numpy ndarray as input")
-            v = np.ascontiguousarray(v, dtype=np.float32)
-            _check_call(_LIB.MXPredSetInput(
-                self.handle, c_str(k),
-                v.ctypes.data_as(mx_float_p),
-                mx_uint(v.size)))
+            keys.append(c_str(k))
+            values.append(np.ascontiguousarray(v, dtype=np.float32))
+        # set all the inputs with a single copy per device
+        _check_call(_LIB.MXPredSetInputs(
+            self.handle, mx_uint(len(keys)),
+            c_array(ctypes.c_char_p, keys),
+            c_array(mx_float_p, [v.ctypes.data_as(mx_float_p) for v in values]),
+            c_array(mx_uint, [v.size for v in values])))
         _check_call(_LIB.MXPredForward(self.handle))
 
     def get_output(self, index):
@@ -118,7 +118,8 @@ struct Context {
   enum DeviceType {
     kCPU = cpu::kDevMask,
     kGPU = gpu::kDevMask,
-    kCPUPinned = 3
+    kCPUPinned = 3,
+    kCPUShared = 5
   };
   /*! \brief the device type we run the op on */
   DeviceType dev_type;
@@ -131,7 +132,7 @@ struct Context {
    * \return cpu::kDevMask or gpu::kDevMask
    */
   inline int dev_mask() const {
-    if (dev_type == kCPUPinned) return cpu::kDevMask;
+    if (dev_type == kCPUPinned || dev_type == kCPUShared) return cpu::kDevMask;
     return dev_type;
   }
   /*!
@@ -175,7 +176,7 @@ struct Context {
     return true;
   }
   /*! \brief the maximal device type */
-  static const int32_t kMaxDevType = 4;
+  static const int32_t kMaxDevType = 6;
   /*! \brief the maximal device index */
   static const int32_t kMaxDevID = 16;
   /*!
@@ -199,7 +200,14 @@ struct Context {
    */
   inline static Context CPUPinned(int32_t dev_id = -1);
   /*!
-   * Create a context from string of the format [cpu|gpu|cpu_pinned](n)
+   * Create a CPU context backed by shared memory, whose arrays
+   *  can be attached by other processes.
+   * \param dev_id dummy device id.
+   * \return CPU shared memory context.
+   */
+  inline static Context CPUShared(int32_t dev_id = 0);
+  /*!
+   * Create a context from string of the format [cpu|gpu|cpu_pinned|cpu_shared](n)
    * \param str the string pattern
    * \return Context
    */
@@ -248,7 +256,7 @@ inline Context Context::Create(DeviceType dev_type, int32_t dev_id) {
   ctx.dev_type = dev_type;
   if (dev_id < 0) {
     ctx.dev_id = 0;
-    if (dev_type != kCPU) {
+    if (dev_type != kCPU && dev_type != kCPUShared) {
 #if MXNET_USE_CUDA
       CHECK_EQ(cudaGetDevice(&ctx.dev_id), cudaSuccess);
 #else
@@ -268,6 +276,10 @@ inline Context Context::CPUPinned(int32_t dev_id) {
   return Create(kCPUPinned, dev_id);
 }
 
+inline Context Context::CPUShared(int32_t dev_id) {
+  return Create(kCPUShared, dev_id);
+}
+
 inline Context Context::GPU(int32_t dev_id) {
   return Create(kGPU, dev_id);
 }
@@ -288,6 +300,8 @@ inline Context Context::FromString(std::string str) {
       ret = GPU(id);
     } else if (type == "cpu_pinned") {
       ret = CPUPinned(id);
+    } else if (type == "cpu_shared") {
+      ret = CPUShared(id);
     } else {
       LOG(FATAL) << "Invalid context string " << str;
     }
@@ -304,6 +318,8 @@ inline std::ostream& operator<<(std::ostream &out, const Context &ctx) {
     out << "gpu(";
   } else if (ctx.dev_type == Context::kCPUPinned) {
     out << "cpu_pinned(";
+  } else if (ctx.dev_type == Context::kCPUShared) {
+    out << "cpu_shared(";
   } else {
     out << "unknown(";
   }
@@ -319,6 +335,7 @@ inline std::ostream& operator<<(std::ostream &out, const Context &ctx) {
 
 }  // namespace mxnet
 
+#include "./bfloat16.h"
 #include "./tensor_blob.h"
 //! \endcond
 #endif  // MXNET_BASE_H_
@@ -0,0 +1,96 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file bfloat16.h
+ * \brief bfloat16 data type, the upper half of a float32.
+ *
+ *  bfloat16 keeps the 8 exponent bits of float32 and 7 bits of mantissa, so it
+ *  has the range of float32 and converts to float32 with a shift. It is stored
+ *  in NDArrays under the type flag kBfloat16 and computed in float32.
+ */
+#ifndef MXNET_BFLOAT16_H_
+#define MXNET_BFLOAT16_H_
+
+#include <mshadow/base.h>
+#include <cstdint>
+#include <cstring>
+
+namespace mxnet {
+/*! \brief type flag of bfloat16, next to the mshadow type flags */
+const int kBfloat16 = 12;
+
+namespace bfloat16 {
+/*! \brief bfloat16 value, converted to and from float32 for arithmetic */
+struct bf16_t {
+  /*! \brief the upper 16 bits of the float32 */
+  uint16_t bits_;
+
+  MSHADOW_XINLINE bf16_t() {}
+  /*! \brief round to nearest even, as the float16 conversions do */
+  MSHADOW_XINLINE explicit bf16_t(float value) : bits_(FromFloat(value)) {}
+  MSHADOW_XINLINE operator float() const { return ToFloat(bits_); }
+
+  MSHADOW_XINLINE bf16_t& operator+=(float rhs) { return *this = bf16_t(float(*this) + rhs); }
+  MSHADOW_XINLINE bf16_t& operator-=(float rhs) { return *this = bf16_t(float(*this) - rhs); }
+  MSHADOW_XINLINE bf16_t& operator*=(float rhs) { return *this = bf16_t(float(*this) * rhs); }
+  MSHADOW_XINLINE bf16_t& operator/=(float rhs) { return *this = bf16_t(float(*this) / rhs); }
+
+  MSHADOW_XINLINE static float ToFloat(uint16_t bits) {
+    union { uint32_t u; float f; } x;
+    x.u = static_cast<uint32_t>(bits) << 16;
+    return x.f;
+  }
+
+  MSHADOW_XINLINE static uint16_t FromFloat(float value) {
+    union { uint32_t u; float f; } x;
+    x.f = value;
+    if ((x.u & 0x7fffffffU) > 0x7f800000U) {
+      return static_cast<uint16_t>((x.u >> 16) | 0x40);  // quiet nan
+    }
+    x.u += 0x7fffU + ((x.u >> 16) & 1);
+    return static_cast<uint16_t>(x.u >> 16);
+  }
+};
+}  // namespace bfloat16
+
+typedef bfloat16::bf16_t bf16_t;
+
+/*!
+ * \brief size in bytes of a type flag, mshadow::mshadow_sizeof with bfloat16
+ * \param type_flag the type flag
+ */
+inline size_t TypeSize(int type_flag) {
+  return type_flag == kBfloat16 ? sizeof(bf16_t) : mshadow::mshadow_sizeof(type_flag);
+}
+}  // namespace mxnet
+
+namespace mshadow {
+/*! \brief lets TBlob::dptr and TBlob::get check bfloat16 blobs */
+template<>
+struct DataType<mxnet::bf16_t> {
+  static const int kFlag = mxnet::kBfloat16;
+  static const int kLanes = 1;
+};
+}  // namespace mshadow
+
+/*!
+ * \brief MSHADOW_TYPE_SWITCH that also covers bfloat16, for code that works
+ *  on any storage type, such as copies and fills.
+ */
+#define MXNET_TYPE_SWITCH_WITH_BF16(type, DType, ...)   \
+  if ((type) == mxnet::kBfloat16) {                     \
+    typedef mxnet::bf16_t DType;                        \
+    {__VA_ARGS__}                                       \
+  } else {                                              \
+    MSHADOW_TYPE_SWITCH(type, DType, __VA_ARGS__)       \
+  }
+
+/*! \brief MSHADOW_REAL_TYPE_SWITCH that also covers bfloat16 */
+#define MXNET_REAL_TYPE_SWITCH_WITH_BF16(type, DType, ...)  \
+  if ((type) == mxnet::kBfloat16) {                         \
+    typedef mxnet::bf16_t DType;                            \
+    {__VA_ARGS__}                                           \
+  } else {                                                  \
+    MSHADOW_REAL_TYPE_SWITCH(type, DType, __VA_ARGS__)      \
+  }
+
+#endif  // MXNET_BFLOAT16_H_
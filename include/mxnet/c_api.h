@@ -44,6 +44,10 @@ typedef float mx_float;
 // these typedefs are mainly used for readablity reasons
 /*! \brief handle to NDArray */
 typedef void *NDArrayHandle;
+/*! \brief handle to a batched asynchronous copy */
+typedef void *NDArrayCopyHandle;
+/*! \brief handle to a DLManagedTensor */
+typedef void *DLManagedTensorHandle;
 /*! \brief handle to a mxnet narray function that changes NDArray */
 typedef const void *FunctionHandle;
 /*! \brief handle to a function that takes param and creates symbol */
@@ -268,6 +272,7 @@ MXNET_DLL int MXNDArraySaveRawBytes(NDArrayHandle handle,
                                     const char **out_buf);
 /*!
  * \brief Save list of narray into the file.
+ *  The legacy format is written, unless MXNET_NDARRAY_SAVE_FORMAT is 2.
  * \param fname name of the file.
  * \param num_args number of arguments to save.
  * \param args the array of NDArrayHandles to be saved.
@@ -292,6 +297,25 @@ MXNET_DLL int MXNDArrayLoad(const char* fname,
                             NDArrayHandle** out_arr,
                             mx_uint *out_name_size,
                             const char*** out_names);
+/*!
+ * \brief Load the narrays of the given names from the file.
+ *  Only these arrays are read from a file in the indexed format.
+ * \param fname name of the file.
+ * \param num_names number of names.
+ * \param names the names of the arrays to load.
+ * \param out_size number of narray loaded.
+ * \param out_arr head of the returning narray handles, in the order of names.
+ * \param out_name_size size of output name arrray.
+ * \param out_names the names of returning NDArrays
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayLoadSubset(const char* fname,
+                                  mx_uint num_names,
+                                  const char** names,
+                                  mx_uint *out_size,
+                                  NDArrayHandle** out_arr,
+                                  mx_uint *out_name_size,
+                                  const char*** out_names);
 /*!
  * \brief Perform a synchronize copy from a continugous CPU memory region.
  *
@@ -320,6 +344,47 @@ MXNET_DLL int MXNDArraySyncCopyFromCPU(NDArrayHandle handle,
 MXNET_DLL int MXNDArraySyncCopyToCPU(NDArrayHandle handle,
                                      void *data,
                                      size_t size);
+/*!
+ * \brief Asynchronously copy continugous CPU memory regions into many NDArrays.
+ *
+ *  A single engine operation is pushed for all the arrays on the same device.
+ *  The source memory must stay valid until MXNDArrayWaitCopy returns.
+ *
+ * \param num number of arrays
+ * \param handles the NDArray handles
+ * \param data the data source of each array
+ * \param sizes the size of each source, in number of elements
+ * \param out completion handle, must be passed to MXNDArrayWaitCopy
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayAsyncCopyFromCPU(mx_uint num,
+                                        NDArrayHandle *handles,
+                                        const void **data,
+                                        const size_t *sizes,
+                                        NDArrayCopyHandle *out);
+/*!
+ * \brief Asynchronously copy many NDArrays to continugous CPU memory regions.
+ *
+ *  The destination memory can be read after MXNDArrayWaitCopy returns.
+ *
+ * \param num number of arrays
+ * \param handles the NDArray handles
+ * \param data the destination of each array
+ * \param sizes the size of each destination, in number of elements
+ * \param out completion handle, must be passed to MXNDArrayWaitCopy
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayAsyncCopyToCPU(mx_uint num,
+                                      NDArrayHandle *handles,
+                                      void **data,
+                                      const size_t *sizes,
+                                      NDArrayCopyHandle *out);
+/*!
+ * \brief Wait until a batched copy is finished and free its handle.
+ * \param handle the handle returned by MXNDArrayAsyncCopyFromCPU or MXNDArrayAsyncCopyToCPU
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayWaitCopy(NDArrayCopyHandle handle);
 /*!
  * \brief Wait until all the pending writes with respect NDArray are finished.
  *  Always call this before read data out synchronizely.
@@ -416,6 +481,61 @@ MXNET_DLL int MXNDArrayGetDType(NDArrayHandle handle,
 MXNET_DLL int MXNDArrayGetContext(NDArrayHandle handle,
                                   int *out_dev_type,
                                   int *out_dev_id);
+/*!
+ * \brief export an NDArray as a DLManagedTensor sharing its memory.
+ *  The export is not synchronized with pending operations: call
+ *  MXNDArrayWaitToRead before reading, or MXNDArrayWaitToWrite before writing
+ *  the tensor.
+ * \param handle the NDArray handle
+ * \param out the tensor, to be released with MXNDArrayCallDLPackDeleter
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayToDLPack(NDArrayHandle handle,
+                                DLManagedTensorHandle *out);
+/*!
+ * \brief create an NDArray sharing the memory of a DLManagedTensor.
+ *  The NDArray takes ownership of the tensor and calls its deleter
+ *  when it is freed.
+ * \param dlpack the tensor, which must be compact
+ * \param out the returning handle
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayFromDLPack(DLManagedTensorHandle dlpack,
+                                  NDArrayHandle *out);
+/*!
+ * \brief release a DLManagedTensor by calling its deleter.
+ * \param dlpack the tensor
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayCallDLPackDeleter(DLManagedTensorHandle dlpack);
+/*!
+ * \brief get the handle of the shared memory of an NDArray created with
+ *  the cpu_shared context, which another process can attach to.
+ * \param handle the NDArray handle
+ * \param shared_pid the id of the process which created the memory
+ * \param shared_id the id of the memory in that process
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayGetSharedMemHandle(NDArrayHandle handle,
+                                          int *shared_pid,
+                                          int *shared_id);
+/*!
+ * \brief create an NDArray on the shared memory returned by
+ *  MXNDArrayGetSharedMemHandle, possibly in another process. No data is copied.
+ * \param shared_pid the id of the process which created the memory
+ * \param shared_id the id of the memory in that process
+ * \param shape the pointer to the shape
+ * \param ndim the dimension of the shape
+ * \param dtype data type of the array, must match the shared array
+ * \param out the returning handle
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXNDArrayCreateFromSharedMem(int shared_pid,
+                                           int shared_id,
+                                           const mx_uint *shape,
+                                           mx_uint ndim,
+                                           int dtype,
+                                           NDArrayHandle *out);
 /*!
  * \brief return gradient buffer attached to this NDArray
  * \param handle NDArray handle
@@ -1176,6 +1296,39 @@ MXNET_DLL int MXExecutorSimpleBind(SymbolHandle symbol_handle,
 MXNET_DLL int MXExecutorSetMonitorCallback(ExecutorHandle handle,
                                            ExecutorMonitorCallback callback,
                                            void* callback_handle);
+/*!
+ * \brief compute statistics of node outputs inside the execution of each node,
+ *  this keeps bulk execution enabled unlike the monitor callback.
+ * \param handle the executor handle
+ * \param stat_mask bit mask of statistics: 1 norm, 2 mean, 4 min, 8 max,
+ *  16 number of NaN, 32 number of Inf
+ * \param interval statistics are computed every interval-th forward pass
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXExecutorSetMonitorStats(ExecutorHandle handle,
+                                        int stat_mask,
+                                        int interval);
+/*!
+ * \brief switch the computation of the statistics set by MXExecutorSetMonitorStats
+ *  on or off, from the next forward pass
+ * \param handle the executor handle
+ * \param enabled whether the statistics are computed
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXExecutorEnableMonitorStats(ExecutorHandle handle,
+                                           int enabled);
+/*!
+ * \brief get the statistics of the last sampled iteration
+ * \param handle the executor handle
+ * \param out_size number of monitored node outputs
+ * \param out_names name of each monitored node output
+ * \param out handle of a CPU NDArray of shape (out_size, number of statistics)
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXExecutorGetMonitorStats(ExecutorHandle handle,
+                                        mx_uint *out_size,
+                                        const char ***out_names,
+                                        NDArrayHandle *out);
 //--------------------------------------------
 // Part 5: IO Interface
 //--------------------------------------------
@@ -1408,6 +1561,22 @@ typedef void (MXKVStoreUpdater)(int key,
 MXNET_DLL int MXKVStoreSetUpdater(KVStoreHandle handle,
                                   MXKVStoreUpdater updater,
                                   void *updater_handle);
+/*!
+ * \brief set an optimizer implemented in the library as the updater, so that
+ *  updates do not call back into the frontend. Setting the same optimizer again
+ *  only changes its parameters.
+ * \param handle handle to the KVStore
+ * \param name the name of the optimizer, such as sgd, adam or rmsprop
+ * \param num_params number of parameters
+ * \param keys parameter keys, such as learning_rate
+ * \param vals parameter values
+ * \return 0 when success, -1 when failure happens
+ */
+MXNET_DLL int MXKVStoreSetOptimizer(KVStoreHandle handle,
+                                    const char *name,
+                                    mx_uint num_params,
+                                    const char **keys,
+                                    const char **vals);
 /*!
  * \brief get the type of the kvstore
  * \param handle handle to the KVStore
@@ -126,6 +126,21 @@ MXNET_DLL int MXPredSetInput(PredictorHandle handle,
                              const char* key,
                              const mx_float* data,
                              mx_uint size);
+/*!
+ * \brief Set several inputs of predictor at once.
+ *  All the copies are done by a single engine operation per device.
+ * \param handle The predictor handle.
+ * \param num_input Number of inputs to set.
+ * \param keys The name of each input node.
+ * \param data The pointer to the data of each input.
+ * \param sizes The size of each data array, used for safety check.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredSetInputs(PredictorHandle handle,
+                              mx_uint num_input,
+                              const char** keys,
+                              const mx_float** data,
+                              const mx_uint* sizes);
 /*!
  * \brief Run a forward pass to get the output.
  * \param handle The handle of the predictor.
@@ -161,6 +176,21 @@ MXNET_DLL int MXPredGetOutput(PredictorHandle handle,
                               mx_uint index,
                               mx_float* data,
                               mx_uint size);
+/*!
+ * \brief Get several outputs of prediction at once.
+ *  All the copies are done by a single engine operation per device.
+ * \param handle The handle of the predictor.
+ * \param num_output Number of outputs to get.
+ * \param indices The index of each output node.
+ * \param data User allocated data to hold each output.
+ * \param sizes The size of each data array, used for safe checking.
+ * \return 0 when success, -1 when failure.
+ */
+MXNET_DLL int MXPredGetOutputs(PredictorHandle handle,
+                               mx_uint num_output,
+                               const mx_uint* indices,
+                               mx_float** data,
+                               const mx_uint* sizes);
 /*!
  * \brief Free a predictor handle.
  * \param handle The handle of the predictor.
@@ -27,6 +27,22 @@ namespace mxnet {
 /*! \brief use symbolic graph from NNVM */
 using nnvm::Symbol;
 
+/*! \brief statistics of node outputs that can be computed by the executor */
+enum MonitorStatFlag {
+  /*! \brief L2 norm */
+  kMonitorNorm = 1,
+  /*! \brief mean value */
+  kMonitorMean = 2,
+  /*! \brief minimum value */
+  kMonitorMin = 4,
+  /*! \brief maximum value */
+  kMonitorMax = 8,
+  /*! \brief number of NaN elements */
+  kMonitorNaN = 16,
+  /*! \brief number of infinite elements */
+  kMonitorInf = 32
+};
+
 /*!
  * \brief Executor of a computation graph.
  *  Executor can be created by Binding a symbol.
@@ -131,6 +147,32 @@ class Executor {
    * \brief Install a callback to notify the completion of operation.
    */
   virtual void SetMonitorCallback(const MonitorCallback& callback) {}
+  /*!
+   * \brief Compute statistics of every node output inside the execution of the node.
+   *  Unlike the monitor callback this keeps bulk execution enabled.
+   * \param stat_mask bit mask of MonitorStatFlag selecting the statistics.
+   * \param interval statistics are computed every interval-th forward pass.
+   */
+  virtual void SetMonitorStats(int stat_mask, int interval) {
+    LOG(FATAL) << "SetMonitorStats is not supported by this executor";
+  }
+  /*!
+   * \brief Switch the computation of the statistics on or off, from the next forward pass.
+   *  While on, the statistics are computed every interval-th forward pass.
+   * \param enabled whether the statistics are computed.
+   */
+  virtual void EnableMonitorStats(bool enabled) {
+    LOG(FATAL) << "EnableMonitorStats is not supported by this executor";
+  }
+  /*!
+   * \brief Get the statistics of the last sampled iteration.
+   * \param names the name of each monitored node output.
+   * \param stats array of shape (names.size(), number of statistics) on CPU,
+   *  the columns follow the order of MonitorStatFlag.
+   */
+  virtual void GetMonitorStats(std::vector<std::string>* names, NDArray* stats) const {
+    LOG(FATAL) << "GetMonitorStats is not supported by this executor";
+  }
 };  // class executor
 }  // namespace mxnet
 #endif  // MXNET_EXECUTOR_H_
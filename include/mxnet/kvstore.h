@@ -11,12 +11,16 @@
 #include <string>
 #include <functional>
 #include <atomic>
+#include <memory>
+#include <utility>
 #include "./ndarray.h"
 #if MXNET_USE_DIST_KVSTORE
 #include "ps/ps.h"
 #endif  // MXNET_USE_DIST_KVSTORE
 
 namespace mxnet {
+class Optimizer;
+
 /*!
  * \brief distributed key-value store
  *
@@ -35,6 +39,10 @@ class KVStore {
    *       multi-devices on a single machine. can be also
    *   - 'device' or 'local_allreduce_device' : same to local but use gpus for kv
    *       allreduce
+   *   - 'ring' or 'local_allreduce_ring' : same to device but big arrays are
+   *       reduced over a ring of the devices
+   *   - 'local_shm' : local, and synchronized with the other processes of the
+   *       machine through shared memory
    *   - 'dist_*' : multi-machines
    * \return a new created KVStore.
    */
@@ -174,6 +182,19 @@ class KVStore {
     updater_ = updater;
   }
 
+  /*!
+   * \brief set an optimizer registered with MXNET_REGISTER_OPTIMIZER as the
+   *  updater, so that updates run without calling back into the frontend.
+   *
+   * Setting the same optimizer again only changes its parameters, and keeps its
+   * states. On "dist_*" stores, the optimizer runs on the servers.
+   *
+   * \param name the name of the optimizer, such as sgd
+   * \param kwargs the parameters of the optimizer
+   */
+  virtual void SetOptimizer(const std::string& name,
+                            const std::vector<std::pair<std::string, std::string> >& kwargs);
+
   /******************************************************
    * the following are used for multi-machines.
    ******************************************************/
@@ -318,6 +339,12 @@ class KVStore {
    */
   Updater updater_;
 
+  /**
+   * \brief the optimizer set by \ref SetOptimizer, and its name
+   */
+  std::shared_ptr<Optimizer> optimizer_;
+  std::string optimizer_name_;
+
   /**
    * \brief the kvstore type
    */
@@ -12,6 +12,7 @@
 #include <dmlc/type_traits.h>
 #include <dmlc/registry.h>
 #include <nnvm/node.h>
+#include <functional>
 #include <vector>
 #include <map>
 #include <string>
@@ -91,6 +92,38 @@ class NDArray {
         dtype_(data.type_flag_), entry_({nullptr, 0, 0}) {
 #if MKL_EXPERIMENTAL == 1
     Mkl_mem_ = std::make_shared<MKLMemHolder>();
+#endif
+  }
+  /*!
+   * \brief constructing a static NDArray that shares data with TBlob, and
+   *  releases it with deleter once the NDArray and all the operations
+   *  pending on it are done.
+   * \param data the memory content of static data
+   * \param dev_id the device id this tensor sits at
+   * \param deleter the function releasing the memory
+   */
+  NDArray(const TBlob &data, int dev_id, const std::function<void()>& deleter)
+      : ptr_(std::make_shared<Chunk>(data, dev_id)), shape_(data.shape_),
+        dtype_(data.type_flag_), entry_({nullptr, 0, 0}) {
+    ptr_->deleter = deleter;
+#if MKL_EXPERIMENTAL == 1
+    Mkl_mem_ = std::make_shared<MKLMemHolder>();
+#endif
+  }
+  /*!
+   * \brief constructs an NDArray on the shared memory of another process.
+   *  The memory was allocated by an NDArray with Context::kCPUShared, whose
+   *  handle is obtained by GetSharedMemHandle. No data is copied.
+   * \param shared_pid id of the process which created the memory
+   * \param shared_id id of the memory in that process
+   * \param shape the shape of array
+   * \param dtype data type of this ndarray
+   */
+  NDArray(int shared_pid, int shared_id, const TShape& shape, int dtype)
+      : ptr_(std::make_shared<Chunk>(shared_pid, shared_id, shape.Size(), dtype)),
+        shape_(shape), dtype_(dtype), entry_({nullptr, 0, 0}) {
+#if MKL_EXPERIMENTAL == 1
+    Mkl_mem_ = std::make_shared<MKLMemHolder>();
 #endif
   }
   /*!
@@ -117,6 +150,19 @@ class NDArray {
   inline Context ctx() const {
     return ptr_->shandle.ctx;
   }
+  /*!
+   * \brief get the handle of the shared memory of an NDArray with Context::kCPUShared,
+   *  which can be used by another process to construct an NDArray on the same memory.
+   * \param shared_pid the id of the process which created the memory
+   * \param shared_id the id of the memory in that process
+   */
+  inline void GetSharedMemHandle(int* shared_pid, int* shared_id) const {
+    CHECK_EQ(ctx().dev_type, Context::kCPUShared)
+        << "GetSharedMemHandle requires an NDArray in shared memory";
+    CheckAndAlloc();
+    *shared_pid = ptr_->shandle.shared_pid;
+    *shared_id = ptr_->shandle.shared_id;
+  }
   /*!
    * \return the data type of NDArray, this function is only valid when the NDArray is not empty
    */
@@ -262,6 +308,59 @@ class NDArray {
    * \param size the memory size we want to copy into, in sizeof(DType) not raw btyes.
    */
   void SyncCopyToCPU(void *data, size_t size) const;
+  /*!
+   * \brief Asynchronously copy continugous CPU memory regions into many arrays.
+   *
+   *  One engine operator is pushed per context of the arrays, ordered after the
+   *  pending operations on the arrays, instead of one synchronous copy per array.
+   *  The source memory must stay valid until WaitCopy is called on the handle.
+   *
+   * \param arrays the destination arrays.
+   * \param data the data source of each array.
+   * \param sizes the size of each source, in sizeof(DType) not raw btyes.
+   * \return completion handle, to be passed to WaitCopy exactly once.
+   */
+  static Engine::VarHandle AsyncCopyFromCPU(const std::vector<NDArray>& arrays,
+                                            const std::vector<const void*>& data,
+                                            const std::vector<size_t>& sizes);
+  /*!
+   * \brief Asynchronously copy many arrays to continugous CPU memory regions.
+   *
+   *  The destination memory can be read after WaitCopy is called on the handle.
+   *
+   * \param arrays the source arrays.
+   * \param data the destination of each array.
+   * \param sizes the size of each destination, in sizeof(DType) not raw btyes.
+   * \return completion handle, to be passed to WaitCopy exactly once.
+   */
+  static Engine::VarHandle AsyncCopyToCPU(const std::vector<NDArray>& arrays,
+                                          const std::vector<void*>& data,
+                                          const std::vector<size_t>& sizes);
+  /*!
+   * \brief Wait until a batched copy is finished and release its handle.
+   * \param handle the handle returned by AsyncCopyFromCPU or AsyncCopyToCPU.
+   */
+  static void WaitCopy(Engine::VarHandle handle);
+  /*!
+   * \brief Export the array as a DLManagedTensor sharing its memory.
+   *
+   *  The tensor holds a reference to the memory of the array until its deleter
+   *  is called. The export does not synchronize with the engine: call
+   *  WaitToRead before reading the tensor, or WaitToWrite before writing it.
+   *
+   * \return the tensor, to be released by calling its deleter.
+   */
+  DLManagedTensor* ToDLPack() const;
+  /*!
+   * \brief Create a static NDArray sharing the memory of a DLManagedTensor.
+   *
+   *  The array takes ownership of the tensor, whose deleter is called once the
+   *  array and the operations pending on it are done.
+   *
+   * \param tensor the tensor, which must be compact.
+   * \return the array.
+   */
+  static NDArray FromDLPack(DLManagedTensor* tensor);
   /*!
    * \brief Slice a NDArray
    * \param begin begin index in first dim
@@ -283,8 +382,8 @@ class NDArray {
    * \return NDArray in new shape and type.
    */
   inline NDArray AsArray(const TShape &shape, int dtype) const {
-    CHECK_GE(shape_.Size() * mshadow::mshadow_sizeof(dtype_),
-             shape.Size() * mshadow::mshadow_sizeof(dtype))
+    CHECK_GE(shape_.Size() * TypeSize(dtype_),
+             shape.Size() * TypeSize(dtype))
         << "NDArray.AsArray: target memory size is bigger";
 #if MKL_EXPERIMENTAL == 1
     if (Mkl_mem_ != nullptr) {
@@ -327,6 +426,22 @@ class NDArray {
   static void Save(dmlc::Stream* fo,
                    const std::vector<NDArray>& data,
                    const std::vector<std::string>& names);
+  /*!
+   * \brief Save list of ndarray into the Stream in the indexed format.
+   *
+   *  The file starts with an index of the names, types, shapes and offsets of
+   *  the arrays, whose data is aligned to 64 bytes, so that a subset of the
+   *  arrays can be loaded and large arrays can be loaded in parallel.
+   *
+   * \param fo The stream of output.
+   * \param data the NDArrays to be saved.
+   * \param names the name of the NDArray, optional, can be zero length.
+   * \param compress whether to store arrays compressed when it saves space.
+   */
+  static void SaveIndexed(dmlc::Stream* fo,
+                          const std::vector<NDArray>& data,
+                          const std::vector<std::string>& names,
+                          bool compress = false);
   /*!
    * \brief Load list of ndarray into from the stream.
    * \param fi The stream of the input file.
@@ -336,6 +451,18 @@ class NDArray {
   static void Load(dmlc::Stream* fi,
                    std::vector<NDArray>* data,
                    std::vector<std::string>* keys);
+  /*!
+   * \brief Load list of ndarray from a file in the indexed or the legacy format.
+   *  Arrays of an indexed file are read by MXNET_NDARRAY_LOAD_NTHREADS threads.
+   * \param fname The name of the file.
+   * \param select names of the arrays to load, all the arrays if empty.
+   * \param data the NDArrays loaded, in the order of select if given.
+   * \param keys the name of the NDArray, if saved in the file.
+   */
+  static void Load(const std::string& fname,
+                   const std::vector<std::string>& select,
+                   std::vector<NDArray>* data,
+                   std::vector<std::string>* keys);
 
  private:
   friend class autograd::AutogradRuntime;
@@ -352,6 +479,8 @@ class NDArray {
     bool static_data;
     /*! \brief whether allocation is delayed */
     bool delay_alloc;
+    /*! \brief releases static data owned by the chunk, if any */
+    std::function<void()> deleter;
     /*! \brief default cosntructor */
     Chunk() : static_data(true), delay_alloc(false) {
       var  = Engine::Get()->NewVariable();
@@ -368,16 +497,23 @@ class NDArray {
         shandle.ctx = Context::GPU(dev_id);
       }
       shandle.dptr = data.dptr_;
-      shandle.size = data.shape_.Size() * mshadow::mshadow_sizeof(data.type_flag_);
+      shandle.size = data.shape_.Size() * TypeSize(data.type_flag_);
     }
     /*! \brief construct a new chunk */
     Chunk(uint64_t size, Context ctx, bool delay_alloc_, int dtype)
         : static_data(false), delay_alloc(true) {
       var = Engine::Get()->NewVariable();
-      shandle.size = size * mshadow::mshadow_sizeof(dtype);
+      shandle.size = size * TypeSize(dtype);
       shandle.ctx = ctx;
       if (!delay_alloc_) this->CheckAndAlloc();
     }
+    /*! \brief attach to the shared memory created by another process */
+    Chunk(int shared_pid, int shared_id, uint64_t size, int dtype)
+        : static_data(false), delay_alloc(false) {
+      var = Engine::Get()->NewVariable();
+      shandle = Storage::Get()->AttachShared(size * TypeSize(dtype),
+                                             shared_pid, shared_id);
+    }
     /*! \brief check if delay alloc is on, do alloc if not yet done */
     inline void CheckAndAlloc(void) {
       if (delay_alloc) {
@@ -388,7 +524,10 @@ class NDArray {
     /*! \brief destructor */
     ~Chunk() {
       if (static_data || delay_alloc) {
-        Engine::Get()->DeleteVariable([](RunContext s) {}, shandle.ctx, var);
+        std::function<void()> release = deleter;
+        Engine::Get()->DeleteVariable([release](RunContext s) {
+            if (release) release();
+          }, shandle.ctx, var);
       } else {
         Storage::Handle h = this->shandle;
         Engine::Get()->DeleteVariable([h](RunContext s) {
@@ -0,0 +1,70 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file optimizer.h
+ * \brief optimizers run by KVStore on the stored weights
+ */
+#ifndef MXNET_OPTIMIZER_H_
+#define MXNET_OPTIMIZER_H_
+
+#include <dmlc/base.h>
+#include <dmlc/registry.h>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "./ndarray.h"
+
+namespace mxnet {
+/*!
+ * \brief An optimizer that updates the weights stored by a KVStore without calling
+ *  back into the frontend. Updates are pushed to the engine on the context of the
+ *  weight, and the optimizer keeps the states of each key there.
+ */
+class Optimizer {
+ public:
+  /*! \brief virtual destructor */
+  virtual ~Optimizer() {}
+  /*!
+   * \brief set the parameters, such as learning_rate, wd, rescale_grad and
+   *  clip_gradient. It may be called again to change them, the states are kept.
+   * \param kwargs the parameters
+   */
+  virtual void Init(const std::vector<std::pair<std::string, std::string> >& kwargs) = 0;
+  /*!
+   * \brief push the update of a weight by its gradient to the engine
+   * \param key the key of the weight, the states are kept per key
+   * \param grad the gradient
+   * \param weight the weight, updated in place
+   */
+  virtual void Update(int key, const NDArray& grad, NDArray* weight) = 0;
+  /*!
+   * \brief create an optimizer by its registered name
+   * \param type_name the name, such as sgd, adam or rmsprop
+   */
+  static Optimizer *Create(const char *type_name);
+};
+
+/*! \brief typedef the factory function of optimizer */
+typedef std::function<Optimizer *()> OptimizerFactory;
+/*!
+ * \brief Registry entry for Optimizer factory functions.
+ */
+struct OptimizerReg
+    : public dmlc::FunctionRegEntryBase<OptimizerReg,
+                                        OptimizerFactory> {
+};
+
+/*!
+ * \brief Macro to register Optimizer
+ *
+ * \code
+ * // example of registering the sgd optimizer
+ * MXNET_REGISTER_OPTIMIZER(sgd, SGDOptimizer)
+ * .describe("Stochastic gradient descent, with momentum");
+ * \endcode
+ */
+#define MXNET_REGISTER_OPTIMIZER(Name, OptimizerType)                   \
+  DMLC_REGISTRY_REGISTER(::mxnet::OptimizerReg, OptimizerReg, Name)     \
+  .set_body([]() { return new OptimizerType(); })
+}  // namespace mxnet
+#endif  // MXNET_OPTIMIZER_H_
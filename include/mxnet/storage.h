@@ -32,6 +32,16 @@ class Storage {
      * \brief Context information about device and ID.
      */
     Context ctx;
+    /*!
+     * \brief Id of the process which created the shared memory,
+     *  only used by Context::kCPUShared.
+     */
+    int shared_pid{-1};
+    /*!
+     * \brief Id of the shared memory in the creating process,
+     *  only used by Context::kCPUShared.
+     */
+    int shared_id{-1};
   };
   /*!
    * \brief Allocate a new contiguous memory for a given size.
@@ -40,6 +50,15 @@ class Storage {
    * \return Handle struct.
    */
   virtual Handle Alloc(size_t size, Context ctx) = 0;
+  /*!
+   * \brief Map the shared memory created by Alloc with Context::kCPUShared,
+   *  possibly in another process.
+   * \param size Total size of memory in bytes.
+   * \param shared_pid Id of the process which created the memory.
+   * \param shared_id Id of the memory in that process.
+   * \return Handle struct, to be released with Free.
+   */
+  virtual Handle AttachShared(size_t size, int shared_pid, int shared_id) = 0;
   /*!
    * \brief Free storage.
    * \param handle Handle struect.
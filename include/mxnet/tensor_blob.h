@@ -91,6 +91,27 @@ class TBlob {
 #endif
     SetDLTensor(dev_mask, dev_id);
   }
+  /*!
+   * \brief constructor that construct TBlob from DLTensor, sharing its memory
+   * \param dltensor the DLTensor, which must be compact
+   */
+  explicit TBlob(const DLTensor &dltensor)
+      : dptr_(static_cast<char*>(dltensor.data) + dltensor.byte_offset),
+        shape_(TShape(dltensor.shape, dltensor.shape + dltensor.ndim)),
+        type_flag_(DLDataTypeTransform(dltensor.dtype)) {
+    if (dltensor.strides != NULL) {
+      int64_t stride = 1;
+      for (int i = dltensor.ndim - 1; i >= 0; --i) {
+        CHECK(dltensor.shape[i] == 1 || dltensor.strides[i] == stride)
+          << "TBlob only supports compact DLTensor";
+        stride *= dltensor.shape[i];
+      }
+    }
+#if MKL_EXPERIMENTAL == 1
+    Mkl_mem_ = NULL;
+#endif
+    SetDLTensor(DLDeviceTypeTransform(dltensor.ctx.device_type), dltensor.ctx.device_id);
+  }
   /*!
    * \brief constructor from tensor
    * \param src source tensor
@@ -329,11 +350,56 @@ class TBlob {
         {2, {2, 16, 1}},  // Float16
         {3, {1,  8, 1}},  // UInt8
         {4, {0, 32, 1}},  // Int32
-        {5, {0,  8, 1}}   // Int8
+        {5, {0,  8, 1}},  // Int8
+        {kBfloat16, {4, 16, 1}}  // Bfloat16, DLPack code kDLBfloat
       };
     return MSHADOW_DTYPE_TO_DLPACK_DTYPE[type_flag];
   }
 
+  static int DLDataTypeTransform(DLDataType dldata_type) {
+    CHECK_EQ(dldata_type.lanes, 1U) << "vector types are not supported by TBlob";
+    switch (dldata_type.code) {
+      case kDLFloat:
+        switch (dldata_type.bits) {
+          case 16: return mshadow::kFloat16;
+          case 32: return mshadow::kFloat32;
+          case 64: return mshadow::kFloat64;
+        }
+        break;
+      case kDLUInt:
+        switch (dldata_type.bits) {
+          case 8: return mshadow::kUint8;
+        }
+        break;
+      case kDLInt:
+        switch (dldata_type.bits) {
+          case 32: return mshadow::kInt32;
+        }
+        break;
+      case 4:  // kDLBfloat
+        switch (dldata_type.bits) {
+          case 16: return kBfloat16;
+        }
+        break;
+    }
+    LOG(FATAL) << "Unsupported DLDataType: code " << static_cast<int>(dldata_type.code)
+               << ", bits " << static_cast<int>(dldata_type.bits);
+    return mshadow::kFloat32;
+  }
+
+  static int DLDeviceTypeTransform(DLDeviceType device_type) {
+    switch (device_type) {
+      case kDLCPU:
+      case kDLCPUPinned:
+        return cpu::kDevMask;
+      case kDLGPU:
+        return gpu::kDevMask;
+      default:
+        LOG(FATAL) << "Unsupported DLDeviceType: " << static_cast<int>(device_type);
+    }
+    return cpu::kDevMask;
+  }
+
   inline void SetDLTensor(int dev_mask, int dev_id) {
     dltensor_.data = dptr_;
     dltensor_.ctx = DLContext{static_cast<DLDeviceType>(dev_mask), dev_id};
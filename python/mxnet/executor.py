@@ -5,6 +5,7 @@ from __future__ import absolute_import
 
 import ctypes
 import copy
+import collections
 import warnings
 import numpy as np
 from .base import _LIB
@@ -25,6 +26,10 @@ def _monitor_callback_wrapper(callback):
         callback(name, array)
     return callback_handle
 
+# bit of each statistic computed by set_monitor_stats, in column order
+_MONITOR_STATS = collections.OrderedDict(
+    [('norm', 1), ('mean', 2), ('min', 4), ('max', 8), ('nan', 16), ('inf', 32)])
+
 class Executor(object):
     """Executor is the object providing efficient symbolic graph execution and optimization.
 
@@ -61,6 +66,7 @@ class Executor(object):
         self._aux_dict = None
         self._output_dict = None
         self._monitor_callback = None
+        self._monitor_stats = None
         self._output_dirty = False
         self._ctx = copy.deepcopy(ctx)
         self._grad_req = copy.deepcopy(grad_req)
@@ -244,6 +250,66 @@ class Executor(object):
             self._monitor_callback,
             None))
 
+    def set_monitor_stats(self, stats, interval=1):
+        """Compute statistics of every node output while the graph executes.
+
+        Unlike `set_monitor_callback`, statistics are computed inside the
+        execution of each node, so bulk execution stays enabled.
+
+        Parameters
+        ----------
+        stats : list of str
+            Statistics to compute, from 'norm', 'mean', 'min', 'max', 'nan' and 'inf'.
+        interval : int
+            Statistics are computed every `interval` forward passes.
+
+        Examples
+        --------
+        >>> texe.set_monitor_stats(['norm', 'nan'], interval=10)
+        >>> texe.forward()
+        >>> names, values = texe.get_monitor_stats()
+        """
+        mask = 0
+        for name in stats:
+            if name not in _MONITOR_STATS:
+                raise ValueError('Unknown monitor statistic %s' % name)
+            mask |= _MONITOR_STATS[name]
+        self._monitor_stats = [s for s in _MONITOR_STATS if mask & _MONITOR_STATS[s]]
+        check_call(_LIB.MXExecutorSetMonitorStats(
+            self.handle, ctypes.c_int(mask), ctypes.c_int(interval)))
+
+    def enable_monitor_stats(self, enabled=True):
+        """Switch the statistics set by `set_monitor_stats` on or off, from the
+        next forward pass. While on, they are computed every `interval` forward
+        passes.
+
+        Parameters
+        ----------
+        enabled : bool
+            Whether the statistics are computed.
+        """
+        check_call(_LIB.MXExecutorEnableMonitorStats(
+            self.handle, ctypes.c_int(int(enabled))))
+
+    def get_monitor_stats(self):
+        """Get the statistics of the last sampled iteration.
+
+        Returns
+        -------
+        names : list of str
+            Name of each monitored node output.
+        values : NDArray
+            Array of shape (len(names), number of statistics) on CPU. The columns
+            are ordered as 'norm', 'mean', 'min', 'max', 'nan', 'inf', restricted
+            to the statistics passed to `set_monitor_stats`.
+        """
+        size = mx_uint()
+        names = ctypes.POINTER(ctypes.c_char_p)()
+        handle = NDArrayHandle()
+        check_call(_LIB.MXExecutorGetMonitorStats(
+            self.handle, ctypes.byref(size), ctypes.byref(names), ctypes.byref(handle)))
+        return [py_str(names[i]) for i in range(size.value)], NDArray(handle, writable=False)
+
     @property
     def arg_dict(self):
         """Get dictionary representation of argument arrrays.
@@ -219,7 +219,7 @@ class KVStore(object):
             self.handle, mx_uint(len(ckeys)), ckeys, cvals,
             ctypes.c_int(priority)))
 
-    def set_optimizer(self, optimizer):
+    def set_optimizer(self, optimizer, **kwargs):
         """ Registers an optimizer with the kvstore.
 
         When using a single machine, this function updates the local optimizer.
@@ -227,10 +227,20 @@ class KVStore(object):
         it will serialized the optimizer with pickle and send it to all servers.
         The function returns after all servers have been updated.
 
+        The name of an optimizer implemented in the library, ``'sgd'``, ``'adam'``
+        or ``'rmsprop'``, may be given instead, with its parameters as keyword
+        arguments. Updates then run without calling back into Python, also on
+        the servers. Setting the same name again only changes the parameters.
+        Their states cannot be saved with `save_optimizer_states`.
+
         Parameters
         ----------
-        optimizer : Optimizer
-            The new optimizer for the store
+        optimizer : Optimizer or str
+            The new optimizer for the store, or the name of a native optimizer.
+        kwargs : dict
+            Parameters of the native optimizer, such as ``learning_rate``, ``wd``,
+            ``rescale_grad``, ``clip_gradient``, ``momentum`` for sgd and
+            ``centered`` for rmsprop.
 
         Examples
         --------
@@ -248,7 +258,20 @@ class KVStore(object):
         >>> weight.asnumpy()
         array([[-0.01, -0.01],
                [-0.01, -0.01]], dtype=float32)
+        >>> # the same, without calling back into Python
+        >>> kv.set_optimizer('sgd', learning_rate=0.01)
         """
+        if isinstance(optimizer, string_types):
+            params = [(k, v) for k, v in kwargs.items() if v is not None]
+            keys = c_array(ctypes.c_char_p, [c_str(k) for k, _ in params])
+            vals = c_array(ctypes.c_char_p, [c_str(str(v)) for _, v in params])
+            check_call(_LIB.MXKVStoreSetOptimizer(
+                self.handle, c_str(optimizer), mx_uint(len(params)), keys, vals))
+            self._updater = None
+            self._updater_func = None
+            return
+        assert not kwargs, "parameters are only given with the name of a native optimizer"
+
         is_worker = ctypes.c_int()
         check_call(_LIB.MXKVStoreIsWorkerNode(ctypes.byref(is_worker)))
 
@@ -402,6 +425,18 @@ def create(name='local'):
     the KVStore also attempts to use GPU peer-to-peer communication,
     potentially accelerating the communication.
 
+    ``ring``: Same as ``device``, but big arrays are summed over a ring of the
+    devices, with a reduce-scatter and an allgather, so that every device sends
+    and receives an equal share of the data. It also works over several CPU
+    contexts.
+
+    ``local_shm``: Behaves as ``dist_sync`` between the processes of one machine,
+    without servers. Gradients are summed over the processes through shared memory,
+    and every process applies the update to its copy of the weights. The processes are
+    set by the environment variables ``MXNET_KVSTORE_SHM_NUM_PROCS`` and
+    ``MXNET_KVSTORE_SHM_RANK``. ``local_shm_ring`` and ``local_shm_device`` combine
+    it with ``ring`` and ``device`` within each process.
+
     For distributed training, KVStore also supports a number of types:
 
     ``dist_sync``: Behaves similarly to ``local`` but with one major difference.
@@ -417,9 +452,14 @@ def create(name='local'):
     No two updates happen on the same weight at the same time. However, the order is not
     guaranteed.
 
+    ``dist_ssp``: Performs asynchronous updates with bounded staleness. A pull of a
+    key by a worker that pushed it more than ``MXNET_KVSTORE_SSP_STALENESS`` times
+    more than the slowest worker waits until that worker catches up.
+
     Parameters
     ----------
-    name : {'local', 'device', 'dist_sync', 'dist_device_sync', 'dist_async'}
+    name : {'local', 'device', 'ring', 'local_shm', 'dist_sync', 'dist_device_sync', \
+            'dist_async', 'dist_ssp'}
         The type of KVStore.
     Returns
     -------
@@ -3,6 +3,7 @@
 """MXNet model module"""
 from __future__ import absolute_import, print_function
 
+import os
 import time
 import logging
 import warnings
@@ -57,7 +58,7 @@ def _create_kvstore(kvstore, num_device, arg_params):
         kv = kvstore
     elif isinstance(kvstore, str):
         # create kvstore using the string type
-        if num_device is 1 and 'dist' not in kvstore:
+        if num_device is 1 and 'dist' not in kvstore and 'shm' not in kvstore:
             # no need to use kv for single device and single machine
             kv = None
         else:
@@ -86,8 +87,47 @@ def _initialize_kvstore(kvstore, param_arrays, arg_params, param_names,
         if update_on_kvstore:
             kvstore.pull(name, param_on_devs, priority=-idx)
 
+def _kvstore_fusion():
+    """Whether the kvstore fuses the small keys pushed or pulled in one call,
+    which is set by MXNET_KVSTORE_FUSION_BUCKET_SIZE."""
+    return int(os.environ.get('MXNET_KVSTORE_FUSION_BUCKET_SIZE', 0)) > 0
+
+def _fusion_groups(param_arrays, grad_arrays):
+    """Group the parameter indices the way the kvstore buckets the keys: in init
+    order, a key smaller than MXNET_KVSTORE_FUSION_BUCKET_SIZE joins the last
+    bucket unless it would overflow it or has another dtype, and a larger key is
+    alone. Parameters without gradients are left out of the groups."""
+    bound = int(os.environ.get('MXNET_KVSTORE_FUSION_BUCKET_SIZE', 0))
+    groups, bucket, bucket_size, bucket_dtype = [], None, 0, None
+    for index, arg_list in enumerate(param_arrays):
+        size, dtype = arg_list[0].size, arg_list[0].dtype
+        if size >= bound:
+            groups.append([index])
+            continue
+        if bucket is None or bucket_size + size > bound or bucket_dtype != dtype:
+            bucket, bucket_size, bucket_dtype = [], 0, dtype
+            groups.append(bucket)
+        bucket.append(index)
+        bucket_size += size
+    groups = [[i for i in g if grad_arrays[i][0] is not None] for g in groups]
+    return [g for g in groups if g]
+
+def _push_pull_fused(param_arrays, grad_arrays, kvstore, param_names, pull_grads):
+    """Push the gradients, then pull the weights or the summed gradients, one
+    bucket of the kvstore per call for it to fuse the bucket. The priority of a
+    call is the negative index of its first parameter, as without fusion."""
+    for group in _fusion_groups(param_arrays, grad_arrays):
+        names = [param_names[i] for i in group]
+        grads = [grad_arrays[i] for i in group]
+        kvstore.push(names, grads, priority=-group[0])
+        kvstore.pull(names, grads if pull_grads else [param_arrays[i] for i in group],
+                     priority=-group[0])
+
 def _update_params_on_kvstore(param_arrays, grad_arrays, kvstore, param_names):
     """Perform update of param_arrays from grad_arrays on kvstore."""
+    if _kvstore_fusion():
+        _push_pull_fused(param_arrays, grad_arrays, kvstore, param_names, False)
+        return
     for index, pair in enumerate(zip(param_arrays, grad_arrays)):
         arg_list, grad_list = pair
         if grad_list[0] is None:
@@ -101,11 +141,14 @@ def _update_params_on_kvstore(param_arrays, grad_arrays, kvstore, param_names):
 def _update_params(param_arrays, grad_arrays, updater, num_device,
                    kvstore=None, param_names=None):
     """Perform update of param_arrays from grad_arrays not on kvstore."""
+    fused = kvstore and _kvstore_fusion()
+    if fused:
+        _push_pull_fused(param_arrays, grad_arrays, kvstore, param_names, True)
     for index, pair in enumerate(zip(param_arrays, grad_arrays)):
         arg_list, grad_list = pair
         if grad_list[0] is None:
             continue
-        if kvstore:
+        if kvstore and not fused:
             name = param_names[index]
             # push gradient, priority is negative index
             kvstore.push(name, grad_list, priority=-index)
@@ -805,7 +848,8 @@ class FeedForward(BASE_ESTIMATOR):
         # init optmizer
         if isinstance(self.optimizer, str):
             batch_size = data.batch_size
-            if kvstore and 'dist' in kvstore.type and not '_async' in kvstore.type:
+            if kvstore and ('dist' in kvstore.type and not '_async' in kvstore.type
+                            and not '_ssp' in kvstore.type or 'shm' in kvstore.type):
                 batch_size *= kvstore.num_workers
             optimizer = opt.create(self.optimizer,
                                    rescale_grad=(1.0/batch_size),
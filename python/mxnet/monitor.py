@@ -29,8 +29,13 @@ class Monitor(object):
         Only tensors with names that match `name_pattern` will be included.
         For example, '.*weight|.*output' will print all weights and outputs and
         '.*backward.*' will print all gradients.
+    stats : list of str, optional
+        If given, node outputs are summarized by the executor itself while the
+        graph runs, which keeps bulk execution enabled and is cheap enough for
+        production use. Choose from 'norm', 'mean', 'min', 'max', 'nan' and 'inf'.
+        `stat_func` is then only applied to arguments and auxiliary states.
     """
-    def __init__(self, interval, stat_func=None, pattern='.*', sort=False):
+    def __init__(self, interval, stat_func=None, pattern='.*', sort=False, stats=None):
         if stat_func is None:
             def asum_stat(x):
                 """returns |x|/size(x), async execution."""
@@ -44,6 +49,7 @@ class Monitor(object):
         self.exes = []
         self.re_prog = re.compile(pattern)
         self.sort = sort
+        self.stats = stats
         def stat_helper(name, array):
             """wrapper for executor callback"""
             array = ctypes.cast(array, NDArrayHandle)
@@ -62,7 +68,12 @@ class Monitor(object):
         exe : mx.executor.Executor
             The Executor (returned by symbol.bind) to install to.
         """
-        exe.set_monitor_callback(self.stat_helper)
+        if self.stats is None:
+            exe.set_monitor_callback(self.stat_helper)
+        else:
+            # sampled by tic, which switches the statistics on
+            exe.set_monitor_stats(self.stats, 1)
+            exe.enable_monitor_stats(False)
         self.exes.append(exe)
 
     def tic(self):
@@ -74,6 +85,9 @@ class Monitor(object):
                     array.wait_to_read()
                 for array in exe.aux_arrays:
                     array.wait_to_read()
+            if self.stats is not None:
+                for exe in self.exes:
+                    exe.enable_monitor_stats(True)
             self.queue = []
             self.activated = True
         self.step += 1
@@ -93,6 +107,15 @@ class Monitor(object):
                 array.wait_to_read()
             for array in exe.aux_arrays:
                 array.wait_to_read()
+        if self.stats is not None:
+            for exe in self.exes:
+                exe.enable_monitor_stats(False)
+                names, values = exe.get_monitor_stats()
+                values = values.asnumpy()
+                for name, row in zip(names, values):
+                    if self.re_prog.match(name):
+                        self.queue.append((self.step, name, '\t'.join(
+                            '%s=%s' % (k, v) for k, v in zip(exe._monitor_stats, row))))
         for exe in self.exes:
             for name, array in zip(exe._symbol.list_arguments(), exe.arg_arrays):
                 if self.re_prog.match(name):
@@ -105,6 +128,9 @@ class Monitor(object):
         if self.sort:
             self.queue.sort(key=lambda x: x[1])
         for n, k, v_list in self.queue:
+            if isinstance(v_list, str):
+                res.append((n, k, v_list))
+                continue
             if isinstance(v_list, NDArray):
                 v_list = [v_list]
             assert isinstance(v_list, list)
@@ -47,13 +47,17 @@ except ImportError:
 # pylint: enable=unused-import
 
 # pylint: disable= no-member
+# numpy has no bfloat16, its values are held as the raw 16 bits
+bfloat16 = np.dtype([('bfloat16', np.uint16)])
+
 _DTYPE_NP_TO_MX = {
     None       : -1,
     np.float32 : 0,
     np.float64 : 1,
     np.float16 : 2,
     np.uint8   : 3,
-    np.int32   : 4
+    np.int32   : 4,
+    bfloat16   : 12
 }
 
 _DTYPE_MX_TO_NP = {
@@ -62,9 +66,29 @@ _DTYPE_MX_TO_NP = {
     1 : np.float64,
     2 : np.float16,
     3 : np.uint8,
-    4 : np.int32
+    4 : np.int32,
+    12 : bfloat16
 }
 
+
+def _np_dtype(dtype):
+    """numpy dtype of `dtype`, which may also be `bfloat16` or 'bfloat16'."""
+    if isinstance(dtype, string_types) and dtype == 'bfloat16':
+        return bfloat16
+    return np.dtype(dtype)
+
+
+def _dtype_type(dtype):
+    """Key of `dtype` in `_DTYPE_NP_TO_MX`."""
+    dtype = _np_dtype(dtype)
+    return bfloat16 if dtype == bfloat16 else dtype.type
+
+
+def _dtype_name(dtype):
+    """Name of `dtype` as the operators parse it."""
+    dtype = _np_dtype(dtype)
+    return 'bfloat16' if dtype == bfloat16 else dtype.name
+
 _GRAD_REQ_MAP = {
     'null': 0,
     'write': 1,
@@ -103,7 +127,93 @@ def _new_alloc_handle(shape, ctx, delay_alloc, dtype=mx_real_t):
         ctypes.c_int(ctx.device_typeid),
         ctypes.c_int(ctx.device_id),
         ctypes.c_int(int(delay_alloc)),
-        ctypes.c_int(int(_DTYPE_NP_TO_MX[np.dtype(dtype).type])),
+        ctypes.c_int(int(_DTYPE_NP_TO_MX[_dtype_type(dtype)])),
+        ctypes.byref(hdl)))
+    return hdl
+
+_c_str_dltensor = c_str('dltensor')
+_c_str_used_dltensor = c_str('used_dltensor')
+ctypes.pythonapi.PyCapsule_New.restype = ctypes.py_object
+ctypes.pythonapi.PyCapsule_New.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_void_p]
+ctypes.pythonapi.PyCapsule_IsValid.restype = ctypes.c_int
+ctypes.pythonapi.PyCapsule_IsValid.argtypes = [ctypes.py_object, ctypes.c_char_p]
+ctypes.pythonapi.PyCapsule_GetPointer.restype = ctypes.c_void_p
+ctypes.pythonapi.PyCapsule_GetPointer.argtypes = [ctypes.py_object, ctypes.c_char_p]
+ctypes.pythonapi.PyCapsule_SetName.restype = ctypes.c_int
+ctypes.pythonapi.PyCapsule_SetName.argtypes = [ctypes.py_object, ctypes.c_char_p]
+ctypes.pythonapi.PyCapsule_SetDestructor.restype = ctypes.c_int
+ctypes.pythonapi.PyCapsule_SetDestructor.argtypes = [ctypes.py_object, ctypes.c_void_p]
+
+# the destructor receives a capsule being destroyed, which must not be
+# wrapped as a python object again.
+_capsule_is_valid = ctypes.PYFUNCTYPE(ctypes.c_int, ctypes.c_void_p, ctypes.c_char_p)(
+    ('PyCapsule_IsValid', ctypes.pythonapi))
+_capsule_get_pointer = ctypes.PYFUNCTYPE(ctypes.c_void_p, ctypes.c_void_p, ctypes.c_char_p)(
+    ('PyCapsule_GetPointer', ctypes.pythonapi))
+
+def _dlpack_deleter(capsule):
+    """Releases a capsule which was not consumed by `from_dlpack`."""
+    if _capsule_is_valid(capsule, _c_str_dltensor):
+        ptr = _capsule_get_pointer(capsule, _c_str_dltensor)
+        check_call(_LIB.MXNDArrayCallDLPackDeleter(ctypes.c_void_p(ptr)))
+
+_c_dlpack_deleter = ctypes.CFUNCTYPE(None, ctypes.c_void_p)(_dlpack_deleter)
+
+def _to_dlpack(handle):
+    """Returns a DLPack capsule named ``dltensor`` sharing the memory of `handle`."""
+    dlpack = ctypes.c_void_p()
+    check_call(_LIB.MXNDArrayToDLPack(handle, ctypes.byref(dlpack)))
+    return ctypes.pythonapi.PyCapsule_New(
+        dlpack, _c_str_dltensor, ctypes.cast(_c_dlpack_deleter, ctypes.c_void_p))
+
+def from_dlpack(dlpack):
+    """Returns an array sharing the memory of a DLPack capsule.
+
+    The capsule is consumed: it is renamed to ``used_dltensor`` and the
+    memory is released by the returned array. No data is copied.
+
+    The returned array has its own dependency tracking. Operations on it are not
+    ordered with those on other arrays of the same memory, so wait for the writes
+    through one of them before reading another.
+
+    Parameters
+    ----------
+    dlpack : PyCapsule
+        A capsule named ``dltensor``, as produced by `NDArray.to_dlpack_for_read`
+        or by another framework.
+
+    Returns
+    -------
+    NDArray
+        An array on the same memory.
+    """
+    if not ctypes.pythonapi.PyCapsule_IsValid(dlpack, _c_str_dltensor):
+        raise ValueError('Invalid DLPack capsule, a capsule can only be consumed once')
+    ptr = ctypes.pythonapi.PyCapsule_GetPointer(dlpack, _c_str_dltensor)
+    handle = NDArrayHandle()
+    check_call(_LIB.MXNDArrayFromDLPack(ctypes.c_void_p(ptr), ctypes.byref(handle)))
+    ctypes.pythonapi.PyCapsule_SetName(dlpack, _c_str_used_dltensor)
+    ctypes.pythonapi.PyCapsule_SetDestructor(dlpack, None)
+    return NDArray(handle=handle)
+
+def _new_from_shared_mem(shared_pid, shared_id, shape, dtype):
+    """Return a new handle on the shared memory of an array in ``cpu_shared`` context.
+
+    The arguments are the tuple returned by `NDArray._to_shared_mem`, possibly
+    in another process. No data is copied.
+
+    Returns
+    -------
+    handle
+        A new `NDArray` handle.
+    """
+    hdl = NDArrayHandle()
+    check_call(_LIB.MXNDArrayCreateFromSharedMem(
+        ctypes.c_int(shared_pid),
+        ctypes.c_int(shared_id),
+        c_array(mx_uint, shape),
+        mx_uint(len(shape)),
+        ctypes.c_int(int(_DTYPE_NP_TO_MX[_dtype_type(dtype)])),
         ctypes.byref(hdl)))
     return hdl
 
@@ -501,6 +611,11 @@ fixed-size items.
         >> a.asnumpy()
         array([ 3.,  4.], dtype=float32)
         """
+        if self.dtype == bfloat16 and not (isinstance(source_array, np.ndarray) and
+                                           source_array.dtype == bfloat16):
+            # numpy cannot round to bfloat16, the values are cast from float32
+            array(source_array, ctx=Context('cpu'), dtype=np.float32).copyto(self)
+            return
         if not isinstance(source_array, np.ndarray):
             try:
                 source_array = np.array(source_array, dtype=self.dtype)
@@ -699,6 +814,31 @@ fixed-size items.
         """
         check_call(_LIB.MXNDArrayWaitToRead(self.handle))
 
+    def to_dlpack_for_read(self):
+        """Returns a DLPack capsule sharing the memory of this array, for reading.
+
+        Pending writes to the array are finished first. No data is copied.
+
+        Examples
+        --------
+        >>> x = mx.nd.ones((2, 3))
+        >>> y = mx.nd.from_dlpack(x.to_dlpack_for_read())
+        >>> y.asnumpy()
+        array([[ 1.,  1.,  1.],
+               [ 1.,  1.,  1.]], dtype=float32)
+        """
+        self.wait_to_read()
+        return _to_dlpack(self.handle)
+
+    def to_dlpack_for_write(self):
+        """Returns a DLPack capsule sharing the memory of this array, for writing.
+
+        All pending reads and writes of the array are finished first.
+        No data is copied.
+        """
+        check_call(_LIB.MXNDArrayWaitToWrite(self.handle))
+        return _to_dlpack(self.handle)
+
 
     @property
     def ndim(self):
@@ -772,6 +912,17 @@ fixed-size items.
             self.handle, ctypes.byref(dev_typeid), ctypes.byref(dev_id)))
         return Context(Context.devtype2str[dev_typeid.value], dev_id.value)
 
+    def _to_shared_mem(self):
+        """Returns ``(shared_pid, shared_id, shape, dtype)`` of an array in
+        ``cpu_shared`` context, from which `_new_from_shared_mem` creates
+        an array on the same memory.
+        """
+        shared_pid = ctypes.c_int()
+        shared_id = ctypes.c_int()
+        check_call(_LIB.MXNDArrayGetSharedMemHandle(
+            self.handle, ctypes.byref(shared_pid), ctypes.byref(shared_id)))
+        return shared_pid.value, shared_id.value, self.shape, self.dtype
+
     @property
     def dtype(self):
         """Data-type of the array’s elements.
@@ -1234,7 +1385,8 @@ def array(source_array, ctx=None, dtype=None):
         dtype = mx_real_t if dtype is None else dtype
         if not isinstance(source_array, np.ndarray):
             try:
-                source_array = np.array(source_array, dtype=dtype)
+                source_array = np.array(
+                    source_array, dtype=np.float32 if _np_dtype(dtype) == bfloat16 else dtype)
             except:
                 raise TypeError('source_array must be array like object')
     arr = empty(source_array.shape, ctx, dtype)
@@ -2255,7 +2407,7 @@ def negative(arr):
     """
     return multiply(arr, -1.0)
 
-def load(fname):
+def load(fname, names=None):
     """Loads an array from file.
 
     See more details in ``save``.
@@ -2264,29 +2416,49 @@ def load(fname):
     ----------
     fname : str
         The filename.
+    names : list of str, optional
+        Names of the arrays to load from a file saved from a dict. Only
+        these arrays are read from a file in the indexed format, see
+        ``MXNET_NDARRAY_SAVE_FORMAT``.
 
     Returns
     -------
     list of NDArray or dict of str to NDArray
         Loaded data.
+
+    Examples
+    --------
+    >>> mx.nd.save('my_dict', {'x':mx.nd.zeros((2,3)), 'y':mx.nd.ones((1,4))})
+    >>> mx.nd.load('my_dict', names=['y'])
+    {'y': <NDArray 1x4 @cpu(0)>}
     """
     if not isinstance(fname, string_types):
         raise TypeError('fname required to be a string')
     out_size = mx_uint()
     out_name_size = mx_uint()
     handles = ctypes.POINTER(NDArrayHandle)()
-    names = ctypes.POINTER(ctypes.c_char_p)()
-    check_call(_LIB.MXNDArrayLoad(c_str(fname),
-                                  ctypes.byref(out_size),
-                                  ctypes.byref(handles),
-                                  ctypes.byref(out_name_size),
-                                  ctypes.byref(names)))
+    out_names = ctypes.POINTER(ctypes.c_char_p)()
+    if names is None:
+        check_call(_LIB.MXNDArrayLoad(c_str(fname),
+                                      ctypes.byref(out_size),
+                                      ctypes.byref(handles),
+                                      ctypes.byref(out_name_size),
+                                      ctypes.byref(out_names)))
+    else:
+        check_call(_LIB.MXNDArrayLoadSubset(c_str(fname),
+                                            mx_uint(len(names)),
+                                            c_array(ctypes.c_char_p,
+                                                    [c_str(n) for n in names]),
+                                            ctypes.byref(out_size),
+                                            ctypes.byref(handles),
+                                            ctypes.byref(out_name_size),
+                                            ctypes.byref(out_names)))
     if out_name_size.value == 0:
         return [NDArray(NDArrayHandle(handles[i])) for i in range(out_size.value)]
     else:
         assert out_name_size.value == out_size.value
-        return dict(
-            (py_str(names[i]), NDArray(NDArrayHandle(handles[i]))) for i in range(out_size.value))
+        return dict((py_str(out_names[i]), NDArray(NDArrayHandle(handles[i])))
+                    for i in range(out_size.value))
 
 
 def save(fname, data):
@@ -2515,7 +2687,7 @@ def %s(*%s, **kwargs):"""%(func_name, arr_name))
         if dtype_name is not None:
             code.append("""
     if '%s' in kwargs:
-        kwargs['%s'] = np.dtype(kwargs['%s']).name"""%(
+        kwargs['%s'] = _dtype_name(kwargs['%s'])"""%(
             dtype_name, dtype_name, dtype_name))
         code.append("""
     _ = kwargs.pop('name', None)
@@ -2546,7 +2718,7 @@ def %s(%s):
             code.append("""
     if %s is not _Null:
         keys.append('%s')
-        vals.append(np.dtype(%s).name)"""%(dtype_name, dtype_name, dtype_name))
+        vals.append(_dtype_name(%s))"""%(dtype_name, dtype_name, dtype_name))
 
     code.append("""
     return _imperative_invoke(%d, ndargs, keys, vals, out)"""%(
@@ -6,9 +6,13 @@ import warnings
 import numpy
 from .ndarray import (NDArray, zeros, clip, sqrt, sign, array, maximum, abs as NDabs)
 from .ndarray import (sgd_update, sgd_mom_update, adam_update, rmsprop_update, rmspropalex_update,
-                      mp_sgd_update, mp_sgd_mom_update)
+                      mp_sgd_update, mp_sgd_mom_update, mp_adam_update)
+from .ndarray import bfloat16
 from .random import normal
 
+# weight types that multi_precision keeps a float32 copy of
+_LOW_PRECISION = (numpy.float16, bfloat16)
+
 
 class Optimizer(object):
     """The base class inherited by all optimizers.
@@ -331,7 +335,8 @@ class SGD(Optimizer):
        ``False`` results in using the same precision as the weights (default),
        ``True`` makes internal 32-bit copy of the weights and applies gradients
                 in 32-bit precision even if actual weights used in the model have lower precision.
-                Turning this on can improve convergence and accuracy when training with float16.
+                Turning this on can improve convergence and accuracy when training with float16
+                or bfloat16.
     """
     def __init__(self, momentum=0.0, multi_precision=False, **kwargs):
         super(SGD, self).__init__(**kwargs)
@@ -341,12 +346,12 @@ class SGD(Optimizer):
     def create_state(self, index, weight):
         momentum = None
         weight_master_copy = None
-        if self.multi_precision and weight.dtype == numpy.float16:
+        if self.multi_precision and weight.dtype in _LOW_PRECISION:
             weight_master_copy = array(weight, ctx=weight.context, dtype=numpy.float32)
             if self.momentum != 0.0:
                 momentum = zeros(weight.shape, weight.context, dtype=numpy.float32)
             return (momentum, weight_master_copy)
-        if weight.dtype == numpy.float16 and not self.multi_precision:
+        if weight.dtype in _LOW_PRECISION and not self.multi_precision:
             warnings.warn("Accumulating with float16 in optimizer can lead to "
                           "poor accuracy or slow convergence. "
                           "Consider using multi_precision=True option of the "
@@ -531,15 +536,23 @@ class Adam(Optimizer):
         Exponential decay rate for the second moment estimates.
     epsilon : float, optional
         Small value to avoid division by 0.
+    multi_precision: bool, optional
+       Keep the moment estimates and a copy of float16 or bfloat16 weights in
+       float32 and apply the update in float32, see :class:`ndarray.mp_adam_update`.
     """
     def __init__(self, learning_rate=0.001, beta1=0.9, beta2=0.999, epsilon=1e-8,
-                 **kwargs):
+                 multi_precision=False, **kwargs):
         super(Adam, self).__init__(learning_rate=learning_rate, **kwargs)
         self.beta1 = beta1
         self.beta2 = beta2
         self.epsilon = epsilon
+        self.multi_precision = multi_precision
 
     def create_state(self, index, weight):
+        if self.multi_precision and weight.dtype in _LOW_PRECISION:
+            return (zeros(weight.shape, weight.context, dtype=numpy.float32),  # mean
+                    zeros(weight.shape, weight.context, dtype=numpy.float32),  # variance
+                    array(weight, ctx=weight.context, dtype=numpy.float32))
         return (zeros(weight.shape, weight.context, dtype=weight.dtype),  # mean
                 zeros(weight.shape, weight.context, dtype=weight.dtype))  # variance
 
@@ -560,9 +573,14 @@ class Adam(Optimizer):
         if self.clip_gradient:
             kwargs['clip_gradient'] = self.clip_gradient
 
-        mean, var = state
-        adam_update(weight, grad, mean, var, out=weight,
-                    lr=lr, wd=wd, **kwargs)
+        if len(state) == 3:
+            mean, var, weight32 = state
+            mp_adam_update(weight, grad, mean, var, weight32, out=weight,
+                           lr=lr, wd=wd, **kwargs)
+        else:
+            mean, var = state
+            adam_update(weight, grad, mean, var, out=weight,
+                        lr=lr, wd=wd, **kwargs)
 
 @register
 class AdaGrad(Optimizer):
@@ -18,6 +18,7 @@ from .base import NDArrayHandle, ExecutorHandle, SymbolHandle, OpHandle
 from .base import check_call, MXNetError, NotImplementedForSymbol, _Null  # pylint: disable=unused-import
 from .context import Context
 from .ndarray import NDArray, _DTYPE_NP_TO_MX, _DTYPE_MX_TO_NP, _GRAD_REQ_MAP
+from .ndarray import _dtype_type, _dtype_name
 from .name import NameManager  # pylint: disable=unused-import
 from .executor import Executor
 from . import _symbol_internal as _internal
@@ -845,7 +846,7 @@ class Symbol(SymbolBase):
             keys = None
             for s in args:
                 if s is not None:
-                    s = _numpy.dtype(s).type
+                    s = _dtype_type(s)
                     if s not in _DTYPE_NP_TO_MX:
                         raise TypeError('Argument need to be one of ' + str(_DTYPE_NP_TO_MX))
                     sdata.append(_DTYPE_NP_TO_MX[s])
@@ -854,7 +855,7 @@ class Symbol(SymbolBase):
         else:
             keys = []
             for k, v in kwargs.items():
-                v = _numpy.dtype(v).type
+                v = _dtype_type(v)
                 if v in _DTYPE_NP_TO_MX:
                     keys.append(c_str(k))
                     sdata.append(_DTYPE_NP_TO_MX[v])
@@ -1308,7 +1309,7 @@ class Symbol(SymbolBase):
             provided_arg_type_names = []
             provided_arg_type_data = []
             for k, v in type_dict.items():
-                v = _numpy.dtype(v).type
+                v = _dtype_type(v)
                 if v in _DTYPE_NP_TO_MX:
                     provided_arg_type_names.append(c_str(k))
                     provided_arg_type_data.append(ctypes.c_int(_DTYPE_NP_TO_MX[v]))
@@ -1787,7 +1788,7 @@ def var(name, attr=None, shape=None, lr_mult=None, wd_mult=None, dtype=None, ini
     if wd_mult is not None:
         attr['__wd_mult__'] = str(wd_mult)
     if dtype is not None:
-        attr['__dtype__'] = str(_DTYPE_NP_TO_MX[_numpy.dtype(dtype).type])
+        attr['__dtype__'] = str(_DTYPE_NP_TO_MX[_dtype_type(dtype)])
     if init is not None:
         if not isinstance(init, string_types):
             init = init.dumps()
@@ -2223,7 +2224,7 @@ def %s(*%s, **kwargs):"""%(func_name, arr_name))
         if dtype_name is not None:
             code.append("""
     if '%s' in kwargs:
-        kwargs['%s'] = _numpy.dtype(kwargs['%s']).name"""%(
+        kwargs['%s'] = _dtype_name(kwargs['%s'])"""%(
             dtype_name, dtype_name, dtype_name))
         code.append("""
     attr = kwargs.pop('attr', None)
@@ -2282,7 +2283,7 @@ def %s(%s):
             code.append("""
     if %s is not _Null:
         keys.append('%s')
-        vals.append(_numpy.dtype(%s).name)"""%(dtype_name, dtype_name, dtype_name))
+        vals.append(_dtype_name(%s))"""%(dtype_name, dtype_name, dtype_name))
 
         code.append("""
     name = NameManager.current.get(name, '%s')
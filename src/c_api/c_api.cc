@@ -9,6 +9,7 @@
 #include <dmlc/memory_io.h>
 #include <dmlc/recordio.h>
 #include <dmlc/omp.h>
+#include <dmlc/parameter.h>
 #include <mxnet/base.h>
 #include <mxnet/ndarray.h>
 #include <mxnet/operator.h>
@@ -197,6 +198,44 @@ int MXNDArraySyncCopyToCPU(NDArrayHandle handle,
   API_END();
 }
 
+int MXNDArrayAsyncCopyFromCPU(mx_uint num,
+                              NDArrayHandle *handles,
+                              const void **data,
+                              const size_t *sizes,
+                              NDArrayCopyHandle *out) {
+  API_BEGIN();
+  std::vector<NDArray> arrays;
+  for (mx_uint i = 0; i < num; ++i) {
+    arrays.push_back(*static_cast<NDArray*>(handles[i]));
+  }
+  *out = NDArray::AsyncCopyFromCPU(arrays,
+                                   std::vector<const void*>(data, data + num),
+                                   std::vector<size_t>(sizes, sizes + num));
+  API_END();
+}
+
+int MXNDArrayAsyncCopyToCPU(mx_uint num,
+                            NDArrayHandle *handles,
+                            void **data,
+                            const size_t *sizes,
+                            NDArrayCopyHandle *out) {
+  API_BEGIN();
+  std::vector<NDArray> arrays;
+  for (mx_uint i = 0; i < num; ++i) {
+    arrays.push_back(*static_cast<NDArray*>(handles[i]));
+  }
+  *out = NDArray::AsyncCopyToCPU(arrays,
+                                 std::vector<void*>(data, data + num),
+                                 std::vector<size_t>(sizes, sizes + num));
+  API_END();
+}
+
+int MXNDArrayWaitCopy(NDArrayCopyHandle handle) {
+  API_BEGIN();
+  NDArray::WaitCopy(static_cast<Engine::VarHandle>(handle));
+  API_END();
+}
+
 int MXNDArrayWaitToRead(NDArrayHandle handle) {
   API_BEGIN();
   static_cast<NDArray*>(handle)->WaitToRead();
@@ -233,7 +272,12 @@ int MXNDArraySave(const char* fname,
   }
   {
     std::unique_ptr<dmlc::Stream> fo(dmlc::Stream::Create(fname, "w"));
-    mxnet::NDArray::Save(fo.get(), data, names);
+    if (dmlc::GetEnv("MXNET_NDARRAY_SAVE_FORMAT", 1) == 2) {
+      mxnet::NDArray::SaveIndexed(fo.get(), data, names,
+                                  dmlc::GetEnv("MXNET_NDARRAY_SAVE_COMPRESS", false));
+    } else {
+      mxnet::NDArray::Save(fo.get(), data, names);
+    }
   }
   API_END();
 }
@@ -243,15 +287,24 @@ int MXNDArrayLoad(const char* fname,
                   NDArrayHandle** out_arr,
                   mx_uint *out_name_size,
                   const char*** out_names) {
+  return MXNDArrayLoadSubset(fname, 0, nullptr, out_size, out_arr,
+                             out_name_size, out_names);
+}
+
+int MXNDArrayLoadSubset(const char* fname,
+                        mx_uint num_names,
+                        const char** names_to_load,
+                        mx_uint *out_size,
+                        NDArrayHandle** out_arr,
+                        mx_uint *out_name_size,
+                        const char*** out_names) {
   MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
   ret->ret_vec_str.clear();
   API_BEGIN();
   std::vector<NDArray> data;
   std::vector<std::string> &names = ret->ret_vec_str;
-  {
-    std::unique_ptr<dmlc::Stream> fi(dmlc::Stream::Create(fname, "r"));
-    mxnet::NDArray::Load(fi.get(), &data, &names);
-  }
+  std::vector<std::string> select(names_to_load, names_to_load + num_names);
+  mxnet::NDArray::Load(fname, select, &data, &names);
   ret->ret_handles.resize(data.size());
   for (size_t i = 0; i < data.size(); ++i) {
     NDArray *ptr = new NDArray();
@@ -398,6 +451,50 @@ int MXNDArrayGetContext(NDArrayHandle handle,
   API_END();
 }
 
+int MXNDArrayToDLPack(NDArrayHandle handle,
+                      DLManagedTensorHandle *out) {
+  API_BEGIN();
+  *out = static_cast<NDArray*>(handle)->ToDLPack();
+  API_END();
+}
+
+int MXNDArrayFromDLPack(DLManagedTensorHandle dlpack,
+                        NDArrayHandle *out) {
+  NDArray *ptr = nullptr;
+  API_BEGIN();
+  ptr = new NDArray(NDArray::FromDLPack(static_cast<DLManagedTensor*>(dlpack)));
+  *out = ptr;
+  API_END_HANDLE_ERROR(delete ptr);
+}
+
+int MXNDArrayCallDLPackDeleter(DLManagedTensorHandle dlpack) {
+  API_BEGIN();
+  if (dlpack != nullptr) {
+    DLManagedTensor *tensor = static_cast<DLManagedTensor*>(dlpack);
+    if (tensor->deleter != nullptr) tensor->deleter(tensor);
+  }
+  API_END();
+}
+
+int MXNDArrayGetSharedMemHandle(NDArrayHandle handle,
+                                int *shared_pid,
+                                int *shared_id) {
+  API_BEGIN();
+  static_cast<NDArray*>(handle)->GetSharedMemHandle(shared_pid, shared_id);
+  API_END();
+}
+
+int MXNDArrayCreateFromSharedMem(int shared_pid,
+                                 int shared_id,
+                                 const mx_uint *shape,
+                                 mx_uint ndim,
+                                 int dtype,
+                                 NDArrayHandle *out) {
+  API_BEGIN();
+  *out = new NDArray(shared_pid, shared_id, TShape(shape, shape + ndim), dtype);
+  API_END();
+}
+
 
 int MXNDArrayGetGrad(NDArrayHandle handle, NDArrayHandle *out) {
   API_BEGIN();
@@ -735,6 +832,20 @@ int MXKVStoreSetUpdater(KVStoreHandle handle,
   API_END();
 }
 
+int MXKVStoreSetOptimizer(KVStoreHandle handle,
+                          const char *name,
+                          mx_uint num_params,
+                          const char **keys,
+                          const char **vals) {
+  API_BEGIN();
+  std::vector<std::pair<std::string, std::string> > kwargs;
+  for (mx_uint i = 0; i < num_params; ++i) {
+    kwargs.emplace_back(keys[i], vals[i]);
+  }
+  static_cast<KVStore*>(handle)->SetOptimizer(name, kwargs);
+  API_END();
+}
+
 int MXKVStoreGetRank(KVStoreHandle handle, int *rank) {
   API_BEGIN();
   *rank = static_cast<KVStore*>(handle)->get_rank();
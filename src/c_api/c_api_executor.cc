@@ -477,3 +477,39 @@ int MXExecutorSetMonitorCallback(ExecutorHandle handle,
   exec->SetMonitorCallback(clbk);
   API_END();
 }
+
+int MXExecutorSetMonitorStats(ExecutorHandle handle,
+                              int stat_mask,
+                              int interval) {
+  API_BEGIN();
+  Executor *exec = static_cast<Executor*>(handle);
+  exec->SetMonitorStats(stat_mask, interval);
+  API_END();
+}
+
+int MXExecutorEnableMonitorStats(ExecutorHandle handle,
+                                 int enabled) {
+  API_BEGIN();
+  Executor *exec = static_cast<Executor*>(handle);
+  exec->EnableMonitorStats(enabled != 0);
+  API_END();
+}
+
+int MXExecutorGetMonitorStats(ExecutorHandle handle,
+                              mx_uint *out_size,
+                              const char ***out_names,
+                              NDArrayHandle *out) {
+  Executor *exec = static_cast<Executor*>(handle);
+  MXAPIThreadLocalEntry *ret = MXAPIThreadLocalStore::Get();
+  API_BEGIN();
+  NDArray stats;
+  exec->GetMonitorStats(&(ret->ret_vec_str), &stats);
+  ret->ret_vec_charp.clear();
+  for (const auto& name : ret->ret_vec_str) {
+    ret->ret_vec_charp.push_back(name.c_str());
+  }
+  *out_size = static_cast<mx_uint>(ret->ret_vec_str.size());
+  *out_names = dmlc::BeginPtr(ret->ret_vec_charp);
+  *out = new NDArray(stats);
+  API_END();
+}
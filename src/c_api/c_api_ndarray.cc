@@ -120,8 +120,8 @@ void SetContext(Context* p_ctx,
   } else {
     ctx = default_ctx;
   }
-  // Pinned context doesn't propagate
-  if (ctx.dev_type == Context::kCPUPinned) {
+  // Pinned and shared contexts don't propagate
+  if (ctx.dev_type == Context::kCPUPinned || ctx.dev_type == Context::kCPUShared) {
     ctx = Context::CPU();
   }
 #if !MXNET_USE_CUDA
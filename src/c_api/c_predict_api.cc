@@ -244,14 +244,27 @@ int MXPredSetInput(PredictorHandle handle,
                    const char* key,
                    const mx_float* data,
                    mx_uint size) {
+  return MXPredSetInputs(handle, 1, &key, &data, &size);
+}
+
+int MXPredSetInputs(PredictorHandle handle,
+                    mx_uint num_input,
+                    const char** keys,
+                    const mx_float** data,
+                    const mx_uint* sizes) {
   MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
   API_BEGIN();
-  auto it = p->key2arg.find(key);
-  if (it == p->key2arg.end()) {
-    LOG(FATAL) << "cannot find input key " << key;
+  std::vector<NDArray> arrays;
+  for (mx_uint i = 0; i < num_input; ++i) {
+    auto it = p->key2arg.find(keys[i]);
+    if (it == p->key2arg.end()) {
+      LOG(FATAL) << "cannot find input key " << keys[i];
+    }
+    arrays.push_back(p->arg_arrays[it->second]);
   }
-  NDArray& nd = p->arg_arrays[it->second];
-  nd.SyncCopyFromCPU(data, size);
+  NDArray::WaitCopy(NDArray::AsyncCopyFromCPU(
+      arrays, std::vector<const void*>(data, data + num_input),
+      std::vector<size_t>(sizes, sizes + num_input)));
   API_END();
 }
 
@@ -273,12 +286,25 @@ int MXPredGetOutput(PredictorHandle handle,
                     mx_uint index,
                     mx_float* data,
                     mx_uint size) {
+  return MXPredGetOutputs(handle, 1, &index, &data, &size);
+}
+
+int MXPredGetOutputs(PredictorHandle handle,
+                     mx_uint num_output,
+                     const mx_uint* indices,
+                     mx_float** data,
+                     const mx_uint* sizes) {
   MXAPIPredictor* p = static_cast<MXAPIPredictor*>(handle);
   API_BEGIN();
-  CHECK_LT(index, p->out_arrays.size())
-      << "Output index out of range";
-  const NDArray& nd = p->out_arrays[index];
-  nd.SyncCopyToCPU(data, size);
+  std::vector<NDArray> arrays;
+  for (mx_uint i = 0; i < num_output; ++i) {
+    CHECK_LT(indices[i], p->out_arrays.size())
+        << "Output index out of range";
+    arrays.push_back(p->out_arrays[indices[i]]);
+  }
+  NDArray::WaitCopy(NDArray::AsyncCopyToCPU(
+      arrays, std::vector<void*>(data, data + num_output),
+      std::vector<size_t>(sizes, sizes + num_output)));
   API_END();
 }
 
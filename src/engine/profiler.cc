@@ -85,6 +85,7 @@ OprExecStat *Profiler::AddOprStat(int dev_type, uint32_t dev_id) {
   int idx;
   switch (dev_type) {
     case Context::kCPU:
+    case Context::kCPUShared:
       idx = dev_id;
       break;
     case Context::kGPU:
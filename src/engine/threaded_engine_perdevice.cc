@@ -34,6 +34,7 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
   ThreadedEnginePerDevice() noexcept(false) {
     gpu_worker_nthreads_ = common::GetNumThreadPerGPU();
     cpu_worker_nthreads_ = dmlc::GetEnv("MXNET_CPU_WORKER_NTHREADS", 1);
+    cpu_worker_priority_queue_ = dmlc::GetEnv("MXNET_CPU_WORKER_PRIORITY_QUEUE", false);
     // create CPU task
     int cpu_priority_nthreads = dmlc::GetEnv("MXNET_CPU_PRIORITY_NTHREADS", 4);
     cpu_priority_worker_.reset(new ThreadWorkerBlock<kPriorityQueue>());
@@ -48,6 +49,7 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
     gpu_normal_workers_.Clear();
     gpu_copy_workers_.Clear();
     cpu_normal_workers_.Clear();
+    cpu_ordered_workers_.Clear();
     cpu_priority_worker_.reset(nullptr);
   }
 
@@ -65,6 +67,20 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
       if (ctx.dev_mask() == cpu::kDevMask) {
         if (opr_block->opr->prop == FnProperty::kCPUPrioritized) {
           cpu_priority_worker_->task_queue.Push(opr_block, opr_block->priority);
+        } else if (cpu_worker_priority_queue_) {
+          int dev_id = ctx.dev_id;
+          int nthread = cpu_worker_nthreads_;
+          auto ptr =
+          cpu_ordered_workers_.Get(dev_id, [this, ctx, nthread]() {
+              auto blk = new ThreadWorkerBlock<kPriorityQueue>();
+              blk->pool.reset(new ThreadPool(nthread, [this, ctx, blk] () {
+                    this->CPUWorker(ctx, blk);
+                  }));
+              return blk;
+            });
+          if (ptr) {
+            ptr->task_queue.Push(opr_block, opr_block->priority);
+          }
         } else {
           int dev_id = ctx.dev_id;
           int nthread = cpu_worker_nthreads_;
@@ -139,8 +155,12 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
   int cpu_worker_nthreads_;
   /*! \brief number of concurrent thread each gpu worker uses */
   int gpu_worker_nthreads_;
+  /*! \brief whether normal cpu workers execute ready operations by priority */
+  bool cpu_worker_priority_queue_;
   // cpu worker
   common::LazyAllocArray<ThreadWorkerBlock<kWorkerQueue> > cpu_normal_workers_;
+  // cpu worker that orders ready operations by priority
+  common::LazyAllocArray<ThreadWorkerBlock<kPriorityQueue> > cpu_ordered_workers_;
   // cpu priority worker
   std::unique_ptr<ThreadWorkerBlock<kPriorityQueue> > cpu_priority_worker_;
   // workers doing normal works on GPU
@@ -212,6 +232,7 @@ class ThreadedEnginePerDevice : public ThreadedEngine {
     SignalQueueForKill(&gpu_normal_workers_);
     SignalQueueForKill(&gpu_copy_workers_);
     SignalQueueForKill(&cpu_normal_workers_);
+    SignalQueueForKill(&cpu_ordered_workers_);
     if (cpu_priority_worker_) {
       cpu_priority_worker_->task_queue.SignalForKill();
     }
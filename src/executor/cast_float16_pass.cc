@@ -0,0 +1,92 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file cast_float16_pass.cc
+ * \brief Run the operators that support it in float16 storage.
+ */
+#include <mxnet/base.h>
+#include <mxnet/operator.h>
+#include <mxnet/op_attr_types.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "./exec_pass.h"
+
+namespace mxnet {
+namespace exec {
+
+namespace {
+/*! \brief operators that keep their arrays in float16 and compute in float32 on cpu */
+bool RunsInFloat16(const nnvm::Node& node) {
+  static const std::unordered_set<std::string> kFloat16 = {
+    "FullyConnected", "Convolution", "Pooling", "Activation", "softmax", "log_softmax",
+    "Flatten", "Reshape", "elemwise_add", "_sub", "_mul", "relu", "sigmoid", "tanh",
+  };
+  if (node.is_variable()) return false;
+  return kFloat16.count(node.attrs.op->name) != 0;
+}
+}  // namespace
+
+Graph CastFloat16(Graph g, const std::unordered_map<std::string, int>& arg_dtypes) {
+  using nnvm::Node;
+  using nnvm::NodePtr;
+  using nnvm::NodeEntry;
+  static const Op* cast_op = Op::Get("Cast");
+  std::vector<NodePtr> nodes;
+  std::unordered_map<const Node*, bool> half;
+  nnvm::DFSVisit(g.outputs, [&](const NodePtr& n) {
+      nodes.push_back(n);
+      half[n.get()] = RunsInFloat16(*n);
+    });
+  // variables without a given type are stored in float16 when only
+  // float16 operators read them, as the weights of most networks.
+  std::unordered_set<const Node*> read_by_float32;
+  for (const NodePtr& n : nodes) {
+    if (half[n.get()]) continue;
+    for (const NodeEntry& e : n->inputs) read_by_float32.insert(e.node.get());
+  }
+  for (const NodeEntry& e : g.outputs) read_by_float32.insert(e.node.get());
+  for (const NodePtr& n : nodes) {
+    if (!n->is_variable()) continue;
+    auto it = arg_dtypes.find(n->attrs.name);
+    const bool typed = (it != arg_dtypes.end() && it->second != mshadow::kFloat16) ||
+        n->attrs.dict.count("__dtype__") != 0;
+    half[n.get()] = !typed && read_by_float32.count(n.get()) == 0;
+  }
+
+  std::map<std::pair<const Node*, uint32_t>, NodeEntry> casted;
+  auto cast = [&](const NodeEntry& e, bool to_half) {
+    auto key = std::make_pair(e.node.get(), e.index);
+    auto it = casted.find(key);
+    if (it != casted.end()) return it->second;
+    const std::string dtype = to_half ? "float16" : "float32";
+    NodePtr node = Node::Create();
+    node->attrs.op = cast_op;
+    node->attrs.name = e.node->attrs.name +
+        (e.node->num_outputs() > 1 ? "_output" + std::to_string(e.index) : "") + "_" + dtype;
+    node->attrs.dict["dtype"] = dtype;
+    auto ctx_group = e.node->attrs.dict.find("__ctx_group__");
+    if (ctx_group != e.node->attrs.dict.end()) {
+      node->attrs.dict["__ctx_group__"] = ctx_group->second;
+    }
+    cast_op->attr_parser(&(node->attrs));
+    node->inputs.push_back(e);
+    return casted[key] = NodeEntry{node, 0, 0};
+  };
+  for (const NodePtr& n : nodes) {
+    const bool to_half = half[n.get()];
+    for (NodeEntry& e : n->inputs) {
+      if (half[e.node.get()] != to_half) e = cast(e, to_half);
+    }
+  }
+  for (NodeEntry& e : g.outputs) {
+    if (half[e.node.get()]) e = cast(e, false);
+  }
+  return g;
+}
+
+}  // namespace exec
+}  // namespace mxnet
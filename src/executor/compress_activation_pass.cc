@@ -0,0 +1,169 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file compress_activation_pass.cc
+ * \brief Keep the activations needed by backward in a compressed type.
+ */
+#include <mxnet/base.h>
+#include <mxnet/operator.h>
+#include <mxnet/op_attr_types.h>
+#include <nnvm/graph_attr_types.h>
+#include <nnvm/pass_functions.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "./exec_pass.h"
+
+namespace mxnet {
+namespace exec {
+
+namespace {
+/*! \brief backward operators that compare values or read indices of their inputs */
+bool ReadsExactValues(const nnvm::Node& node) {
+  static const std::unordered_set<std::string> kExact = {
+    "_backward_Pooling", "_backward_Embedding", "_backward_take", "_backward_batch_take",
+    "_backward_pick", "_backward_SequenceLast", "_backward_SequenceMask",
+    "_backward_SequenceReverse", "_backward_Custom", "_backward_topk",
+  };
+  if (node.is_variable()) return false;
+  return kExact.count(node.attrs.op->name) != 0;
+}
+
+/*! \brief the name of a type in the out_dtype parameter of _stash_decode */
+const char* DecodedTypeName(int dtype) {
+  switch (dtype) {
+    case mshadow::kFloat32: return "float32";
+    case mshadow::kFloat64: return "float64";
+    case mshadow::kFloat16: return "float16";
+    case kBfloat16: return "bfloat16";
+    default: return nullptr;
+  }
+}
+
+bool CompressionDisabled(const nnvm::Node& node) {
+  auto it = node.attrs.dict.find("__compress_activation__");
+  if (it == node.attrs.dict.end()) return false;
+  return it->second == "0" || it->second == "False" || it->second == "false";
+}
+}  // namespace
+
+Graph CompressActivations(Graph g, size_t num_forward_outputs,
+                          int stash_dtype, int block_size,
+                          const std::unordered_map<std::string, int>& arg_dtypes) {
+  using nnvm::Node;
+  using nnvm::NodePtr;
+  using nnvm::NodeEntry;
+  static const Op* encode_op = Op::Get("_stash_encode");
+  static const Op* decode_op = Op::Get("_stash_decode");
+  std::vector<NodeEntry> forward_outputs(g.outputs.begin(),
+                                         g.outputs.begin() + num_forward_outputs);
+  std::unordered_set<const Node*> forward_nodes;
+  NodePtr last;
+  nnvm::DFSVisit(forward_outputs, [&](const NodePtr& n) {
+      forward_nodes.insert(n.get());
+      last = n;
+    });
+  if (last == nullptr || last->is_variable()) return g;
+
+  std::vector<NodePtr> backward_nodes;
+  nnvm::DFSVisit(g.outputs, [&](const NodePtr& n) {
+      if (forward_nodes.count(n.get()) == 0) backward_nodes.push_back(n);
+    });
+  // forward entries read by backward, and whether they can be compressed
+  std::map<std::pair<const Node*, uint32_t>, std::pair<NodeEntry, bool> > stashed;
+  for (const NodePtr& n : backward_nodes) {
+    for (const NodeEntry& e : n->inputs) {
+      if (forward_nodes.count(e.node.get()) == 0 || e.node->is_variable()) continue;
+      auto it = stashed.emplace(std::make_pair(e.node.get(), e.index),
+                                std::make_pair(e, true)).first;
+      it->second.second = it->second.second && !ReadsExactValues(*n);
+    }
+  }
+  // graph outputs are kept anyway, and the last forward node is
+  // the one the encoders are attached to.
+  for (const NodeEntry& e : forward_outputs) {
+    stashed.erase(std::make_pair(e.node.get(), e.index));
+  }
+  for (auto it = stashed.begin(); it != stashed.end();) {
+    const Node* src = it->first.first;
+    if (!it->second.second || src == last.get() || CompressionDisabled(*src)) {
+      it = stashed.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (stashed.size() == 0) return g;
+
+  // types of the forward outputs, so that decode does not depend on its
+  // consumers to know the type it restores
+  nnvm::Graph fwd;
+  fwd.outputs = forward_outputs;
+  const auto& fidx = fwd.indexed_graph();
+  nnvm::DTypeVector input_dtypes(fidx.input_nodes().size(), -1);
+  for (size_t i = 0; i < input_dtypes.size(); ++i) {
+    auto it = arg_dtypes.find(fidx[fidx.input_nodes()[i]].source->attrs.name);
+    if (it != arg_dtypes.end()) input_dtypes[i] = it->second;
+  }
+  fwd = nnvm::pass::InferType(fwd, input_dtypes, "__dtype__");
+  const auto& fwd_dtypes = fwd.GetAttr<nnvm::DTypeVector>("dtype");
+
+  // The encoders are made control dependencies of a copy of the last forward
+  // node, which places them in the forward part of the topological order.
+  // The original node belongs to the symbol and is left untouched.
+  NodePtr new_last = Node::Create();
+  *new_last = *last;
+  const std::string dtype_str = stash_dtype == mshadow::kUint8 ? "uint8" : "float16";
+  std::map<std::pair<const Node*, uint32_t>, NodeEntry> decoded;
+  for (const auto& kv : stashed) {
+    const NodeEntry& e = kv.second.first;
+    const std::string name = e.node->attrs.name + "_output" + std::to_string(e.index);
+    NodePtr encode = Node::Create();
+    encode->attrs.op = encode_op;
+    encode->attrs.name = name + "_stash_encode";
+    encode->attrs.dict["dtype"] = dtype_str;
+    encode->attrs.dict["block_size"] = std::to_string(block_size);
+    encode->inputs.push_back(e);
+    NodePtr decode = Node::Create();
+    decode->attrs.op = decode_op;
+    decode->attrs.name = name + "_stash_decode";
+    decode->attrs.dict = encode->attrs.dict;
+    const char* out_dtype = DecodedTypeName(
+        fwd_dtypes[fidx.entry_id(fidx.node_id(e.node.get()), e.index)]);
+    if (out_dtype != nullptr) decode->attrs.dict["out_dtype"] = out_dtype;
+    auto ctx_group = e.node->attrs.dict.find("__ctx_group__");
+    if (ctx_group != e.node->attrs.dict.end()) {
+      encode->attrs.dict["__ctx_group__"] = ctx_group->second;
+      decode->attrs.dict["__ctx_group__"] = ctx_group->second;
+    }
+    encode_op->attr_parser(&(encode->attrs));
+    decode_op->attr_parser(&(decode->attrs));
+    for (uint32_t i = 0; i < encode->num_outputs(); ++i) {
+      decode->inputs.emplace_back(NodeEntry{encode, i, 0});
+    }
+    new_last->control_deps.push_back(encode);
+    decoded[kv.first] = NodeEntry{decode, 0, 0};
+  }
+  // redirect backward readers
+  for (const NodePtr& n : backward_nodes) {
+    for (NodeEntry& e : n->inputs) {
+      auto it = decoded.find(std::make_pair(e.node.get(), e.index));
+      if (it != decoded.end()) {
+        e = it->second;
+      } else if (e.node == last) {
+        e.node = new_last;
+      }
+    }
+    for (NodePtr& dep : n->control_deps) {
+      if (dep == last) dep = new_last;
+    }
+  }
+  for (NodeEntry& e : g.outputs) {
+    if (e.node == last) e.node = new_last;
+  }
+  return g;
+}
+
+}  // namespace exec
+}  // namespace mxnet
@@ -12,6 +12,8 @@
 #include <nnvm/graph.h>
 #include <vector>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace mxnet {
 namespace exec {
@@ -105,6 +107,48 @@ Graph AttachOpResources(Graph g);
  */
 Graph DetectInplaceAddTo(Graph g);
 
+/*!
+ * \brief Store the activations kept for the backward pass in a compressed type.
+ *
+ *  Every output of a forward node that is read by the backward pass is encoded
+ *  by a _stash_encode node right after forward, and the backward readers are
+ *  redirected to a _stash_decode node, so the full precision array can be freed
+ *  by the memory planner at the end of forward. Outputs of the graph, and outputs
+ *  read by backward operators that compare values or read indices, are kept.
+ *  A node can be excluded with the attribute __compress_activation__=False.
+ *
+ *  Must be applied to the full graph before the context assignment.
+ *
+ * \param g the full graph, whose first num_forward_outputs outputs are forward outputs.
+ * \param num_forward_outputs number of forward outputs.
+ * \param stash_dtype storage type, mshadow::kFloat16 or mshadow::kUint8.
+ * \param block_size number of values sharing a scale with mshadow::kUint8.
+ * \param arg_dtypes known types of the arguments by name, from which the types of
+ *  the stashed outputs are inferred and recorded on the decode nodes.
+ * \return graph with the encode and decode nodes inserted.
+ */
+Graph CompressActivations(Graph g, size_t num_forward_outputs,
+                          int stash_dtype, int block_size,
+                          const std::unordered_map<std::string, int>& arg_dtypes);
+
+/*!
+ * \brief Keep the arrays of the operators that support it in float16 on cpu.
+ *
+ *  The operators that compute in float32 on float16 arrays read and write
+ *  float16, a Cast node is inserted wherever they meet a float32 operator,
+ *  and the outputs of the graph stay float32. Arguments without a given type
+ *  that only float16 operators read, the weights of a float32 model, are
+ *  inferred as float16 and converted when they are loaded.
+ *
+ *  Applied to the forward graph of an inference executor, the nodes of g
+ *  are modified so it must not share them with a user symbol.
+ *
+ * \param g the forward graph.
+ * \param arg_dtypes types given to the arguments, which are kept.
+ * \return graph with the Cast nodes inserted.
+ */
+Graph CastFloat16(Graph g, const std::unordered_map<std::string, int>& arg_dtypes);
+
 }  // namespace exec
 }  // namespace mxnet
 
@@ -8,9 +8,13 @@
 #include <nnvm/pass_functions.h>
 #include <vector>
 #include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <string>
 
 #include "./exec_pass.h"
 #include "./graph_executor.h"
+#include "./static_schedule.h"
 #include "../engine/profiler.h"
 
 namespace mxnet {
@@ -30,7 +34,9 @@ GraphExecutor::~GraphExecutor() {
 }
 
 void GraphExecutor::Forward(bool is_train) {
+  if (monitor_stats_ != nullptr) monitor_stats_->Begin();
   RunOps(is_train, 0, num_forward_nodes_);
+  if (monitor_stats_ != nullptr) monitor_stats_->Publish();
 }
 
 void GraphExecutor::PartialForward(bool is_train, int step, int *step_left) {
@@ -38,8 +44,10 @@ void GraphExecutor::PartialForward(bool is_train, int step, int *step_left) {
   if (sstep >= num_forward_nodes_) {
     *step_left = 0; return;
   }
+  if (sstep == 0 && monitor_stats_ != nullptr) monitor_stats_->Begin();
   RunOps(is_train, sstep, sstep + 1);
   *step_left = static_cast<int>(num_forward_nodes_ - sstep - 1);
+  if (*step_left == 0 && monitor_stats_ != nullptr) monitor_stats_->Publish();
 }
 
 void GraphExecutor::Backward(const std::vector<NDArray>& head_grads) {
@@ -58,6 +66,7 @@ void GraphExecutor::Backward(const std::vector<NDArray>& head_grads) {
     }
   }
   RunOps(true, num_forward_nodes_, idx.num_nodes());
+  if (monitor_stats_ != nullptr) monitor_stats_->Publish();
 }
 
 void GraphExecutor::Print(std::ostream &os) const {  // NOLINT(*)
@@ -67,6 +76,10 @@ void GraphExecutor::Print(std::ostream &os) const {  // NOLINT(*)
   size_t total_bytes = graph_.GetAttr<size_t>("storage_allocated_bytes");
   os << "Total " << (total_bytes >> 20UL) <<" MB allocated\n";
   os << "Total " << 11 << " TempSpace resource requested\n";
+  if (do_checkpoint_) {
+    os << "Total " << num_checkpoints_ << " checkpoints, "
+       << num_recompute_nodes_ << " nodes recomputed in backward\n";
+  }
 }
 
 void GraphExecutor::SetMonitorCallback(const MonitorCallback& callback) {
@@ -74,6 +87,60 @@ void GraphExecutor::SetMonitorCallback(const MonitorCallback& callback) {
   monitor_callback_ = callback;
 }
 
+void GraphExecutor::SetMonitorStats(int stat_mask, int interval) {
+  static const auto& flist_outputs =
+      nnvm::Op::GetAttr<nnvm::FListOutputNames>("FListOutputNames");
+  CHECK(monitor_stats_ == nullptr) << "monitor statistics are already set";
+  const auto& idx = graph_.indexed_graph();
+  // one row per output of each node that runs as a cached operator
+  std::vector<std::string> names;
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    OpNode& opnode = op_nodes_[nid];
+    if (opnode.cached_opr == nullptr) continue;
+    const auto& node = idx[nid].source;
+    std::vector<std::string> output_names;
+    if (flist_outputs.count(node->op())) {
+      output_names = flist_outputs[node->op()](node->attrs);
+    } else {
+      for (size_t i = 0; i < node->num_outputs(); ++i) {
+        output_names.emplace_back(std::to_string(i));
+      }
+    }
+    opnode.monitor_row = static_cast<int>(names.size());
+    for (size_t i = 0; i < opnode.exec->out_array.size(); ++i) {
+      // FListOutputNames may name fewer outputs than the node has
+      names.emplace_back(node->attrs.name + "_" + (i < output_names.size() ?
+                         output_names[i] : "output" + std::to_string(i)));
+    }
+  }
+  monitor_stats_ = std::make_shared<MonitorStats>(stat_mask, interval, std::move(names));
+  // re-create the operators so they depend on the monitor state
+  for (uint32_t nid = 0; nid < idx.num_nodes(); ++nid) {
+    OpNode& opnode = op_nodes_[nid];
+    if (opnode.cached_opr == nullptr) continue;
+    Engine::Get()->DeleteOperator(opnode.cached_opr);
+    opnode.use_vars.push_back(monitor_stats_->var());
+    this->CreateCachedOpr(nid);
+  }
+  for (auto& seg : cached_seg_opr_) {
+    if (seg.opr != nullptr) {
+      Engine::Get()->DeleteOperator(seg.opr);
+    }
+  }
+  this->InitOpSegs();
+}
+
+void GraphExecutor::EnableMonitorStats(bool enabled) {
+  CHECK(monitor_stats_ != nullptr) << "monitor statistics are not set";
+  monitor_stats_->set_enabled(enabled);
+}
+
+void GraphExecutor::GetMonitorStats(std::vector<std::string>* names, NDArray* stats) const {
+  CHECK(monitor_stats_ != nullptr) << "monitor statistics are not set";
+  *names = monitor_stats_->names();
+  *stats = monitor_stats_->stats();
+}
+
 const std::vector<NDArray>& GraphExecutor::outputs() const {
   return output_arrays_;
 }
@@ -190,12 +257,55 @@ inline ValueType get_node_attr(
   }
 }
 
+/*!
+ * \brief Whether the output of a node can be recomputed during backward.
+ *  Nodes that mutate their inputs (e.g. update auxiliary states) or draw
+ *  random numbers would produce different results the second time.
+ */
+inline bool CanRecompute(const nnvm::Node& node) {
+  static auto& fmutate_inputs = nnvm::Op::GetAttr<nnvm::FMutateInputs>("FMutateInputs");
+  if (node.is_variable()) return false;
+  const std::string& type = node.attrs.op->name;
+  if (type == "Dropout") return false;
+  if (type == "BatchNorm" || type == "CuDNNBatchNorm") return false;
+  if (type.compare(0, 8, "_random_") == 0 || type.compare(0, 8, "_sample_") == 0) return false;
+  if (fmutate_inputs.count(node.op())) return false;
+  return true;
+}
+
+/*!
+ * \brief Select the nodes whose outputs are kept for backward when
+ *  gradient checkpointing is enabled. Nodes marked with the attribute
+ *  __checkpoint__ are used if there are any, otherwise one every interval
+ *  forward nodes is picked, with interval=sqrt(N) by default.
+ */
+std::unordered_set<const nnvm::Node*> SelectCheckpoints(const nnvm::Symbol& symbol,
+                                                        size_t interval) {
+  std::vector<const nnvm::Node*> topo_order;
+  std::unordered_set<const nnvm::Node*> checkpoints;
+  nnvm::DFSVisit(symbol.outputs, [&](const nnvm::NodePtr& n) {
+      if (n->is_variable()) return;
+      topo_order.push_back(n.get());
+      if (get_node_attr(*n, "__checkpoint__", false)) checkpoints.insert(n.get());
+    });
+  if (checkpoints.size() != 0) return checkpoints;
+  if (interval == 0) {
+    interval = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(topo_order.size()))));
+  }
+  interval = std::max(interval, static_cast<size_t>(1));
+  for (size_t i = interval - 1; i < topo_order.size(); i += interval) {
+    checkpoints.insert(topo_order[i]);
+  }
+  return checkpoints;
+}
+
 /*!
  * \brief Create the graph for backward pass.
  * This is triggered by both simple_bind and bind flows.
  */
 nnvm::Graph GraphExecutor::InitFullGraph(nnvm::Symbol symbol,
-                                         const std::vector<OpReqType>& grad_req_types) {
+                                         const std::vector<OpReqType>& grad_req_types,
+                                         const std::unordered_map<std::string, int>& arg_dtypes) {
   using nnvm::NodePtr;
   using nnvm::NodeEntry;
   // initial information
@@ -223,11 +333,20 @@ nnvm::Graph GraphExecutor::InitFullGraph(nnvm::Symbol symbol,
   }
 
   int do_mirror = dmlc::GetEnv("MXNET_BACKWARD_DO_MIRROR", 0);
-  auto need_mirror = [do_mirror](const nnvm::Node& node) -> int {
+  std::unordered_set<const nnvm::Node*> checkpoints;
+  do_checkpoint_ = dmlc::GetEnv("MXNET_BACKWARD_CHECKPOINT", false);
+  if (do_checkpoint_) {
+    checkpoints = SelectCheckpoints(
+        symbol, dmlc::GetEnv("MXNET_BACKWARD_CHECKPOINT_INTERVAL", static_cast<size_t>(0)));
+    num_checkpoints_ = checkpoints.size();
+  }
+  auto need_mirror = [do_mirror, this, &checkpoints](const nnvm::Node& node) -> int {
     if (node.is_variable()) return 0;
     const std::string& type = node.attrs.op->name;
     if (type == "Dropout") return false;
     if (get_node_attr(node, "__force_mirroring__", false)) return true;
+    // recompute everything between checkpoints
+    if (do_checkpoint_) return checkpoints.count(&node) == 0 && CanRecompute(node);
     if (do_mirror == 0) return false;
     if (type == "Convolution") return false;
     if (type == "FullyConnected") return false;
@@ -251,6 +370,16 @@ nnvm::Graph GraphExecutor::InitFullGraph(nnvm::Symbol symbol,
   for (const auto &e : g_grad.outputs) {
     g.outputs.push_back(e);
   }
+  // 0: keep activations as is, 1: float16, 2: 8 bits with a scale per block
+  int compress = dmlc::GetEnv("MXNET_BACKWARD_COMPRESS_ACTIVATION", 0);
+  if (compress != 0) {
+    CHECK(compress == 1 || compress == 2)
+        << "MXNET_BACKWARD_COMPRESS_ACTIVATION must be 0, 1(float16) or 2(uint8)";
+    g = CompressActivations(g, num_forward_outputs_,
+                            compress == 1 ? mshadow::kFloat16 : mshadow::kUint8,
+                            dmlc::GetEnv("MXNET_BACKWARD_COMPRESS_BLOCK_SIZE", 256),
+                            arg_dtypes);
+  }
   return g;
 }
 
@@ -447,8 +576,18 @@ void GraphExecutor::Init(nnvm::Symbol symbol,
   std::vector<Context> aux_state_ctxes(aux_states.size());
   std::transform(aux_states.begin(), aux_states.end(), aux_state_ctxes.begin(), get_ctx1);
 
+  std::unordered_map<std::string, int> arg_dtype_map;
+  const std::vector<std::string> arg_names = symbol.ListInputNames(nnvm::Symbol::kReadOnlyArgs);
+  const std::vector<std::string> aux_names =
+      symbol.ListInputNames(nnvm::Symbol::kAuxiliaryStates);
+  for (size_t i = 0; i < arg_names.size() && i < in_args.size(); ++i) {
+    arg_dtype_map[arg_names[i]] = in_args[i].dtype();
+  }
+  for (size_t i = 0; i < aux_names.size() && i < aux_states.size(); ++i) {
+    arg_dtype_map[aux_names[i]] = aux_states[i].dtype();
+  }
   nnvm::Graph g = InitGraph(symbol, default_ctx, ctx_map, in_arg_ctxes,
-                            arg_grad_ctxes, aux_state_ctxes, grad_req_types);
+                            arg_grad_ctxes, aux_state_ctxes, grad_req_types, arg_dtype_map);
 
   // create arg_shapes and arg_dtypes for shape and type inferences
   const auto& idx = g.indexed_graph();
@@ -720,6 +859,56 @@ void GraphExecutor::FinishInitGraph(nnvm::Symbol symbol,
     g.attrs["storage"] = std::make_shared<dmlc::any>(std::move(arg_storage_id));
     g = nnvm::ApplyPass(g, "PlanMemory");
   }
+  if (do_checkpoint_) {
+    // forward nodes copied into the backward graph are recomputed
+    const auto& planned_idx = g.indexed_graph();
+    size_t num_forward_ops = 0;
+    num_recompute_nodes_ = 0;
+    for (size_t nid = 0; nid < planned_idx.num_nodes(); ++nid) {
+      const nnvm::Node* node = planned_idx[nid].source;
+      if (node->is_variable()) continue;
+      if (nid < num_forward_nodes_) {
+        ++num_forward_ops;
+      } else if (node->attrs.name.size() > 7 &&
+                 node->attrs.name.compare(node->attrs.name.size() - 7, 7, "_mirror") == 0) {
+        ++num_recompute_nodes_;
+      }
+    }
+    size_t total_bytes = g.GetAttr<size_t>("storage_allocated_bytes");
+    LOG(INFO) << "Gradient checkpointing: " << num_checkpoints_ << " checkpoints, "
+              << num_recompute_nodes_ << " of " << num_forward_ops
+              << " forward nodes recomputed in backward, "
+              << (total_bytes >> 20UL) << " MB planned memory";
+  }
+  {
+    // report the memory kept for backward by the compressed activations
+    static const Op* encode_op = Op::Get("_stash_encode");
+    const auto& planned_idx = g.indexed_graph();
+    const auto& vshape = g.GetAttr<nnvm::ShapeVector>("shape");
+    const auto& vdtype = g.GetAttr<nnvm::DTypeVector>("dtype");
+    size_t num_stashed = 0, raw_bytes = 0, stashed_bytes = 0;
+    std::string stash_dtype;
+    for (size_t nid = 0; nid < planned_idx.num_nodes(); ++nid) {
+      const auto& inode = planned_idx[nid];
+      if (inode.source->op() != encode_op) continue;
+      uint32_t eid = planned_idx.entry_id(inode.inputs[0]);
+      raw_bytes += vshape[eid].Size() * TypeSize(vdtype[eid]);
+      for (uint32_t i = 0; i < inode.source->num_outputs(); ++i) {
+        eid = planned_idx.entry_id(nid, i);
+        stashed_bytes += vshape[eid].Size() * TypeSize(vdtype[eid]);
+      }
+      stash_dtype = inode.source->attrs.dict.at("dtype");
+      ++num_stashed;
+    }
+    if (num_stashed != 0) {
+      LOG(INFO) << "Activation compression: " << num_stashed << " arrays, "
+                << (raw_bytes >> 20UL) << " MB stored as " << (stashed_bytes >> 20UL)
+                << " MB in " << stash_dtype << ", "
+                << (g.GetAttr<size_t>("storage_allocated_bytes") >> 20UL)
+                << " MB planned memory, error bound "
+                << (stash_dtype == "float16" ? "2^-11 relative" : "max(abs(block))/254 absolute");
+    }
+  }
   g = DetectInplaceAddTo(g);
 
   g.attrs["saved_states"] = std::make_shared<nnvm::any>(std::move(saved_states_));
@@ -749,6 +938,7 @@ void GraphExecutor::FinishInitGraph(nnvm::Symbol symbol,
     }
   }
   this->InitCachedOps();
+  this->InitOpPriority();
   this->InitOpSegs();
 }
 
@@ -782,8 +972,17 @@ void GraphExecutor::Init(nnvm::Symbol symbol,
                          std::unordered_map<std::string, NDArray>* shared_buffer,
                          Executor* shared_exec,
                          const nnvm::NodeEntryMap<NDArray>& feed_dict) {
+  // float16 storage for inference on cpu, on a copy of the user's symbol
+  if (dmlc::GetEnv("MXNET_EXEC_CPU_FLOAT16", false) &&
+      default_ctx.dev_mask() == cpu::kDevMask && ctx_map.empty() &&
+      std::all_of(grad_req_types.begin(), grad_req_types.end(),
+                  [](OpReqType req) { return req == kNullOp; })) {
+    nnvm::Graph cast;
+    cast.outputs = symbol.Copy().outputs;
+    symbol.outputs = CastFloat16(cast, arg_dtype_map).outputs;
+  }
   nnvm::Graph g = InitGraph(symbol, default_ctx, ctx_map, in_arg_ctxes, arg_grad_ctxes,
-                            aux_state_ctxes, grad_req_types);
+                            aux_state_ctxes, grad_req_types, arg_dtype_map);
   // The following code of shape and dtype inferences and argument
   // initialization is for simple_bind only. Regular bind operation
   // should do this differently.
@@ -854,9 +1053,10 @@ Graph GraphExecutor::InitGraph(nnvm::Symbol symbol,
                                const std::vector<Context>& in_arg_ctxes,
                                const std::vector<Context>& arg_grad_ctxes,
                                const std::vector<Context>& aux_state_ctxes,
-                               const std::vector<OpReqType>& grad_req_types) {
+                               const std::vector<OpReqType>& grad_req_types,
+                               const std::unordered_map<std::string, int>& arg_dtypes) {
   // setup gradient
-  nnvm::Graph g = InitFullGraph(symbol, grad_req_types);
+  nnvm::Graph g = InitFullGraph(symbol, grad_req_types, arg_dtypes);
 
   // create "device" and "context" attrs for the graph
   g = AssignContext(g, default_ctx, ctx_map,
@@ -916,7 +1116,7 @@ void GraphExecutor::InitDataEntryMemory(std::vector<NDArray>* shared_pool) {
   // get maximum bytes in each pool
   for (size_t i = 0; i < vshape.size(); ++i) {
     if (!data_entry_[i].is_none()) continue;
-    size_t bytes = vshape[i].Size() * mshadow::mshadow_sizeof(vdtype[i]);
+    size_t bytes = vshape[i].Size() * TypeSize(vdtype[i]);
     int storage_id = vstorage[i];
     if (storage_id < 0) continue;
     size_t sid = static_cast<size_t>(storage_id);
@@ -934,7 +1134,7 @@ void GraphExecutor::InitDataEntryMemory(std::vector<NDArray>* shared_pool) {
   std::multimap<size_t, NDArray> free_pool;
   if (shared_pool != nullptr) {
     for (const NDArray& nd : *shared_pool) {
-      size_t bytes = nd.shape().Size() * mshadow::mshadow_sizeof(nd.dtype());
+      size_t bytes = nd.shape().Size() * TypeSize(nd.dtype());
       free_pool.insert(std::make_pair(bytes, nd));
     }
   }
@@ -1052,8 +1252,6 @@ void GraphExecutor::InitCachedOps() {
     if (inode.source->is_variable()) continue;
     if (op_nodes_[nid].skip_exec_node) continue;
     auto& exec = op_nodes_[nid].exec;
-    bool is_async = op_nodes_[nid].exec->exec_type() == ExecType::kAsync;
-    bool is_gpu = op_nodes_[nid].ctx.dev_mask() == gpu::kDevMask;
 
     // the variables
     std::vector<Engine::VarHandle> use_vars, mutate_vars;
@@ -1081,31 +1279,81 @@ void GraphExecutor::InitCachedOps() {
         exec->Setup();
       }, Context::CPU(), {}, all_vars, FnProperty::kNormal, 0,
       PROFILER_MESSAGE("SetupExec"));
-    auto exec_fun = [exec, is_async, is_gpu] (
-        RunContext ctx, Engine::CallbackOnComplete on_complete) {
-      if (is_async) {
-        exec->op_ctx.async_on_complete = on_complete;
-      }
-      exec->Run(ctx);
-      // call on complete only if it is async op
-      if (!is_async) {
-        if (is_gpu) {
-        #if MXNET_USE_CUDA
-          // Wait GPU kernel to finish.
-          ctx.get_stream<gpu>()->Wait();
-        #else
-          LOG(FATAL) << MXNET_GPU_NOT_ENABLED_ERROR;
-        #endif
-        }
-        on_complete();
-      }
-    };
-    // setup the vars
-    op_nodes_[nid].cached_opr = Engine::Get()->NewOperator(
-        exec_fun, use_vars, mutate_vars, FnProperty::kNormal,
-        PROFILER_MESSAGE(op_nodes_[nid].opr_name));
     op_nodes_[nid].mutate_vars = mutate_vars;
     op_nodes_[nid].use_vars = use_vars;
+    this->CreateCachedOpr(nid);
+  }
+}
+
+void GraphExecutor::CreateCachedOpr(uint32_t nid) {
+  OpNode& opnode = op_nodes_[nid];
+  auto& exec = opnode.exec;
+  bool is_async = exec->exec_type() == ExecType::kAsync;
+  bool is_gpu = opnode.ctx.dev_mask() == gpu::kDevMask;
+  std::shared_ptr<MonitorStats> stats = monitor_stats_;
+  int monitor_row = opnode.monitor_row;
+  auto exec_fun = [exec, is_async, is_gpu, stats, monitor_row] (
+      RunContext ctx, Engine::CallbackOnComplete on_complete) {
+    if (is_async) {
+      exec->op_ctx.async_on_complete = on_complete;
+    }
+    exec->Run(ctx);
+    // call on complete only if it is async op
+    if (!is_async) {
+      if (is_gpu) {
+      #if MXNET_USE_CUDA
+        // Wait GPU kernel to finish.
+        ctx.get_stream<gpu>()->Wait();
+      #else
+        LOG(FATAL) << MXNET_GPU_NOT_ENABLED_ERROR;
+      #endif
+      }
+      if (stats != nullptr) stats->Compute(monitor_row, exec->out_array);
+      on_complete();
+    }
+  };
+  // setup the vars
+  opnode.cached_opr = Engine::Get()->NewOperator(
+      exec_fun, opnode.use_vars, opnode.mutate_vars, FnProperty::kNormal,
+      PROFILER_MESSAGE(opnode.opr_name));
+}
+
+/*!
+ * \brief Assign engine priorities to backward nodes.
+ *  Each backward node gets the rank of the first gradient output that
+ *  depends on it, so the nodes on the path to the gradients of the first
+ *  layers run first and the communication of those gradients can overlap
+ *  with the rest of the backward pass. The ranks follow the order of the
+ *  gradient arrays, which is the order kvstore push/pull priorities use.
+ *  Only CPU workers with MXNET_CPU_WORKER_PRIORITY_QUEUE=1 execute ready
+ *  operators by priority, other workers ignore it.
+ */
+void GraphExecutor::InitOpPriority() {
+  if (!dmlc::GetEnv("MXNET_EXEC_BACKWARD_PRIORITY", true)) return;
+  const auto& idx = graph_.indexed_graph();
+  const size_t num_grads = idx.outputs().size() - num_forward_outputs_;
+  if (num_grads == 0) return;
+  const uint32_t kNoRank = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> rank(idx.num_nodes(), kNoRank);
+  for (size_t j = num_forward_outputs_; j < idx.outputs().size(); ++j) {
+    uint32_t& r = rank[idx.outputs()[j].node_id];
+    r = std::min(r, static_cast<uint32_t>(j - num_forward_outputs_));
+  }
+  // propagate the rank to the producers inside the backward graph
+  for (size_t nid = idx.num_nodes(); nid-- > num_forward_nodes_;) {
+    if (rank[nid] == kNoRank) continue;
+    for (const auto& e : idx[nid].inputs) {
+      if (e.node_id < num_forward_nodes_) continue;
+      rank[e.node_id] = std::min(rank[e.node_id], rank[nid]);
+    }
+    for (uint32_t cid : idx[nid].control_deps) {
+      if (cid < num_forward_nodes_) continue;
+      rank[cid] = std::min(rank[cid], rank[nid]);
+    }
+  }
+  for (size_t nid = num_forward_nodes_; nid < idx.num_nodes(); ++nid) {
+    op_nodes_[nid].priority = rank[nid] == kNoRank ?
+        -static_cast<int>(num_grads) : -static_cast<int>(rank[nid]);
   }
 }
 
@@ -1126,9 +1374,18 @@ void GraphExecutor::InitOpSegs() {
     // bulk the whole graph for inference
     num_nodes_threshold = std::numeric_limits<size_t>::max();
   }
+  // Whether to replay forward and backward pass with a static schedule
+  bool static_schedule = dmlc::GetEnv("MXNET_EXEC_STATIC_SCHEDULE", false);
+  if (static_schedule) {
+    cached_seg_opr_[0] = this->CreateStaticSchedOpr(0, num_forward_nodes_);
+    if (num_forward_nodes_ < total_num_nodes) {
+      cached_seg_opr_[num_forward_nodes_] =
+          this->CreateStaticSchedOpr(num_forward_nodes_, total_num_nodes);
+    }
+  }
 
   // create forward segments for training
-  if (prefer_bulk_exec > 0) {
+  if (prefer_bulk_exec > 0 && cached_seg_opr_[0].opr == nullptr) {
     size_t topo_start = 0;
     for (size_t nid = 0; nid < num_forward_nodes_; nid++) {
       auto &node = graph_.indexed_graph()[nid].source;
@@ -1149,7 +1406,8 @@ void GraphExecutor::InitOpSegs() {
   }
 
   // create backward segments for training
-  if (prefer_bulk_exec) {
+  if (prefer_bulk_exec && num_forward_nodes_ < total_num_nodes &&
+      cached_seg_opr_[num_forward_nodes_].opr == nullptr) {
     // get all gradient variables
     std::unordered_set<engine::VarHandle> grad_vars;
     for (auto &kv : grad_store_) {
@@ -1205,7 +1463,9 @@ void GraphExecutor::ExecuteMonCallback(size_t nid) {
   }
   for (index_t i = 0; i < opnode.exec->out_array.size(); ++i) {
     NDArray *cpy = new NDArray(opnode.exec->out_array[i]);
-    std::string name = inode.source->attrs.name + "_" + output_names[i];
+    // FListOutputNames may name fewer outputs than the node has
+    std::string name = inode.source->attrs.name + "_" + (i < output_names.size() ?
+                       output_names[i] : "output" + std::to_string(i));
     this->monitor_callback_(name.c_str(), reinterpret_cast<void*>(cpy));
   }
 }
@@ -1231,7 +1491,7 @@ void GraphExecutor::RunOps(bool is_train, size_t topo_start, size_t topo_end) {
 #else
       bool profiling = false;
 #endif
-      Engine::Get()->Push(seg_op.opr, seg_op.ctx, 0, profiling);
+      Engine::Get()->Push(seg_op.opr, seg_op.ctx, seg_op.priority, profiling);
       nid = seg_op.topo_end - 1;
       continue;
     }
@@ -1245,7 +1505,7 @@ void GraphExecutor::RunOps(bool is_train, size_t topo_start, size_t topo_end) {
       CHECK_EQ(inode.inputs.size(), 1U);
       CHECK_EQ(opnode.exec->in_array.size(), 1U);
       CHECK_EQ(opnode.exec->out_array.size(), 1U);
-      CopyFromTo(opnode.exec->in_array[0], &(opnode.exec->out_array[0]));
+      CopyFromTo(opnode.exec->in_array[0], &(opnode.exec->out_array[0]), opnode.priority);
     } else if (opnode.exec->exec_type() == ExecType::kLocal) {
       opnode.exec->Run(RunContext{opnode.ctx, nullptr});
     } else if (opnode.cached_opr != nullptr) {
@@ -1254,7 +1514,7 @@ void GraphExecutor::RunOps(bool is_train, size_t topo_start, size_t topo_end) {
 #else
       bool profiling = false;
 #endif
-      Engine::Get()->Push(opnode.cached_opr, opnode.ctx, 0, profiling);
+      Engine::Get()->Push(opnode.cached_opr, opnode.ctx, opnode.priority, profiling);
     } else {
       LOG(FATAL) << "Not accessed";
     }
@@ -1273,6 +1533,7 @@ GraphExecutor::CachedSegOpr GraphExecutor::CreateCachedSegOpr(size_t topo_start,
   ret.topo_start = topo_start;
   ret.topo_end = topo_end;
   auto& exec_list = ret.exec_list;
+  std::vector<int> monitor_rows;
   // invalid segment
   if (topo_end <= topo_start) {
     return ret;
@@ -1293,16 +1554,21 @@ GraphExecutor::CachedSegOpr GraphExecutor::CreateCachedSegOpr(size_t topo_start,
     if (op_node.exec->exec_type() != ExecType::kSync) {
       return ret;
     }
-    if (pctx == nullptr) pctx = &(op_node.ctx);
+    if (pctx == nullptr) {
+      pctx = &(op_node.ctx);
+      ret.priority = op_node.priority;
+    }
     if (*pctx != op_node.ctx) {
       return ret;
     }
+    ret.priority = std::max(ret.priority, op_node.priority);
     auto& exec = op_nodes_[nid].exec;
     std::copy(op_node.mutate_vars.begin(), op_node.mutate_vars.end(),
               std::inserter(mutate_vars, mutate_vars.end()));
     std::copy(op_node.use_vars.begin(), op_node.use_vars.end(),
               std::inserter(use_vars, use_vars.end()));
     ret.exec_list.push_back(exec);
+    monitor_rows.push_back(op_node.monitor_row);
 #if MXNET_USE_PROFILER
     opr_names += inode.source->op()->name + ",";
 #endif
@@ -1313,11 +1579,13 @@ GraphExecutor::CachedSegOpr GraphExecutor::CreateCachedSegOpr(size_t topo_start,
   Engine::Get()->DeduplicateVarHandle(&use_vars, &mutate_vars);
 
   bool is_gpu = pctx->dev_mask() == gpu::kDevMask;
-  auto exec_fun = [exec_list, is_gpu] (
+  std::shared_ptr<MonitorStats> stats = monitor_stats_;
+  auto exec_fun = [exec_list, is_gpu, stats, monitor_rows] (
       RunContext ctx, Engine::CallbackOnComplete on_complete) {
     // Run all opr in the sub-graph
-    for (auto &exec : exec_list) {
-      exec->Run(ctx);
+    for (size_t i = 0; i < exec_list.size(); ++i) {
+      exec_list[i]->Run(ctx);
+      if (stats != nullptr) stats->Compute(monitor_rows[i], exec_list[i]->out_array);
     }
     if (is_gpu) {
 #if MXNET_USE_CUDA
@@ -1342,6 +1610,64 @@ GraphExecutor::CachedSegOpr GraphExecutor::CreateCachedSegOpr(size_t topo_start,
       PROFILER_MESSAGE(p_opr_name));
   return ret;
 }
+
+GraphExecutor::CachedSegOpr GraphExecutor::CreateStaticSchedOpr(size_t topo_start,
+                                                                size_t topo_end) {
+  std::vector<Engine::VarHandle> use_vars;
+  std::vector<Engine::VarHandle> mutate_vars;
+  Context *pctx = nullptr;
+  GraphExecutor::CachedSegOpr ret;
+  ret.topo_start = topo_start;
+  ret.topo_end = topo_end;
+  if (topo_end <= topo_start) return ret;
+
+  std::vector<StaticSchedule::Task> tasks;
+  const auto& idx = graph_.indexed_graph();
+  for (size_t nid = topo_start; nid < topo_end; ++nid) {
+    const auto& inode = idx[nid];
+    OpNode& op_node = op_nodes_[nid];
+    if (op_node.skip_exec_node) continue;
+    if (inode.source->is_variable()) continue;
+    // only synchronous CPU operators can be replayed off the engine
+    if (op_node.exec->exec_type() != ExecType::kSync) return ret;
+    if (op_node.ctx.dev_mask() != cpu::kDevMask) return ret;
+    if (pctx == nullptr) {
+      pctx = &(op_node.ctx);
+      ret.priority = op_node.priority;
+    }
+    if (*pctx != op_node.ctx) return ret;
+    ret.priority = std::max(ret.priority, op_node.priority);
+    auto exec = op_node.exec;
+    std::shared_ptr<MonitorStats> stats = monitor_stats_;
+    int monitor_row = op_node.monitor_row;
+    StaticSchedule::Task task;
+    task.fn = [exec, stats, monitor_row](RunContext rctx) {
+      exec->Run(rctx);
+      if (stats != nullptr) stats->Compute(monitor_row, exec->out_array);
+    };
+    task.use_vars = op_node.use_vars;
+    task.mutate_vars = op_node.mutate_vars;
+    tasks.emplace_back(std::move(task));
+    std::copy(op_node.mutate_vars.begin(), op_node.mutate_vars.end(),
+              std::inserter(mutate_vars, mutate_vars.end()));
+    std::copy(op_node.use_vars.begin(), op_node.use_vars.end(),
+              std::inserter(use_vars, use_vars.end()));
+    ret.exec_list.push_back(exec);
+  }
+  if (pctx == nullptr) return ret;
+  ret.ctx = *pctx;
+  Engine::Get()->DeduplicateVarHandle(&use_vars, &mutate_vars);
+
+  std::shared_ptr<StaticSchedule> sched = std::make_shared<StaticSchedule>(std::move(tasks));
+  auto exec_fun = [sched] (RunContext ctx, Engine::CallbackOnComplete on_complete) {
+    sched->Run(ctx);
+    on_complete();
+  };
+  ret.opr = Engine::Get()->NewOperator(
+      exec_fun, use_vars, mutate_vars, FnProperty::kNormal,
+      PROFILER_MESSAGE("StaticSchedule"));
+  return ret;
+}
 }  // namespace exec
 
 Executor *Executor::SimpleBind(nnvm::Symbol symbol,
@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 #include "./exec_pass.h"
+#include "./monitor_stats.h"
 
 namespace mxnet {
 
@@ -51,6 +52,9 @@ class GraphExecutor : public Executor {
   const std::unordered_map<std::string, NDArray>& aux_state_map() const override;
   void Print(std::ostream &os) const override; // NOLINT(*)
   void SetMonitorCallback(const MonitorCallback& callback) override;
+  void SetMonitorStats(int stat_mask, int interval) override;
+  void EnableMonitorStats(bool enabled) override;
+  void GetMonitorStats(std::vector<std::string>* names, NDArray* stats) const override;
   // Initialize the rest of attributes
   // after setting up arguments.
   void FinishInitGraph(nnvm::Symbol symbol, nnvm::Graph g,
@@ -105,6 +109,10 @@ class GraphExecutor : public Executor {
     std::vector<Engine::VarHandle> use_vars;
     // cached mutate vars, used for seg ops creation
     std::vector<Engine::VarHandle> mutate_vars;
+    // priority of the operator when pushed to engine
+    int priority{0};
+    // first row of the outputs in the monitor statistics
+    int monitor_row{-1};
   };
   // a cached segment operator that executes a segment
   struct CachedSegOpr {
@@ -116,6 +124,8 @@ class GraphExecutor : public Executor {
     size_t topo_end;
     // the cached operator
     Engine::OprHandle opr = nullptr;
+    // priority of the operator when pushed to engine
+    int priority{0};
     // list of op executors
     std::vector<std::shared_ptr<OpExecutor> > exec_list;
   };
@@ -152,12 +162,18 @@ class GraphExecutor : public Executor {
                   const std::vector<Context>& in_arg_ctxes,
                   const std::vector<Context>& arg_grad_ctxes,
                   const std::vector<Context>& aux_state_ctxes,
-                  const std::vector<OpReqType>& grad_req_types);
+                  const std::vector<OpReqType>& grad_req_types,
+                  const std::unordered_map<std::string, int>& arg_dtypes);
   // intialize the full graph for simple bind, including gradient
   Graph InitFullGraph(nnvm::Symbol symbol,
-                      const std::vector<OpReqType>& grad_req_types);
+                      const std::vector<OpReqType>& grad_req_types,
+                      const std::unordered_map<std::string, int>& arg_dtypes);
   // initialize the cached operator
   void InitCachedOps();
+  // create the cached engine operator of node nid from its cached vars
+  void CreateCachedOpr(uint32_t nid);
+  // initialize the engine priorities of backward nodes
+  void InitOpPriority();
   // initialize the opr segments for bulk exec
   void InitOpSegs();
   // initialize the resources in the graph
@@ -174,6 +190,15 @@ class GraphExecutor : public Executor {
    *  ret.opr Can be nullptr if creation failed.
   */
   CachedSegOpr CreateCachedSegOpr(size_t topo_start, size_t topo_end);
+  /*!
+   * \brief Try to create a cached operator that replays the nodes between
+   *  start and end with a precomputed static schedule.
+   * \param topo_start beginning of segment
+   * \param topo_end end of segment
+   * \return the cached operator.
+   *  ret.opr Can be nullptr if the nodes cannot be statically scheduled.
+   */
+  CachedSegOpr CreateStaticSchedOpr(size_t topo_start, size_t topo_end);
   // run the monitor callback for node `nid`
   void ExecuteMonCallback(size_t nid);
 
@@ -207,10 +232,18 @@ class GraphExecutor : public Executor {
   size_t num_forward_inputs_{0};
   // number of forward nodes
   size_t num_forward_nodes_{0};
+  // whether gradient checkpointing is enabled
+  bool do_checkpoint_{false};
+  // number of checkpoint nodes whose outputs are kept for backward
+  size_t num_checkpoints_{0};
+  // number of forward nodes recomputed in backward
+  size_t num_recompute_nodes_{0};
   // saved operator for autograd
   std::unordered_map<const nnvm::Node*, OpStatePtr> saved_states_;
   // monitor call back
   std::function<void(const char*, void*)> monitor_callback_{nullptr};
+  // statistics computed inside the node operators
+  std::shared_ptr<MonitorStats> monitor_stats_{nullptr};
   // whether to enable bulk execution
   bool prefer_bulk_execution_;
   // cached segment operator
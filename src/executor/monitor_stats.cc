@@ -0,0 +1,98 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file monitor_stats.cc
+ * \brief Implementation of the fused monitor statistics.
+ */
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <utility>
+#include "./monitor_stats.h"
+
+namespace mxnet {
+namespace exec {
+
+MonitorStats::MonitorStats(int stat_mask, int interval, std::vector<std::string> names)
+    : stat_mask_(stat_mask), num_stats_(0), interval_(std::max(interval, 1)),
+      names_(std::move(names)) {
+  for (int flag = kMonitorNorm; flag <= kMonitorInf; flag <<= 1) {
+    if (stat_mask_ & flag) ++num_stats_;
+  }
+  CHECK_GT(num_stats_, 0) << "MonitorStats: no statistics selected";
+  var_ = Engine::Get()->NewVariable();
+  buffer_.resize(names_.size() * num_stats_, std::numeric_limits<float>::quiet_NaN());
+  stats_ = NDArray(TShape(mshadow::Shape2(std::max(names_.size(), size_t(1)), num_stats_)),
+                   Context::CPU(), false, mshadow::kFloat32);
+}
+
+MonitorStats::~MonitorStats() {
+  Engine::Get()->DeleteVariable([](RunContext ctx) {}, Context::CPU(), var_);
+}
+
+void MonitorStats::Begin() {
+  active_ = enabled_ && (step_++ % interval_) == 0;
+  bool active = active_;
+  std::shared_ptr<MonitorStats> self = shared_from_this();
+  Engine::Get()->PushSync([self, active](RunContext ctx) {
+      self->running_ = active;
+      if (active) {
+        std::fill(self->buffer_.begin(), self->buffer_.end(),
+                  std::numeric_limits<float>::quiet_NaN());
+      }
+    }, Context::CPU(), {}, {var_}, FnProperty::kNormal, 0,
+    PROFILER_MESSAGE("MonitorStatsBegin"));
+}
+
+void MonitorStats::Publish() {
+  if (!active_ || names_.size() == 0) return;
+  std::shared_ptr<MonitorStats> self = shared_from_this();
+  NDArray stats = stats_;
+  Engine::Get()->PushSync([self, stats](RunContext ctx) {
+      float* dst = stats.data().dptr<float>();
+      std::memcpy(dst, self->buffer_.data(), self->buffer_.size() * sizeof(float));
+    }, Context::CPU(), {}, {var_, stats_.var()}, FnProperty::kNormal, 0,
+    PROFILER_MESSAGE("MonitorStatsPublish"));
+}
+
+void MonitorStats::Compute(int row, const std::vector<NDArray>& arrays) {
+  if (!running_) return;
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    float* out = buffer_.data() + (row + i) * num_stats_;
+    const NDArray& arr = arrays[i];
+    // only arrays in CPU memory can be summarized in place
+    if (arr.is_none() || arr.ctx().dev_mask() != cpu::kDevMask) continue;
+    const TBlob blob = arr.data();
+    const size_t size = blob.Size();
+    double sqsum = 0, sum = 0;
+    double vmin = std::numeric_limits<double>::infinity();
+    double vmax = -std::numeric_limits<double>::infinity();
+    size_t num_nan = 0, num_inf = 0;
+    MSHADOW_TYPE_SWITCH(blob.type_flag_, DType, {
+      const DType* dptr = blob.dptr<DType>();
+      for (size_t j = 0; j < size; ++j) {
+        const double v = static_cast<double>(dptr[j]);
+        if (std::isnan(v)) {
+          ++num_nan; continue;
+        }
+        if (std::isinf(v)) ++num_inf;
+        sqsum += v * v;
+        sum += v;
+        if (v < vmin) vmin = v;
+        if (v > vmax) vmax = v;
+      }
+    });
+    int k = 0;
+    if (stat_mask_ & kMonitorNorm) out[k++] = static_cast<float>(std::sqrt(sqsum));
+    if (stat_mask_ & kMonitorMean) out[k++] = static_cast<float>(size == 0 ? 0 : sum / size);
+    if (stat_mask_ & kMonitorMin) out[k++] = static_cast<float>(vmin);
+    if (stat_mask_ & kMonitorMax) out[k++] = static_cast<float>(vmax);
+    if (stat_mask_ & kMonitorNaN) out[k++] = static_cast<float>(num_nan);
+    if (stat_mask_ & kMonitorInf) out[k++] = static_cast<float>(num_inf);
+  }
+}
+
+}  // namespace exec
+}  // namespace mxnet
@@ -0,0 +1,101 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file monitor_stats.h
+ * \brief Statistics of node outputs computed inside the engine operators
+ *  of the executor, so monitoring does not disable bulk execution.
+ */
+#ifndef MXNET_EXECUTOR_MONITOR_STATS_H_
+#define MXNET_EXECUTOR_MONITOR_STATS_H_
+
+#include <mxnet/base.h>
+#include <mxnet/engine.h>
+#include <mxnet/executor.h>
+#include <mxnet/ndarray.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mxnet {
+namespace exec {
+
+/*!
+ * \brief State shared between the executor and its cached operators.
+ *
+ *  Synchronization: Begin() pushes an operator that mutates var, every node
+ *  operator reads var, and Publish() pushes an operator that mutates var and
+ *  the stats array. Node operators of the same iteration therefore see the
+ *  same value of running, and write disjoint rows of buffer concurrently.
+ */
+class MonitorStats : public std::enable_shared_from_this<MonitorStats> {
+ public:
+  /*!
+   * \param stat_mask bit mask of MonitorStatFlag
+   * \param interval compute the statistics every interval-th forward
+   * \param names name of each monitored entry
+   */
+  MonitorStats(int stat_mask, int interval, std::vector<std::string> names);
+  ~MonitorStats();
+  /*! \return number of statistics per entry */
+  inline int num_stats() const {
+    return num_stats_;
+  }
+  /*! \return the engine variable guarding the state */
+  inline Engine::VarHandle var() const {
+    return var_;
+  }
+  /*! \return name of each row of stats */
+  inline const std::vector<std::string>& names() const {
+    return names_;
+  }
+  /*! \return the published statistics, of shape (num_entries, num_stats) */
+  inline const NDArray& stats() const {
+    return stats_;
+  }
+  /*! \brief switch sampling on or off from the next forward pass */
+  inline void set_enabled(bool enabled) {
+    enabled_ = enabled;
+  }
+  /*! \return whether the current iteration is sampled */
+  inline bool active() const {
+    return active_;
+  }
+  /*! \brief called at the start of each forward pass */
+  void Begin();
+  /*! \brief push the copy of the computed statistics to the stats array */
+  void Publish();
+  /*!
+   * \brief compute the statistics of arrays into consecutive rows,
+   *  called from inside engine operators.
+   * \param row first row to write
+   * \param arrays the arrays to summarize
+   */
+  void Compute(int row, const std::vector<NDArray>& arrays);
+
+ private:
+  /*! \brief the selected statistics */
+  int stat_mask_;
+  /*! \brief number of selected statistics */
+  int num_stats_;
+  /*! \brief sampling interval */
+  int interval_;
+  /*! \brief number of forward calls so far */
+  size_t step_{0};
+  /*! \brief whether sampling is switched on */
+  bool enabled_{true};
+  /*! \brief whether the iteration being pushed is sampled */
+  bool active_{false};
+  /*! \brief whether the iteration being executed is sampled, guarded by var_ */
+  bool running_{false};
+  /*! \brief engine variable */
+  Engine::VarHandle var_;
+  /*! \brief row names */
+  std::vector<std::string> names_;
+  /*! \brief buffer written by the operators */
+  std::vector<float> buffer_;
+  /*! \brief published statistics */
+  NDArray stats_;
+};
+
+}  // namespace exec
+}  // namespace mxnet
+#endif  // MXNET_EXECUTOR_MONITOR_STATS_H_
@@ -0,0 +1,195 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file static_schedule.cc
+ * \brief Implementation of static schedule replay.
+ */
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include "./static_schedule.h"
+
+namespace mxnet {
+namespace exec {
+
+StaticSchedule::StaticSchedule(std::vector<Task> tasks, int num_workers)
+    : tasks_(std::move(tasks)) {
+  const uint32_t ntask = static_cast<uint32_t>(tasks_.size());
+  // Resolve dependencies the same way the engine does at runtime:
+  // a read waits for the last write, a write waits for the last write
+  // and for all the reads issued since then.
+  struct VarState {
+    int last_writer{-1};
+    std::vector<uint32_t> readers;
+  };
+  std::unordered_map<engine::VarHandle, VarState> vstate;
+  std::vector<std::vector<uint32_t> > deps(ntask);
+  for (uint32_t i = 0; i < ntask; ++i) {
+    auto& dep = deps[i];
+    for (auto v : tasks_[i].use_vars) {
+      VarState& s = vstate[v];
+      if (s.last_writer >= 0) dep.push_back(static_cast<uint32_t>(s.last_writer));
+      s.readers.push_back(i);
+    }
+    for (auto v : tasks_[i].mutate_vars) {
+      VarState& s = vstate[v];
+      if (s.last_writer >= 0) dep.push_back(static_cast<uint32_t>(s.last_writer));
+      for (uint32_t r : s.readers) {
+        if (r != i) dep.push_back(r);
+      }
+      s.readers.clear();
+      s.last_writer = static_cast<int>(i);
+    }
+    std::sort(dep.begin(), dep.end());
+    dep.resize(std::unique(dep.begin(), dep.end()) - dep.begin());
+  }
+  // topological levels, tasks are already in a valid order.
+  std::vector<uint32_t> level(ntask, 0);
+  num_levels_ = ntask == 0 ? 0 : 1;
+  for (uint32_t i = 0; i < ntask; ++i) {
+    for (uint32_t d : deps[i]) {
+      level[i] = std::max(level[i], level[d] + 1);
+    }
+    num_levels_ = std::max(num_levels_, static_cast<size_t>(level[i]) + 1);
+  }
+  // successor lists and initial counters
+  num_deps_.resize(ntask);
+  succ_ptr_.assign(ntask + 1, 0);
+  for (uint32_t i = 0; i < ntask; ++i) {
+    num_deps_[i] = static_cast<int>(deps[i].size());
+    for (uint32_t d : deps[i]) ++succ_ptr_[d + 1];
+  }
+  for (uint32_t i = 0; i < ntask; ++i) {
+    succ_ptr_[i + 1] += succ_ptr_[i];
+  }
+  succ_.resize(succ_ptr_[ntask]);
+  std::vector<uint32_t> top(succ_ptr_.begin(), succ_ptr_.end() - 1);
+  for (uint32_t i = 0; i < ntask; ++i) {
+    for (uint32_t d : deps[i]) succ_[top[d]++] = i;
+  }
+  pending_.reset(new std::atomic<int>[ntask]);
+  // Distribute the tasks level by level. A task prefers the worker of its
+  // last dependency to keep producer and consumer on the same core,
+  // unless that worker is already more loaded than the others in this level.
+  if (num_workers <= 0) {
+    num_workers = StaticScheduleTeam::Get()->size();
+  }
+  num_workers = std::max(1, std::min(num_workers, StaticScheduleTeam::Get()->size()));
+  num_workers = std::max(1, std::min(num_workers, static_cast<int>(ntask)));
+  worker_tasks_.resize(num_workers);
+  std::vector<uint32_t> order(ntask);
+  for (uint32_t i = 0; i < ntask; ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&level](uint32_t a, uint32_t b) {
+      return level[a] < level[b];
+    });
+  std::vector<int> assigned(ntask, 0);
+  std::vector<size_t> load(num_workers, 0);
+  size_t begin = 0;
+  while (begin < order.size()) {
+    size_t end = begin;
+    while (end < order.size() && level[order[end]] == level[order[begin]]) ++end;
+    std::fill(load.begin(), load.end(), 0);
+    for (size_t k = begin; k < end; ++k) {
+      uint32_t tid = order[k];
+      int best = static_cast<int>(std::min_element(load.begin(), load.end()) - load.begin());
+      if (deps[tid].size() != 0) {
+        int pref = assigned[deps[tid].back()];
+        if (load[pref] == load[best]) best = pref;
+      }
+      assigned[tid] = best;
+      load[best] += 1;
+      worker_tasks_[best].push_back(tid);
+    }
+    begin = end;
+  }
+}
+
+void StaticSchedule::RunWorker(size_t wid, RunContext rctx) {
+  for (uint32_t tid : worker_tasks_[wid]) {
+    std::atomic<int>& counter = pending_[tid];
+    int spin = 0;
+    while (counter.load(std::memory_order_acquire) != 0) {
+      if (++spin > 1024) std::this_thread::yield();
+    }
+    tasks_[tid].fn(rctx);
+    for (uint32_t k = succ_ptr_[tid]; k < succ_ptr_[tid + 1]; ++k) {
+      pending_[succ_[k]].fetch_sub(1, std::memory_order_acq_rel);
+    }
+  }
+}
+
+void StaticSchedule::Run(RunContext rctx) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  for (size_t i = 0; i < num_deps_.size(); ++i) {
+    pending_[i].store(num_deps_[i], std::memory_order_relaxed);
+  }
+  if (worker_tasks_.size() <= 1) {
+    if (worker_tasks_.size() == 1) this->RunWorker(0, rctx);
+    return;
+  }
+  std::function<void(int)> job = [this, rctx](int wid) {
+    this->RunWorker(static_cast<size_t>(wid), rctx);
+  };
+  StaticScheduleTeam::Get()->Run(static_cast<int>(worker_tasks_.size()), job);
+}
+
+StaticScheduleTeam* StaticScheduleTeam::Get() {
+  static StaticScheduleTeam inst(dmlc::GetEnv("MXNET_EXEC_STATIC_SCHEDULE_NTHREADS", 2));
+  return &inst;
+}
+
+StaticScheduleTeam::StaticScheduleTeam(int nthreads) {
+  for (int i = 1; i < nthreads; ++i) {
+    threads_.emplace_back([this, i]() { this->Worker(i); });
+  }
+}
+
+StaticScheduleTeam::~StaticScheduleTeam() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    kill_ = true;
+  }
+  start_cond_.notify_all();
+  for (auto& t : threads_) t.join();
+}
+
+void StaticScheduleTeam::Run(int n, const std::function<void(int)>& fn) {
+  CHECK_LE(n, this->size());
+  std::lock_guard<std::mutex> job_lock(job_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    job_ = &fn;
+    num_active_ = n;
+    num_running_ = n - 1;
+    ++generation_;
+  }
+  start_cond_.notify_all();
+  fn(0);
+  std::unique_lock<std::mutex> lock(mutex_);
+  finish_cond_.wait(lock, [this]() { return num_running_ == 0; });
+  job_ = nullptr;
+}
+
+void StaticScheduleTeam::Worker(int tid) {
+  uint64_t seen = 0;
+  while (true) {
+    const std::function<void(int)>* job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_cond_.wait(lock, [this, seen]() { return kill_ || generation_ != seen; });
+      if (kill_) return;
+      seen = generation_;
+      if (tid >= num_active_) continue;
+      job = job_;
+    }
+    (*job)(tid);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--num_running_ == 0) finish_cond_.notify_one();
+    }
+  }
+}
+
+}  // namespace exec
+}  // namespace mxnet
@@ -0,0 +1,134 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file static_schedule.h
+ * \brief Precomputed execution plan that replays a fixed list of
+ *  operations on a dedicated thread team without going through
+ *  the dependency engine.
+ */
+#ifndef MXNET_EXECUTOR_STATIC_SCHEDULE_H_
+#define MXNET_EXECUTOR_STATIC_SCHEDULE_H_
+
+#include <mxnet/base.h>
+#include <mxnet/engine.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mxnet {
+namespace exec {
+
+/*!
+ * \brief A static schedule of a fixed sequence of tasks.
+ *
+ *  The dependencies between the tasks are resolved once at construction,
+ *  following exactly the same read/write semantics as the engine applies to
+ *  the var handles. Tasks are then leveled topologically and distributed
+ *  over a fixed number of workers. Each replay only resets an array of
+ *  atomic dependency counters, so no var queue is touched at runtime.
+ *
+ *  The schedule itself is meant to be wrapped into a single engine
+ *  operator, which makes it interoperate with the rest of the engine
+ *  through the union of the vars of all tasks.
+ */
+class StaticSchedule {
+ public:
+  /*! \brief a single task in the schedule */
+  struct Task {
+    /*! \brief the function to run */
+    std::function<void(RunContext)> fn;
+    /*! \brief vars read by the task */
+    std::vector<engine::VarHandle> use_vars;
+    /*! \brief vars written by the task */
+    std::vector<engine::VarHandle> mutate_vars;
+  };
+  /*!
+   * \brief build the schedule
+   * \param tasks tasks in a valid sequential execution order
+   * \param num_workers number of workers to distribute the tasks to,
+   *  0 means use MXNET_EXEC_STATIC_SCHEDULE_NTHREADS.
+   */
+  explicit StaticSchedule(std::vector<Task> tasks, int num_workers = 0);
+  /*!
+   * \brief replay the schedule, blocks until all tasks have finished.
+   * \param rctx the run context passed to every task.
+   */
+  void Run(RunContext rctx);
+  /*! \return number of tasks */
+  inline size_t num_tasks() const {
+    return tasks_.size();
+  }
+  /*! \return number of topological levels of the plan */
+  inline size_t num_levels() const {
+    return num_levels_;
+  }
+  /*! \return number of workers used by the plan */
+  inline size_t num_workers() const {
+    return worker_tasks_.size();
+  }
+  /*! \return task ids executed by worker i, in execution order */
+  inline const std::vector<uint32_t>& worker_tasks(size_t i) const {
+    return worker_tasks_[i];
+  }
+
+ private:
+  /*! \brief run the task list of one worker */
+  void RunWorker(size_t wid, RunContext rctx);
+  /*! \brief all the tasks */
+  std::vector<Task> tasks_;
+  /*! \brief successors of each task, in CSR format */
+  std::vector<uint32_t> succ_ptr_, succ_;
+  /*! \brief initial number of unfinished dependencies of each task */
+  std::vector<int> num_deps_;
+  /*! \brief dependency counters used during replay */
+  std::unique_ptr<std::atomic<int>[]> pending_;
+  /*! \brief per worker task list */
+  std::vector<std::vector<uint32_t> > worker_tasks_;
+  /*! \brief number of levels */
+  size_t num_levels_{0};
+  /*! \brief the schedule can only be replayed once at a time */
+  std::mutex run_mutex_;
+};
+
+/*!
+ * \brief Thread team shared by all static schedules of the process.
+ *  The caller thread always participates as member 0.
+ */
+class StaticScheduleTeam {
+ public:
+  /*! \brief get the singleton */
+  static StaticScheduleTeam* Get();
+  /*! \return number of members, including the caller */
+  inline int size() const {
+    return static_cast<int>(threads_.size()) + 1;
+  }
+  /*!
+   * \brief run fn(i) for i in [0, n) on the team and wait for completion.
+   * \param n number of members to use, must not exceed size().
+   * \param fn the job.
+   */
+  void Run(int n, const std::function<void(int)>& fn);
+  ~StaticScheduleTeam();
+
+ private:
+  explicit StaticScheduleTeam(int nthreads);
+  void Worker(int tid);
+  /*! \brief serialize the jobs from concurrent callers */
+  std::mutex job_mutex_;
+  /*! \brief protect the job state below */
+  std::mutex mutex_;
+  std::condition_variable start_cond_, finish_cond_;
+  const std::function<void(int)>* job_{nullptr};
+  int num_active_{0};
+  int num_running_{0};
+  uint64_t generation_{0};
+  bool kill_{false};
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace exec
+}  // namespace mxnet
+#endif  // MXNET_EXECUTOR_STATIC_SCHEDULE_H_
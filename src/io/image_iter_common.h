@@ -8,9 +8,11 @@
 #define MXNET_IO_IMAGE_ITER_COMMON_H_
 
 #include <mxnet/io.h>
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include "../operator/tensor/blocked_transpose.h"
 
 namespace mxnet {
 namespace io {
@@ -307,6 +309,36 @@ struct PrefetcherParam : public dmlc::Parameter<PrefetcherParam> {
   }
 };
 
+/*!
+ * \brief Copy an interleaved 8-bit image with channels in OpenCV order (BGR or
+ *  BGRA) into planes in RGB or RGBA order, with the blocked transpose.
+ * \param data the first row of the image
+ * \param rows number of rows
+ * \param cols number of columns
+ * \param channels number of channels, 1, 3 or 4
+ * \param step distance between rows, in bytes
+ * \param out output of shape (channels, rows, cols)
+ */
+template<typename DType>
+inline void ImageHWCToCHW(const uint8_t* data, int rows, int cols, int channels,
+                          size_t step, DType* out) {
+  TShape oshape(3);
+  oshape[0] = channels;
+  oshape[1] = rows;
+  oshape[2] = cols;
+  std::vector<int64_t> strides = {1, static_cast<int64_t>(step), channels};
+  if (channels == 3) {
+    // reversed channel order
+    strides[0] = -1;
+    data += 2;
+  }
+  op::StridedCopyCPU(data, out, oshape, strides);
+  if (channels == 4) {
+    const size_t plane = static_cast<size_t>(rows) * cols;
+    std::swap_ranges(out, out + plane, out + 2 * plane);
+  }
+}
+
 }  // namespace io
 }  // namespace mxnet
 
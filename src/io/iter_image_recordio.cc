@@ -189,20 +189,8 @@ ParseNext(std::vector<InstVector<DType>> *out_vec) {
 
       // For RGB or RGBA data, swap the B and R channel:
       // OpenCV store as BGR (or BGRA) and we want RGB (or RGBA)
-      std::vector<int> swap_indices;
-      if (n_channels == 1) swap_indices = {0};
-      if (n_channels == 3) swap_indices = {2, 1, 0};
-      if (n_channels == 4) swap_indices = {2, 1, 0, 3};
-
-      for (int i = 0; i < res.rows; ++i) {
-        uchar* im_data = res.ptr<uchar>(i);
-        for (int j = 0; j < res.cols; ++j) {
-          for (int k = 0; k < n_channels; ++k) {
-              data[k][i][j] = im_data[swap_indices[k]];
-          }
-          im_data += n_channels;
-        }
-      }
+      CHECK(data.CheckContiguous());
+      ImageHWCToCHW(res.ptr<uchar>(0), res.rows, res.cols, n_channels, res.step, data.dptr_);
 
       mshadow::Tensor<cpu, 1> label = out.label().Back();
       if (label_map_ != nullptr) {
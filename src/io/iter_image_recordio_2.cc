@@ -14,6 +14,7 @@
 #include <dmlc/omp.h>
 #include <dmlc/common.h>
 #include <dmlc/timer.h>
+#include <algorithm>
 #include <type_traits>
 #include "./image_recordio.h"
 #include "./image_augmenter.h"
@@ -339,13 +340,6 @@ inline void ImageRecordIOParser2<DType>::ParseChunk(dmlc::InputSplit::Blob * chu
 
       mshadow::Tensor<cpu, 3, DType> data = out.data().Back();
 
-      // For RGB or RGBA data, swap the B and R channel:
-      // OpenCV store as BGR (or BGRA) and we want RGB (or RGBA)
-      std::vector<int> swap_indices;
-      if (n_channels == 1) swap_indices = {0};
-      if (n_channels == 3) swap_indices = {2, 1, 0};
-      if (n_channels == 4) swap_indices = {2, 1, 0, 3};
-
       std::uniform_real_distribution<float> rand_uniform(0, 1);
       std::bernoulli_distribution coin_flip(0.5);
       bool is_mirrored = (normalize_param_.rand_mirror && coin_flip(*(prnds_[tid])))
@@ -360,58 +354,42 @@ inline void ImageRecordIOParser2<DType>::ParseChunk(dmlc::InputSplit::Blob * chu
           (rand_uniform(*(prnds_[tid])) * normalize_param_.max_random_illumination * 2
           - normalize_param_.max_random_illumination) * normalize_param_.scale;
       }
-      for (int i = 0; i < res.rows; ++i) {
-        uchar* im_data = res.ptr<uchar>(i);
-        for (int j = 0; j < res.cols; ++j) {
-          DType RGBA[4];
-          for (int k = 0; k < n_channels; ++k) {
-            RGBA[k] = im_data[swap_indices[k]];
-          }
-          if (!std::is_same<DType, uint8_t>::value) {
-            // normalize/mirror here to avoid memory copies
-            // logic from iter_normalize.h, function SetOutImg
-
-            if (normalize_param_.mean_r > 0.0f || normalize_param_.mean_g > 0.0f ||
-                normalize_param_.mean_b > 0.0f || normalize_param_.mean_a > 0.0f) {
-              // subtract mean per channel
-              RGBA[0] -= normalize_param_.mean_r;
-              if (n_channels >= 3) {
-                RGBA[1] -= normalize_param_.mean_g;
-                RGBA[2] -= normalize_param_.mean_b;
-              }
-              if (n_channels == 4) {
-                RGBA[3] -= normalize_param_.mean_a;
-              }
-              for (int k = 0; k < n_channels; ++k) {
-                RGBA[k] = RGBA[k] * contrast_scaled + illumination_scaled;
+      // the layout changes with the blocked transpose, then each plane is
+      // normalized and mirrored in place
+      CHECK(data.CheckContiguous());
+      ImageHWCToCHW(res.ptr<uchar>(0), res.rows, res.cols, n_channels, res.step,
+                    data.dptr_);
+      if (!std::is_same<DType, uint8_t>::value) {
+        // logic from iter_normalize.h, function SetOutImg
+        const float mean[4] = {normalize_param_.mean_r, normalize_param_.mean_g,
+                               normalize_param_.mean_b, normalize_param_.mean_a};
+        const bool channel_mean = mean[0] > 0.0f || mean[1] > 0.0f ||
+                                  mean[2] > 0.0f || mean[3] > 0.0f;
+        const bool mean_img = !channel_mean && meanfile_ready_ &&
+                              normalize_param_.mean_img.length() != 0;
+        const int cols = res.cols;
+        for (int k = 0; k < n_channels; ++k) {
+          // the gray channel only has the mean of r subtracted
+          const float m = n_channels == 1 && k > 0 ? 0.0f : mean[k];
+          for (int i = 0; i < res.rows; ++i) {
+            DType* row = data[k][i].dptr_;
+            if (channel_mean) {
+              for (int j = 0; j < cols; ++j) {
+                row[j] = (row[j] - m) * contrast_scaled + illumination_scaled;
               }
-            } else if (!meanfile_ready_ || normalize_param_.mean_img.length() == 0) {
-              // do not subtract anything
-              for (int k = 0; k < n_channels; ++k) {
-                RGBA[k] = RGBA[k] * normalize_param_.scale;
+            } else if (mean_img) {
+              const float* mrow = meanimg_[k][i].dptr_;
+              for (int j = 0; j < cols; ++j) {
+                row[j] = (row[j] - mrow[j]) * contrast_scaled + illumination_scaled;
               }
             } else {
-              CHECK(meanfile_ready_);
-              for (int k = 0; k < n_channels; ++k) {
-                  RGBA[k] = (RGBA[k] - meanimg_[k][i][j]) * contrast_scaled + illumination_scaled;
+              const float scale = normalize_param_.scale;
+              for (int j = 0; j < cols; ++j) {
+                row[j] = row[j] * scale;
               }
             }
+            if (is_mirrored) std::reverse(row, row + cols);
           }
-          for (int k = 0; k < n_channels; ++k) {
-            if (!std::is_same<DType, uint8_t>::value) {
-              // normalize/mirror here to avoid memory copies
-              // logic from iter_normalize.h, function SetOutImg
-              if (is_mirrored) {
-                data[k][i][res.cols - j - 1] = RGBA[k];
-              } else {
-                data[k][i][j] = RGBA[k];
-              }
-            } else {
-              // do not do normalization in Uint8 reader
-              data[k][i][j] = RGBA[k];
-            }
-          }
-          im_data += n_channels;
         }
       }
 
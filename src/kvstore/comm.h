@@ -4,6 +4,7 @@
 #ifndef MXNET_KVSTORE_COMM_H_
 #define MXNET_KVSTORE_COMM_H_
 #include <string>
+#include <cstring>
 #include <algorithm>
 #include <utility>
 #include <limits>
@@ -48,6 +49,77 @@ class Comm {
   Context pinned_ctx_;
 };
 
+/**
+ * \brief add dptr[first], dptr[first+1], ... into dptr[0] over [offset, offset+size)
+ */
+template<typename DType>
+inline void ReduceSumCPUStripe(const std::vector<DType*> &dptr, size_t first,
+                               size_t offset, index_t size) {
+  using namespace mshadow;  // NOLINT(*)
+  Tensor<cpu, 1, DType> in_0(dptr[0] + offset, Shape1(size));
+  for (size_t i = first; i < dptr.size(); i+=4) {
+    switch (dptr.size() - i) {
+      case 1: {
+        Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
+        in_0 += in_1;
+        break;
+      }
+      case 2: {
+        Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
+        Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
+        in_0 += in_1 + in_2;
+        break;
+      }
+      case 3: {
+        Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
+        Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
+        Tensor<cpu, 1, DType> in_3(dptr[i+2] + offset, Shape1(size));
+        in_0 += in_1 + in_2 + in_3;
+        break;
+      }
+      default: {
+        Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
+        Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
+        Tensor<cpu, 1, DType> in_3(dptr[i+2] + offset, Shape1(size));
+        Tensor<cpu, 1, DType> in_4(dptr[i+3] + offset, Shape1(size));
+        in_0 += in_1 + in_2 + in_3 + in_4;
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * \brief sum dptr[1], dptr[2], ... into dptr[0] of total elements, or into
+ * zeros when assign. Arrays of at least bound elements are summed in stripes
+ * of 4K elements by nthreads threads, so that each stripe of dptr[0] stays in
+ * cache while the others are added to it.
+ */
+template<typename DType>
+inline void ReduceSumCPUParallel(const std::vector<DType*> &dptr, size_t total,
+                                 size_t bound, int nthreads, bool assign = false) {
+  auto stripe = [&dptr, assign](size_t begin, size_t end) {
+    if (assign) {
+      std::memcpy(dptr[0] + begin, dptr[1] + begin, (end - begin) * sizeof(DType));
+    }
+    ReduceSumCPUStripe(dptr, assign ? 2 : 1, begin, static_cast<index_t>(end - begin));
+  };
+  const size_t step = std::min(bound, static_cast<size_t>(4 << 10));
+  long ntask = (total + step - 1) / step; // NOLINT(*)
+  if (total < bound || nthreads <= 1) {
+    stripe(0, total);
+  } else {
+    #pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (long j = 0; j < ntask; ++j) { // NOLINT(*)
+      size_t k = static_cast<size_t>(j);
+      size_t begin = std::min(k * step, total);
+      size_t end = std::min((k + 1) * step, total);
+      if (j == ntask - 1) CHECK_EQ(end, total);
+      stripe(begin, end);
+    }
+  }
+}
+
 /**
  * \brief an implemention of Comm that first copy data to CPU memeory, and then
  * reduce there
@@ -122,65 +194,10 @@ class CommCPU : public Comm {
         dptr[i] = data.FlatTo2D<cpu, DType>().dptr_;
       }
       size_t total = in_data[0].shape().Size();
-      ReduceSumCPUImpl(dptr, total);
+      ReduceSumCPUParallel(dptr, total, bigarray_bound_, nthread_reduction_);
     });
   }
 
-  template<typename DType>
-  inline static void ReduceSumCPU(
-      const std::vector<DType*> &dptr, size_t offset, index_t size) {
-    using namespace mshadow;  // NOLINT(*)
-    Tensor<cpu, 1, DType> in_0(dptr[0] + offset, Shape1(size));
-    for (size_t i = 1; i < dptr.size(); i+=4) {
-      switch (dptr.size() - i) {
-        case 1: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          in_0 += in_1;
-          break;
-        }
-        case 2: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
-          in_0 += in_1 + in_2;
-          break;
-        }
-        case 3: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_3(dptr[i+2] + offset, Shape1(size));
-          in_0 += in_1 + in_2 + in_3;
-          break;
-        }
-        default: {
-          Tensor<cpu, 1, DType> in_1(dptr[i] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_2(dptr[i+1] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_3(dptr[i+2] + offset, Shape1(size));
-          Tensor<cpu, 1, DType> in_4(dptr[i+3] + offset, Shape1(size));
-          in_0 += in_1 + in_2 + in_3 + in_4;
-          break;
-        }
-      }
-    }
-  }
-
-  template<typename DType>
-  inline void ReduceSumCPUImpl(std::vector<DType*> dptr, size_t total) {
-    const size_t step = std::min(bigarray_bound_, static_cast<size_t>(4 << 10));
-    long ntask = (total + step - 1) / step; // NOLINT(*)
-    if (total < bigarray_bound_ || nthread_reduction_ <= 1) {
-      ReduceSumCPU(dptr, 0, total);
-    } else {
-      #pragma omp parallel for schedule(static) num_threads(nthread_reduction_)
-      for (long j = 0; j < ntask; ++j) { // NOLINT(*)
-        size_t k = static_cast<size_t>(j);
-        size_t begin = std::min(k * step, total);
-        size_t end = std::min((k + 1) * step, total);
-        if (j == ntask - 1) CHECK_EQ(end, total);
-        ReduceSumCPU(dptr, begin, static_cast<index_t>(end - begin));
-      }
-    }
-  }
-
   /// \brief temporal space for pushing and pulling
   struct BufferEntry {
     /// \brief the merged value
@@ -278,7 +295,7 @@ class CommDevice : public Comm {
     }
   }
 
- private:
+ protected:
   void EnableP2P(const std::vector<Context>& devs) {
 #if MXNET_USE_CUDA
     std::vector<int> gpus;
@@ -321,6 +338,7 @@ class CommDevice : public Comm {
 #endif
   }
 
+ private:
   using KeyAttrs = std::tuple<int, TShape, int>;
   // try to allocate buff on device evenly
   void InitMergeBuffer(const std::vector<Context>& devs) {
@@ -365,6 +383,165 @@ class CommDevice : public Comm {
   bool inited_;
 };
 
+/**
+ * \brief an implementation of Comm that reduces large arrays over a ring of
+ * the source devices, as a reduce-scatter followed by an allgather.
+ *
+ * An array is split into one chunk per source. In each of the n-1 steps of the
+ * reduce-scatter, every source sends a chunk to the next one, which adds it to
+ * its own. So all devices send and receive the same amount of data at once,
+ * instead of all of them sending to the device that reduces the key, and each
+ * ends with one chunk reduced, which is gathered into the merged array.
+ * Broadcast scatters the chunks of the new value back to these devices and
+ * completes them with a ring allgather. Arrays smaller than
+ * MXNET_KVSTORE_BIGARRAY_BOUND are reduced as by CommDevice.
+ */
+class CommRing : public CommDevice {
+ public:
+  CommRing() {
+    bigarray_bound_ = dmlc::GetEnv("MXNET_KVSTORE_BIGARRAY_BOUND", 1000 * 1000);
+    p2p_inited_ = false;
+  }
+
+  virtual ~CommRing() { }
+
+  void Init(int key, const TShape& shape, int dtype = mshadow::kFloat32) override {
+    if (shape.Size() < bigarray_bound_) {
+      CommDevice::Init(key, shape, dtype);
+    } else {
+      auto& buf = ring_buf_[key];
+      buf.shape = shape;
+      buf.dtype = dtype;
+    }
+  }
+
+  const NDArray& Reduce(int key, const std::vector<NDArray>& src,
+                        int priority) override {
+    auto it = ring_buf_.find(key);
+    if (it == ring_buf_.end() || src.size() == 1) {
+      return CommDevice::Reduce(key, src, priority);
+    }
+    auto& buf = it->second;
+    const size_t n = src.size();
+    if (buf.parts.empty()) {
+      InitRingBuffer(key, src, &buf);
+    }
+    CHECK_EQ(buf.parts.size(), n) << "key " << key << " is pushed from "
+                                  << n << " devices, it was from " << buf.parts.size();
+    for (size_t i = 0; i < n; ++i) {
+      CopyFromTo(src[i], &buf.parts[i], priority);
+    }
+    // reduce-scatter. all the sends of a step are pushed before its sums, so
+    // that a device does not wait for the chunk it receives to send its own
+    for (size_t s = 0; s + 1 < n; ++s) {
+      for (size_t i = 0; i < n; ++i) {
+        const size_t next = (i + 1) % n;
+        NDArray recv = RecvChunk(buf.recv[next], (i + n - s) % n, n, buf);
+        CopyFromTo(Chunk(buf.parts[i], (i + n - s) % n, n), &recv, priority);
+      }
+      for (size_t i = 0; i < n; ++i) {
+        const size_t next = (i + 1) % n;
+        NDArray recv = RecvChunk(buf.recv[next], (i + n - s) % n, n, buf);
+        NDArray chunk = Chunk(buf.parts[next], (i + n - s) % n, n);
+        ElementwiseSum({chunk, recv}, &chunk, priority);
+      }
+    }
+    // device i holds the sum of chunk i+1
+    for (size_t i = 0; i < n; ++i) {
+      NDArray chunk = Chunk(buf.merged, (i + 1) % n, n);
+      CopyFromTo(Chunk(buf.parts[i], (i + 1) % n, n), &chunk, priority);
+    }
+    return buf.merged;
+  }
+
+  void Broadcast(int key, const NDArray& src,
+                 const std::vector<NDArray*> dst, int priority) override {
+    auto it = ring_buf_.find(key);
+    if (it == ring_buf_.end()) {
+      CommDevice::Broadcast(key, src, dst, priority);
+      return;
+    }
+    auto& buf = it->second;
+    const size_t n = buf.parts.size();
+    if (n == 0) {
+      // not reduced yet, such as the pull after init
+      for (auto d : dst) CopyFromTo(src, d, priority);
+      return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      NDArray chunk = Chunk(buf.parts[i], (i + 1) % n, n);
+      CopyFromTo(Chunk(src, (i + 1) % n, n), &chunk, priority);
+    }
+    // allgather, through recv for the same reason as the reduce-scatter
+    for (size_t s = 0; s + 1 < n; ++s) {
+      for (size_t i = 0; i < n; ++i) {
+        const size_t next = (i + 1) % n;
+        NDArray recv = RecvChunk(buf.recv[next], (i + 1 + n - s) % n, n, buf);
+        CopyFromTo(Chunk(buf.parts[i], (i + 1 + n - s) % n, n), &recv, priority);
+      }
+      for (size_t i = 0; i < n; ++i) {
+        const size_t next = (i + 1) % n;
+        NDArray chunk = Chunk(buf.parts[next], (i + 1 + n - s) % n, n);
+        CopyFromTo(RecvChunk(buf.recv[next], (i + 1 + n - s) % n, n, buf), &chunk, priority);
+      }
+    }
+    for (auto d : dst) {
+      auto part = std::find_if(buf.parts.begin(), buf.parts.end(), [d](const NDArray& p) {
+          return p.ctx() == d->ctx();
+        });
+      CopyFromTo(part != buf.parts.end() ? *part : src, d, priority);
+    }
+  }
+
+ private:
+  /// \brief temporal space of a key reduced over the ring
+  struct RingBuffer {
+    TShape shape;
+    int dtype;
+    /// \brief the merged value
+    NDArray merged;
+    /// \brief the copy of the source on each device
+    std::vector<NDArray> parts;
+    /// \brief the chunk received by each device, of the size of the largest chunk
+    std::vector<NDArray> recv;
+  };
+
+  void InitRingBuffer(int key, const std::vector<NDArray>& src, RingBuffer *buf) {
+    const size_t n = src.size();
+    std::vector<Context> devs;
+    for (const auto& a : src) {
+      devs.push_back(a.ctx());
+    }
+    if (!p2p_inited_ && dmlc::GetEnv("MXNET_ENABLE_GPU_P2P", 1)) {
+      EnableP2P(devs);
+    }
+    p2p_inited_ = true;
+    const size_t max_chunk = (buf->shape.Size() + n - 1) / n;
+    for (size_t i = 0; i < n; ++i) {
+      buf->parts.emplace_back(buf->shape, devs[i], false, buf->dtype);
+      buf->recv.emplace_back(mshadow::Shape1(max_chunk), devs[i], false, buf->dtype);
+    }
+    // spread the merged arrays, and so the updates, over the devices
+    buf->merged = NDArray(buf->shape, devs[key % n], false, buf->dtype);
+  }
+
+  /// \brief chunk c of n of an array, as a flat array
+  static NDArray Chunk(const NDArray& arr, size_t c, size_t n) {
+    const size_t size = arr.shape().Size();
+    return arr.Reshape(mshadow::Shape1(size)).Slice(size * c / n, size * (c + 1) / n);
+  }
+
+  /// \brief the part of a receive buffer holding chunk c of n of the key
+  static NDArray RecvChunk(const NDArray& recv, size_t c, size_t n, const RingBuffer& buf) {
+    const size_t size = buf.shape.Size();
+    return recv.Slice(0, size * (c + 1) / n - size * c / n);
+  }
+
+  std::unordered_map<int, RingBuffer> ring_buf_;
+  size_t bigarray_bound_;
+  bool p2p_inited_;
+};
+
 }  // namespace kvstore
 }  // namespace mxnet
 #endif  // MXNET_KVSTORE_COMM_H_
@@ -4,9 +4,13 @@
  * \brief implement kv_store
  */
 #include <mxnet/kvstore.h>
+#include <mxnet/optimizer.h>
 #include <stdlib.h>
 #include <dmlc/logging.h>
 #include "./kvstore_local.h"
+#ifndef _WIN32
+#include "./kvstore_shm.h"
+#endif  // _WIN32
 #if MXNET_USE_DIST_KVSTORE
 #include "./kvstore_dist.h"
 #endif  // MXNET_USE_DIST_KVSTORE
@@ -18,17 +22,25 @@ KVStore* KVStore::Create(const char *type_name) {
   std::transform(tname.begin(), tname.end(), tname.begin(), ::tolower);
   KVStore* kv = nullptr;
   bool use_device_comm = false;
+  bool use_ring_comm = false;
   auto has = [tname](const std::string& pattern) {
     return tname.find(pattern) != std::string::npos;
   };
   if (has("device")) {
     use_device_comm = true;
   }
+  if (has("ring")) {
+    use_ring_comm = true;
+  }
 
   if (has("dist")) {
 #if MXNET_USE_DIST_KVSTORE
     kv = new kvstore::KVStoreDist(use_device_comm);
-    if (!has("_async") && kv->IsWorkerNode() && kv->get_rank() == 0) {
+    if (has("_ssp") && kv->IsWorkerNode() && kv->get_rank() == 0) {
+      // configure the server to be the stale synchronous mode
+      kv->SendCommandToServers(kvstore::kSSPMode, std::to_string(
+          dmlc::GetEnv("MXNET_KVSTORE_SSP_STALENESS", 2)));
+    } else if (!has("_async") && kv->IsWorkerNode() && kv->get_rank() == 0) {
       // configure the server to be the sync mode
       kv->SendCommandToServers(kvstore::kSyncMode, "");
     }
@@ -36,11 +48,31 @@ KVStore* KVStore::Create(const char *type_name) {
     LOG(FATAL) << "compile with USE_DIST_KVSTORE=1 to use " << tname;
     return nullptr;
 #endif  // MXNET_USE_DIST_KVSTORE
+  } else if (has("shm")) {
+#ifndef _WIN32
+    kv = new kvstore::KVStoreShm(use_device_comm, use_ring_comm);
+#else
+    LOG(FATAL) << tname << " is not supported on Windows";
+    return nullptr;
+#endif  // _WIN32
   } else {
-    kv =  new kvstore::KVStoreLocal(use_device_comm);
+    kv =  new kvstore::KVStoreLocal(use_device_comm, use_ring_comm);
   }
   kv->type_ = tname;
   return kv;
 }
 
+void KVStore::SetOptimizer(const std::string& name,
+                           const std::vector<std::pair<std::string, std::string> >& kwargs) {
+  if (optimizer_ == nullptr || optimizer_name_ != name) {
+    optimizer_.reset(Optimizer::Create(name.c_str()));
+    optimizer_name_ = name;
+  }
+  optimizer_->Init(kwargs);
+  std::shared_ptr<Optimizer> optimizer = optimizer_;
+  set_updater([optimizer](int key, const NDArray& recved, NDArray* stored) {
+      optimizer->Update(key, recved, stored);
+    });
+}
+
 }  // namespace mxnet
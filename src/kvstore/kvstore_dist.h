@@ -141,6 +141,16 @@ class KVStoreDist : public KVStoreLocal {
     }
   }
 
+  void SetOptimizer(const std::string& name,
+                    const std::vector<std::pair<std::string, std::string> >& kwargs) override {
+    if (IsWorkerNode()) {
+      // the servers update the weights
+      SendCommandToServers(kSetOptimizer, EncodeOptimizer(name, kwargs));
+    } else {
+      KVStore::SetOptimizer(name, kwargs);
+    }
+  }
+
   void Barrier() override {
     ps::Postoffice::Get()->Barrier(ps::kWorkerGroup);
   }
@@ -5,6 +5,8 @@
  */
 #ifndef MXNET_KVSTORE_KVSTORE_DIST_SERVER_H_
 #define MXNET_KVSTORE_KVSTORE_DIST_SERVER_H_
+#include <algorithm>
+#include <chrono>
 #include <queue>
 #include <string>
 #include <mutex>
@@ -12,15 +14,51 @@
 #include <memory>
 #include <functional>
 #include <future>
+#include <sstream>
+#include <utility>
 #include <vector>
 #include "ps/ps.h"
 #include "mxnet/kvstore.h"
+#include "mxnet/optimizer.h"
+#include "./comm.h"
 
 namespace mxnet {
 namespace kvstore {
 
 static const int kStopServer = -1;
 static const int kSyncMode = -2;
+static const int kSetOptimizer = -3;
+static const int kSSPMode = -4;
+
+/**
+ * \brief the body of the command \a kSetOptimizer: the name of the optimizer,
+ * then a line key=value for each parameter
+ */
+inline std::string EncodeOptimizer(
+    const std::string& name, const std::vector<std::pair<std::string, std::string> >& kwargs) {
+  std::ostringstream os;
+  os << name << '\n';
+  for (const auto& kv : kwargs) {
+    CHECK(kv.first.find_first_of("=\n") == std::string::npos &&
+          kv.second.find('\n') == std::string::npos)
+        << "invalid optimizer parameter " << kv.first;
+    os << kv.first << '=' << kv.second << '\n';
+  }
+  return os.str();
+}
+
+inline void DecodeOptimizer(const std::string& body, std::string* name,
+                            std::vector<std::pair<std::string, std::string> >* kwargs) {
+  std::istringstream is(body);
+  std::string line;
+  std::getline(is, *name);
+  kwargs->clear();
+  while (std::getline(is, line)) {
+    const size_t eq = line.find('=');
+    CHECK_NE(eq, std::string::npos) << "invalid optimizer parameter " << line;
+    kwargs->emplace_back(line.substr(0, eq), line.substr(eq + 1));
+  }
+}
 
 /**
  * \brief executor runs a function using the thread called \ref Start
@@ -94,6 +132,10 @@ class KVStoreDistServer {
     ps_server_->set_request_handle(
         std::bind(&KVStoreDistServer::DataHandle, this, _1, _2, _3));
     sync_mode_ = false;
+    staleness_ = -1;
+    nthread_reduction_ = dmlc::GetEnv("MXNET_KVSTORE_REDUCTION_NTHREADS", 4);
+    bigarray_bound_ = dmlc::GetEnv("MXNET_KVSTORE_BIGARRAY_BOUND", 1000 * 1000);
+    merge_batch_ = std::max(dmlc::GetEnv("MXNET_KVSTORE_SERVER_MERGE_BATCH", 4), 1);
   }
 
   ~KVStoreDistServer() {
@@ -108,6 +150,7 @@ class KVStoreDistServer {
   void set_updater(const KVStore::Updater& updater)  {
     CHECK(updater);
     updater_ = updater;
+    optimizer_.reset();
   }
 
   /**
@@ -120,9 +163,24 @@ class KVStoreDistServer {
  private:
   void CommandHandle(const ps::SimpleData& recved, ps::SimpleApp* app) {
     if (recved.head == kStopServer) {
+      if (staleness_ >= 0) ReportStaleness();
       exec_.Stop();
     } else if (recved.head == kSyncMode) {
       sync_mode_ = true;
+    } else if (recved.head == kSSPMode) {
+      sync_mode_ = false;
+      staleness_ = std::stoi(recved.body);
+      CHECK_GE(staleness_, 0) << "invalid staleness " << recved.body;
+    } else if (recved.head == kSetOptimizer) {
+      std::string name;
+      std::vector<std::pair<std::string, std::string> > kwargs;
+      DecodeOptimizer(recved.body, &name, &kwargs);
+      // the same optimizer keeps its states
+      if (optimizer_ == nullptr || optimizer_name_ != name) {
+        optimizer_.reset(Optimizer::Create(name.c_str()));
+        optimizer_name_ = name;
+      }
+      optimizer_->Init(kwargs);
     } else {
       // let the main thread to execute ctrl, which is necessary for python
       exec_.Exec([this, recved]() {
@@ -168,18 +226,22 @@ class KVStoreDistServer {
           merged.array = NDArray(dshape, Context());
         }
 
-        if (merged.request.size() == 0) {
-          CopyFromTo(recved, &merged.array, 0);
-        } else {
-          merged.array += recved;
-        }
-
+        // the pushes are summed on the engine in batches, which hold the
+        // received values until they are added
+        merged.pending.push_back(req_data.vals);
         merged.request.push_back(req_meta);
+        const bool last = merged.request.size() == (size_t)ps::NumWorkers();
+        if (last || merged.pending.size() == merge_batch_) {
+          MergePending(&merged);
+        }
 
-        if (merged.request.size() == (size_t)ps::NumWorkers()) {
-          // let the main thread to execute updater_, which is necessary for
-          // python
-          if (updater_) {
+        if (last) {
+          if (optimizer_) {
+            // native optimizers push to the engine from this thread
+            optimizer_->Update(key, merged.array, &stored);
+          } else if (updater_) {
+            // let the main thread to execute updater_, which is necessary for
+            // python
             exec_.Exec([this, key, &merged, &stored](){
                 CHECK(updater_);
                 updater_(key, merged.array, &stored);
@@ -193,31 +255,115 @@ class KVStoreDistServer {
           }
           merged.request.clear();
           stored.WaitToRead();
-        } else {
-          merged.array.WaitToRead();
         }
       } else {
         // async push
-        exec_.Exec([this, key, &recved, &stored](){
-            CHECK(updater_);
-            updater_(key, recved, &stored);
-          });
+        if (optimizer_) {
+          optimizer_->Update(key, recved, &stored);
+        } else {
+          exec_.Exec([this, key, &recved, &stored](){
+              CHECK(updater_);
+              updater_(key, recved, &stored);
+            });
+        }
         server->Response(req_meta);
         stored.WaitToRead();
+        if (staleness_ >= 0) Tick(key, req_meta, server);
       }
     } else {
       // pull
-      ps::KVPairs<real_t> response;
       CHECK(!stored.is_none()) << "init " << key << " first";
-      int len = stored.shape()[0];
-      response.keys = req_data.keys;
-      response.lens = {len};
-      // TODO(mli) try to remove this CopyFrom
-      response.vals.CopyFrom(static_cast<const float*>(stored.data().dptr_), len);
-      server->Response(req_meta, response);
+      if (staleness_ >= 0 && !PullReady(key, req_meta)) {
+        // answered by the push that lets the slowest worker catch up
+        ssp_[key].pending.push_back({req_meta, req_data.keys, Clock::now()});
+        ++stats_.delayed;
+      } else {
+        ResponsePull(key, req_meta, req_data.keys, server);
+      }
+    }
+  }
+
+  /**
+   * \brief push the sum of the pending pushes into merged->array, which is
+   * overwritten by the first batch of a round. Big values are summed in stripes
+   * by several threads, as CommCPU does.
+   */
+  void MergePending(MergeBuf* merged) {
+    std::vector<ps::SArray<real_t> > recved;
+    recved.swap(merged->pending);
+    const bool assign = merged->request.size() == recved.size();
+    NDArray array = merged->array;
+    const size_t total = array.shape().Size();
+    const size_t bound = bigarray_bound_;
+    const int nthreads = nthread_reduction_;
+    Engine::Get()->PushSync([array, recved, assign, total, bound, nthreads](RunContext rctx) {
+        std::vector<real_t*> dptr = {array.data().dptr<real_t>()};
+        for (const auto& r : recved) dptr.push_back(r.data());
+        ReduceSumCPUParallel(dptr, total, bound, nthreads, assign);
+      }, array.ctx(), {}, {array.var()},
+      FnProperty::kCPUPrioritized, 0, PROFILER_MESSAGE("KVStoreServerMerge"));
+  }
+
+  void ResponsePull(int key, const ps::KVMeta& req_meta, const ps::SArray<ps::Key>& keys,
+                    ps::KVServer<real_t>* server) {
+    const NDArray& stored = store_[key];
+    if (staleness_ >= 0) {
+      const auto& clocks = ssp_[key].clocks;
+      if (!clocks.empty()) {
+        const int ahead = clocks[ps::Postoffice::IDtoRank(req_meta.sender)] -
+                          *std::min_element(clocks.begin(), clocks.end());
+        ++stats_.pulls;
+        stats_.staleness_sum += std::max(ahead, 0);
+        stats_.max_staleness = std::max(stats_.max_staleness, ahead);
+      }
+    }
+    ps::KVPairs<real_t> response;
+    int len = stored.shape()[0];
+    response.keys = keys;
+    response.lens = {len};
+    // TODO(mli) try to remove this CopyFrom
+    response.vals.CopyFrom(static_cast<const float*>(stored.data().dptr_), len);
+    server->Response(req_meta, response);
+  }
+
+  /**
+   * \brief whether the worker of a pull is at most staleness_ pushes of the
+   * key ahead of the slowest worker
+   */
+  bool PullReady(int key, const ps::KVMeta& req_meta) {
+    auto& clocks = ssp_[key].clocks;
+    if (clocks.empty()) clocks.resize(ps::NumWorkers(), 0);
+    const int clock = clocks[ps::Postoffice::IDtoRank(req_meta.sender)];
+    return *std::min_element(clocks.begin(), clocks.end()) >= clock - staleness_;
+  }
+
+  /**
+   * \brief count a push of a worker, and answer the pulls it makes ready
+   */
+  void Tick(int key, const ps::KVMeta& req_meta, ps::KVServer<real_t>* server) {
+    auto& ssp = ssp_[key];
+    if (ssp.clocks.empty()) ssp.clocks.resize(ps::NumWorkers(), 0);
+    ++ssp.clocks[ps::Postoffice::IDtoRank(req_meta.sender)];
+    auto now = Clock::now();
+    for (auto it = ssp.pending.begin(); it != ssp.pending.end();) {
+      if (PullReady(key, it->meta)) {
+        stats_.delay_sec += std::chrono::duration<double>(now - it->arrival).count();
+        ResponsePull(key, it->meta, it->keys, server);
+        it = ssp.pending.erase(it);
+      } else {
+        ++it;
+      }
     }
   }
 
+  void ReportStaleness() {
+    LOG(INFO) << "server " << ps::MyRank() << ", staleness " << staleness_ << ": "
+              << stats_.pulls << " pulls, ahead of the slowest worker by "
+              << (stats_.pulls ? static_cast<double>(stats_.staleness_sum) / stats_.pulls : 0)
+              << " pushes on average and " << stats_.max_staleness << " at most, "
+              << stats_.delayed << " delayed for " << stats_.delay_sec << " seconds in total";
+  }
+
   int DecodeKey(ps::Key key) {
     auto kr = ps::Postoffice::Get()->GetServerKeyRanges()[ps::MyRank()];
     return key - kr.begin();
@@ -227,13 +373,50 @@ class KVStoreDistServer {
    * \brief user defined
    */
   bool sync_mode_;
+  /**
+   * \brief in stale synchronous mode, the number of pushes of a key by which a
+   * worker may be ahead of the slowest one when it pulls, -1 otherwise
+   */
+  int staleness_;
+  typedef std::chrono::steady_clock Clock;
+  struct PendingPull {
+    ps::KVMeta meta;
+    ps::SArray<ps::Key> keys;
+    Clock::time_point arrival;
+  };
+  struct SSPState {
+    /// \brief the number of pushes of each worker
+    std::vector<int> clocks;
+    std::vector<PendingPull> pending;
+  };
+  std::unordered_map<int, SSPState> ssp_;
+  struct SSPStats {
+    size_t pulls = 0;
+    size_t delayed = 0;
+    size_t staleness_sum = 0;
+    int max_staleness = 0;
+    double delay_sec = 0;
+  };
+  SSPStats stats_;
+  int nthread_reduction_;
+  size_t bigarray_bound_;
+  /// \brief the number of pushes of a key summed by one operation
+  size_t merge_batch_;
   KVStore::Controller controller_;
   KVStore::Updater updater_;
+  /**
+   * \brief the optimizer set by the command \a kSetOptimizer, used instead of
+   * updater_
+   */
+  std::unique_ptr<Optimizer> optimizer_;
+  std::string optimizer_name_;
 
   std::unordered_map<int, NDArray> store_;
 
   struct MergeBuf {
     std::vector<ps::KVMeta> request;
+    /// \brief the received values not yet added to array
+    std::vector<ps::SArray<real_t> > pending;
     NDArray array;
   };
   std::unordered_map<int, MergeBuf> merge_buf_;
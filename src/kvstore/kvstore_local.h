@@ -14,24 +14,35 @@
 #include <utility>
 #include <algorithm>
 #include "./comm.h"
+#include "../ndarray/ndarray_function.h"
 
 namespace mxnet {
 namespace kvstore {
 /**
  * \brief store data in local machine
+ *
+ * When MXNET_KVSTORE_FUSION_BUCKET_SIZE is set, the keys smaller than it are
+ * packed at init, in init order, into buckets of up to that many elements. A
+ * push or pull of all the keys of a bucket in one call copies them into the
+ * bucket with one operation per device, and reduces or broadcasts the bucket
+ * as one array, instead of running one reduce or broadcast per key.
  */
 class KVStoreLocal : public KVStore {
  public:
   /*
    * \param use_device_comm
+   * \param use_ring_comm reduce large arrays over a ring of the devices
    */
-  explicit KVStoreLocal(bool use_device_comm) : KVStore() {
-    if (use_device_comm) {
+  explicit KVStoreLocal(bool use_device_comm, bool use_ring_comm = false) : KVStore() {
+    if (use_ring_comm) {
+      comm_ = new CommRing();
+    } else if (use_device_comm) {
       comm_ = new CommDevice();
     } else {
       comm_ = new CommCPU();
     }
     pinned_ctx_ = comm_->pinned_ctx();
+    fusion_size_ = dmlc::GetEnv("MXNET_KVSTORE_FUSION_BUCKET_SIZE", 0);
   }
 
   virtual ~KVStoreLocal() {
@@ -45,6 +56,7 @@ class KVStoreLocal : public KVStore {
           << "duplicate init of key " << keys[i];
       local_[keys[i]] = values[i].Copy(pinned_ctx_);
       comm_->Init(keys[i], values[i].shape(), values[i].dtype());
+      if (fusion_size_ > 0) AddToBucket(keys[i], values[i]);
     }
   }
 
@@ -68,22 +80,12 @@ class KVStoreLocal : public KVStore {
     std::vector<int> uniq_keys;
     std::vector<std::vector<NDArray> > grouped_vals;
     GroupKVPairs(keys, values, &uniq_keys, &grouped_vals);
+    if (fusion_size_ > 0) PushBuckets(&uniq_keys, &grouped_vals, priority);
 
     for (size_t i = 0; i < uniq_keys.size(); ++i) {
       int key = uniq_keys[i];
-      const NDArray& merged = comm_->Reduce(key, grouped_vals[i], priority);
-      NDArray& local = local_[key];
-      if (updater_ != nullptr) {
-        CHECK(!local.is_none()) << "key " << key << " has not been inited";
-        // if merged is on gpu, we may need copy weight from cpu to gpu
-        if (merged.ctx().dev_mask() != cpu::kDevMask &&
-            local.ctx().dev_mask() == cpu::kDevMask) {
-          local = local.Copy(merged.ctx());
-        }
-        updater_(key, merged,  &local);
-      } else {
-        local = merged;
-      }
+      const NDArray& merged = Reduce(key, grouped_vals[i], priority);
+      Update(key, merged);
     }
   }
 
@@ -93,6 +95,7 @@ class KVStoreLocal : public KVStore {
     std::vector<int> uniq_keys;
     std::vector<std::vector<NDArray*> > grouped_vals;
     GroupKVPairs(keys, values, &uniq_keys, &grouped_vals);
+    if (fusion_size_ > 0) PullBuckets(&uniq_keys, &grouped_vals, priority);
 
     for (size_t i = 0; i < uniq_keys.size(); ++i) {
       int key = uniq_keys[i];
@@ -119,6 +122,31 @@ class KVStoreLocal : public KVStore {
   }
 
  protected:
+  /**
+   * \brief update the stored value of a key with the sum of the pushed values
+   */
+  void Update(int key, const NDArray& merged) {
+    NDArray& local = local_[key];
+    if (updater_ != nullptr) {
+      CHECK(!local.is_none()) << "key " << key << " has not been inited";
+      // if merged is on gpu, we may need copy weight from cpu to gpu
+      if (merged.ctx().dev_mask() != cpu::kDevMask &&
+          local.ctx().dev_mask() == cpu::kDevMask) {
+        local = local.Copy(merged.ctx());
+      }
+      updater_(key, merged,  &local);
+    } else {
+      local = merged;
+    }
+  }
+
+  /**
+   * \brief returns the sum of the values pushed for a key
+   */
+  virtual const NDArray& Reduce(int key, const std::vector<NDArray>& vals, int priority) {
+    return comm_->Reduce(key, vals, priority);
+  }
+
   /**
    * \brief group values on keys
    */
@@ -160,6 +188,265 @@ class KVStoreLocal : public KVStore {
     }
   }
 
+  /// \brief keys reduced and broadcast together
+  struct Bucket {
+    /// \brief the keys, in init order
+    std::vector<int> keys;
+    /// \brief the shapes of the keys
+    std::vector<TShape> shapes;
+    /// \brief the offset of each key in the bucket
+    std::vector<size_t> offsets;
+    /// \brief number of elements
+    size_t size = 0;
+    int dtype;
+    /// \brief the keys packed on each device
+    std::vector<NDArray> bufs;
+    /// \brief the stored values packed
+    NDArray stored;
+  };
+
+  /// \brief the key of a bucket in comm_, negative to not meet the keys of users
+  static int BucketKey(size_t b) {
+    return -1 - static_cast<int>(b);
+  }
+
+  void AddToBucket(int key, const NDArray& value) {
+    const size_t size = value.shape().Size();
+    if (buckets_frozen_ || size >= fusion_size_) return;
+    CHECK_GE(key, 0) << "keys must not be negative when MXNET_KVSTORE_FUSION_BUCKET_SIZE is set";
+    if (buckets_.empty() || buckets_.back().size + size > fusion_size_ ||
+        buckets_.back().dtype != value.dtype()) {
+      buckets_.emplace_back();
+      buckets_.back().dtype = value.dtype();
+    }
+    Bucket& bucket = buckets_.back();
+    bucket.keys.push_back(key);
+    bucket.shapes.push_back(value.shape());
+    bucket.offsets.push_back(bucket.size);
+    bucket.size += size;
+  }
+
+  /**
+   * \brief no key joins the buckets after the first push or pull, when the
+   * buckets are given to comm_
+   */
+  void FreezeBuckets() {
+    if (buckets_frozen_) return;
+    buckets_frozen_ = true;
+    for (size_t b = 0; b < buckets_.size(); ++b) {
+      if (buckets_[b].keys.size() < 2) continue;
+      comm_->Init(BucketKey(b), mshadow::Shape1(buckets_[b].size), buckets_[b].dtype);
+      for (int key : buckets_[b].keys) key_bucket_[key] = b;
+    }
+  }
+
+  /**
+   * \brief the buckets all the keys of which are in uniq_keys, with the same
+   * number of values on the same devices, in the reverse of init order, which
+   * is the order the gradients are computed in. idx gets the position in
+   * uniq_keys of each key of the buckets
+   */
+  template <typename V>
+  std::vector<size_t> FullBuckets(const std::vector<int>& uniq_keys,
+                                  const std::vector<std::vector<V> >& grouped_vals,
+                                  std::vector<std::vector<size_t> > *idx) {
+    FreezeBuckets();
+    std::unordered_map<int, size_t> found;
+    for (size_t i = 0; i < uniq_keys.size(); ++i) {
+      if (key_bucket_.count(uniq_keys[i])) found[uniq_keys[i]] = i;
+    }
+    std::vector<size_t> ret;
+    if (found.empty()) return ret;
+    for (size_t b = buckets_.size(); b-- > 0;) {
+      if (buckets_[b].keys.size() < 2) continue;
+      std::vector<size_t> pos;
+      for (int key : buckets_[b].keys) {
+        auto it = found.find(key);
+        if (it == found.end()) break;
+        pos.push_back(it->second);
+      }
+      if (pos.size() != buckets_[b].keys.size()) continue;
+      bool same_devices = true;
+      const auto& first = grouped_vals[pos[0]];
+      for (size_t j = 0; j < pos.size() && same_devices; ++j) {
+        const auto& v = grouped_vals[pos[j]];
+        same_devices = first.size() == v.size();
+        for (size_t d = 0; d < v.size() && same_devices; ++d) {
+          same_devices = Ctx(first[d]) == Ctx(v[d]) && Dtype(v[d]) == buckets_[b].dtype;
+        }
+      }
+      if (!same_devices) continue;
+      ret.push_back(b);
+      idx->push_back(pos);
+    }
+    return ret;
+  }
+
+  /**
+   * \brief push the full buckets, and remove their keys from the lists
+   */
+  void PushBuckets(std::vector<int> *uniq_keys,
+                   std::vector<std::vector<NDArray> > *grouped_vals,
+                   int priority) {
+    std::vector<std::vector<size_t> > idx;
+    std::vector<size_t> full = FullBuckets(*uniq_keys, *grouped_vals, &idx);
+    if (full.empty()) return;
+    std::vector<bool> fused(uniq_keys->size(), false);
+    for (size_t f = 0; f < full.size(); ++f) {
+      Bucket& bucket = buckets_[full[f]];
+      const auto& pos = idx[f];
+      const auto& first = (*grouped_vals)[pos[0]];
+      InitBucketBuffers(&bucket, first);
+      for (size_t d = 0; d < first.size(); ++d) {
+        std::vector<NDArray> from, to;
+        // in the order the gradients are computed in
+        for (size_t j = pos.size(); j-- > 0;) {
+          from.push_back(Flat((*grouped_vals)[pos[j]][d]));
+          to.push_back(KeyView(bucket, bucket.bufs[d], j));
+        }
+        FusedCopy(from, to, priority);
+      }
+      const NDArray& merged = Reduce(BucketKey(full[f]), bucket.bufs, priority);
+      for (size_t j = pos.size(); j-- > 0;) {
+        Update(bucket.keys[j], KeyView(bucket, merged, j).Reshape(bucket.shapes[j]));
+        fused[pos[j]] = true;
+      }
+    }
+    RemoveFused(fused, uniq_keys, grouped_vals);
+  }
+
+  /**
+   * \brief pull the full buckets, and remove their keys from the lists
+   */
+  void PullBuckets(std::vector<int> *uniq_keys,
+                   std::vector<std::vector<NDArray*> > *grouped_vals,
+                   int priority) {
+    std::vector<std::vector<size_t> > idx;
+    std::vector<size_t> full = FullBuckets(*uniq_keys, *grouped_vals, &idx);
+    if (full.empty()) return;
+    std::vector<bool> fused(uniq_keys->size(), false);
+    for (size_t f = 0; f < full.size(); ++f) {
+      Bucket& bucket = buckets_[full[f]];
+      const auto& pos = idx[f];
+      // the stored values are packed, when they are on one device
+      const Context ctx = local_[bucket.keys[0]].ctx();
+      bool one_device = true;
+      for (int key : bucket.keys) one_device = one_device && local_[key].ctx() == ctx;
+      if (!one_device) continue;
+      if (bucket.stored.is_none() || bucket.stored.ctx() != ctx) {
+        bucket.stored = NDArray(mshadow::Shape1(bucket.size), ctx, false, bucket.dtype);
+      }
+      std::vector<NDArray> from, to;
+      for (size_t j = 0; j < pos.size(); ++j) {
+        from.push_back(Flat(local_[bucket.keys[j]]));
+        to.push_back(KeyView(bucket, bucket.stored, j));
+      }
+      FusedCopy(from, to, priority);
+      const auto& first = (*grouped_vals)[pos[0]];
+      InitBucketBuffers(&bucket, first);
+      std::vector<NDArray*> dst;
+      for (auto& buf : bucket.bufs) dst.push_back(&buf);
+      comm_->Broadcast(BucketKey(full[f]), bucket.stored, dst, priority);
+      for (size_t d = 0; d < first.size(); ++d) {
+        std::vector<NDArray> from, to;
+        for (size_t j = 0; j < pos.size(); ++j) {
+          from.push_back(KeyView(bucket, bucket.bufs[d], j));
+          to.push_back(Flat(*(*grouped_vals)[pos[j]][d]));
+        }
+        FusedCopy(from, to, priority);
+      }
+      for (size_t p : pos) fused[p] = true;
+    }
+    RemoveFused(fused, uniq_keys, grouped_vals);
+  }
+
+  template <typename V>
+  void RemoveFused(const std::vector<bool>& fused, std::vector<int> *uniq_keys,
+                   std::vector<std::vector<V> > *grouped_vals) {
+    size_t n = 0;
+    for (size_t i = 0; i < fused.size(); ++i) {
+      if (fused[i]) continue;
+      (*uniq_keys)[n] = (*uniq_keys)[i];
+      (*grouped_vals)[n] = (*grouped_vals)[i];
+      ++n;
+    }
+    uniq_keys->resize(n);
+    grouped_vals->resize(n);
+  }
+
+  /**
+   * \brief allocate the bucket on the devices of the values, once
+   */
+  template <typename V>
+  void InitBucketBuffers(Bucket *bucket, const std::vector<V>& vals) {
+    bool same = bucket->bufs.size() == vals.size();
+    for (size_t d = 0; d < vals.size() && same; ++d) {
+      same = bucket->bufs[d].ctx() == Ctx(vals[d]);
+    }
+    if (same) return;
+    bucket->bufs.clear();
+    for (const auto& v : vals) {
+      bucket->bufs.emplace_back(mshadow::Shape1(bucket->size), Ctx(v), false, bucket->dtype);
+    }
+  }
+
+  static NDArray KeyView(const Bucket& bucket, const NDArray& arr, size_t j) {
+    const size_t begin = bucket.offsets[j];
+    return arr.Slice(begin, begin + bucket.shapes[j].Size());
+  }
+
+  static NDArray Flat(const NDArray& arr) {
+    return arr.Reshape(mshadow::Shape1(arr.shape().Size()));
+  }
+
+  static Context Ctx(const NDArray& arr) { return arr.ctx(); }
+  static Context Ctx(const NDArray* arr) { return arr->ctx(); }
+  static int Dtype(const NDArray& arr) { return arr.dtype(); }
+  static int Dtype(const NDArray* arr) { return arr->dtype(); }
+
+  /**
+   * \brief copy from[i] to to[i] for every i with one engine operation, instead
+   * of one per array. all the arrays are on the same device
+   */
+  static void FusedCopy(const std::vector<NDArray>& from, const std::vector<NDArray>& to,
+                        int priority) {
+    const Context ctx = to[0].ctx();
+    std::vector<Engine::VarHandle> const_vars, mutate_vars;
+    auto add = [](std::vector<Engine::VarHandle> *vars, Engine::VarHandle var) {
+      if (std::find(vars->begin(), vars->end(), var) == vars->end()) vars->push_back(var);
+    };
+    for (size_t i = 0; i < from.size(); ++i) {
+      CHECK(from[i].ctx() == ctx && to[i].ctx() == ctx);
+      CHECK_EQ(from[i].shape().Size(), to[i].shape().Size());
+      add(&mutate_vars, to[i].var());
+    }
+    for (const auto& a : from) {
+      if (std::find(mutate_vars.begin(), mutate_vars.end(), a.var()) == mutate_vars.end()) {
+        add(&const_vars, a.var());
+      }
+    }
+    Engine::Get()->PushSync([from, to, ctx](RunContext rctx) {
+        for (size_t i = 0; i < from.size(); ++i) {
+          TBlob tmp = to[i].data();
+          if (ctx.dev_mask() == cpu::kDevMask) {
+            ndarray::Copy<cpu, cpu>(from[i].data(), &tmp, ctx, ctx, rctx);
+          } else {
+#if MXNET_USE_CUDA
+            ndarray::Copy<gpu, gpu>(from[i].data(), &tmp, ctx, ctx, rctx);
+#else
+            LOG(FATAL) << MXNET_GPU_NOT_ENABLED_ERROR;
+#endif  // MXNET_USE_CUDA
+          }
+        }
+#if MXNET_USE_CUDA
+        if (ctx.dev_mask() == gpu::kDevMask) {
+          rctx.get_stream<gpu>()->Wait();
+        }
+#endif  // MXNET_USE_CUDA
+      }, ctx, const_vars, mutate_vars, FnProperty::kNormal, priority,
+      PROFILER_MESSAGE("KVStoreFusedCopy"));
+  }
+
   /// reducer and broadcaster
   Comm* comm_;
   /// pinned context
@@ -170,6 +457,12 @@ class KVStoreLocal : public KVStore {
   std::unordered_map<std::string, int> str_key_dict_;
   /// the next available integer for string->int key mapping
   int next_str_key_ = 0;
+  /// \brief the largest number of elements of a bucket, 0 to not fuse keys
+  size_t fusion_size_;
+  std::vector<Bucket> buckets_;
+  /// \brief the bucket of each fused key
+  std::unordered_map<int, size_t> key_bucket_;
+  bool buckets_frozen_ = false;
 };
 }  // namespace kvstore
 }  // namespace mxnet
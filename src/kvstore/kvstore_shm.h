@@ -0,0 +1,290 @@
+/**
+ * Copyright (c) 2017 by Contributors
+ * @file   kvstore_shm.h
+ * @brief  local store synchronized between the processes of a host
+ */
+#ifndef MXNET_KVSTORE_KVSTORE_SHM_H_
+#define MXNET_KVSTORE_KVSTORE_SHM_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <mxnet/engine.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "./kvstore_local.h"
+
+namespace mxnet {
+namespace kvstore {
+
+/**
+ * \brief allreduce over a shared memory segment between the processes of a host
+ *
+ * Arrays go through the segment in pieces of up to one slot. Every process
+ * copies its piece into its slot, then each of the n processes sums 1/n of the
+ * piece over the slots into the result slot (a reduce-scatter), and every
+ * process copies the result back (an allgather). Each element is summed once,
+ * in rank order, so all the processes get the same bits.
+ *
+ * The calls must come in the same order in all processes.
+ */
+class ShmAllreduce {
+ public:
+  /**
+   * \param name the name of the segment, shared by the processes
+   * \param rank the rank of this process, rank 0 creates the segment
+   * \param num_procs the number of processes
+   * \param slot_bytes the size of a piece
+   */
+  ShmAllreduce(const std::string& name, int rank, int num_procs, size_t slot_bytes)
+      : rank_(rank), num_procs_(num_procs), slot_bytes_(slot_bytes) {
+    CHECK(rank >= 0 && rank < num_procs) << "invalid rank " << rank << " of " << num_procs;
+    CHECK_LE(num_procs, kMaxProcs) << "too many processes";
+    slot_bytes_ = std::max(slot_bytes_, static_cast<size_t>(kAlign)) / kAlign * kAlign;
+    bytes_ = kHeaderBytes + (num_procs_ + 1) * slot_bytes_;
+    int fd = -1;
+    if (rank_ == 0) {
+      // remove the segment left by a run that failed to start
+      shm_unlink(name.c_str());
+      fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+      CHECK_NE(fd, -1) << "failed to create shared memory " << name << ": " << strerror(errno);
+      CHECK_EQ(ftruncate(fd, bytes_), 0) << "failed to allocate shared memory " << name;
+    } else {
+      struct stat st;
+      while ((fd = shm_open(name.c_str(), O_RDWR, 0600)) == -1 ||
+             fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != bytes_) {
+        if (fd != -1) close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    void *mem = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(mem != MAP_FAILED) << "failed to map shared memory " << name;
+    mem_ = static_cast<char*>(mem);
+    header_ = reinterpret_cast<Header*>(mem_);
+    if (rank_ == 0) {
+      new (header_) Header();
+      header_->num_procs = num_procs_;
+      header_->ready.store(kReady);
+    } else {
+      while (header_->ready.load() != kReady) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      CHECK_EQ(header_->num_procs, num_procs_) << "processes disagree on their number";
+    }
+    Barrier();
+    // every process has mapped it, the segment goes away with the last mapping
+    if (rank_ == 0) shm_unlink(name.c_str());
+  }
+
+  ~ShmAllreduce() {
+    munmap(mem_, bytes_);
+  }
+
+  /**
+   * \brief sum data over the processes, in place
+   */
+  void Allreduce(int key, const TBlob& data) {
+    MSHADOW_TYPE_SWITCH(data.type_flag_, DType, {
+      DType *dptr = data.dptr<DType>();
+      const size_t size = data.Size();
+      const size_t piece = slot_bytes_ / sizeof(DType);
+      DType *result = reinterpret_cast<DType*>(Slot(num_procs_));
+      for (size_t begin = 0; begin < size; begin += piece) {
+        const size_t len = std::min(piece, size - begin);
+        header_->keys[rank_] = key;
+        std::memcpy(Slot(rank_), dptr + begin, len * sizeof(DType));
+        Sync(&header_->data);
+        CheckKeys(key);
+        const size_t b = len * rank_ / num_procs_, e = len * (rank_ + 1) / num_procs_;
+        std::memcpy(result + b, Slot(0) + b * sizeof(DType), (e - b) * sizeof(DType));
+        for (int j = 1; j < num_procs_; ++j) {
+          const DType *slot = reinterpret_cast<const DType*>(Slot(j));
+          for (size_t k = b; k < e; ++k) result[k] += slot[k];
+        }
+        Sync(&header_->data);
+        std::memcpy(dptr + begin, result, len * sizeof(DType));
+        // nobody writes the slots again before everybody has read the result
+        Sync(&header_->data);
+      }
+    });
+  }
+
+  /**
+   * \brief copy data of rank 0 to the other processes
+   */
+  void Broadcast(int key, const TBlob& data) {
+    MSHADOW_TYPE_SWITCH(data.type_flag_, DType, {
+      DType *dptr = data.dptr<DType>();
+      const size_t size = data.Size();
+      const size_t piece = slot_bytes_ / sizeof(DType);
+      for (size_t begin = 0; begin < size; begin += piece) {
+        const size_t len = std::min(piece, size - begin);
+        header_->keys[rank_] = key;
+        if (rank_ == 0) std::memcpy(Slot(num_procs_), dptr + begin, len * sizeof(DType));
+        Sync(&header_->data);
+        CheckKeys(key);
+        if (rank_ != 0) std::memcpy(dptr + begin, Slot(num_procs_), len * sizeof(DType));
+        Sync(&header_->data);
+      }
+    });
+  }
+
+  /**
+   * \brief barrier of the main threads, independent of the one of the data
+   */
+  void Barrier() {
+    Sync(&header_->user);
+  }
+
+ private:
+  static const uint32_t kReady = 0x6d78736d;
+  static const int kAlign = 64;
+  static const int kMaxProcs = 256;
+
+  struct SpinBarrier {
+    std::atomic<int> count{0};
+    std::atomic<int> generation{0};
+  };
+
+  struct Header {
+    std::atomic<uint32_t> ready{0};
+    int num_procs;
+    SpinBarrier data;
+    SpinBarrier user;
+    /// \brief the key of the current call of each process
+    int keys[kMaxProcs];
+  };
+  static const size_t kHeaderBytes = (sizeof(Header) + kAlign - 1) / kAlign * kAlign;
+
+  char *Slot(int i) {
+    return mem_ + kHeaderBytes + i * slot_bytes_;
+  }
+
+  void Sync(SpinBarrier *barrier) {
+    const int generation = barrier->generation.load();
+    if (barrier->count.fetch_add(1) == num_procs_ - 1) {
+      barrier->count.store(0);
+      barrier->generation.fetch_add(1);
+    } else {
+      while (barrier->generation.load() == generation) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  void CheckKeys(int key) {
+    for (int j = 0; j < num_procs_; ++j) {
+      CHECK_EQ(header_->keys[j], key)
+          << "process " << j << " pushed key " << header_->keys[j] << " while process "
+          << rank_ << " pushed key " << key << ", all must push the keys in the same order";
+    }
+  }
+
+  int rank_;
+  int num_procs_;
+  size_t slot_bytes_;
+  size_t bytes_;
+  char *mem_;
+  Header *header_;
+};
+
+/**
+ * \brief a local store synchronized with the stores of the other processes of
+ * the host through shared memory, without servers. After the local reduce,
+ * the pushed values are summed over the processes, which all apply the same
+ * update to their copy of the value.
+ *
+ * The processes are given by MXNET_KVSTORE_SHM_NUM_PROCS and
+ * MXNET_KVSTORE_SHM_RANK, and share the segment MXNET_KVSTORE_SHM_NAME. As
+ * with dist_sync, they must init and push the keys in the same order, and the
+ * values of rank 0 are used for init.
+ */
+class KVStoreShm : public KVStoreLocal {
+ public:
+  KVStoreShm(bool use_device_comm, bool use_ring_comm)
+      : KVStoreLocal(use_device_comm, use_ring_comm) {
+    rank_ = dmlc::GetEnv("MXNET_KVSTORE_SHM_RANK", 0);
+    num_procs_ = dmlc::GetEnv("MXNET_KVSTORE_SHM_NUM_PROCS", 1);
+    shm_.reset(new ShmAllreduce(
+        dmlc::GetEnv("MXNET_KVSTORE_SHM_NAME", std::string("/mxnet_kvstore")),
+        rank_, num_procs_, dmlc::GetEnv("MXNET_KVSTORE_SHM_SLOT_SIZE", 4 << 20)));
+    shm_var_ = Engine::Get()->NewVariable();
+  }
+
+  virtual ~KVStoreShm() {
+    Engine::Get()->WaitForAll();
+    Engine::Get()->DeleteVariable([](RunContext ctx) {}, Context::CPU(), shm_var_);
+    Engine::Get()->WaitForAll();
+  }
+
+  void Init(const std::vector<int>& keys,
+            const std::vector<NDArray>& values) override {
+    KVStoreLocal::Init(keys, values);
+    for (int key : keys) {
+      PushShm(key, local_[key], true, 0);
+    }
+    for (int key : keys) {
+      local_[key].WaitToRead();
+    }
+  }
+
+  int get_rank() const override { return rank_; }
+
+  int get_group_size() const override { return num_procs_; }
+
+  void Barrier() override {
+    shm_->Barrier();
+  }
+
+ protected:
+  const NDArray& Reduce(int key, const std::vector<NDArray>& vals, int priority) override {
+    const NDArray& merged = comm_->Reduce(key, vals, priority);
+    NDArray& buf = merge_buf_[key];
+    if (buf.is_none()) {
+      buf = NDArray(merged.shape(), pinned_ctx_, false, merged.dtype());
+    }
+    CopyFromTo(merged, &buf, priority);
+    PushShm(key, buf, false, priority);
+    return buf;
+  }
+
+ private:
+  /**
+   * \brief push the allreduce, or the broadcast, of arr. all of them write
+   * shm_var_, so that they run in the order they are pushed
+   */
+  void PushShm(int key, const NDArray& arr, bool broadcast, int priority) {
+    ShmAllreduce *shm = shm_.get();
+    NDArray data = arr;
+    // kNormal, as the call waits for the other processes and would hold one of
+    // the few threads of the prioritized operators otherwise
+    Engine::Get()->PushSync([shm, key, data, broadcast](RunContext rctx) {
+        if (broadcast) {
+          shm->Broadcast(key, data.data());
+        } else {
+          shm->Allreduce(key, data.data());
+        }
+      }, Context::CPU(), {}, {data.var(), shm_var_},
+      FnProperty::kNormal, priority, PROFILER_MESSAGE("KVStoreShmAllreduce"));
+  }
+
+  int rank_;
+  int num_procs_;
+  std::unique_ptr<ShmAllreduce> shm_;
+  Engine::VarHandle shm_var_;
+  /// \brief the values summed over the processes
+  std::unordered_map<int, NDArray> merge_buf_;
+};
+}  // namespace kvstore
+}  // namespace mxnet
+#endif  // MXNET_KVSTORE_KVSTORE_SHM_H_
@@ -11,7 +11,10 @@
 #include <mxnet/ndarray.h>
 #include <mxnet/resource.h>
 #include <mshadow/tensor.h>
+#include <map>
+#include <vector>
 #include "./ndarray_function.h"
+#include "./ndarray_file.h"
 #include "./autograd.h"
 
 #if MXNET_USE_OPENCV
@@ -71,9 +74,7 @@ NDArray NDArray::Slice(index_t begin, index_t end) const {
   CHECK(!is_none()) << "NDArray is not initialized";
   CHECK_GE(shape_[0], end) << "Slice end index out of range";
   size_t length = shape_.ProdShape(1, shape_.ndim());
-  MSHADOW_TYPE_SWITCH(ret.dtype(), DType, {
-    ret.byte_offset_ += begin * length * sizeof(DType);
-  });
+  ret.byte_offset_ += begin * length * TypeSize(ret.dtype());
   ret.shape_[0] = end - begin;
   if (AutogradRuntime::Get()->IsTraining()) {
     // fake a slice_axis op
@@ -667,7 +668,7 @@ void NDArray::Save(dmlc::Stream *strm) const {
   int32_t type_flag = save_data.type_flag_;
   strm->Write(&type_flag, sizeof(type_flag));
   CHECK(save_data.CheckContiguous());
-  size_t type_size = mshadow::mshadow_sizeof(type_flag);
+  size_t type_size = TypeSize(type_flag);
   strm->Write(save_data.dptr_, type_size * shape_.Size());
 }
 
@@ -705,7 +706,7 @@ bool NDArray::Load(dmlc::Stream *strm) {
   // load data into CPU
   NDArray temp(shape, Context::CPU(), false, type_flag);
   TBlob load_data = temp.data();
-  size_t type_size = mshadow::mshadow_sizeof(type_flag);
+  size_t type_size = TypeSize(type_flag);
   size_t nread = type_size * shape.Size();
 
   if (strm->Read(load_data.dptr_, nread) != nread) return false;
@@ -739,6 +740,10 @@ void NDArray::Load(dmlc::Stream* fi,
   uint64_t header, reserved;
   CHECK(fi->Read(&header))
       << "Invalid NDArray file format";
+  if (header == ndarray_file::kMXAPINDArrayIndexedMagic) {
+    ndarray_file::LoadIndexed(fi, data, keys);
+    return;
+  }
   CHECK(fi->Read(&reserved))
       << "Invalid NDArray file format";
   CHECK(header == kMXAPINDArrayListMagic)
@@ -812,6 +817,139 @@ void NDArray::SyncCopyToCPU(void *data, size_t size) const {
   }
 }
 
+namespace {
+/*!
+ * \brief push one operator per context copying between the arrays
+ *  and host memory, all of them writing done.
+ */
+void PushBatchCopy(const std::vector<NDArray>& arrays,
+                   const std::vector<TBlob>& host,
+                   bool from_cpu, Engine::VarHandle done) {
+  std::map<Context, std::vector<size_t> > groups;
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    groups[arrays[i].ctx()].push_back(i);
+  }
+  for (const auto& kv : groups) {
+    const Context& ctx = kv.first;
+    std::vector<NDArray> nds;
+    std::vector<TBlob> blobs;
+    std::vector<Engine::VarHandle> const_vars, mutable_vars{done};
+    for (size_t i : kv.second) {
+      nds.push_back(arrays[i]);
+      blobs.push_back(host[i]);
+      if (from_cpu) {
+        mutable_vars.push_back(arrays[i].var());
+      } else {
+        const_vars.push_back(arrays[i].var());
+      }
+    }
+    Engine::Get()->DeduplicateVarHandle(&const_vars, &mutable_vars);
+    if (ctx.dev_mask() == cpu::kDevMask) {
+      Engine::Get()->PushSync([nds, blobs, from_cpu](RunContext rctx) {
+          for (size_t k = 0; k < nds.size(); ++k) {
+            TBlob arr = nds[k].data();
+            TBlob blob = blobs[k];
+            if (from_cpu) {
+              ndarray::Copy<cpu, cpu>(blob, &arr, Context::CPU(), Context::CPU(), rctx);
+            } else {
+              ndarray::Copy<cpu, cpu>(arr, &blob, Context::CPU(), Context::CPU(), rctx);
+            }
+          }
+        }, ctx, const_vars, mutable_vars, FnProperty::kNormal, 0,
+        from_cpu ? PROFILER_MESSAGE("AsyncCopyFromCPU") : PROFILER_MESSAGE("AsyncCopyToCPU"));
+    } else {
+#if MXNET_USE_CUDA
+      Engine::Get()->PushSync([nds, blobs, from_cpu, ctx](RunContext rctx) {
+          for (size_t k = 0; k < nds.size(); ++k) {
+            TBlob arr = nds[k].data();
+            TBlob blob = blobs[k];
+            if (from_cpu) {
+              ndarray::Copy<cpu, gpu>(blob, &arr, Context::CPU(), ctx, rctx);
+            } else {
+              ndarray::Copy<gpu, cpu>(arr, &blob, ctx, Context::CPU(), rctx);
+            }
+          }
+          // Wait GPU kernel to complete
+          rctx.get_stream<gpu>()->Wait();
+        }, ctx, const_vars, mutable_vars,
+        from_cpu ? FnProperty::kCopyToGPU : FnProperty::kCopyFromGPU, 0,
+        from_cpu ? PROFILER_MESSAGE("AsyncCopyCPU2GPU") : PROFILER_MESSAGE("AsyncCopyGPU2CPU"));
+#else
+      LOG(FATAL) << "GPU is not enabled";
+#endif
+    }
+  }
+}
+}  // namespace
+
+Engine::VarHandle NDArray::AsyncCopyFromCPU(const std::vector<NDArray>& arrays,
+                                            const std::vector<const void*>& data,
+                                            const std::vector<size_t>& sizes) {
+  CHECK_EQ(arrays.size(), data.size());
+  CHECK_EQ(arrays.size(), sizes.size());
+  std::vector<TBlob> host;
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    TShape dshape = arrays[i].shape();
+    CHECK_EQ(dshape.Size(), sizes[i])
+        << "Memory size do not match";
+    host.emplace_back(const_cast<void*>(data[i]), dshape, cpu::kDevMask, arrays[i].dtype(), 0);
+  }
+  Engine::VarHandle done = Engine::Get()->NewVariable();
+  PushBatchCopy(arrays, host, true, done);
+  return done;
+}
+
+Engine::VarHandle NDArray::AsyncCopyToCPU(const std::vector<NDArray>& arrays,
+                                          const std::vector<void*>& data,
+                                          const std::vector<size_t>& sizes) {
+  CHECK_EQ(arrays.size(), data.size());
+  CHECK_EQ(arrays.size(), sizes.size());
+  std::vector<TBlob> host;
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    TShape dshape = arrays[i].shape();
+    CHECK_EQ(dshape.Size(), sizes[i])
+        << "Memory size do not match";
+    host.emplace_back(data[i], dshape, cpu::kDevMask, arrays[i].dtype(), 0);
+  }
+  Engine::VarHandle done = Engine::Get()->NewVariable();
+  PushBatchCopy(arrays, host, false, done);
+  return done;
+}
+
+void NDArray::WaitCopy(Engine::VarHandle handle) {
+  Engine::Get()->WaitForVar(handle);
+  Engine::Get()->DeleteVariable([](RunContext ctx) {}, Context::CPU(), handle);
+}
+
+namespace {
+/*! \brief owner of an exported DLManagedTensor, keeps the array alive */
+struct NDArrayDLManager {
+  NDArray handle;
+  DLManagedTensor tensor;
+};
+}  // namespace
+
+DLManagedTensor* NDArray::ToDLPack() const {
+  CHECK(!is_none()) << "Cannot export an empty NDArray";
+  NDArrayDLManager* manager = new NDArrayDLManager();
+  manager->handle = *this;
+  // the shape of the DLTensor points into the TBlob of the copy, which
+  // is not modified as long as the manager lives.
+  manager->tensor.dl_tensor = manager->handle.data().dltensor();
+  manager->tensor.manager_ctx = manager;
+  manager->tensor.deleter = [](DLManagedTensor* tensor) {
+    delete static_cast<NDArrayDLManager*>(tensor->manager_ctx);
+  };
+  return &(manager->tensor);
+}
+
+NDArray NDArray::FromDLPack(DLManagedTensor* tensor) {
+  CHECK(tensor != nullptr);
+  return NDArray(TBlob(tensor->dl_tensor), tensor->dl_tensor.ctx.device_id, [tensor]() {
+      if (tensor->deleter != nullptr) tensor->deleter(tensor);
+    });
+}
+
 #if MXNET_PREDICT_ONLY == 0
 // register API function
 // those with underscore will be registered at NDArray
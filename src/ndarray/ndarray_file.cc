@@ -0,0 +1,417 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file ndarray_file.cc
+ * \brief indexed file format of NDArray lists, with loading of a subset
+ *  of the arrays and parallel loading of large arrays.
+ */
+#include <dmlc/io.h>
+#include <dmlc/memory_io.h>
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <mxnet/base.h>
+#include <mxnet/ndarray.h>
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "./ndarray_file.h"
+
+namespace mxnet {
+namespace ndarray_file {
+namespace {
+
+/*! \brief the arrays have names */
+const uint64_t kNamedFlag = 1;
+/*! \brief size of the fixed part of the header */
+const uint64_t kHeaderSize = 6 * sizeof(uint64_t);
+/*! \brief size of the pieces a large array is read in */
+const uint64_t kLoadChunkSize = 16 << 20;
+
+inline uint64_t Align(uint64_t pos) {
+  return (pos + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+/*! \brief entry of the index of an array */
+struct IndexEntry {
+  std::string name;
+  /*! \brief type flag, -1 for an empty array */
+  int32_t dtype{-1};
+  /*! \brief context the array was saved from */
+  int32_t dev_type{Context::kCPU};
+  int32_t dev_id{0};
+  /*! \brief Codec of the stored data */
+  int32_t codec{kRaw};
+  TShape shape;
+  /*! \brief offset of the stored data from the start of the file */
+  uint64_t offset{0};
+  uint64_t stored_size{0};
+  uint64_t raw_size{0};
+
+  void Save(dmlc::Stream* strm) const {
+    strm->Write(name);
+    strm->Write(dtype);
+    strm->Write(dev_type);
+    strm->Write(dev_id);
+    strm->Write(codec);
+    shape.Save(strm);
+    strm->Write(offset);
+    strm->Write(stored_size);
+    strm->Write(raw_size);
+  }
+  bool Load(dmlc::Stream* strm) {
+    return strm->Read(&name) && strm->Read(&dtype) && strm->Read(&dev_type) &&
+        strm->Read(&dev_id) && strm->Read(&codec) && shape.Load(strm) &&
+        strm->Read(&offset) && strm->Read(&stored_size) && strm->Read(&raw_size);
+  }
+};
+
+/*!
+ * \brief Group the bytes of the values by significance, then run-length
+ *  encode the zero bytes. The high bytes of float weights and the bytes of
+ *  sparse or quantized arrays are mostly zero.
+ *
+ *  A control byte c < 128 is followed by c + 1 literal bytes,
+ *  a control byte c >= 128 stands for c - 127 zero bytes.
+ */
+std::string ShuffleRLEEncode(const char* src, size_t size, size_t type_size) {
+  const size_t num = size / type_size;
+  std::string shuffled(size, 0);
+  for (size_t b = 0; b < type_size; ++b) {
+    for (size_t i = 0; i < num; ++i) shuffled[b * num + i] = src[i * type_size + b];
+  }
+  std::string out;
+  size_t i = 0;
+  while (i < size && out.size() < size) {
+    size_t zeros = 0;
+    while (i + zeros < size && zeros < 128 && shuffled[i + zeros] == 0) ++zeros;
+    if (zeros >= 2) {
+      out.push_back(static_cast<char>(127 + zeros));
+      i += zeros;
+      continue;
+    }
+    // literal bytes, up to the next run of zeros
+    size_t len = 0;
+    while (i + len < size && len < 128 &&
+           !(shuffled[i + len] == 0 && i + len + 1 < size && shuffled[i + len + 1] == 0)) {
+      ++len;
+    }
+    out.push_back(static_cast<char>(len - 1));
+    out.append(shuffled, i, len);
+    i += len;
+  }
+  return out;
+}
+
+bool ShuffleRLEDecode(const char* src, size_t stored_size,
+                      char* dst, size_t size, size_t type_size) {
+  std::string shuffled(size, 0);
+  size_t i = 0, j = 0;
+  while (i < stored_size) {
+    const unsigned char c = static_cast<unsigned char>(src[i++]);
+    if (c >= 128) {
+      j += c - 127;
+      if (j > size) return false;
+    } else {
+      const size_t len = c + 1;
+      if (i + len > stored_size || j + len > size) return false;
+      std::memcpy(&shuffled[j], src + i, len);
+      i += len;
+      j += len;
+    }
+  }
+  if (j != size) return false;
+  const size_t num = size / type_size;
+  for (size_t b = 0; b < type_size; ++b) {
+    for (size_t k = 0; k < num; ++k) dst[k * type_size + b] = shuffled[b * num + k];
+  }
+  return true;
+}
+
+bool DecodeEntry(const IndexEntry& e, const char* src, char* dst) {
+  switch (e.codec) {
+    case kShuffleRLE:
+      return ShuffleRLEDecode(src, e.stored_size, dst, e.raw_size,
+                              TypeSize(e.dtype));
+    default:
+      LOG(FATAL) << "Unknown codec " << e.codec << " in NDArray file";
+  }
+  return false;
+}
+
+/*! \brief read the header after the magic number, and the index */
+bool ReadIndex(dmlc::Stream* fi, std::vector<IndexEntry>* index,
+               bool* named, uint64_t* pos) {
+  uint64_t version, flags, alignment, num, index_size;
+  if (!(fi->Read(&version) && fi->Read(&flags) && fi->Read(&alignment) &&
+        fi->Read(&num) && fi->Read(&index_size))) {
+    return false;
+  }
+  CHECK_LE(version, kVersion)
+      << "NDArray file was written by a newer version of MXNet";
+  std::string index_str(index_size, 0);
+  if (fi->Read(dmlc::BeginPtr(index_str), index_size) != index_size) return false;
+  dmlc::MemoryFixedSizeStream strm(dmlc::BeginPtr(index_str), index_size);
+  index->resize(num);
+  for (IndexEntry& e : *index) {
+    if (!e.Load(&strm)) return false;
+    if (e.dtype != -1 && e.raw_size != e.shape.Size() * TypeSize(e.dtype)) {
+      return false;
+    }
+    if (e.codec == kRaw && e.stored_size != e.raw_size) return false;
+  }
+  *named = (flags & kNamedFlag) != 0;
+  *pos = kHeaderSize + index_size;
+  return true;
+}
+
+/*! \brief array in CPU memory the entry is read into */
+NDArray AllocHost(const IndexEntry& e) {
+  if (e.dtype == -1) return NDArray();
+  return NDArray(e.shape, Context::CPU(), false, e.dtype);
+}
+
+/*! \brief move a loaded array to the context it was saved from, as the legacy format does */
+NDArray ToSavedContext(NDArray host, const IndexEntry& e) {
+  if (host.is_none()) return host;
+  Context ctx = Context::Create(static_cast<Context::DeviceType>(e.dev_type), e.dev_id);
+  if (ctx.dev_mask() == cpu::kDevMask) return host;
+#if MXNET_USE_CUDA
+  return host.Copy(ctx);
+#else
+  return host;
+#endif
+}
+
+}  // namespace
+
+void LoadIndexed(dmlc::Stream* fi,
+                 std::vector<NDArray>* data,
+                 std::vector<std::string>* keys) {
+  std::vector<IndexEntry> index;
+  bool named;
+  uint64_t pos;
+  CHECK(ReadIndex(fi, &index, &named, &pos)) << "Invalid NDArray file format";
+  data->resize(index.size());
+  keys->clear();
+  std::string buf;
+  for (size_t i = 0; i < index.size(); ++i) {
+    const IndexEntry& e = index[i];
+    CHECK_GE(e.offset, pos) << "Invalid NDArray file format";
+    // skip the padding
+    buf.resize(e.offset - pos);
+    CHECK_EQ(fi->Read(dmlc::BeginPtr(buf), buf.size()), buf.size())
+        << "Invalid NDArray file format";
+    NDArray host = AllocHost(e);
+    if (!host.is_none()) {
+      char* dst = static_cast<char*>(host.data().dptr_);
+      if (e.codec == kRaw) {
+        CHECK_EQ(fi->Read(dst, e.stored_size), e.stored_size) << "Invalid NDArray file format";
+      } else {
+        buf.resize(e.stored_size);
+        CHECK_EQ(fi->Read(dmlc::BeginPtr(buf), buf.size()), buf.size())
+            << "Invalid NDArray file format";
+        CHECK(DecodeEntry(e, buf.data(), dst)) << "Invalid NDArray file format";
+      }
+    }
+    pos = e.offset + e.stored_size;
+    (*data)[i] = ToSavedContext(host, e);
+    if (named) keys->push_back(e.name);
+  }
+}
+
+}  // namespace ndarray_file
+
+void NDArray::SaveIndexed(dmlc::Stream* fo,
+                          const std::vector<NDArray>& data,
+                          const std::vector<std::string>& names,
+                          bool compress) {
+  using namespace ndarray_file;
+  CHECK(names.size() == 0 || names.size() == data.size())
+      << "Number of names must match the number of arrays";
+  const size_t num = data.size();
+  std::vector<IndexEntry> index(num);
+  std::vector<NDArray> host(num);
+  for (size_t i = 0; i < num; ++i) {
+    IndexEntry& e = index[i];
+    if (names.size() != 0) e.name = names[i];
+    if (data[i].is_none()) continue;
+    const Context ctx = data[i].ctx();
+    e.dtype = data[i].dtype();
+    e.dev_type = ctx.dev_type;
+    e.dev_id = ctx.dev_id;
+    e.shape = data[i].shape();
+    e.raw_size = e.shape.Size() * TypeSize(e.dtype);
+    host[i] = ctx.dev_mask() == cpu::kDevMask ? data[i] : data[i].Copy(Context::CPU());
+  }
+  std::vector<const char*> src(num, nullptr);
+  for (size_t i = 0; i < num; ++i) {
+    if (host[i].is_none()) continue;
+    host[i].WaitToRead();
+    CHECK(host[i].data().CheckContiguous());
+    src[i] = static_cast<const char*>(host[i].data().dptr_);
+  }
+  // an array is kept compressed only if that saves space
+  std::vector<std::string> encoded(num);
+  if (compress) {
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < static_cast<int>(num); ++i) {
+      if (index[i].raw_size == 0) continue;
+      std::string out = ShuffleRLEEncode(src[i], index[i].raw_size,
+                                         TypeSize(index[i].dtype));
+      if (out.size() < index[i].raw_size) encoded[i].swap(out);
+    }
+  }
+  for (size_t i = 0; i < num; ++i) {
+    IndexEntry& e = index[i];
+    e.codec = encoded[i].size() != 0 ? kShuffleRLE : kRaw;
+    e.stored_size = e.codec == kRaw ? e.raw_size : encoded[i].size();
+  }
+  // offsets are fixed size, so the index has the same size before and after
+  // they are assigned
+  std::string index_str;
+  auto write_index = [&index, &index_str]() {
+    index_str.clear();
+    dmlc::MemoryStringStream strm(&index_str);
+    for (const IndexEntry& e : index) e.Save(&strm);
+  };
+  write_index();
+  uint64_t offset = Align(kHeaderSize + index_str.size());
+  for (IndexEntry& e : index) {
+    e.offset = offset;
+    offset = Align(offset + e.stored_size);
+  }
+  write_index();
+
+  const uint64_t flags = names.size() != 0 ? kNamedFlag : 0;
+  fo->Write(kMXAPINDArrayIndexedMagic);
+  fo->Write(kVersion);
+  fo->Write(flags);
+  fo->Write(kAlignment);
+  fo->Write(static_cast<uint64_t>(num));
+  fo->Write(static_cast<uint64_t>(index_str.size()));
+  fo->Write(index_str.data(), index_str.size());
+  uint64_t pos = kHeaderSize + index_str.size();
+  const std::vector<char> padding(kAlignment, 0);
+  for (size_t i = 0; i < num; ++i) {
+    const IndexEntry& e = index[i];
+    fo->Write(padding.data(), e.offset - pos);
+    if (e.codec == kRaw) {
+      fo->Write(src[i], e.stored_size);
+    } else {
+      fo->Write(encoded[i].data(), e.stored_size);
+    }
+    pos = e.offset + e.stored_size;
+  }
+}
+
+void NDArray::Load(const std::string& fname,
+                   const std::vector<std::string>& select,
+                   std::vector<NDArray>* data,
+                   std::vector<std::string>* keys) {
+  using namespace ndarray_file;
+  std::unique_ptr<dmlc::SeekStream> fi(dmlc::SeekStream::CreateForRead(fname.c_str()));
+  uint64_t magic;
+  CHECK(fi->Read(&magic)) << "Invalid NDArray file format";
+  if (magic != kMXAPINDArrayIndexedMagic) {
+    // legacy format, all the arrays are read
+    fi->Seek(0);
+    Load(fi.get(), data, keys);
+    if (select.size() == 0) return;
+    CHECK_EQ(keys->size(), data->size())
+        << "Cannot select arrays by name in a file without names";
+    std::unordered_map<std::string, NDArray> loaded;
+    for (size_t i = 0; i < keys->size(); ++i) loaded[(*keys)[i]] = (*data)[i];
+    data->clear();
+    for (const std::string& name : select) {
+      auto it = loaded.find(name);
+      CHECK(it != loaded.end()) << "Cannot find array " << name << " in " << fname;
+      data->push_back(it->second);
+    }
+    *keys = select;
+    return;
+  }
+
+  std::vector<IndexEntry> index;
+  bool named;
+  uint64_t pos;
+  CHECK(ReadIndex(fi.get(), &index, &named, &pos)) << "Invalid NDArray file format";
+  std::vector<size_t> chosen;
+  if (select.size() == 0) {
+    for (size_t i = 0; i < index.size(); ++i) chosen.push_back(i);
+  } else {
+    CHECK(named) << "Cannot select arrays by name in a file without names";
+    std::unordered_map<std::string, size_t> position;
+    for (size_t i = 0; i < index.size(); ++i) position[index[i].name] = i;
+    for (const std::string& name : select) {
+      auto it = position.find(name);
+      CHECK(it != position.end()) << "Cannot find array " << name << " in " << fname;
+      chosen.push_back(it->second);
+    }
+  }
+  std::vector<NDArray> host(chosen.size());
+  std::vector<char*> dst(chosen.size(), nullptr);
+  for (size_t k = 0; k < chosen.size(); ++k) {
+    host[k] = AllocHost(index[chosen[k]]);
+    if (!host[k].is_none()) dst[k] = static_cast<char*>(host[k].data().dptr_);
+  }
+  // raw arrays are read in pieces, so that a large array is read by several
+  // threads. Compressed arrays are read and decoded as a whole.
+  struct Piece {
+    size_t k;
+    uint64_t begin, size;
+  };
+  std::vector<Piece> pieces;
+  for (size_t k = 0; k < chosen.size(); ++k) {
+    const IndexEntry& e = index[chosen[k]];
+    if (e.codec == kRaw) {
+      for (uint64_t begin = 0; begin < e.stored_size; begin += kLoadChunkSize) {
+        pieces.push_back(Piece{k, begin, std::min(kLoadChunkSize, e.stored_size - begin)});
+      }
+    } else {
+      pieces.push_back(Piece{k, 0, e.stored_size});
+    }
+  }
+  const int nthread = std::max(1, std::min(dmlc::GetEnv("MXNET_NDARRAY_LOAD_NTHREADS", 4),
+                                           static_cast<int>(pieces.size())));
+  std::exception_ptr error = nullptr;
+  std::mutex error_mutex;
+  #pragma omp parallel num_threads(nthread)
+  {
+    std::unique_ptr<dmlc::SeekStream> strm;
+    std::string buf;
+    #pragma omp for schedule(dynamic)
+    for (int j = 0; j < static_cast<int>(pieces.size()); ++j) {
+      try {
+        if (strm == nullptr) strm.reset(dmlc::SeekStream::CreateForRead(fname.c_str()));
+        const Piece& p = pieces[j];
+        const IndexEntry& e = index[chosen[p.k]];
+        strm->Seek(e.offset + p.begin);
+        if (e.codec == kRaw) {
+          CHECK_EQ(strm->Read(dst[p.k] + p.begin, p.size), p.size)
+              << "Invalid NDArray file format";
+        } else {
+          buf.resize(p.size);
+          CHECK_EQ(strm->Read(dmlc::BeginPtr(buf), p.size), p.size)
+              << "Invalid NDArray file format";
+          CHECK(DecodeEntry(e, buf.data(), dst[p.k])) << "Invalid NDArray file format";
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (error == nullptr) error = std::current_exception();
+      }
+    }
+  }
+  if (error != nullptr) std::rethrow_exception(error);
+  data->resize(chosen.size());
+  keys->clear();
+  for (size_t k = 0; k < chosen.size(); ++k) {
+    (*data)[k] = ToSavedContext(host[k], index[chosen[k]]);
+    if (named) keys->push_back(index[chosen[k]].name);
+  }
+}
+
+}  // namespace mxnet
@@ -0,0 +1,54 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file ndarray_file.h
+ * \brief indexed file format of NDArray lists
+ *
+ *  Layout of the file, all integers are little endian:
+ *
+ *    uint64 magic, kMXAPINDArrayIndexedMagic
+ *    uint64 version of the format
+ *    uint64 flags, bit 0 set when the arrays are named
+ *    uint64 alignment of the data of each array
+ *    uint64 number of arrays
+ *    uint64 size of the index in bytes
+ *    index: for each array, IndexEntry::Save
+ *    padding to the alignment
+ *    data of each array at its offset, padded to the alignment
+ */
+#ifndef MXNET_NDARRAY_NDARRAY_FILE_H_
+#define MXNET_NDARRAY_NDARRAY_FILE_H_
+
+#include <dmlc/io.h>
+#include <mxnet/ndarray.h>
+#include <string>
+#include <vector>
+
+namespace mxnet {
+namespace ndarray_file {
+
+/*! \brief magic number of the indexed format, the legacy format uses 0x112 */
+const uint64_t kMXAPINDArrayIndexedMagic = 0x113;
+/*! \brief version of the indexed format */
+const uint64_t kVersion = 2;
+/*! \brief alignment of the data of each array, relative to the start of the file */
+const uint64_t kAlignment = 64;
+
+/*! \brief how the data of an array is stored */
+enum Codec {
+  /*! \brief raw bytes */
+  kRaw = 0,
+  /*! \brief bytes grouped by significance, then run-length encoding of zero bytes */
+  kShuffleRLE = 1
+};
+
+/*!
+ * \brief Load the rest of an indexed file after its magic number,
+ *  reading the stream sequentially.
+ */
+void LoadIndexed(dmlc::Stream* fi,
+                 std::vector<NDArray>* data,
+                 std::vector<std::string>* keys);
+
+}  // namespace ndarray_file
+}  // namespace mxnet
+#endif  // MXNET_NDARRAY_NDARRAY_FILE_H_
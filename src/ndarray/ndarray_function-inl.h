@@ -8,6 +8,7 @@
 
 #include <vector>
 #include "./ndarray_function.h"
+#include "../operator/tensor/elemwise_sum.h"
 // this file will be included twice by CPU and GPU
 // macro to help specialize evaluation function
 
@@ -351,7 +352,7 @@ void EvalRandom<DEVICE, GenNegBinomialDistribution>(
 template<>
 void Eval<DEVICE>(const real_t &rhs, TBlob *ret, RunContext ctx) {
   mshadow::Stream<DEVICE> *s = ctx.get_stream<DEVICE>();
-  MSHADOW_TYPE_SWITCH(ret->type_flag_, DType, {
+  MXNET_TYPE_SWITCH_WITH_BF16(ret->type_flag_, DType, {
     ret->FlatTo2D<DEVICE, DType>(s) = DType(rhs);
   });
 }
@@ -369,6 +370,13 @@ void ElementwiseSum<DEVICE>(const std::vector<TBlob> source,
       << "Only support input/output with the same data type";
   }
   MSHADOW_TYPE_SWITCH(dst->type_flag_, DType, {
+    if (source.size() > 2) {
+      std::vector<const DType*> in_dptrs;
+      for (const TBlob& in : source) in_dptrs.push_back(in.dptr<DType>());
+      if (op::ElementwiseSumBlocked(s, in_dptrs, dst->dptr<DType>(), dst->Size(), kWriteTo)) {
+        return;
+      }
+    }
     Tensor<xpu, 2, DType> out = dst->FlatTo2D<xpu, DType>(s);
 
     switch (source.size()) {
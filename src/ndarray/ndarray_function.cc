@@ -5,8 +5,10 @@
  */
 
 // this will be invoked by gcc and compile CPU version
+#include <cstring>
 #include "./ndarray_function.h"
 #include "./ndarray_function-inl.h"
+#include "../operator/half_cpu.h"
 
 namespace mxnet {
 namespace ndarray {
@@ -14,6 +16,36 @@ template<>
 void Copy<cpu, cpu>(const TBlob &from, TBlob *to,
                     Context from_ctx, Context to_ctx,
                     RunContext ctx) {
+  using op::half_cpu::half_t;
+  // float32 weights converted to float16 or bfloat16 on load, and back
+  if (from.type_flag_ == mshadow::kFloat32 && op::half_cpu::IsHalfType(to->type_flag_)) {
+    MXNET_HALF_TYPE_SWITCH(to->type_flag_, DType, {
+      op::half_cpu::FloatToHalfParallel(from.dptr<float>(), to->dptr<DType>(), from.Size());
+    });
+    return;
+  }
+  if (op::half_cpu::IsHalfType(from.type_flag_) && to->type_flag_ == mshadow::kFloat32) {
+    MXNET_HALF_TYPE_SWITCH(from.type_flag_, DType, {
+      op::half_cpu::HalfToFloatParallel(from.dptr<DType>(), to->dptr<float>(), from.Size());
+    });
+    return;
+  }
+  if (from.type_flag_ == kBfloat16 || to->type_flag_ == kBfloat16) {
+    if (from.type_flag_ == to->type_flag_) {
+      std::memcpy(to->dptr_, from.dptr_, from.Size() * sizeof(bf16_t));
+      return;
+    }
+    // the other types convert through float32
+    MXNET_TYPE_SWITCH_WITH_BF16(to->type_flag_, DType, {
+      MXNET_TYPE_SWITCH_WITH_BF16(from.type_flag_, SrcDType, {
+        const SrcDType* src = from.dptr<SrcDType>();
+        DType* dst = to->dptr<DType>();
+        const index_t size = from.Size();
+        for (index_t i = 0; i < size; ++i) dst[i] = DType(static_cast<float>(src[i]));
+      });
+    });
+    return;
+  }
   MSHADOW_TYPE_SWITCH(to->type_flag_, DType, {
     if (to->type_flag_ == from.type_flag_) {
         mshadow::Copy(to->FlatTo1D<cpu, DType>(),
@@ -17,7 +17,7 @@ void Copy<cpu, gpu>(const TBlob &from, TBlob *to,
                     RunContext ctx) {
   CHECK_EQ(to->type_flag_, from.type_flag_)
     << "Source and target must have the same data type when copying across devices.";
-  MSHADOW_TYPE_SWITCH(to->type_flag_, DType, {
+  MXNET_TYPE_SWITCH_WITH_BF16(to->type_flag_, DType, {
     mshadow::Copy(to->FlatTo1D<gpu, DType>(),
                   from.FlatTo1D<cpu, DType>(),
                   ctx.get_stream<gpu>());
@@ -30,7 +30,7 @@ void Copy<gpu, cpu>(const TBlob &from, TBlob *to,
                     RunContext ctx) {
   CHECK_EQ(to->type_flag_, from.type_flag_)
     << "Source and target must have the same data type when copying across devices.";
-  MSHADOW_TYPE_SWITCH(to->type_flag_, DType, {
+  MXNET_TYPE_SWITCH_WITH_BF16(to->type_flag_, DType, {
     mshadow::Copy(to->FlatTo1D<cpu, DType>(),
                   from.FlatTo1D<gpu, DType>(),
                   ctx.get_stream<gpu>());
@@ -66,7 +66,7 @@ void Copy<gpu, gpu>(const TBlob &from, TBlob *to,
                         to_ctx.dev_id,
                         from.dptr_,
                         from_ctx.dev_id,
-                        from.shape_.Size() * mshadow::mshadow_sizeof(to->type_flag_),
+                        from.shape_.Size() * TypeSize(to->type_flag_),
                         s->stream_);
   }
 }
@@ -6,6 +6,7 @@
 */
 #include "./activation-inl.h"
 #include "./mshadow_op.h"
+#include "./half_cpu_op.h"
 #if MXNET_USE_MKL2017 == 1
 #include <mkl_memory.h>
 #include "./mkl/mkl_memory-inl.h"
@@ -17,6 +18,10 @@ namespace op {
 template<>
 Operator *CreateOp<cpu>(ActivationParam param, int dtype, const TShape& dshape) {
   Operator *op = NULL;
+  if (half_cpu::IsHalfType(dtype)) {
+    // float16 or bfloat16 storage, float32 compute
+    return new HalfCPUOp(CreateOp<cpu>(param, mshadow::kFloat32, dshape));
+  }
 #if MXNET_USE_MKL2017 == 1
   if (param.act_type == activation::kReLU && dshape.ndim() <= 4) {
       switch (dtype) {
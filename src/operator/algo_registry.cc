@@ -0,0 +1,105 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file algo_registry.cc
+ * \brief registry of the implementations chosen by operators
+*/
+#include "./algo_registry.h"
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
+
+namespace mxnet {
+namespace op {
+
+namespace {
+/*! \brief first line of the files, for the entries of later formats to be ignored */
+const char kHeader[] = "# mxnet algorithm registry 1";
+
+/*!
+ * \brief read the entries of a file into reg, where they are not there already.
+ *  Each line is a key, a tab and the integers of the entry separated by spaces.
+ */
+bool ReadEntries(const std::string &fname,
+                 std::unordered_map<std::string, std::vector<int> > *reg) {
+  std::ifstream is(fname);
+  if (!is) return false;
+  std::string line;
+  if (!std::getline(is, line) || line != kHeader) {
+    LOG(WARNING) << "Ignoring " << fname << ", it is not an algorithm registry file";
+    return false;
+  }
+  while (std::getline(is, line)) {
+    const size_t tab = line.rfind('\t');
+    if (tab == std::string::npos || tab == 0) continue;
+    std::istringstream values(line.substr(tab + 1));
+    std::vector<int> algo;
+    int v;
+    while (values >> v) algo.push_back(v);
+    if (algo.empty()) continue;
+    reg->emplace(line.substr(0, tab), algo);
+  }
+  return true;
+}
+}  // namespace
+
+AlgoRegistry::AlgoRegistry() : file_(dmlc::GetEnv("MXNET_AUTOTUNE_FILE", std::string())) {
+  if (!file_.empty()) Load(file_);
+}
+
+AlgoRegistry::~AlgoRegistry() {
+  if (!file_.empty() && changed_) Save(file_);
+}
+
+AlgoRegistry *AlgoRegistry::Get() {
+  static AlgoRegistry inst;
+  return &inst;
+}
+
+bool AlgoRegistry::Load(const std::string &fname) {
+  std::unordered_map<std::string, std::vector<int> > reg;
+  if (!ReadEntries(fname, &reg)) return false;
+  std::lock_guard<std::mutex> guard(lock_);
+  for (auto &kv : reg) reg_.emplace(kv.first, kv.second);
+  if (!reg_.empty()) empty_ = false;
+  return true;
+}
+
+bool AlgoRegistry::Save(const std::string &fname) {
+  std::unordered_map<std::string, std::vector<int> > reg;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    reg = reg_;
+  }
+  // keep what other processes saved since this one started
+  ReadEntries(fname, &reg);
+  std::map<std::string, std::vector<int> > sorted(reg.begin(), reg.end());
+  // written aside and renamed, so that readers never see a partial file
+  const std::string tmp = fname + ".tmp" + std::to_string(std::random_device()());
+  {
+    std::ofstream os(tmp);
+    os << kHeader << '\n';
+    for (auto &kv : sorted) {
+      os << kv.first << '\t';
+      for (size_t i = 0; i < kv.second.size(); ++i) {
+        os << (i ? " " : "") << kv.second[i];
+      }
+      os << '\n';
+    }
+    if (!os) {
+      LOG(WARNING) << "Failed to write the algorithm registry to " << tmp;
+      std::remove(tmp.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp.c_str(), fname.c_str()) != 0) {
+    LOG(WARNING) << "Failed to write the algorithm registry to " << fname;
+    std::remove(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace op
+}  // namespace mxnet
@@ -0,0 +1,116 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file algo_registry.h
+ * \brief registry of the implementations chosen by operators that have several,
+ *  persisted across processes
+ */
+#ifndef MXNET_OPERATOR_ALGO_REGISTRY_H_
+#define MXNET_OPERATOR_ALGO_REGISTRY_H_
+
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mxnet {
+namespace op {
+
+/*!
+ * \brief Algorithms chosen by operators, keyed by a string that describes the
+ *  problem: operator, shapes, type and context. An entry is one or more
+ *  integers, such as the index of the fastest candidate implementation.
+ *
+ *  The entries are loaded at start and saved at exit from the file named by
+ *  MXNET_AUTOTUNE_FILE, so that a process starts with the choices made by the
+ *  ones before it. Operators only benchmark their candidates, with Tune, when
+ *  MXNET_CPU_AUTOTUNE is set, and otherwise use the registered choice or their
+ *  default.
+ */
+class AlgoRegistry {
+ public:
+  /*! \brief whether operators benchmark the candidates of unknown keys */
+  static bool Enabled() {
+    static const bool enabled = dmlc::GetEnv("MXNET_CPU_AUTOTUNE", false);
+    return enabled;
+  }
+
+  /*! \brief whether a lookup may find anything, to skip building keys otherwise */
+  bool Active() const { return Enabled() || !empty_; }
+
+  bool Find(const std::string &key, std::vector<int> *algo) {
+    std::lock_guard<std::mutex> guard(lock_);
+    auto it = reg_.find(key);
+    if (it == reg_.end()) return false;
+    *algo = it->second;
+    return true;
+  }
+
+  void Register(const std::string &key, const std::vector<int> &algo) {
+    std::lock_guard<std::mutex> guard(lock_);
+    reg_[key] = algo;
+    changed_ = true;
+    empty_ = false;
+  }
+
+  /*!
+   * \brief The candidate registered for key. An unknown key gets the fastest
+   *  of num_candidates candidates when tuning is enabled, timed by run(i) on
+   *  data the caller may overwrite, and fallback otherwise.
+   */
+  template<typename F>
+  int Tune(const std::string &key, int num_candidates, int fallback, F run) {
+    std::vector<int> algo;
+    if (Find(key, &algo) && algo.size() == 1 && algo[0] >= 0 && algo[0] < num_candidates) {
+      return algo[0];
+    }
+    if (!Enabled()) return fallback;
+    int best = fallback;
+    double best_time = std::numeric_limits<double>::max();
+    for (int i = 0; i < num_candidates; ++i) {
+      run(i);  // warm up
+      double time = std::numeric_limits<double>::max();
+      for (int r = 0; r < kRepeat; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        run(i);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        time = std::min(time, elapsed.count());
+      }
+      if (time < best_time) {
+        best_time = time;
+        best = i;
+      }
+    }
+    Register(key, {best});
+    return best;
+  }
+
+  /*! \brief add the entries of a file, keeping the ones already registered */
+  bool Load(const std::string &fname);
+  /*! \brief write the entries, and those of the file not registered here, to the file */
+  bool Save(const std::string &fname);
+
+  static AlgoRegistry *Get();
+
+ private:
+  /*! \brief timed runs of each candidate, the fastest is kept */
+  static const int kRepeat = 3;
+
+  AlgoRegistry();
+  ~AlgoRegistry();
+
+  std::mutex lock_;
+  std::unordered_map<std::string, std::vector<int> > reg_;
+  std::string file_;
+  std::atomic<bool> empty_{true};
+  bool changed_ = false;
+};
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_ALGO_REGISTRY_H_
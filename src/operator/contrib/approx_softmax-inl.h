@@ -0,0 +1,539 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file approx_softmax-inl.h
+ * \brief sampled and hierarchical softmax for large output vocabularies
+ */
+#ifndef MXNET_OPERATOR_CONTRIB_APPROX_SOFTMAX_INL_H_
+#define MXNET_OPERATOR_CONTRIB_APPROX_SOFTMAX_INL_H_
+
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <mxnet/operator_util.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_set>
+#include <vector>
+#include "../mshadow_op.h"
+#include "../operator_common.h"
+#include "../elemwise_op_common.h"
+#include "../random/sample_op.h"
+
+#ifndef MSHADOW_SGL_DBL_TYPE_SWITCH
+/*! \brief float32 and float64 only, the CPU dot of mshadow has no float16 version */
+#define MSHADOW_SGL_DBL_TYPE_SWITCH(type, DType, ...)  \
+  switch (type) {                                      \
+  case mshadow::kFloat32:                              \
+    {                                                  \
+      typedef float DType;                             \
+      {__VA_ARGS__}                                    \
+    }                                                  \
+    break;                                             \
+  case mshadow::kFloat64:                              \
+    {                                                  \
+      typedef double DType;                            \
+      {__VA_ARGS__}                                    \
+    }                                                  \
+    break;                                             \
+  default:                                             \
+    LOG(FATAL) << "This operation only supports "      \
+                  "32-bit and 64-bit floating point";  \
+  }
+#endif
+
+namespace mxnet {
+namespace op {
+
+namespace sampled_softmax {
+enum SampledSoftmaxInputs {kData, kWeight, kBias, kLabel};
+enum SampledSoftmaxOutputs {kLoss, kSamples, kProb};
+enum SampledSoftmaxBackwardInputs {kOutGrad, kInData, kInWeight, kInLabel, kInSamples, kInProb};
+enum SampledSoftmaxResource {kRandom, kTempSpace};
+}  // namespace sampled_softmax
+
+namespace hsoftmax {
+enum HierarchicalSoftmaxInputs {kData, kWeight, kBias, kLabel, kPath, kCode};
+}  // namespace hsoftmax
+
+struct SampledSoftmaxParam : public dmlc::Parameter<SampledSoftmaxParam> {
+  int num_classes;
+  int num_sampled;
+  bool remove_accidental_hits;
+  DMLC_DECLARE_PARAMETER(SampledSoftmaxParam) {
+    DMLC_DECLARE_FIELD(num_classes).set_lower_bound(2)
+    .describe("Number of classes, the rows of weight.");
+    DMLC_DECLARE_FIELD(num_sampled).set_lower_bound(1)
+    .describe("Number of distinct classes sampled for each batch.");
+    DMLC_DECLARE_FIELD(remove_accidental_hits).set_default(true)
+    .describe("Whether the sampled classes equal to the label of an example are left "
+              "out of the softmax of that example.");
+  }
+};
+
+struct HierarchicalSoftmaxParam : public dmlc::Parameter<HierarchicalSoftmaxParam> {
+  int num_classes;
+  DMLC_DECLARE_PARAMETER(HierarchicalSoftmaxParam) {
+    DMLC_DECLARE_FIELD(num_classes).set_lower_bound(2)
+    .describe("Number of classes, the leaves of the tree. weight has num_classes - 1 rows, "
+              "one for each inner node.");
+  }
+};
+
+/*!
+ * \brief dst[rows[e]] += coefs[e] * src[srcs[e]] and bias[rows[e]] += coefs[e]
+ *  for the entries e with rows[e] >= 0. The entries are grouped by row, so the
+ *  rows are updated in parallel without races, in a deterministic order, and
+ *  only the rows that appear in rows are touched. dst or bias may be null.
+ */
+template<typename DType>
+inline void AddScaledRows(const std::vector<int>& rows, const std::vector<int>& srcs,
+                          const std::vector<DType>& coefs, const DType* src, int dim,
+                          DType* dst, DType* bias) {
+  std::vector<int> order;
+  order.reserve(rows.size());
+  for (size_t e = 0; e < rows.size(); ++e) {
+    if (rows[e] >= 0) order.push_back(static_cast<int>(e));
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&rows](int a, int b) { return rows[a] < rows[b]; });
+  std::vector<int> starts;
+  for (size_t k = 0; k < order.size(); ++k) {
+    if (k == 0 || rows[order[k]] != rows[order[k - 1]]) starts.push_back(static_cast<int>(k));
+  }
+  starts.push_back(static_cast<int>(order.size()));
+  #pragma omp parallel for
+  for (int g = 0; g < static_cast<int>(starts.size()) - 1; ++g) {
+    const int row = rows[order[starts[g]]];
+    DType* d = dst ? dst + static_cast<int64_t>(row) * dim : nullptr;
+    for (int k = starts[g]; k < starts[g + 1]; ++k) {
+      const int e = order[k];
+      if (d) {
+        const DType* x = src + static_cast<int64_t>(srcs[e]) * dim;
+        for (int j = 0; j < dim; ++j) d[j] += coefs[e] * x[j];
+      }
+      if (bias) bias[row] += coefs[e];
+    }
+  }
+}
+
+template<typename DType>
+inline DType Dot(const DType* a, const DType* b, int n) {
+  DType sum = 0;
+  for (int j = 0; j < n; ++j) sum += a[j] * b[j];
+  return sum;
+}
+
+/*!
+ * \brief Draws distinct log-uniform classes of [0, range_max) until there are
+ *  num_sampled of them, from uniform samples drawn by blocks with prnd.
+ * \return number of classes drawn, including the repeated ones.
+ */
+inline int SampleUniqueLogUniform(mshadow::Random<cpu, float> *prnd, int num_sampled,
+                                  int range_max, std::vector<int>* samples) {
+  const float log_range = std::log(range_max + 1.0f);
+  std::vector<float> uniform(std::max(2 * num_sampled, 64));
+  mshadow::Tensor<cpu, 1, float> block(uniform.data(), mshadow::Shape1(uniform.size()));
+  std::unordered_set<int> seen;
+  samples->clear();
+  int tries = 0;
+  while (static_cast<int>(samples->size()) < num_sampled) {
+    prnd->SampleUniform(&block, 0, 1);
+    for (size_t k = 0; k < uniform.size() && static_cast<int>(samples->size()) < num_sampled;
+         ++k) {
+      ++tries;
+      const int c = LogUniformClass(uniform[k], log_range, range_max);
+      if (seen.insert(c).second) samples->push_back(c);
+    }
+  }
+  return tries;
+}
+
+/*!
+ * \brief log of the expected number of times class c is drawn by
+ *  SampleUniqueLogUniform when it draws num_tries classes.
+ */
+inline double LogExpectedCount(int c, int range_max, int num_tries) {
+  return std::log(-std::expm1(num_tries * std::log1p(-LogUniformProb(c, range_max))));
+}
+
+/*!
+ * \brief Sampled softmax forward. Row i of prob is the softmax of the logits
+ *  of label[i] and of the sampled classes, each corrected by the log of its
+ *  expected count, and loss[i] = -log(prob[i][0]). prob, which the backward
+ *  pass reads, is written even when req of the loss is kNullOp.
+ * \param log_q log expected counts of the sampled classes, then of the labels.
+ * \param workspace space for num_sampled * (dim + n) values.
+ */
+template<typename DType>
+inline void SampledSoftmaxForwardCPU(const mshadow::Tensor<cpu, 2, DType>& data,
+                                     const mshadow::Tensor<cpu, 2, DType>& weight,
+                                     const mshadow::Tensor<cpu, 1, DType>& bias,
+                                     const mshadow::Tensor<cpu, 1, DType>& label,
+                                     const std::vector<int>& samples,
+                                     const std::vector<double>& log_q,
+                                     bool remove_accidental_hits, DType* workspace,
+                                     const mshadow::Tensor<cpu, 2, DType>& prob,
+                                     DType* loss, OpReqType req) {
+  using namespace mshadow::expr;
+  const int n = data.size(0), dim = data.size(1), num_sampled = samples.size();
+  mshadow::Tensor<cpu, 2, DType> wsampled(workspace, mshadow::Shape2(num_sampled, dim));
+  mshadow::Tensor<cpu, 2, DType> logits(workspace + num_sampled * dim,
+                                        mshadow::Shape2(n, num_sampled));
+  for (int j = 0; j < num_sampled; ++j) mshadow::Copy(wsampled[j], weight[samples[j]]);
+  logits = dot(data, wsampled.T());
+  #pragma omp parallel for
+  for (int i = 0; i < n; ++i) {
+    const int l = static_cast<int>(label[i]);
+    DType* z = prob[i].dptr_;
+    z[0] = Dot(data[i].dptr_, weight[l].dptr_, dim) + bias[l] -
+           static_cast<DType>(log_q[num_sampled + i]);
+    DType zmax = z[0];
+    for (int j = 0; j < num_sampled; ++j) {
+      if (remove_accidental_hits && samples[j] == l) {
+        z[j + 1] = -std::numeric_limits<DType>::infinity();
+      } else {
+        z[j + 1] = logits[i][j] + bias[samples[j]] - static_cast<DType>(log_q[j]);
+        zmax = std::max(zmax, z[j + 1]);
+      }
+    }
+    DType sum = 0;
+    for (int j = 0; j <= num_sampled; ++j) {
+      z[j] = std::exp(z[j] - zmax);
+      sum += z[j];
+    }
+    for (int j = 0; j <= num_sampled; ++j) z[j] /= sum;
+    if (req == kNullOp) continue;
+    const DType value = -std::log(std::max(z[0], std::numeric_limits<DType>::min()));
+    loss[i] = req == kAddTo ? loss[i] + value : value;
+  }
+}
+
+/*!
+ * \brief Sampled softmax backward. With dz = ograd * (prob - one_hot(0)), the
+ *  gradient of data is computed with a product by the sampled rows of weight,
+ *  and only the rows of the weight and bias gradients of the labels and of the
+ *  sampled classes are written, the others being zeroed when req is kWriteTo.
+ * \param workspace space for num_sampled * (2 * dim + n) values.
+ */
+template<typename DType>
+inline void SampledSoftmaxBackwardCPU(const mshadow::Tensor<cpu, 1, DType>& ograd,
+                                      const mshadow::Tensor<cpu, 2, DType>& data,
+                                      const mshadow::Tensor<cpu, 2, DType>& weight,
+                                      const mshadow::Tensor<cpu, 1, DType>& label,
+                                      const std::vector<int>& samples,
+                                      const mshadow::Tensor<cpu, 2, DType>& prob,
+                                      DType* workspace,
+                                      mshadow::Tensor<cpu, 2, DType> gdata,
+                                      mshadow::Tensor<cpu, 2, DType> gweight,
+                                      mshadow::Tensor<cpu, 1, DType> gbias,
+                                      const std::vector<OpReqType>& req) {
+  using namespace mshadow::expr;
+  using namespace sampled_softmax;
+  const int n = data.size(0), dim = data.size(1), num_sampled = samples.size();
+  mshadow::Tensor<cpu, 2, DType> wsampled(workspace, mshadow::Shape2(num_sampled, dim));
+  mshadow::Tensor<cpu, 2, DType> dz(workspace + num_sampled * dim,
+                                    mshadow::Shape2(n, num_sampled));
+  mshadow::Tensor<cpu, 2, DType> gsampled(workspace + num_sampled * (dim + n),
+                                          mshadow::Shape2(num_sampled, dim));
+  std::vector<int> rows(n), srcs(n);
+  std::vector<DType> dz_label(n);
+  for (int j = 0; j < num_sampled; ++j) mshadow::Copy(wsampled[j], weight[samples[j]]);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < num_sampled; ++j) dz[i][j] = ograd[i] * prob[i][j + 1];
+    rows[i] = static_cast<int>(label[i]);
+    srcs[i] = i;
+    dz_label[i] = ograd[i] * (prob[i][0] - DType(1));
+  }
+  if (req[kData] != kNullOp) {
+    Assign(gdata, req[kData], dot(dz, wsampled));
+    #pragma omp parallel for
+    for (int i = 0; i < n; ++i) {
+      const DType* w = weight[rows[i]].dptr_;
+      for (int j = 0; j < dim; ++j) gdata[i][j] += dz_label[i] * w[j];
+    }
+  }
+  const bool write_weight = req[kWeight] != kNullOp, write_bias = req[kBias] != kNullOp;
+  if (write_weight && req[kWeight] != kAddTo) gweight = DType(0);
+  if (write_bias && req[kBias] != kAddTo) gbias = DType(0);
+  if (write_weight) gsampled = dot(dz.T(), data);
+  // the sampled classes are distinct, their rows are updated in parallel
+  #pragma omp parallel for
+  for (int j = 0; j < num_sampled; ++j) {
+    if (write_weight) {
+      DType* w = gweight[samples[j]].dptr_;
+      for (int k = 0; k < dim; ++k) w[k] += gsampled[j][k];
+    }
+    if (write_bias) {
+      DType sum = 0;
+      for (int i = 0; i < n; ++i) sum += dz[i][j];
+      gbias[samples[j]] += sum;
+    }
+  }
+  AddScaledRows(rows, srcs, dz_label, data.dptr_, dim,
+                write_weight ? gweight.dptr_ : nullptr, write_bias ? gbias.dptr_ : nullptr);
+}
+
+inline bool SampledSoftmaxShape(const nnvm::NodeAttrs& attrs,
+                                std::vector<TShape> *in_attrs,
+                                std::vector<TShape> *out_attrs) {
+  using namespace sampled_softmax;
+  const SampledSoftmaxParam& param = nnvm::get<SampledSoftmaxParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 4U);
+  CHECK_EQ(out_attrs->size(), 3U);
+  CHECK_LT(param.num_sampled, param.num_classes)
+    << "SampledSoftmax: num_sampled must be smaller than num_classes";
+  const TShape& dshape = (*in_attrs)[kData];
+  if (dshape.ndim() == 0) return false;
+  CHECK_EQ(dshape.ndim(), 2U) << "SampledSoftmax: data must be (batch, dim)";
+  SHAPE_ASSIGN_CHECK(*in_attrs, kWeight, mshadow::Shape2(param.num_classes, dshape[1]));
+  SHAPE_ASSIGN_CHECK(*in_attrs, kBias, mshadow::Shape1(param.num_classes));
+  SHAPE_ASSIGN_CHECK(*in_attrs, kLabel, mshadow::Shape1(dshape[0]));
+  SHAPE_ASSIGN_CHECK(*out_attrs, kLoss, mshadow::Shape1(dshape[0]));
+  SHAPE_ASSIGN_CHECK(*out_attrs, kSamples, mshadow::Shape1(param.num_sampled));
+  SHAPE_ASSIGN_CHECK(*out_attrs, kProb, mshadow::Shape2(dshape[0], param.num_sampled + 1));
+  return true;
+}
+
+template<typename xpu>
+void SampledSoftmaxCompute(const nnvm::NodeAttrs& attrs,
+                           const OpContext& ctx,
+                           const std::vector<TBlob>& inputs,
+                           const std::vector<OpReqType>& req,
+                           const std::vector<TBlob>& outputs) {
+  using namespace sampled_softmax;
+  const SampledSoftmaxParam& param = nnvm::get<SampledSoftmaxParam>(attrs.parsed);
+  mshadow::Stream<cpu> *s = ctx.get_stream<cpu>();
+  const int n = inputs[kData].shape_[0], dim = inputs[kData].shape_[1];
+  std::vector<int> samples;
+  const int tries = SampleUniqueLogUniform(ctx.requested[kRandom].get_random<cpu, float>(s),
+                                           param.num_sampled, param.num_classes, &samples);
+  MSHADOW_SGL_DBL_TYPE_SWITCH(inputs[kData].type_flag_, DType, {
+    mshadow::Tensor<cpu, 1, DType> label = inputs[kLabel].get<cpu, 1, DType>(s);
+    std::vector<double> log_q(param.num_sampled + n);
+    for (int j = 0; j < param.num_sampled; ++j) {
+      log_q[j] = LogExpectedCount(samples[j], param.num_classes, tries);
+    }
+    for (int i = 0; i < n; ++i) {
+      log_q[param.num_sampled + i] =
+        LogExpectedCount(static_cast<int>(label[i]), param.num_classes, tries);
+    }
+    mshadow::Tensor<cpu, 1, DType> workspace = ctx.requested[kTempSpace]
+      .get_space_typed<cpu, 1, DType>(mshadow::Shape1(param.num_sampled * (dim + n)), s);
+    mshadow::Tensor<cpu, 1, DType> out_samples = outputs[kSamples].get<cpu, 1, DType>(s);
+    for (int j = 0; j < param.num_sampled; ++j) out_samples[j] = DType(samples[j]);
+    SampledSoftmaxForwardCPU(inputs[kData].get<cpu, 2, DType>(s),
+                             inputs[kWeight].get<cpu, 2, DType>(s),
+                             inputs[kBias].get<cpu, 1, DType>(s), label, samples, log_q,
+                             param.remove_accidental_hits, workspace.dptr_,
+                             outputs[kProb].get<cpu, 2, DType>(s),
+                             outputs[kLoss].dptr<DType>(), req[kLoss]);
+  });
+}
+
+template<typename xpu>
+void SampledSoftmaxGradCompute(const nnvm::NodeAttrs& attrs,
+                               const OpContext& ctx,
+                               const std::vector<TBlob>& inputs,
+                               const std::vector<OpReqType>& req,
+                               const std::vector<TBlob>& outputs) {
+  using namespace sampled_softmax;
+  const SampledSoftmaxParam& param = nnvm::get<SampledSoftmaxParam>(attrs.parsed);
+  mshadow::Stream<cpu> *s = ctx.get_stream<cpu>();
+  const int n = inputs[kInData].shape_[0], dim = inputs[kInData].shape_[1];
+  MSHADOW_SGL_DBL_TYPE_SWITCH(inputs[kInData].type_flag_, DType, {
+    mshadow::Tensor<cpu, 1, DType> in_samples = inputs[kInSamples].get<cpu, 1, DType>(s);
+    std::vector<int> samples(param.num_sampled);
+    for (int j = 0; j < param.num_sampled; ++j) samples[j] = static_cast<int>(in_samples[j]);
+    mshadow::Tensor<cpu, 1, DType> workspace = ctx.requested[0]
+      .get_space_typed<cpu, 1, DType>(mshadow::Shape1(param.num_sampled * (2 * dim + n)), s);
+    SampledSoftmaxBackwardCPU(inputs[kOutGrad].get<cpu, 1, DType>(s),
+                              inputs[kInData].get<cpu, 2, DType>(s),
+                              inputs[kInWeight].get<cpu, 2, DType>(s),
+                              inputs[kInLabel].get<cpu, 1, DType>(s), samples,
+                              inputs[kInProb].get<cpu, 2, DType>(s), workspace.dptr_,
+                              outputs[kData].get<cpu, 2, DType>(s),
+                              outputs[kWeight].get<cpu, 2, DType>(s),
+                              outputs[kBias].get<cpu, 1, DType>(s), req);
+    if (req[kLabel] != kNullOp && req[kLabel] != kAddTo) {
+      mshadow::Tensor<cpu, 1, DType> glabel = outputs[kLabel].get<cpu, 1, DType>(s);
+      glabel = DType(0);
+    }
+  });
+}
+
+/*! \brief the backward node takes the loss gradient, data, weight, label, samples and prob */
+struct SampledSoftmaxGrad {
+  const char *op_name;
+  std::vector<nnvm::NodeEntry> operator()(const nnvm::NodePtr& n,
+                                          const std::vector<nnvm::NodeEntry>& ograds) const {
+    using namespace sampled_softmax;
+    std::vector<nnvm::NodeEntry> heads{ograds[kLoss], n->inputs[kData], n->inputs[kWeight],
+                                       n->inputs[kLabel], nnvm::NodeEntry{n, kSamples, 0},
+                                       nnvm::NodeEntry{n, kProb, 0}};
+    return MakeGradNode(op_name, n, heads, n->attrs.dict);
+  }
+};
+
+/*!
+ * \brief Hierarchical softmax loss of each example: -sum over the nodes k of
+ *  the path of its label of log(sigmoid(s_k * (x . w_k + b_k))), with
+ *  s_k = 1 if code is 1 at k and -1 if it is 0. path and code are
+ *  num_classes x depth, and the paths shorter than depth end with -1.
+ */
+template<typename DType>
+inline void HierarchicalSoftmaxForwardCPU(const mshadow::Tensor<cpu, 2, DType>& data,
+                                          const mshadow::Tensor<cpu, 2, DType>& weight,
+                                          const mshadow::Tensor<cpu, 1, DType>& bias,
+                                          const mshadow::Tensor<cpu, 1, DType>& label,
+                                          const mshadow::Tensor<cpu, 2, DType>& path,
+                                          const mshadow::Tensor<cpu, 2, DType>& code,
+                                          DType* loss, OpReqType req) {
+  const int n = data.size(0), dim = data.size(1), depth = path.size(1);
+  #pragma omp parallel for
+  for (int i = 0; i < n; ++i) {
+    const int l = static_cast<int>(label[i]);
+    DType value = 0;
+    for (int k = 0; k < depth; ++k) {
+      const int node = static_cast<int>(path[l][k]);
+      if (node < 0) break;
+      const DType sign = code[l][k] > DType(0.5) ? DType(1) : DType(-1);
+      const DType z = sign * (Dot(data[i].dptr_, weight[node].dptr_, dim) + bias[node]);
+      // -log(sigmoid(z)) = log(1 + exp(-z))
+      value += std::max(-z, DType(0)) + std::log1p(std::exp(-std::abs(z)));
+    }
+    loss[i] = req == kAddTo ? loss[i] + value : value;
+  }
+}
+
+/*!
+ * \brief Hierarchical softmax backward. Only the rows of the weight and bias
+ *  gradients of the nodes on the paths of the labels are written, the others
+ *  being zeroed when req is kWriteTo.
+ */
+template<typename DType>
+inline void HierarchicalSoftmaxBackwardCPU(const mshadow::Tensor<cpu, 1, DType>& ograd,
+                                           const mshadow::Tensor<cpu, 2, DType>& data,
+                                           const mshadow::Tensor<cpu, 2, DType>& weight,
+                                           const mshadow::Tensor<cpu, 1, DType>& bias,
+                                           const mshadow::Tensor<cpu, 1, DType>& label,
+                                           const mshadow::Tensor<cpu, 2, DType>& path,
+                                           const mshadow::Tensor<cpu, 2, DType>& code,
+                                           mshadow::Tensor<cpu, 2, DType> gdata,
+                                           mshadow::Tensor<cpu, 2, DType> gweight,
+                                           mshadow::Tensor<cpu, 1, DType> gbias,
+                                           const std::vector<OpReqType>& req) {
+  using namespace hsoftmax;
+  const int n = data.size(0), dim = data.size(1), depth = path.size(1);
+  // one entry per example and level of the tree, -1 past the end of the path
+  std::vector<int> rows(n * depth, -1), srcs(n * depth);
+  std::vector<DType> dz(n * depth, DType(0));
+  #pragma omp parallel for
+  for (int i = 0; i < n; ++i) {
+    const int l = static_cast<int>(label[i]);
+    DType* dx = gdata[i].dptr_;
+    if (req[kData] == kWriteTo || req[kData] == kWriteInplace) {
+      std::fill(dx, dx + dim, DType(0));
+    }
+    for (int k = 0; k < depth; ++k) {
+      const int node = static_cast<int>(path[l][k]);
+      if (node < 0) break;
+      const DType sign = code[l][k] > DType(0.5) ? DType(1) : DType(-1);
+      const DType* w = weight[node].dptr_;
+      const DType z = sign * (Dot(data[i].dptr_, w, dim) + bias[node]);
+      // d(-log(sigmoid(z))) / dz = -sigmoid(-z)
+      const DType g = -sign * ograd[i] / (DType(1) + std::exp(z));
+      if (req[kData] != kNullOp) {
+        for (int j = 0; j < dim; ++j) dx[j] += g * w[j];
+      }
+      rows[i * depth + k] = node;
+      srcs[i * depth + k] = i;
+      dz[i * depth + k] = g;
+    }
+  }
+  const bool write_weight = req[kWeight] != kNullOp, write_bias = req[kBias] != kNullOp;
+  if (write_weight && req[kWeight] != kAddTo) gweight = DType(0);
+  if (write_bias && req[kBias] != kAddTo) gbias = DType(0);
+  AddScaledRows(rows, srcs, dz, data.dptr_, dim,
+                write_weight ? gweight.dptr_ : nullptr, write_bias ? gbias.dptr_ : nullptr);
+}
+
+inline bool HierarchicalSoftmaxShape(const nnvm::NodeAttrs& attrs,
+                                     std::vector<TShape> *in_attrs,
+                                     std::vector<TShape> *out_attrs) {
+  using namespace hsoftmax;
+  const HierarchicalSoftmaxParam& param = nnvm::get<HierarchicalSoftmaxParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 6U);
+  CHECK_EQ(out_attrs->size(), 1U);
+  const TShape& dshape = (*in_attrs)[kData];
+  if (dshape.ndim() == 0) return false;
+  CHECK_EQ(dshape.ndim(), 2U) << "HierarchicalSoftmax: data must be (batch, dim)";
+  SHAPE_ASSIGN_CHECK(*in_attrs, kWeight, mshadow::Shape2(param.num_classes - 1, dshape[1]));
+  SHAPE_ASSIGN_CHECK(*in_attrs, kBias, mshadow::Shape1(param.num_classes - 1));
+  SHAPE_ASSIGN_CHECK(*in_attrs, kLabel, mshadow::Shape1(dshape[0]));
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, mshadow::Shape1(dshape[0]));
+  if ((*in_attrs)[kPath].ndim() == 0) {
+    SHAPE_ASSIGN_CHECK(*in_attrs, kPath, (*in_attrs)[kCode]);
+  } else {
+    SHAPE_ASSIGN_CHECK(*in_attrs, kCode, (*in_attrs)[kPath]);
+  }
+  const TShape& pshape = (*in_attrs)[kPath];
+  if (pshape.ndim() == 0) return false;
+  CHECK_EQ(pshape.ndim(), 2U) << "HierarchicalSoftmax: path must be (num_classes, depth)";
+  CHECK_EQ(pshape[0], static_cast<index_t>(param.num_classes))
+    << "HierarchicalSoftmax: path must have a row for each class";
+  return true;
+}
+
+template<typename xpu>
+void HierarchicalSoftmaxCompute(const nnvm::NodeAttrs& attrs,
+                                const OpContext& ctx,
+                                const std::vector<TBlob>& inputs,
+                                const std::vector<OpReqType>& req,
+                                const std::vector<TBlob>& outputs) {
+  using namespace hsoftmax;
+  if (req[0] == kNullOp) return;
+  mshadow::Stream<cpu> *s = ctx.get_stream<cpu>();
+  MSHADOW_SGL_DBL_TYPE_SWITCH(inputs[kData].type_flag_, DType, {
+    HierarchicalSoftmaxForwardCPU(inputs[kData].get<cpu, 2, DType>(s),
+                                  inputs[kWeight].get<cpu, 2, DType>(s),
+                                  inputs[kBias].get<cpu, 1, DType>(s),
+                                  inputs[kLabel].get<cpu, 1, DType>(s),
+                                  inputs[kPath].get<cpu, 2, DType>(s),
+                                  inputs[kCode].get<cpu, 2, DType>(s),
+                                  outputs[0].dptr<DType>(), req[0]);
+  });
+}
+
+template<typename xpu>
+void HierarchicalSoftmaxGradCompute(const nnvm::NodeAttrs& attrs,
+                                    const OpContext& ctx,
+                                    const std::vector<TBlob>& inputs,
+                                    const std::vector<OpReqType>& req,
+                                    const std::vector<TBlob>& outputs) {
+  using namespace hsoftmax;
+  mshadow::Stream<cpu> *s = ctx.get_stream<cpu>();
+  // inputs are the loss gradient followed by the inputs of the forward
+  MSHADOW_SGL_DBL_TYPE_SWITCH(inputs[1 + kData].type_flag_, DType, {
+    HierarchicalSoftmaxBackwardCPU(inputs[0].get<cpu, 1, DType>(s),
+                                   inputs[1 + kData].get<cpu, 2, DType>(s),
+                                   inputs[1 + kWeight].get<cpu, 2, DType>(s),
+                                   inputs[1 + kBias].get<cpu, 1, DType>(s),
+                                   inputs[1 + kLabel].get<cpu, 1, DType>(s),
+                                   inputs[1 + kPath].get<cpu, 2, DType>(s),
+                                   inputs[1 + kCode].get<cpu, 2, DType>(s),
+                                   outputs[kData].get<cpu, 2, DType>(s),
+                                   outputs[kWeight].get<cpu, 2, DType>(s),
+                                   outputs[kBias].get<cpu, 1, DType>(s), req);
+    for (int k : {kLabel, kPath, kCode}) {
+      if (req[k] != kNullOp && req[k] != kAddTo) {
+        mshadow::Tensor<cpu, 1, DType> grad = outputs[k].FlatTo1D<cpu, DType>(s);
+        grad = DType(0);
+      }
+    }
+  });
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_CONTRIB_APPROX_SOFTMAX_INL_H_
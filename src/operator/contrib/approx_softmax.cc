@@ -0,0 +1,147 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file approx_softmax.cc
+ * \brief CPU implementation of sampled and hierarchical softmax
+ */
+#include "./approx_softmax-inl.h"
+
+namespace mxnet {
+namespace op {
+DMLC_REGISTER_PARAMETER(SampledSoftmaxParam);
+DMLC_REGISTER_PARAMETER(HierarchicalSoftmaxParam);
+
+NNVM_REGISTER_OP(_contrib_SampledSoftmax)
+.describe(R"code(Computes the sampled softmax cross entropy loss of each example.
+
+For a large number of classes, the full softmax over the `num_classes` rows of
+`weight` is replaced by a softmax over the label of each example and over
+`num_sampled` distinct classes drawn for the whole batch from the log-uniform
+distribution of ``random_log_uniform``:
+
+.. math::
+
+  loss_i = -\log \frac{\exp(z_{i,label_i})}{\exp(z_{i,label_i}) + \sum_{c \in S} \exp(z_{i,c})}
+
+where :math:`z_{i,c} = data_i \cdot weight_c + bias_c - \log Q(c)` and
+:math:`Q(c)` is the expected number of times class :math:`c` is drawn. This
+correction makes the gradient an estimate of the gradient of the full softmax
+cross entropy. The log-uniform distribution suits classes sorted by decreasing
+frequency, as the words of a vocabulary usually are. With
+`remove_accidental_hits`, the sampled classes equal to the label of an example
+are left out of its softmax.
+
+Only the rows of `weight` and `bias` of the labels and of the sampled classes
+have a nonzero gradient, and only these rows are computed in the backward pass.
+
+The shapes of the inputs and outputs:
+
+- **data**: *(batch_size, dim)*
+- **weight**: *(num_classes, dim)*
+- **bias**: *(num_classes,)*
+- **label**: *(batch_size,)*
+- **out**: *(batch_size,)*
+
+Sampled softmax is only meant for training, the loss of a trained model is
+computed with the full softmax. This implementation is based on paper:
+
+.. [1] On Using Very Large Target Vocabulary for Neural Machine Translation,
+   S. Jean, K. Cho, R. Memisevic, Y. Bengio, 2015 (arXiv:1412.2007).
+
+)code" ADD_FILELINE)
+.set_num_inputs(4)
+.set_num_outputs(3)
+.set_attr_parser(ParamParser<SampledSoftmaxParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs)
+  { return std::vector<std::string>{"data", "weight", "bias", "label"}; })
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", [](const NodeAttrs& attrs)
+  { return std::vector<std::string>{"output", "samples", "prob"}; })
+.set_attr<nnvm::FNumVisibleOutputs>("FNumVisibleOutputs", [](const NodeAttrs& attrs)
+  { return 1; })
+.set_attr<nnvm::FInferShape>("FInferShape", SampledSoftmaxShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<4, 3>)
+.set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& attrs)
+  { return SampleResource(attrs); })
+.set_attr<FCompute>("FCompute<cpu>", SampledSoftmaxCompute<cpu>)
+.set_attr<nnvm::FGradient>("FGradient", SampledSoftmaxGrad{"_backward_contrib_SampledSoftmax"})
+.add_argument("data", "NDArray-or-Symbol", "Input features, of shape (batch_size, dim)")
+.add_argument("weight", "NDArray-or-Symbol", "Output layer weight, a row for each class")
+.add_argument("bias", "NDArray-or-Symbol", "Output layer bias, a value for each class")
+.add_argument("label", "NDArray-or-Symbol", "Class of each example")
+.add_arguments(SampledSoftmaxParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_contrib_SampledSoftmax)
+.set_num_inputs(6)
+.set_num_outputs(4)
+.set_attr_parser(ParamParser<SampledSoftmaxParam>)
+.set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& attrs)
+  { return std::vector<ResourceRequest>{ResourceRequest::kTempSpace}; })
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr<FCompute>("FCompute<cpu>", SampledSoftmaxGradCompute<cpu>);
+
+NNVM_REGISTER_OP(_contrib_HierarchicalSoftmax)
+.describe(R"code(Computes the hierarchical softmax loss of each example.
+
+The classes are the leaves of a binary tree whose `num_classes - 1` inner nodes
+each have a row of `weight` and a value of `bias`. The probability of a class is
+the product, over the inner nodes of the path from the root to its leaf, of the
+probability of taking the branch of the path at that node:
+
+.. math::
+
+  loss_i = -\sum_{k} \log \sigma(s_k (data_i \cdot weight_{n_k} + bias_{n_k}))
+
+where :math:`n_k` is the k-th node of the path of :math:`label_i` and
+:math:`s_k` is 1 if the path goes to the right child of :math:`n_k` and -1 if it
+goes to the left one. The cost of an example is the depth of the tree, about
+:math:`\log_2(num\_classes)` for a balanced tree and less for the frequent
+classes of a Huffman tree.
+
+The tree is given by `path`, the inner nodes of the path of each class padded
+with -1 after its end, and `code`, 1 for a right branch and 0 for a left one.
+Only the rows of `weight` and `bias` of the nodes on the paths of the labels
+have a nonzero gradient, and only these rows are computed in the backward pass.
+
+The shapes of the inputs and outputs:
+
+- **data**: *(batch_size, dim)*
+- **weight**: *(num_classes - 1, dim)*
+- **bias**: *(num_classes - 1,)*
+- **label**: *(batch_size,)*
+- **path**, **code**: *(num_classes, depth)*
+- **out**: *(batch_size,)*
+
+This implementation is based on paper:
+
+.. [1] Hierarchical Probabilistic Neural Network Language Model,
+   F. Morin, Y. Bengio, 2005.
+
+)code" ADD_FILELINE)
+.set_num_inputs(6)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<HierarchicalSoftmaxParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs)
+  { return std::vector<std::string>{"data", "weight", "bias", "label", "path", "code"}; })
+.set_attr<nnvm::FInferShape>("FInferShape", HierarchicalSoftmaxShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<6, 1>)
+.set_attr<FCompute>("FCompute<cpu>", HierarchicalSoftmaxCompute<cpu>)
+.set_attr<nnvm::FGradient>("FGradient",
+                           ElemwiseGradUseIn{"_backward_contrib_HierarchicalSoftmax"})
+.add_argument("data", "NDArray-or-Symbol", "Input features, of shape (batch_size, dim)")
+.add_argument("weight", "NDArray-or-Symbol", "Weight, a row for each inner node of the tree")
+.add_argument("bias", "NDArray-or-Symbol", "Bias, a value for each inner node of the tree")
+.add_argument("label", "NDArray-or-Symbol", "Class of each example")
+.add_argument("path", "NDArray-or-Symbol", "Inner nodes from the root to each class, "
+              "padded with -1")
+.add_argument("code", "NDArray-or-Symbol", "Branches from the root to each class, "
+              "1 for right and 0 for left")
+.add_arguments(HierarchicalSoftmaxParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_contrib_HierarchicalSoftmax)
+.set_num_inputs(7)
+.set_num_outputs(6)
+.set_attr_parser(ParamParser<HierarchicalSoftmaxParam>)
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr<FCompute>("FCompute<cpu>", HierarchicalSoftmaxGradCompute<cpu>);
+
+}  // namespace op
+}  // namespace mxnet
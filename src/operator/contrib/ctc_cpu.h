@@ -0,0 +1,261 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file ctc_cpu.h
+ * \brief CTC loss and gradient on CPU, parallel over the batch and the time steps
+ */
+#ifndef MXNET_OPERATOR_CONTRIB_CTC_CPU_H_
+#define MXNET_OPERATOR_CONTRIB_CTC_CPU_H_
+
+#include <dmlc/omp.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include "../nn/blocked_softmax.h"
+
+namespace mxnet {
+namespace op {
+namespace ctc_cpu {
+/*!
+ * \brief log of zero. A finite value keeps the log-sum-exp free of branches
+ *  and of NaN, every value below it is clamped to it at the next time step.
+ */
+const float kLogZero = -1e30f;
+
+/*!
+ * \brief the columns of alpha and beta have two padding values on each side,
+ *  so the recursions read s - 2 and s + 2 without tests.
+ */
+inline int ColumnSize(int S) {
+  return S + 4;
+}
+
+#if MXNET_SOFTMAX_USE_SSE
+/*!
+ * \brief log(x) for positive normal x as e * ln 2 + log(m), with the mantissa m
+ *  in [sqrt(1/2), sqrt(2)) and the polynomial of Cephes logf.
+ */
+inline __m128 Log(__m128 x) {
+  const __m128 one = _mm_set1_ps(1.0f);
+  __m128i bits = _mm_castps_si128(x);
+  __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+  bits = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f000000));
+  x = _mm_castsi128_ps(bits);  // in [1/2, 1)
+  const __m128 mask = _mm_cmplt_ps(x, _mm_set1_ps(0.707106781186547524f));
+  e = _mm_sub_ps(e, _mm_and_ps(one, mask));
+  x = _mm_add_ps(_mm_sub_ps(x, one), _mm_and_ps(x, mask));
+  const __m128 z = _mm_mul_ps(x, x);
+  __m128 y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(7.0376836292e-2f), x),
+                        _mm_set1_ps(-1.1514610310e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.2420140846e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.6668057665e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-2.4999993993e-1f));
+  y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174e-1f));
+  y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+  y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+  y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+  return _mm_add_ps(_mm_add_ps(x, y), _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+}
+#endif  // MXNET_SOFTMAX_USE_SSE
+
+/*!
+ * \brief out[s] = log(exp(a[s]) + exp(b[s]) + exp(c[s] + skip[s])) + emit[s]
+ *  for s in [0, n), without branches. The largest term is factored out, so the
+ *  sum of the exponentials is in [1, 3] and its log is accurate.
+ */
+template<typename DType>
+inline void LogSumExp3(const DType* a, const DType* b, const DType* c, const DType* skip,
+                       const DType* emit, DType* out, int n) {
+  for (int s = 0; s < n; ++s) {
+    const DType cs = c[s] + skip[s];
+    const DType m = std::max(std::max(a[s], b[s]), std::max(cs, DType(kLogZero)));
+    const DType sum = softmax_cpu::Exp<false>(a[s] - m) + softmax_cpu::Exp<false>(b[s] - m) +
+                      softmax_cpu::Exp<false>(cs - m);
+    out[s] = m + std::log(sum) + emit[s];
+  }
+}
+
+#if MXNET_SOFTMAX_USE_SSE
+template<>
+inline void LogSumExp3<float>(const float* a, const float* b, const float* c, const float* skip,
+                              const float* emit, float* out, int n) {
+  int s = 0;
+  for (; s + 4 <= n; s += 4) {
+    const __m128 va = _mm_loadu_ps(a + s), vb = _mm_loadu_ps(b + s);
+    const __m128 vc = _mm_add_ps(_mm_loadu_ps(c + s), _mm_loadu_ps(skip + s));
+    const __m128 m = _mm_max_ps(_mm_max_ps(va, vb), _mm_max_ps(vc, _mm_set1_ps(kLogZero)));
+    const __m128 sum = _mm_add_ps(_mm_add_ps(softmax_cpu::Exp<false>(_mm_sub_ps(va, m)),
+                                             softmax_cpu::Exp<false>(_mm_sub_ps(vb, m))),
+                                  softmax_cpu::Exp<false>(_mm_sub_ps(vc, m)));
+    _mm_storeu_ps(out + s, _mm_add_ps(_mm_add_ps(m, Log(sum)), _mm_loadu_ps(emit + s)));
+  }
+  for (; s < n; ++s) {
+    const float cs = c[s] + skip[s];
+    const float m = std::max(std::max(a[s], b[s]), std::max(cs, kLogZero));
+    const float sum = softmax_cpu::Exp<false>(a[s] - m) + softmax_cpu::Exp<false>(b[s] - m) +
+                      softmax_cpu::Exp<false>(cs - m);
+    out[s] = m + std::log(sum) + emit[s];
+  }
+}
+#endif  // MXNET_SOFTMAX_USE_SSE
+
+/*! \brief out[s] = exp(a[s] + b[s] - c[s] - shift) for s in [0, n) */
+template<typename DType>
+inline void ExpOfSum(const DType* a, const DType* b, const DType* c, DType shift,
+                     DType* out, int n) {
+  int s = 0;
+#if MXNET_SOFTMAX_USE_SSE
+  if (std::is_same<DType, float>::value) {
+    const float* fa = reinterpret_cast<const float*>(a);
+    const float* fb = reinterpret_cast<const float*>(b);
+    const float* fc = reinterpret_cast<const float*>(c);
+    float* fout = reinterpret_cast<float*>(out);
+    const __m128 vshift = _mm_set1_ps(static_cast<float>(shift));
+    for (; s + 4 <= n; s += 4) {
+      const __m128 x = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(fa + s), _mm_loadu_ps(fb + s)),
+                                  _mm_add_ps(_mm_loadu_ps(fc + s), vshift));
+      _mm_storeu_ps(fout + s, softmax_cpu::Exp<false>(x));
+    }
+  }
+#endif  // MXNET_SOFTMAX_USE_SSE
+  for (; s < n; ++s) out[s] = softmax_cpu::Exp<false>(a[s] + b[s] - c[s] - shift);
+}
+
+/*!
+ * \brief number of DType values of the workspace: the log probabilities of
+ *  the whole batch, then a slot for each thread with the alphas of all the
+ *  time steps, two columns of betas and the per label arrays of one example.
+ *  Threads reuse their slot for all their examples, so the workspace grows
+ *  with the number of threads rather than with the batch size.
+ */
+inline size_t WorkspaceSize(int alphabet_size, int minibatch, int max_time,
+                            int max_label_length, int num_slots) {
+  const size_t W = ColumnSize(2 * max_label_length + 1);
+  return static_cast<size_t>(max_time) * minibatch * alphabet_size +
+         num_slots * ((max_time + 5) * W);
+}
+
+/*! \brief number of workspace slots, one for each thread that can run an example */
+inline int NumSlots(int minibatch) {
+  return std::max(1, std::min(omp_get_max_threads(), minibatch));
+}
+
+/*!
+ * \brief Loss and gradient of one example from the log probabilities logp,
+ *  time step t of the example being at logp + t * stride. The alphas are kept
+ *  for all the time steps, the betas are computed backward one column at a
+ *  time together with the gradient of that time step.
+ * \param grad gradient with respect to the activations, null for the loss only.
+ * \return the negative log likelihood of labels, 0 if they cannot fit in T > 0 steps.
+ *  For T = 0 it is 0 for no labels and infinity otherwise.
+ */
+template<typename DType>
+inline DType ExampleLoss(const DType* logp, DType* grad, int stride, int alphabet_size,
+                         const int* labels, int L, int T, DType* slot) {
+  const int S = 2 * L + 1, W = ColumnSize(S);
+  DType* alpha = slot;                 // T columns
+  DType* beta = alpha + T * W;         // 2 columns
+  DType* emit = beta + 2 * W;          // log probabilities of the extended labels
+  DType* skip = emit + W;              // 0 if s - 2 leads to s, kLogZero otherwise
+  DType* ext = skip + W;               // extended labels, blank at even positions
+  // an empty input only emits the empty label sequence, and has no alphas
+  if (T == 0) return L == 0 ? DType(0) : std::numeric_limits<DType>::infinity();
+  int repeats = 0;
+  for (int i = 1; i < L; ++i) repeats += labels[i] == labels[i - 1];
+  if (L + repeats > T) {
+    if (grad) {
+      for (int t = 0; t < T; ++t) std::fill(grad + t * stride, grad + t * stride + alphabet_size,
+                                            DType(0));
+    }
+    return DType(0);
+  }
+  std::fill(slot, slot + (T + 5) * W, DType(kLogZero));
+  for (int s = 0; s < S; ++s) {
+    ext[s] = DType(s % 2 ? labels[s / 2] : 0);
+    skip[2 + s] = s % 2 && s > 1 && labels[s / 2] != labels[s / 2 - 1] ? DType(0)
+                                                                        : DType(kLogZero);
+  }
+  // alpha[-1] is 1 at s = 0, so that the recursion gives alpha[0]
+  beta[2] = DType(0);
+  for (int t = 0; t < T; ++t) {
+    const DType* lp = logp + t * stride;
+    for (int s = 0; s < S; ++s) emit[2 + s] = lp[static_cast<int>(ext[s])];
+    const DType* prev = t == 0 ? beta + 2 : alpha + (t - 1) * W + 2;
+    LogSumExp3(prev, prev - 1, prev - 2, skip + 2, emit + 2, alpha + t * W + 2, S);
+  }
+  const DType* last = alpha + (T - 1) * W + 2;
+  const DType m = std::max(last[S - 1], L > 0 ? last[S - 2] : DType(kLogZero));
+  const DType log_z = m + std::log(softmax_cpu::Exp<false>(last[S - 1] - m) +
+                                   (L > 0 ? softmax_cpu::Exp<false>(last[S - 2] - m) : DType(0)));
+  if (!grad) return -log_z;
+  // beta[T] is 1 at s = S - 1, so that the recursion gives beta[T - 1]
+  std::fill(beta, beta + 2 * W, DType(kLogZero));
+  beta[(T % 2) * W + 2 + S - 1] = DType(0);
+  for (int t = T - 1; t >= 0; --t) {
+    const DType* lp = logp + t * stride;
+    DType* g = grad + t * stride;
+    for (int s = 0; s < S; ++s) emit[2 + s] = lp[static_cast<int>(ext[s])];
+    const DType* next = beta + ((t + 1) % 2) * W + 2;
+    DType* cur = beta + (t % 2) * W + 2;
+    LogSumExp3(next, next + 1, next + 2, skip + 4, emit + 2, cur, S);
+    // gradient with respect to the activations: the probability minus the
+    // posterior of the extended labels, alpha * beta / (emit * Z)
+    softmax_cpu::ExpSum<false>(lp, DType(0), g, alphabet_size);
+    DType* posterior = emit + 2;
+    ExpOfSum(alpha + t * W + 2, cur, emit + 2, log_z, posterior, S);
+    for (int s = 0; s < S; ++s) g[static_cast<int>(ext[s])] -= posterior[s];
+  }
+  return -log_z;
+}
+
+/*!
+ * \brief CTC loss of a batch of activations of shape (max_time, minibatch,
+ *  alphabet_size), with the blank label 0. The log softmax of the activations
+ *  is computed for all the time steps and examples in parallel. The examples
+ *  are then processed from the longest to the shortest, by T * (2L + 1), and
+ *  handed to the threads one at a time, so batches with uneven lengths keep
+ *  all the threads busy until the end.
+ * \param grads gradient with respect to the activations, null for the loss only.
+ * \param workspace WorkspaceSize values, for num_slots threads.
+ */
+template<typename DType>
+inline void CTCLoss(const DType* activations, DType* costs, DType* grads,
+                    const int* flat_labels, const int* label_lengths, const int* input_lengths,
+                    int alphabet_size, int minibatch, DType* workspace, int num_slots) {
+  const int max_time = *std::max_element(input_lengths, input_lengths + minibatch);
+  const int max_label_length = *std::max_element(label_lengths, label_lengths + minibatch);
+  const int stride = minibatch * alphabet_size;
+  DType* logp = workspace;
+  softmax_cpu::Softmax<false>(activations, logp, max_time * minibatch, alphabet_size, 1, true);
+  std::vector<int> offsets(minibatch, 0), order(minibatch);
+  for (int b = 1; b < minibatch; ++b) offsets[b] = offsets[b - 1] + label_lengths[b - 1];
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int x, int y) {
+    return static_cast<int64_t>(input_lengths[x]) * (2 * label_lengths[x] + 1) >
+           static_cast<int64_t>(input_lengths[y]) * (2 * label_lengths[y] + 1);
+  });
+  const size_t slot_size = static_cast<size_t>(max_time + 5) *
+                           ColumnSize(2 * max_label_length + 1);
+  DType* slots = logp + static_cast<size_t>(max_time) * stride;
+  #pragma omp parallel for schedule(dynamic, 1) num_threads(num_slots)
+  for (int k = 0; k < minibatch; ++k) {
+    const int b = order[k];
+    DType* slot = slots + omp_get_thread_num() * slot_size;
+    DType* grad = grads ? grads + b * alphabet_size : nullptr;
+    costs[b] = ExampleLoss(logp + b * alphabet_size, grad, stride, alphabet_size,
+                           flat_labels + offsets[b], label_lengths[b], input_lengths[b], slot);
+    if (grad) {
+      for (int t = input_lengths[b]; t < max_time; ++t) {
+        std::fill(grad + t * stride, grad + t * stride + alphabet_size, DType(0));
+      }
+    }
+  }
+}
+}  // namespace ctc_cpu
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_CONTRIB_CTC_CPU_H_
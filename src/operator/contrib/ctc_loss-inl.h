@@ -22,6 +22,7 @@
 #include "../operator_common.h"
 #include "../sequence_op_common.h"
 #include "../mshadow_op.h"
+#include "./ctc_cpu.h"
 
 namespace mxnet {
 namespace op {
@@ -80,29 +81,10 @@ inline void get_workspace_size(std::vector<int> *label_lengths,
     *size_bytes += sizeof(T) * alphabet_size * maxT * minibatch;
 
   } else {
-    // cpu can eventually replace all minibatch with
-    // max number of concurrent threads if memory is
-    // really tight
-
-    // per minibatch memory
-    size_t per_minibatch_bytes = 0;
-
-    // output
-    per_minibatch_bytes += sizeof(T) * alphabet_size;
-
-    // alphas
-    per_minibatch_bytes += sizeof(T) * S * maxT;
-
-    // betas
-    per_minibatch_bytes += sizeof(T) * S;
-
-    // labels w/blanks, e_inc, s_inc
-    per_minibatch_bytes += 3 * sizeof(int) * S;
-
-    *size_bytes = per_minibatch_bytes * minibatch;
-
-    // probs
-    *size_bytes += sizeof(T) * alphabet_size * maxT * minibatch;
+    // log probabilities of the batch and a workspace slot for each thread,
+    // see ctc_cpu::WorkspaceSize
+    *size_bytes = sizeof(T) * ctc_cpu::WorkspaceSize(alphabet_size, minibatch, maxT, maxL,
+                                                     ctc_cpu::NumSlots(minibatch));
   }
 }
 
@@ -6,7 +6,7 @@
 */
 
 #include "./ctc_loss-inl.h"
-#include "./ctc_include/detail/cpu_ctc.h"
+#include "./ctc_include/detail/ctc_helper.h"
 
 namespace mshadow {
 
@@ -17,14 +17,11 @@ ctcStatus_t compute_ctc_cost(const Tensor<cpu, 3, DType> activations,
                              void *workspace, int train) {
   int minibatch = static_cast<int>(activations.size(1));
   int alphabet_size = static_cast<int>(activations.size(2));
-  int blank_label = 0;
-  mxnet_warpctc::CpuCTC<DType> ctc(alphabet_size, minibatch, workspace, blank_label);
-  if (train)
-    return ctc.cost_and_grad(activations.dptr_, grads, costs, labels,
-                             label_lengths, input_lengths);
-  else
-    return ctc.score_forward(activations.dptr_, costs, labels, label_lengths,
-                             input_lengths);
+  mxnet::op::ctc_cpu::CTCLoss(activations.dptr_, costs, train ? grads : nullptr, labels,
+                              label_lengths, input_lengths, alphabet_size, minibatch,
+                              static_cast<DType *>(workspace),
+                              mxnet::op::ctc_cpu::NumSlots(minibatch));
+  return CTC_STATUS_SUCCESS;
 }
 
 }  // namespace mshadow
@@ -6,6 +6,7 @@
 */
 
 #include "./convolution-inl.h"
+#include "./half_cpu_op.h"
 #if MXNET_USE_MKL2017 == 1
 #include <mkl_memory.h>
 #include "./mkl/mkl_memory-inl.h"
@@ -25,6 +26,10 @@ Operator* CreateOp<cpu>(ConvolutionParam param, int dtype,
                         std::vector<TShape> *out_shape,
                         Context ctx) {
   Operator *op = NULL;
+  if (half_cpu::IsHalfType(dtype)) {
+    // float16 or bfloat16 storage, float32 compute
+    return new HalfCPUOp(CreateOp<cpu>(param, mshadow::kFloat32, in_shape, out_shape, ctx));
+  }
   // If 1D convolution, use MXNet implementation
   if (param.kernel.ndim() == 1) {
     MSHADOW_REAL_TYPE_SWITCH(dtype, DType, {
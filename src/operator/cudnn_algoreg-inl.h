@@ -12,6 +12,7 @@
 #include <string>
 #include <vector>
 #include "../common/cuda_utils.h"
+#include "./algo_registry.h"
 #include "./convolution-inl.h"
 #include "./deconvolution-inl.h"
 
@@ -26,8 +27,13 @@ class CuDNNAlgoReg {
                      const std::vector<TShape> &out_shape,
                      cudnnDataType_t cudnn_data_type,
                      cudnnDataType_t cudnn_forward_compute_type,
-                     cudnnDataType_t cudnn_backward_compute_type) {
+                     cudnnDataType_t cudnn_backward_compute_type,
+                     const Context &ctx) {
     std::ostringstream oss;
+    // the choices are saved by AlgoRegistry, and only hold for the same gpu and cudnn
+    cudaDeviceProp prop;
+    CUDA_CALL(cudaGetDeviceProperties(&prop, ctx.dev_id));
+    oss << "cudnn_convolution;" << prop.name << ";cudnn=" << CUDNN_VERSION << ";";
     oss << "inputs=";
     for (auto &i : in_shape)
       oss << i << ";";
@@ -54,6 +60,14 @@ class CuDNNAlgoReg {
       *flt = i->second.flt;
       return true;
     }
+    std::vector<int> algo;
+    if (AlgoRegistry::Get()->Find(key, &algo) && algo.size() == 3) {
+      *fwd = static_cast<cudnnConvolutionFwdAlgo_t>(algo[0]);
+      *bwd = static_cast<cudnnConvolutionBwdDataAlgo_t>(algo[1]);
+      *flt = static_cast<cudnnConvolutionBwdFilterAlgo_t>(algo[2]);
+      reg_[key] = {*fwd, *bwd, *flt};
+      return true;
+    }
     return false;
   }
 
@@ -76,6 +90,8 @@ class CuDNNAlgoReg {
     reg_[key].fwd = fwd;
     reg_[key].bwd = bwd;
     reg_[key].flt = flt;
+    AlgoRegistry::Get()->Register(key, {static_cast<int>(fwd), static_cast<int>(bwd),
+                                        static_cast<int>(flt)});
   }
 
   static CuDNNAlgoReg *Get();
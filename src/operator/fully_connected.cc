@@ -4,6 +4,7 @@
  * \brief fully connect operator
 */
 #include "./fully_connected-inl.h"
+#include "./half_cpu_op.h"
 #if MXNET_USE_NNPACK == 1
 #include "./nnpack/nnpack_fully_connected-inl.h"
 #endif  // MXNET_USE_NNPACK
@@ -35,8 +36,9 @@ Operator* CreateOp<cpu>(FullyConnectedParam param, int dtype,
     op = new FullyConnectedOp<cpu, double>(param);
     break;
   case mshadow::kFloat16:
-    LOG(FATAL) << "float16 fully connected layer is currently"
-                  "only supported by CuDNN version.";
+  case kBfloat16:
+    // float16 or bfloat16 storage, float32 compute
+    op = new FullyConnectedHalfCPUOp(param);
     break;
   default:
     LOG(FATAL) << "Unsupported type " << dtype;
@@ -0,0 +1,278 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file half_cpu.h
+ * \brief float16 and bfloat16 storage with float32 compute on cpu
+ *
+ * Conversions between float16 and float32 use the F16C instructions when the
+ * cpu has them, detected at run time, and a scalar routine with the same round
+ * to nearest even otherwise. bfloat16 converts with a shift and a rounding add.
+ * Operators keep their arrays in one of these 16 bit types and convert them a
+ * block at a time to compute in float32.
+*/
+#ifndef MXNET_OPERATOR_HALF_CPU_H_
+#define MXNET_OPERATOR_HALF_CPU_H_
+
+#include <mshadow/base.h>
+#include <mshadow/tensor.h>
+#include <dmlc/omp.h>
+#include <dmlc/logging.h>
+#include <mxnet/bfloat16.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(__CUDACC__)
+#include <immintrin.h>
+#define MXNET_HALF_CPU_F16C 1
+#else
+#define MXNET_HALF_CPU_F16C 0
+#endif
+
+namespace mxnet {
+namespace op {
+namespace half_cpu {
+
+typedef mshadow::half::half_t half_t;
+typedef mxnet::bf16_t bf16_t;
+static_assert(sizeof(half_t) == sizeof(uint16_t), "half_t must be stored in 16 bits");
+static_assert(sizeof(bf16_t) == sizeof(uint16_t), "bf16_t must be stored in 16 bits");
+
+/*! \brief whether a type flag is a 16 bit type computed in float32 */
+inline bool IsHalfType(int type_flag) {
+  return type_flag == mshadow::kFloat16 || type_flag == mxnet::kBfloat16;
+}
+
+/*! \brief switch over the 16 bit types, half_t or bf16_t */
+#define MXNET_HALF_TYPE_SWITCH(type, DType, ...)                    \
+  switch (type) {                                                   \
+  case mshadow::kFloat16:                                           \
+    {                                                               \
+      typedef mxnet::op::half_cpu::half_t DType;                    \
+      {__VA_ARGS__}                                                 \
+    }                                                               \
+    break;                                                          \
+  case mxnet::kBfloat16:                                            \
+    {                                                               \
+      typedef mxnet::op::half_cpu::bf16_t DType;                    \
+      {__VA_ARGS__}                                                 \
+    }                                                               \
+    break;                                                          \
+  default:                                                          \
+    LOG(FATAL) << "Unknown 16 bit type enum " << type;              \
+  }
+
+/*! \brief values converted at a time by the blocked operators */
+const int kBlock = 512;
+
+inline uint32_t FloatBits(float f) {
+  uint32_t x;
+  std::memcpy(&x, &f, sizeof(x));
+  return x;
+}
+
+inline float BitsFloat(uint32_t x) {
+  float f;
+  std::memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+/*! \brief float16 bits of a float, rounded to nearest even as by F16C */
+inline uint16_t FloatToHalfBits(float f) {
+  const uint32_t infinity = 255U << 23, overflow = (127U + 16) << 23;
+  const uint32_t denormal_magic = ((127U - 15) + (23 - 10) + 1) << 23;
+  uint32_t x = FloatBits(f);
+  const uint32_t sign = x & 0x80000000U;
+  x ^= sign;
+  uint16_t h;
+  if (x >= overflow) {
+    h = x > infinity ? 0x7e00 : 0x7c00;
+  } else if (x < (113U << 23)) {
+    // subnormal or zero, the addition rounds the mantissa
+    h = static_cast<uint16_t>(FloatBits(BitsFloat(x) + BitsFloat(denormal_magic)) -
+                              denormal_magic);
+  } else {
+    const uint32_t odd = (x >> 13) & 1;
+    x += ((15U - 127) << 23) + 0xfff + odd;
+    h = static_cast<uint16_t>(x >> 13);
+  }
+  return h | static_cast<uint16_t>(sign >> 16);
+}
+
+/*! \brief float of float16 bits */
+inline float HalfBitsToFloat(uint16_t h) {
+  const uint32_t shifted_exp = 0x7c00U << 13;
+  uint32_t x = (h & 0x7fffU) << 13;
+  const uint32_t exp = x & shifted_exp;
+  x += (127U - 15) << 23;
+  if (exp == shifted_exp) {
+    x += (128U - 16) << 23;  // inf or nan
+  } else if (exp == 0) {
+    x = FloatBits(BitsFloat(x + (1U << 23)) - BitsFloat(113U << 23));  // subnormal
+  }
+  return BitsFloat(x | (static_cast<uint32_t>(h & 0x8000U) << 16));
+}
+
+#if MXNET_HALF_CPU_F16C
+inline bool HasF16C() {
+  static const bool has = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+  }();
+  return has;
+}
+
+__attribute__((target("avx,f16c")))
+inline size_t HalfToFloatF16C(const uint16_t* in, float* out, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+  }
+  return i;
+}
+
+__attribute__((target("avx,f16c")))
+inline size_t FloatToHalfF16C(const float* in, uint16_t* out, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+  }
+  return i;
+}
+#else
+inline bool HasF16C() { return false; }
+inline size_t HalfToFloatF16C(const uint16_t* in, float* out, size_t n) { return 0; }
+inline size_t FloatToHalfF16C(const float* in, uint16_t* out, size_t n) { return 0; }
+#endif  // MXNET_HALF_CPU_F16C
+
+/*! \brief out[i] = float(in[i]) */
+inline void HalfToFloat(const half_t* in, float* out, size_t n) {
+  const uint16_t* bits = reinterpret_cast<const uint16_t*>(in);
+  size_t i = HasF16C() ? HalfToFloatF16C(bits, out, n) : 0;
+  for (; i < n; ++i) out[i] = HalfBitsToFloat(bits[i]);
+}
+
+/*! \brief out[i] = half(in[i]) */
+inline void FloatToHalf(const float* in, half_t* out, size_t n) {
+  uint16_t* bits = reinterpret_cast<uint16_t*>(out);
+  size_t i = HasF16C() ? FloatToHalfF16C(in, bits, n) : 0;
+  for (; i < n; ++i) bits[i] = FloatToHalfBits(in[i]);
+}
+
+/*! \brief out[i] = float(in[i]) */
+inline void HalfToFloat(const bf16_t* in, float* out, size_t n) {
+  const uint16_t* bits = reinterpret_cast<const uint16_t*>(in);
+  for (size_t i = 0; i < n; ++i) out[i] = BitsFloat(static_cast<uint32_t>(bits[i]) << 16);
+}
+
+/*! \brief out[i] = bfloat16(in[i]), rounded to nearest even */
+inline void FloatToHalf(const float* in, bf16_t* out, size_t n) {
+  uint16_t* bits = reinterpret_cast<uint16_t*>(out);
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t x = FloatBits(in[i]);
+    const uint32_t rounded = (x + 0x7fffU + ((x >> 16) & 1)) >> 16;
+    // nan stays a quiet nan instead of rounding to infinity
+    bits[i] = static_cast<uint16_t>((x & 0x7fffffffU) > 0x7f800000U ? (x >> 16) | 0x40 : rounded);
+  }
+}
+
+/*! \brief HalfToFloat of a large array, in parallel */
+template<typename DType>
+inline void HalfToFloatParallel(const DType* in, float* out, size_t n) {
+  const int chunks = static_cast<int>((n + (1 << 16) - 1) >> 16);
+  #pragma omp parallel for if (chunks > 1)
+  for (int c = 0; c < chunks; ++c) {
+    const size_t begin = static_cast<size_t>(c) << 16;
+    HalfToFloat(in + begin, out + begin, std::min<size_t>(n - begin, 1 << 16));
+  }
+}
+
+/*! \brief FloatToHalf of a large array, in parallel */
+template<typename DType>
+inline void FloatToHalfParallel(const float* in, DType* out, size_t n) {
+  const int chunks = static_cast<int>((n + (1 << 16) - 1) >> 16);
+  #pragma omp parallel for if (chunks > 1)
+  for (int c = 0; c < chunks; ++c) {
+    const size_t begin = static_cast<size_t>(c) << 16;
+    FloatToHalf(in + begin, out + begin, std::min<size_t>(n - begin, 1 << 16));
+  }
+}
+
+/*!
+ * \brief out (+)= f(lhs, rhs) in float32, kBlock values at a time. f is called as
+ *  f(float* out, const float* lhs, const float* rhs, int n) for each block of n
+ *  values, rhs is nullptr for unary functions.
+ */
+template<typename DType, typename F>
+inline void Blockwise(const DType* lhs, const DType* rhs, DType* out, size_t n,
+                      bool add, F f) {
+  const int blocks = static_cast<int>((n + kBlock - 1) / kBlock);
+  #pragma omp parallel for if (blocks > 16)
+  for (int b = 0; b < blocks; ++b) {
+    const size_t begin = static_cast<size_t>(b) * kBlock;
+    const int len = static_cast<int>(std::min<size_t>(n - begin, kBlock));
+    float x[kBlock], z[kBlock], y[kBlock];
+    HalfToFloat(lhs + begin, x, len);
+    if (rhs) HalfToFloat(rhs + begin, z, len);
+    f(y, x, rhs ? z : nullptr, len);
+    if (add) {
+      HalfToFloat(out + begin, z, len);
+      for (int i = 0; i < len; ++i) y[i] += z[i];
+    }
+    FloatToHalf(y, out + begin, len);
+  }
+}
+
+/*! \brief rows of the weights converted at a time by Linear, about 256KB of float */
+inline size_t PanelRows(int k, int m) {
+  return std::max(1, std::min(m, (1 << 16) / std::max(k, 1)));
+}
+
+/*! \brief number of floats of the workspace of Linear */
+inline size_t LinearWorkspaceSize(int n, int k, int m) {
+  const size_t rows = PanelRows(k, m);
+  return static_cast<size_t>(n) * k + rows * k + n * rows + m;
+}
+
+/*!
+ * \brief y = x w^T + bias of 16 bit arrays, x of shape (n, k), w of shape (m, k),
+ *  computed in float32. The weights are converted a panel of rows at a time, so
+ *  that they are read once in 16 bits and the panel stays in cache for the GEMM.
+ */
+template<typename DType>
+inline void Linear(const DType* x, const DType* w, const DType* bias, DType* y,
+                   int n, int k, int m, float* workspace) {
+  using namespace mshadow;
+  using namespace mshadow::expr;
+  const int rows = static_cast<int>(PanelRows(k, m));
+  float* xf = workspace;
+  float* panel = xf + static_cast<size_t>(n) * k;
+  float* yf = panel + static_cast<size_t>(rows) * k;
+  float* bf = yf + static_cast<size_t>(n) * rows;
+  HalfToFloatParallel(x, xf, static_cast<size_t>(n) * k);
+  if (bias) {
+    HalfToFloat(bias, bf, m);
+  } else {
+    std::fill(bf, bf + m, 0.0f);
+  }
+  Tensor<cpu, 2, float> data(xf, Shape2(n, k));
+  for (int r = 0; r < m; r += rows) {
+    const int len = std::min(rows, m - r);
+    HalfToFloatParallel(w + static_cast<size_t>(r) * k, panel, static_cast<size_t>(len) * k);
+    Tensor<cpu, 2, float> out(yf, Shape2(n, len));
+    out = dot(data, Tensor<cpu, 2, float>(panel, Shape2(len, k)).T());
+    #pragma omp parallel for if (n > 16)
+    for (int i = 0; i < n; ++i) {
+      float* row = yf + static_cast<size_t>(i) * len;
+      for (int j = 0; j < len; ++j) row[j] += bf[r + j];
+      FloatToHalf(row, y + static_cast<size_t>(i) * m + r, len);
+    }
+  }
+}
+
+}  // namespace half_cpu
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_HALF_CPU_H_
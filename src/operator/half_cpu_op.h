@@ -0,0 +1,176 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file half_cpu_op.h
+ * \brief float16 and bfloat16 operators on cpu computed by their float32 implementation
+*/
+#ifndef MXNET_OPERATOR_HALF_CPU_OP_H_
+#define MXNET_OPERATOR_HALF_CPU_OP_H_
+
+#include <dmlc/logging.h>
+#include <mxnet/operator.h>
+#include <mxnet/storage.h>
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include "./half_cpu.h"
+#include "./fully_connected-inl.h"
+
+namespace mxnet {
+namespace op {
+
+/*!
+ * \brief Runs a float32 operator on float16 or bfloat16 arrays. The 16 bit inputs
+ *  are converted to float32 buffers, the float32 operator computes into float32
+ *  buffers and the outputs are converted back. The buffers are allocated from the
+ *  storage for the duration of each call, so that they are not kept by every
+ *  16 bit node of a graph.
+ */
+class HalfCPUOp : public Operator {
+ public:
+  /*! \param op the float32 operator, owned by this operator */
+  explicit HalfCPUOp(Operator *op) : op_(op) {}
+
+  virtual void Forward(const OpContext &ctx,
+                       const std::vector<TBlob> &in_data,
+                       const std::vector<OpReqType> &req,
+                       const std::vector<TBlob> &out_data,
+                       const std::vector<TBlob> &aux_args) {
+    Space space(HalfSize({&in_data, &out_data, &aux_args}));
+    buffer_ = space.dptr();
+    used_ = 0;
+    std::vector<TBlob> in = ToFloat(in_data, nullptr);
+    std::vector<TBlob> out = ToFloat(out_data, &req);
+    std::vector<TBlob> aux = ToFloat(aux_args, nullptr);
+    op_->Forward(ctx, in, FloatReq(req), out, aux);
+    FromFloat(out, req, out_data);
+    FromFloat(aux, std::vector<OpReqType>(aux.size(), kWriteTo), aux_args);
+  }
+
+  virtual void Backward(const OpContext &ctx,
+                        const std::vector<TBlob> &out_grad,
+                        const std::vector<TBlob> &in_data,
+                        const std::vector<TBlob> &out_data,
+                        const std::vector<OpReqType> &req,
+                        const std::vector<TBlob> &in_grad,
+                        const std::vector<TBlob> &aux_args) {
+    Space space(HalfSize({&out_grad, &in_data, &out_data, &in_grad, &aux_args}));
+    buffer_ = space.dptr();
+    used_ = 0;
+    std::vector<TBlob> ograd = ToFloat(out_grad, nullptr);
+    std::vector<TBlob> in = ToFloat(in_data, nullptr);
+    std::vector<TBlob> out = ToFloat(out_data, nullptr);
+    std::vector<TBlob> igrad = ToFloat(in_grad, &req);
+    std::vector<TBlob> aux = ToFloat(aux_args, nullptr);
+    op_->Backward(ctx, ograd, in, out, FloatReq(req), igrad, aux);
+    FromFloat(igrad, req, in_grad);
+  }
+
+ protected:
+  static bool IsHalf(const TBlob &blob) {
+    return blob.dptr_ != nullptr && half_cpu::IsHalfType(blob.type_flag_);
+  }
+
+  /*! \brief float32 space from the cpu storage, freed when it goes out of scope */
+  class Space {
+   public:
+    explicit Space(size_t size)
+      : handle_(Storage::Get()->Alloc(std::max<size_t>(size, 1) * sizeof(float),
+                                      Context::CPU())) {}
+    ~Space() { Storage::Get()->Free(handle_); }
+    float *dptr() const { return static_cast<float*>(handle_.dptr); }
+
+   private:
+    Storage::Handle handle_;
+  };
+
+  /*! \brief number of floats of the copies of the 16 bit blobs */
+  static size_t HalfSize(std::initializer_list<const std::vector<TBlob>*> blobs) {
+    size_t size = 0;
+    for (const std::vector<TBlob>* v : blobs) {
+      for (const TBlob &blob : *v) {
+        if (IsHalf(blob)) size += blob.Size();
+      }
+    }
+    return size;
+  }
+
+  /*!
+   * \brief float32 copies of the 16 bit blobs, other blobs are passed as they are.
+   *  The values of outputs are only converted when they are added to.
+   */
+  std::vector<TBlob> ToFloat(const std::vector<TBlob> &blobs,
+                             const std::vector<OpReqType> *req) {
+    std::vector<TBlob> ret(blobs);
+    for (size_t i = 0; i < blobs.size(); ++i) {
+      if (!IsHalf(blobs[i])) continue;
+      float *dptr = buffer_ + used_;
+      used_ += blobs[i].Size();
+      if (!req || (*req)[i] == kAddTo) {
+        MXNET_HALF_TYPE_SWITCH(blobs[i].type_flag_, DType, {
+          half_cpu::HalfToFloatParallel(blobs[i].dptr<DType>(), dptr, blobs[i].Size());
+        });
+      }
+      ret[i] = TBlob(dptr, blobs[i].shape_, cpu::kDevMask);
+    }
+    return ret;
+  }
+
+  /*! \brief the float32 outputs are separate buffers, so in place becomes write */
+  static std::vector<OpReqType> FloatReq(const std::vector<OpReqType> &req) {
+    std::vector<OpReqType> ret(req);
+    for (OpReqType &r : ret) {
+      if (r == kWriteInplace) r = kWriteTo;
+    }
+    return ret;
+  }
+
+  static void FromFloat(const std::vector<TBlob> &src, const std::vector<OpReqType> &req,
+                        const std::vector<TBlob> &dst) {
+    for (size_t i = 0; i < dst.size(); ++i) {
+      if (!IsHalf(dst[i]) || req[i] == kNullOp) continue;
+      MXNET_HALF_TYPE_SWITCH(dst[i].type_flag_, DType, {
+        half_cpu::FloatToHalfParallel(src[i].dptr<float>(), dst[i].dptr<DType>(), dst[i].Size());
+      });
+    }
+  }
+
+  std::unique_ptr<Operator> op_;
+  float *buffer_ = nullptr;
+  size_t used_ = 0;
+};  // class HalfCPUOp
+
+/*!
+ * \brief FullyConnected on 16 bit arrays. Forward converts the weights a panel
+ *  at a time instead of as a whole, see half_cpu::Linear.
+ */
+class FullyConnectedHalfCPUOp : public HalfCPUOp {
+ public:
+  explicit FullyConnectedHalfCPUOp(FullyConnectedParam param)
+    : HalfCPUOp(new FullyConnectedOp<cpu, float>(param)), param_(param) {}
+
+  virtual void Forward(const OpContext &ctx,
+                       const std::vector<TBlob> &in_data,
+                       const std::vector<OpReqType> &req,
+                       const std::vector<TBlob> &out_data,
+                       const std::vector<TBlob> &aux_args) {
+    if (req[fullc::kOut] == kNullOp) return;
+    CHECK_EQ(req[fullc::kOut], kWriteTo);
+    const TShape &ishape = in_data[fullc::kData].shape_;
+    const int n = ishape[0], k = ishape.ProdShape(1, ishape.ndim());
+    const int m = in_data[fullc::kWeight].shape_[0];
+    Space workspace(half_cpu::LinearWorkspaceSize(n, k, m));
+    MXNET_HALF_TYPE_SWITCH(out_data[fullc::kOut].type_flag_, DType, {
+      half_cpu::Linear(in_data[fullc::kData].dptr<DType>(), in_data[fullc::kWeight].dptr<DType>(),
+                       param_.no_bias ? nullptr : in_data[fullc::kBias].dptr<DType>(),
+                       out_data[fullc::kOut].dptr<DType>(), n, k, m, workspace.dptr());
+    });
+  }
+
+ private:
+  FullyConnectedParam param_;
+};  // class FullyConnectedHalfCPUOp
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_HALF_CPU_OP_H_
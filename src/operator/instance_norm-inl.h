@@ -16,6 +16,7 @@
 #include <utility>
 #include "./operator_common.h"
 #include "./mshadow_op.h"
+#include "./nn/layer_norm-inl.h"
 
 namespace mxnet {
 namespace op {
@@ -69,6 +70,13 @@ class InstanceNormOp : public Operator {
     Tensor<xpu, 1> var = out_data[instance_norm::kVar].FlatTo1D<xpu, real_t>(s);
     Tensor<xpu, 1> mean =
         out_data[instance_norm::kMean].FlatTo1D<xpu, real_t>(s);
+    // On CPU, fused statistics and normalization
+    const norm::NormLayout layout{n * c, c, 1, rest_dim};
+    if (norm::NormForwardBlocked(s, data.dptr_, gamma.dptr_, beta.dptr_, out.dptr_,
+                                 mean.dptr_, var.dptr_, layout, param_.eps,
+                                 req[instance_norm::kOut])) {
+      return;
+    }
     // Calculate mean + var
     mean = scale * sumall_except_dim<0>(data);
     var = scale * sumall_except_dim<0>(F<mshadow_op::square>(
@@ -121,6 +129,15 @@ class InstanceNormOp : public Operator {
     Tensor<xpu, 1> var = out_data[instance_norm::kVar].FlatTo1D<xpu, real_t>(s);
     Tensor<xpu, 1> mean =
         out_data[instance_norm::kMean].FlatTo1D<xpu, real_t>(s);
+    // On CPU, fused gradients
+    const norm::NormLayout layout{n * c, c, 1, rest_dim};
+    if (norm::NormBackwardBlocked(s, gout.dptr_, data.dptr_, gamma.dptr_, mean.dptr_,
+                                  var.dptr_, gdata.dptr_, ggamma.dptr_, gbeta.dptr_,
+                                  layout, param_.eps, req[instance_norm::kData],
+                                  req[instance_norm::kGamma], req[instance_norm::kBeta],
+                                  ctx.requested[instance_norm::kTempSpace])) {
+      return;
+    }
     // Get temp space
     Tensor<xpu, 2> workspace =
         ctx.requested[instance_norm::kTempSpace].get_space<xpu>(
@@ -10,6 +10,7 @@
 #include <vector>
 #include "./mshadow_op.h"
 #include "./elemwise_op_common.h"
+#include "./nn/blocked_softmax.h"
 
 namespace mxnet {
 namespace op {
@@ -44,6 +45,7 @@ void SoftmaxCrossEntropyForward(const nnvm::NodeAttrs& attrs,
     mshadow::Tensor<xpu, 1, DType> out = outputs[0].get<xpu, 1, DType>(s);
     mshadow::Tensor<xpu, 1, DType> mlabel = inputs[1].get<xpu, 1, DType>(s);
     mshadow::Tensor<xpu, 2, DType> mdata = inputs[0].get<xpu, 2, DType>(s);
+    if (SoftmaxCrossEntropyBlocked(out, mdata, mlabel, req[0])) return;
     mshadow::Tensor<xpu, 1, DType> workspace = ctx.requested[0].get_space_typed<xpu, 1, DType>(
         mshadow::Shape1(mdata.shape_.Size() + mlabel.size(0)), s);
     mshadow::Tensor<xpu, 2, DType> temp1(workspace.dptr_, mdata.shape_, s);
@@ -77,6 +79,7 @@ void SoftmaxCrossEntropyBackward(const nnvm::NodeAttrs& attrs,
     mshadow::Tensor<xpu, 2, DType> mdata = inputs[1].get<xpu, 2, DType>(s);
     mshadow::Tensor<xpu, 2, DType> mdata_grad = outputs[0].get<xpu, 2, DType>(s);
     mshadow::Tensor<xpu, 1, DType> mscale = inputs[0].get<xpu, 1, DType>(s);
+    if (SoftmaxCrossEntropyGradBlocked(mdata_grad, mdata, mlabel, mscale, req[0])) return;
     mshadow::Tensor<xpu, 2, DType> temp = ctx.requested[0].get_space_typed<xpu, 2, DType>(
         mdata.shape_, s);
     mshadow::Softmax(temp, mdata);
@@ -0,0 +1,534 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file blocked_softmax.h
+ * \brief vectorized softmax, log softmax and softmax cross entropy on CPU
+ */
+#ifndef MXNET_OPERATOR_NN_BLOCKED_SOFTMAX_H_
+#define MXNET_OPERATOR_NN_BLOCKED_SOFTMAX_H_
+
+#include <mxnet/base.h>
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include "../half_cpu.h"
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MXNET_SOFTMAX_USE_SSE 1
+#else
+#define MXNET_SOFTMAX_USE_SSE 0
+#endif
+
+namespace mxnet {
+namespace op {
+namespace softmax_cpu {
+/*!
+ * \brief number of columns processed together when the softmax axis is not
+ *  the last one, the values of a block along the axis are contiguous.
+ */
+const int kBlock = 64;
+
+/*! \brief type in which the sums of DType values are accumulated */
+template<typename DType>
+struct AccType {
+  typedef typename std::conditional<std::is_same<DType, double>::value,
+                                    double, float>::type type;
+};
+
+/*!
+ * \brief exp(x) for x <= 0 as 2^n * p(r), with n = round(x / ln 2) and
+ *  |r| <= ln(2) / 2. The accurate polynomial is the one of Cephes expf and is
+ *  within 2 ulp of exp, the fast one has degree 4 and a relative error below 5e-5.
+ */
+template<bool fast>
+inline float ExpPoly(float r) {
+  if (fast) {
+    return ((r * (1.0f / 24) + (1.0f / 6)) * r + 0.5f) * r * r + r + 1.0f;
+  }
+  return (((((1.9875691500e-4f * r + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r +
+            4.1665795894e-2f) * r + 1.6666665459e-1f) * r + 5.0000001201e-1f) * r * r + r + 1.0f;
+}
+
+template<bool fast>
+inline float Exp(float x) {
+  x = std::min(std::max(x, -87.33654f), 88.0f);
+  const float n = std::nearbyint(x * 1.44269504088896341f);
+  const float r = x - n * 0.693359375f + n * 2.12194440e-4f;
+  const int32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+  float scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return ExpPoly<fast>(r) * scale;
+}
+
+template<bool fast>
+inline double Exp(double x) {
+  return std::exp(x);
+}
+
+#if MXNET_SOFTMAX_USE_SSE
+/*! \brief Exp on four values */
+template<bool fast>
+inline __m128 Exp(__m128 x) {
+  x = _mm_max_ps(_mm_min_ps(x, _mm_set1_ps(88.0f)), _mm_set1_ps(-87.33654f));
+  const __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)));
+  const __m128 fn = _mm_cvtepi32_ps(n);
+  const __m128 r = _mm_add_ps(_mm_sub_ps(x, _mm_mul_ps(fn, _mm_set1_ps(0.693359375f))),
+                              _mm_mul_ps(fn, _mm_set1_ps(2.12194440e-4f)));
+  __m128 p;
+  if (fast) {
+    p = _mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(1.0f / 24)), _mm_set1_ps(1.0f / 6));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(0.5f));
+  } else {
+    p = _mm_add_ps(_mm_mul_ps(r, _mm_set1_ps(1.9875691500e-4f)), _mm_set1_ps(1.3981999507e-3f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(8.3334519073e-3f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(4.1665795894e-2f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.6666665459e-1f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(5.0000001201e-1f));
+  }
+  p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), _mm_set1_ps(1.0f));
+  const __m128i bits = _mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23);
+  return _mm_mul_ps(p, _mm_castsi128_ps(bits));
+}
+
+inline float HorizontalSum(__m128 v) {
+  v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+  return _mm_cvtss_f32(v);
+}
+#endif  // MXNET_SOFTMAX_USE_SSE
+
+/*! \brief maximum of x[0, n) */
+template<typename DType>
+inline typename AccType<DType>::type Max(const DType* x, int n) {
+  typedef typename AccType<DType>::type AType;
+  AType m = static_cast<AType>(x[0]);
+  for (int i = 1; i < n; ++i) m = std::max(m, static_cast<AType>(x[i]));
+  return m;
+}
+
+/*! \brief m[i] = max(m[i], x[i]) for i in [0, n) */
+template<typename DType, typename AType>
+inline void MaxInto(const DType* x, AType* m, int n) {
+  for (int i = 0; i < n; ++i) m[i] = std::max(m[i], static_cast<AType>(x[i]));
+}
+
+/*! \brief sum of exp(x[i] - m) for i in [0, n), the values are stored in y if not null */
+template<bool fast, typename DType, typename AType>
+inline AType ExpSum(const DType* x, AType m, DType* y, int n) {
+  AType sum = 0;
+  for (int i = 0; i < n; ++i) {
+    const AType e = Exp<fast>(static_cast<AType>(x[i]) - m);
+    if (y) y[i] = static_cast<DType>(e);
+    sum += e;
+  }
+  return sum;
+}
+
+/*! \brief sum[i] += exp(x[i] - m[i]) for i in [0, n), the values are stored in y if not null */
+template<bool fast, typename DType, typename AType>
+inline void ExpAccumulate(const DType* x, const AType* m, DType* y, AType* sum, int n) {
+  for (int i = 0; i < n; ++i) {
+    const AType e = Exp<fast>(static_cast<AType>(x[i]) - m[i]);
+    if (y) y[i] = static_cast<DType>(e);
+    sum[i] += e;
+  }
+}
+
+#if MXNET_SOFTMAX_USE_SSE
+template<>
+inline float Max<float>(const float* x, int n) {
+  int i = 0;
+  float m = x[0];
+  if (n >= 4) {
+    __m128 vm = _mm_loadu_ps(x);
+    for (i = 4; i + 4 <= n; i += 4) vm = _mm_max_ps(vm, _mm_loadu_ps(x + i));
+    vm = _mm_max_ps(vm, _mm_movehl_ps(vm, vm));
+    vm = _mm_max_ss(vm, _mm_shuffle_ps(vm, vm, 1));
+    m = _mm_cvtss_f32(vm);
+  }
+  for (; i < n; ++i) m = std::max(m, x[i]);
+  return m;
+}
+
+template<bool fast>
+inline float ExpSum(const float* x, float m, float* y, int n) {
+  int i = 0;
+  const __m128 vm = _mm_set1_ps(m);
+  __m128 vsum = _mm_setzero_ps();
+  for (; i + 4 <= n; i += 4) {
+    const __m128 e = Exp<fast>(_mm_sub_ps(_mm_loadu_ps(x + i), vm));
+    if (y) _mm_storeu_ps(y + i, e);
+    vsum = _mm_add_ps(vsum, e);
+  }
+  float sum = HorizontalSum(vsum);
+  for (; i < n; ++i) {
+    const float e = Exp<fast>(x[i] - m);
+    if (y) y[i] = e;
+    sum += e;
+  }
+  return sum;
+}
+
+template<bool fast>
+inline void ExpAccumulate(const float* x, const float* m, float* y, float* sum, int n) {
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const __m128 e = Exp<fast>(_mm_sub_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(m + i)));
+    if (y) _mm_storeu_ps(y + i, e);
+    _mm_storeu_ps(sum + i, _mm_add_ps(_mm_loadu_ps(sum + i), e));
+  }
+  for (; i < n; ++i) {
+    const float e = Exp<fast>(x[i] - m[i]);
+    if (y) y[i] = e;
+    sum[i] += e;
+  }
+}
+#endif  // MXNET_SOFTMAX_USE_SSE
+
+/*!
+ * \brief Softmax of the outer x M x inner array in along its middle axis.
+ *  With inner == 1 each row is contiguous and vectorized along the axis,
+ *  otherwise blocks of kBlock contiguous columns are walked together down
+ *  the axis and vectorized across the columns. out may be in.
+ */
+template<bool fast, typename DType>
+inline void Softmax(const DType* in, DType* out, int outer, int M, int inner, bool log) {
+  typedef typename AccType<DType>::type AType;
+  if (inner == 1) {
+    #pragma omp parallel for
+    for (int i = 0; i < outer; ++i) {
+      const DType* x = in + static_cast<int64_t>(i) * M;
+      DType* y = out + static_cast<int64_t>(i) * M;
+      const AType m = Max(x, M);
+      if (log) {
+        const AType lse = m + std::log(ExpSum<fast>(x, m, static_cast<DType*>(nullptr), M));
+        for (int j = 0; j < M; ++j) y[j] = static_cast<DType>(static_cast<AType>(x[j]) - lse);
+      } else {
+        const AType scale = AType(1) / ExpSum<fast>(x, m, y, M);
+        for (int j = 0; j < M; ++j) y[j] = static_cast<DType>(static_cast<AType>(y[j]) * scale);
+      }
+    }
+    return;
+  }
+  const int nblock = (inner + kBlock - 1) / kBlock;
+  #pragma omp parallel for
+  for (int t = 0; t < outer * nblock; ++t) {
+    const int c0 = (t % nblock) * kBlock, w = std::min(kBlock, inner - c0);
+    const int64_t offset = static_cast<int64_t>(t / nblock) * M * inner + c0;
+    const DType* x = in + offset;
+    DType* y = out + offset;
+    AType m[kBlock], sum[kBlock];
+    for (int k = 0; k < w; ++k) {
+      m[k] = static_cast<AType>(x[k]);
+      sum[k] = 0;
+    }
+    for (int j = 1; j < M; ++j) MaxInto(x + j * inner, m, w);
+    for (int j = 0; j < M; ++j) {
+      ExpAccumulate<fast>(x + j * inner, m, log ? nullptr : y + j * inner, sum, w);
+    }
+    if (log) {
+      for (int k = 0; k < w; ++k) m[k] += std::log(sum[k]);
+      for (int j = 0; j < M; ++j) {
+        for (int k = 0; k < w; ++k) {
+          y[j * inner + k] = static_cast<DType>(static_cast<AType>(x[j * inner + k]) - m[k]);
+        }
+      }
+    } else {
+      for (int k = 0; k < w; ++k) sum[k] = AType(1) / sum[k];
+      for (int j = 0; j < M; ++j) {
+        for (int k = 0; k < w; ++k) {
+          y[j * inner + k] = static_cast<DType>(static_cast<AType>(y[j * inner + k]) * sum[k]);
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * \brief Gradient of Softmax from its output, laid out as in Softmax:
+ *  igrad = out * (ograd - sum(ograd * out)) for softmax and
+ *  igrad = ograd - exp(out) * sum(ograd) for log softmax. igrad may be
+ *  ograd or out.
+ */
+template<bool fast, typename DType>
+inline void SoftmaxGrad(const DType* out, const DType* ograd, DType* igrad,
+                        int outer, int M, int inner, bool log) {
+  typedef typename AccType<DType>::type AType;
+  if (inner == 1) {
+    #pragma omp parallel for
+    for (int i = 0; i < outer; ++i) {
+      const DType* o = out + static_cast<int64_t>(i) * M;
+      const DType* g = ograd + static_cast<int64_t>(i) * M;
+      DType* dx = igrad + static_cast<int64_t>(i) * M;
+      AType sum = 0;
+      for (int j = 0; j < M; ++j) {
+        sum += log ? static_cast<AType>(g[j]) :
+                     static_cast<AType>(g[j]) * static_cast<AType>(o[j]);
+      }
+      if (log) {
+        // exp(out) by blocks, dx may be ograd
+        DType e[kBlock];
+        for (int j0 = 0; j0 < M; j0 += kBlock) {
+          const int w = std::min(kBlock, M - j0);
+          ExpSum<fast>(o + j0, AType(0), e, w);
+          for (int j = 0; j < w; ++j) {
+            dx[j0 + j] = static_cast<DType>(static_cast<AType>(g[j0 + j]) -
+                                            static_cast<AType>(e[j]) * sum);
+          }
+        }
+      } else {
+        for (int j = 0; j < M; ++j) {
+          dx[j] = static_cast<DType>(static_cast<AType>(o[j]) *
+                                     (static_cast<AType>(g[j]) - sum));
+        }
+      }
+    }
+    return;
+  }
+  const int nblock = (inner + kBlock - 1) / kBlock;
+  #pragma omp parallel for
+  for (int t = 0; t < outer * nblock; ++t) {
+    const int c0 = (t % nblock) * kBlock, w = std::min(kBlock, inner - c0);
+    const int64_t offset = static_cast<int64_t>(t / nblock) * M * inner + c0;
+    const DType* o = out + offset;
+    const DType* g = ograd + offset;
+    DType* dx = igrad + offset;
+    AType sum[kBlock] = {0};
+    for (int j = 0; j < M; ++j) {
+      for (int k = 0; k < w; ++k) {
+        sum[k] += log ? static_cast<AType>(g[j * inner + k]) :
+                        static_cast<AType>(g[j * inner + k]) * static_cast<AType>(o[j * inner + k]);
+      }
+    }
+    DType e[kBlock];
+    for (int j = 0; j < M; ++j) {
+      const int64_t base = static_cast<int64_t>(j) * inner;
+      if (log) ExpSum<fast>(o + base, AType(0), e, w);
+      for (int k = 0; k < w; ++k) {
+        const AType gk = static_cast<AType>(g[base + k]);
+        dx[base + k] = static_cast<DType>(log ? gk - static_cast<AType>(e[k]) * sum[k] :
+                                          static_cast<AType>(o[base + k]) * (gk - sum[k]));
+      }
+    }
+  }
+}
+
+/*!
+ * \brief sum over the rows of data of -log(max(softmax(row)[label], 1e-8)),
+ *  computed as min(logsumexp(row) - row[label], -log(1e-8)) without storing
+ *  the probabilities.
+ */
+template<bool fast, typename DType>
+inline typename AccType<DType>::type SoftmaxCrossEntropy(const DType* data, const DType* label,
+                                                         int n, int k) {
+  typedef typename AccType<DType>::type AType;
+  const AType max_loss = -std::log(AType(1e-8f));
+  AType loss = 0;
+  #pragma omp parallel for reduction(+:loss)
+  for (int i = 0; i < n; ++i) {
+    const DType* x = data + static_cast<int64_t>(i) * k;
+    const AType m = Max(x, k);
+    const AType lse = m + std::log(ExpSum<fast>(x, m, static_cast<DType*>(nullptr), k));
+    const int l = static_cast<int>(label[i]);
+    loss += std::min(lse - static_cast<AType>(x[l]), max_loss);
+  }
+  return loss;
+}
+
+/*! \brief grad = scale * (softmax(data) - one_hot(label)), row by row */
+template<bool fast, typename DType>
+inline void SoftmaxCrossEntropyGrad(const DType* data, const DType* label, DType scale,
+                                    DType* grad, int n, int k) {
+  typedef typename AccType<DType>::type AType;
+  #pragma omp parallel for
+  for (int i = 0; i < n; ++i) {
+    const DType* x = data + static_cast<int64_t>(i) * k;
+    DType* g = grad + static_cast<int64_t>(i) * k;
+    const AType m = Max(x, k);
+    const AType factor = static_cast<AType>(scale) / ExpSum<fast>(x, m, g, k);
+    for (int j = 0; j < k; ++j) g[j] = static_cast<DType>(static_cast<AType>(g[j]) * factor);
+    const int l = static_cast<int>(label[i]);
+    g[l] = static_cast<DType>(static_cast<AType>(g[l]) - static_cast<AType>(scale));
+  }
+}
+
+/*! \brief whether exp is approximated with the faster, less accurate polynomial */
+inline bool FastExp() {
+  static const bool fast = dmlc::GetEnv("MXNET_SOFTMAX_FAST_EXP", false);
+  return fast;
+}
+}  // namespace softmax_cpu
+
+/*! \brief sizes before, along and after axis */
+inline void SoftmaxAxisSizes(const TShape& shape, int axis, int* outer, int* M, int* inner) {
+  *outer = 1;
+  *inner = 1;
+  for (int i = 0; i < axis; ++i) *outer *= shape[i];
+  for (index_t i = axis + 1; i < shape.ndim(); ++i) *inner *= shape[i];
+  *M = shape[axis];
+}
+
+/*!
+ * \brief Softmax or log softmax of in along axis with softmax_cpu::Softmax.
+ * \return whether it was computed, the GPU overload returns false to let the
+ *  caller run its kernels.
+ */
+template<typename DType>
+inline bool SoftmaxBlocked(mshadow::Stream<cpu> *s, const DType* in, DType* out,
+                           const TShape& shape, int axis, bool log) {
+  int outer, M, inner;
+  SoftmaxAxisSizes(shape, axis, &outer, &M, &inner);
+  if (softmax_cpu::FastExp()) {
+    softmax_cpu::Softmax<true>(in, out, outer, M, inner, log);
+  } else {
+    softmax_cpu::Softmax<false>(in, out, outer, M, inner, log);
+  }
+  return true;
+}
+
+/*! \brief float16 and bfloat16 are computed in float32 */
+template<typename DType>
+inline bool SoftmaxBlockedHalf(mshadow::Stream<cpu> *s, const DType* in, DType* out,
+                               const TShape& shape, int axis, bool log) {
+  std::vector<float> x(shape.Size()), y(shape.Size());
+  half_cpu::HalfToFloatParallel(in, x.data(), x.size());
+  SoftmaxBlocked(s, x.data(), y.data(), shape, axis, log);
+  half_cpu::FloatToHalfParallel(y.data(), out, y.size());
+  return true;
+}
+
+inline bool SoftmaxBlocked(mshadow::Stream<cpu> *s, const half_cpu::half_t* in,
+                           half_cpu::half_t* out, const TShape& shape, int axis, bool log) {
+  return SoftmaxBlockedHalf(s, in, out, shape, axis, log);
+}
+
+inline bool SoftmaxBlocked(mshadow::Stream<cpu> *s, const half_cpu::bf16_t* in,
+                           half_cpu::bf16_t* out, const TShape& shape, int axis, bool log) {
+  return SoftmaxBlockedHalf(s, in, out, shape, axis, log);
+}
+
+template<typename DType>
+inline bool SoftmaxBlocked(mshadow::Stream<gpu> *s, const DType* in, DType* out,
+                           const TShape& shape, int axis, bool log) {
+  return false;
+}
+
+/*! \brief Softmax along the second axis of a 2 or 3 dimensional tensor */
+template<int ndim, typename DType>
+inline bool SoftmaxBlocked(const mshadow::Tensor<cpu, ndim, DType>& dst,
+                           const mshadow::Tensor<cpu, ndim, DType>& src) {
+  if (!dst.CheckContiguous() || !src.CheckContiguous()) return false;
+  return SoftmaxBlocked(dst.stream_, src.dptr_, dst.dptr_, TShape(src.shape_), 1, false);
+}
+
+template<int ndim, typename DType>
+inline bool SoftmaxBlocked(const mshadow::Tensor<gpu, ndim, DType>& dst,
+                           const mshadow::Tensor<gpu, ndim, DType>& src) {
+  return false;
+}
+
+/*! \brief Gradient of SoftmaxBlocked from its output */
+template<typename DType>
+inline bool SoftmaxGradBlocked(mshadow::Stream<cpu> *s, const DType* out, const DType* ograd,
+                               DType* igrad, const TShape& shape, int axis, bool log) {
+  int outer, M, inner;
+  SoftmaxAxisSizes(shape, axis, &outer, &M, &inner);
+  if (softmax_cpu::FastExp()) {
+    softmax_cpu::SoftmaxGrad<true>(out, ograd, igrad, outer, M, inner, log);
+  } else {
+    softmax_cpu::SoftmaxGrad<false>(out, ograd, igrad, outer, M, inner, log);
+  }
+  return true;
+}
+
+/*! \brief float16 and bfloat16 are computed in float32 */
+template<typename DType>
+inline bool SoftmaxGradBlockedHalf(mshadow::Stream<cpu> *s, const DType* out,
+                                   const DType* ograd, DType* igrad,
+                                   const TShape& shape, int axis, bool log) {
+  const size_t n = shape.Size();
+  std::vector<float> y(n), dy(n), dx(n);
+  half_cpu::HalfToFloatParallel(out, y.data(), n);
+  half_cpu::HalfToFloatParallel(ograd, dy.data(), n);
+  SoftmaxGradBlocked(s, y.data(), dy.data(), dx.data(), shape, axis, log);
+  half_cpu::FloatToHalfParallel(dx.data(), igrad, n);
+  return true;
+}
+
+inline bool SoftmaxGradBlocked(mshadow::Stream<cpu> *s, const half_cpu::half_t* out,
+                               const half_cpu::half_t* ograd, half_cpu::half_t* igrad,
+                               const TShape& shape, int axis, bool log) {
+  return SoftmaxGradBlockedHalf(s, out, ograd, igrad, shape, axis, log);
+}
+
+inline bool SoftmaxGradBlocked(mshadow::Stream<cpu> *s, const half_cpu::bf16_t* out,
+                               const half_cpu::bf16_t* ograd, half_cpu::bf16_t* igrad,
+                               const TShape& shape, int axis, bool log) {
+  return SoftmaxGradBlockedHalf(s, out, ograd, igrad, shape, axis, log);
+}
+
+template<typename DType>
+inline bool SoftmaxGradBlocked(mshadow::Stream<gpu> *s, const DType* out, const DType* ograd,
+                               DType* igrad, const TShape& shape, int axis, bool log) {
+  return false;
+}
+
+/*! \brief out (op)= cross entropy of softmax(data) and label, without the probabilities */
+template<typename DType>
+inline bool SoftmaxCrossEntropyBlocked(const mshadow::Tensor<cpu, 1, DType>& out,
+                                       const mshadow::Tensor<cpu, 2, DType>& data,
+                                       const mshadow::Tensor<cpu, 1, DType>& label,
+                                       OpReqType req) {
+  if (req == kNullOp) return true;
+  if (!data.CheckContiguous()) return false;
+  const int n = data.size(0), k = data.size(1);
+  const DType loss = static_cast<DType>(softmax_cpu::FastExp() ?
+      softmax_cpu::SoftmaxCrossEntropy<true>(data.dptr_, label.dptr_, n, k) :
+      softmax_cpu::SoftmaxCrossEntropy<false>(data.dptr_, label.dptr_, n, k));
+  out[0] = req == kAddTo ? out[0] + loss : loss;
+  return true;
+}
+
+template<typename DType>
+inline bool SoftmaxCrossEntropyBlocked(const mshadow::Tensor<gpu, 1, DType>& out,
+                                       const mshadow::Tensor<gpu, 2, DType>& data,
+                                       const mshadow::Tensor<gpu, 1, DType>& label,
+                                       OpReqType req) {
+  return false;
+}
+
+/*! \brief grad = scale * (softmax(data) - one_hot(label)), writing grad only once */
+template<typename DType>
+inline bool SoftmaxCrossEntropyGradBlocked(const mshadow::Tensor<cpu, 2, DType>& grad,
+                                           const mshadow::Tensor<cpu, 2, DType>& data,
+                                           const mshadow::Tensor<cpu, 1, DType>& label,
+                                           const mshadow::Tensor<cpu, 1, DType>& scale,
+                                           OpReqType req) {
+  if (req == kAddTo || !data.CheckContiguous() || !grad.CheckContiguous()) return false;
+  if (req == kNullOp) return true;
+  const int n = data.size(0), k = data.size(1);
+  if (softmax_cpu::FastExp()) {
+    softmax_cpu::SoftmaxCrossEntropyGrad<true>(data.dptr_, label.dptr_, scale[0], grad.dptr_, n, k);
+  } else {
+    softmax_cpu::SoftmaxCrossEntropyGrad<false>(data.dptr_, label.dptr_, scale[0], grad.dptr_,
+                                                n, k);
+  }
+  return true;
+}
+
+template<typename DType>
+inline bool SoftmaxCrossEntropyGradBlocked(const mshadow::Tensor<gpu, 2, DType>& grad,
+                                           const mshadow::Tensor<gpu, 2, DType>& data,
+                                           const mshadow::Tensor<gpu, 1, DType>& label,
+                                           const mshadow::Tensor<gpu, 1, DType>& scale,
+                                           OpReqType req) {
+  return false;
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_NN_BLOCKED_SOFTMAX_H_
@@ -0,0 +1,434 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file layer_norm-inl.h
+ * \brief fused layer, group and instance normalization on CPU
+ */
+#ifndef MXNET_OPERATOR_NN_LAYER_NORM_INL_H_
+#define MXNET_OPERATOR_NN_LAYER_NORM_INL_H_
+
+#include <dmlc/logging.h>
+#include <dmlc/parameter.h>
+#include <dmlc/omp.h>
+#include <mxnet/operator_util.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../mshadow_op.h"
+#include "../mxnet_op.h"
+#include "../operator_common.h"
+#include "../elemwise_op_common.h"
+
+namespace mxnet {
+namespace op {
+
+namespace norm {
+enum NormInputs { kData, kGamma, kBeta };
+enum NormOutputs { kOut, kMean, kVar };
+enum NormBackwardInputs { kOutGrad, kInData, kInGamma, kInMean, kInVar };
+
+/*! \brief number of elements whose moments are computed from L1 before being merged */
+const int kMomentsChunk = 256;
+
+/*!
+ * \brief How the normalized values are laid out. The data is a sequence of
+ *  rows, each normalized with its own mean and variance. A row is made of
+ *  channels_per_row channels of inner contiguous values. Consecutive rows
+ *  cycle through groups, the channels of group g being
+ *  [g * channels_per_row, (g + 1) * channels_per_row) in gamma and beta.
+ *
+ *  layer norm: groups = 1, channels_per_row = row length, inner = 1.
+ *  instance norm of (N, C, ...): groups = C, channels_per_row = 1.
+ *  group norm of (N, C, ...) with G groups: groups = G, channels_per_row = C / G.
+ */
+struct NormLayout {
+  int rows;
+  int groups;
+  int channels_per_row;
+  int inner;
+  int row_size() const { return channels_per_row * inner; }
+  int channels() const { return groups * channels_per_row; }
+};
+
+/*! \brief type in which the statistics of DType values are accumulated */
+template<typename DType>
+struct NormAccType {
+  typedef typename std::conditional<std::is_same<DType, double>::value,
+                                    double, float>::type type;
+};
+
+/*! \brief out = value, or out += value, depending on req */
+template<typename DType, typename AType>
+inline void AssignReq(DType* out, OpReqType req, AType value) {
+  if (req == kAddTo) {
+    *out = static_cast<DType>(static_cast<AType>(*out) + value);
+  } else if (req != kNullOp) {
+    *out = static_cast<DType>(value);
+  }
+}
+
+/*!
+ * \brief Mean and (biased) variance of x[0, n) in one pass over memory. The
+ *  moments of each chunk of kMomentsChunk values are computed with two loops
+ *  over the chunk, which is then in L1, and merged into the running moments
+ *  as in Welford's algorithm (Chan et al. update), keeping the precision of
+ *  the two pass formula.
+ */
+template<typename DType, typename AType>
+inline void RowMoments(const DType* x, int n, AType* mean, AType* var) {
+  AType m = 0, m2 = 0;
+  int count = 0;
+  for (int start = 0; start < n; start += kMomentsChunk) {
+    const int len = std::min(kMomentsChunk, n - start);
+    const DType* chunk = x + start;
+    AType sum = 0;
+    for (int i = 0; i < len; ++i) sum += static_cast<AType>(chunk[i]);
+    const AType chunk_mean = sum / len;
+    AType chunk_m2 = 0;
+    for (int i = 0; i < len; ++i) {
+      const AType d = static_cast<AType>(chunk[i]) - chunk_mean;
+      chunk_m2 += d * d;
+    }
+    const AType delta = chunk_mean - m;
+    const int total = count + len;
+    m += delta * len / total;
+    m2 += chunk_m2 + delta * delta * (static_cast<AType>(count) * len / total);
+    count = total;
+  }
+  *mean = m;
+  *var = n > 0 ? m2 / n : AType(0);
+}
+
+/*!
+ * \brief out = (x - mean) / sqrt(var + eps) * gamma + beta, with the
+ *  statistics of each row of the layout. Each row is read twice, once for its
+ *  moments and once to normalize it, and the rows are processed in parallel.
+ * \param mean, var set to the statistics of each row.
+ */
+template<typename DType>
+inline void NormForwardCPU(const DType* x, const DType* gamma, const DType* beta,
+                           DType* out, DType* mean, DType* var,
+                           const NormLayout& layout, float eps, OpReqType req) {
+  typedef typename NormAccType<DType>::type AType;
+  const int row_size = layout.row_size();
+  #pragma omp parallel for
+  for (int r = 0; r < layout.rows; ++r) {
+    const DType* xr = x + static_cast<int64_t>(r) * row_size;
+    DType* outr = out + static_cast<int64_t>(r) * row_size;
+    AType m, v;
+    RowMoments(xr, row_size, &m, &v);
+    mean[r] = static_cast<DType>(m);
+    var[r] = static_cast<DType>(v);
+    if (req == kNullOp) continue;
+    const AType inv_std = AType(1) / std::sqrt(v + static_cast<AType>(eps));
+    const int c0 = (r % layout.groups) * layout.channels_per_row;
+    if (layout.inner == 1) {
+      for (int c = 0; c < row_size; ++c) {
+        const AType y = (static_cast<AType>(xr[c]) - m) * inv_std *
+                        static_cast<AType>(gamma[c0 + c]) + static_cast<AType>(beta[c0 + c]);
+        AssignReq(outr + c, req, y);
+      }
+    } else {
+      for (int c = 0; c < layout.channels_per_row; ++c) {
+        const AType scale = static_cast<AType>(gamma[c0 + c]) * inv_std;
+        const AType shift = static_cast<AType>(beta[c0 + c]) - m * scale;
+        const DType* xc = xr + c * layout.inner;
+        DType* outc = outr + c * layout.inner;
+        for (int i = 0; i < layout.inner; ++i) {
+          AssignReq(outc + i, req, static_cast<AType>(xc[i]) * scale + shift);
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * \brief Gradients of NormForwardCPU. With xhat = (x - mean) / std and
+ *  g = dy * gamma, the gradient of a row of size L is
+ *
+ *    dx = (g - sum(g) / L - xhat * sum(g * xhat) / L) / std
+ *
+ *  Each row is read twice: the first pass computes its two sums together with
+ *  the contributions of the row to dgamma = sum(dy * xhat) and dbeta = sum(dy),
+ *  accumulated per thread, and the second writes dx.
+ * \param workspace space for 2 * omp_get_max_threads() * channels values.
+ */
+template<typename DType>
+inline void NormBackwardCPU(const DType* dy, const DType* x, const DType* gamma,
+                            const DType* mean, const DType* var,
+                            DType* dx, DType* dgamma, DType* dbeta,
+                            const NormLayout& layout, float eps,
+                            OpReqType req_data, OpReqType req_gamma, OpReqType req_beta,
+                            typename NormAccType<DType>::type* workspace) {
+  typedef typename NormAccType<DType>::type AType;
+  const int row_size = layout.row_size(), channels = layout.channels();
+  const int nthreads = std::max(1, omp_get_max_threads());
+  std::fill(workspace, workspace + 2 * nthreads * channels, AType(0));
+  #pragma omp parallel num_threads(nthreads)
+  {
+    AType* tgamma = workspace + 2 * omp_get_thread_num() * channels;
+    AType* tbeta = tgamma + channels;
+    #pragma omp for
+    for (int r = 0; r < layout.rows; ++r) {
+      const int64_t offset = static_cast<int64_t>(r) * row_size;
+      const DType* dyr = dy + offset;
+      const DType* xr = x + offset;
+      const AType m = static_cast<AType>(mean[r]);
+      const AType inv_std = AType(1) /
+          std::sqrt(static_cast<AType>(var[r]) + static_cast<AType>(eps));
+      const int c0 = (r % layout.groups) * layout.channels_per_row;
+      AType sum_g = 0, sum_gx = 0;
+      for (int c = 0; c < layout.channels_per_row; ++c) {
+        const AType gm = static_cast<AType>(gamma[c0 + c]);
+        AType sum_dy = 0, sum_dyx = 0;
+        for (int i = c * layout.inner; i < (c + 1) * layout.inner; ++i) {
+          const AType d = static_cast<AType>(dyr[i]);
+          const AType xhat = (static_cast<AType>(xr[i]) - m) * inv_std;
+          sum_dy += d;
+          sum_dyx += d * xhat;
+        }
+        tbeta[c0 + c] += sum_dy;
+        tgamma[c0 + c] += sum_dyx;
+        sum_g += gm * sum_dy;
+        sum_gx += gm * sum_dyx;
+      }
+      if (req_data == kNullOp) continue;
+      const AType mean_g = sum_g / row_size, mean_gx = sum_gx / row_size;
+      DType* dxr = dx + offset;
+      for (int c = 0; c < layout.channels_per_row; ++c) {
+        const AType gm = static_cast<AType>(gamma[c0 + c]);
+        for (int i = c * layout.inner; i < (c + 1) * layout.inner; ++i) {
+          const AType xhat = (static_cast<AType>(xr[i]) - m) * inv_std;
+          AssignReq(dxr + i, req_data,
+                    (gm * static_cast<AType>(dyr[i]) - mean_g - xhat * mean_gx) * inv_std);
+        }
+      }
+    }
+  }
+  for (int c = 0; c < channels; ++c) {
+    AType sum_gamma = 0, sum_beta = 0;
+    for (int t = 0; t < nthreads; ++t) {
+      sum_gamma += workspace[2 * t * channels + c];
+      sum_beta += workspace[2 * t * channels + channels + c];
+    }
+    AssignReq(dgamma + c, req_gamma, sum_gamma);
+    AssignReq(dbeta + c, req_beta, sum_beta);
+  }
+}
+
+/*!
+ * \brief Forward with NormForwardCPU.
+ * \return true, the GPU overload returns false to fall back to the
+ *  expression implementation of the caller.
+ */
+template<typename DType>
+inline bool NormForwardBlocked(mshadow::Stream<cpu> *s, const DType* x, const DType* gamma,
+                               const DType* beta, DType* out, DType* mean, DType* var,
+                               const NormLayout& layout, float eps, OpReqType req) {
+  NormForwardCPU(x, gamma, beta, out, mean, var, layout, eps, req);
+  return true;
+}
+
+template<typename DType>
+inline bool NormForwardBlocked(mshadow::Stream<gpu> *s, const DType* x, const DType* gamma,
+                               const DType* beta, DType* out, DType* mean, DType* var,
+                               const NormLayout& layout, float eps, OpReqType req) {
+  return false;
+}
+
+/*! \brief size of the workspace of NormBackwardCPU, in accumulation values */
+inline size_t NormBackwardWorkspaceSize(const NormLayout& layout) {
+  return 2 * static_cast<size_t>(std::max(1, omp_get_max_threads())) * layout.channels();
+}
+
+/*!
+ * \brief Backward with NormBackwardCPU, its workspace is taken from temp_space.
+ * \return true, the GPU overload returns false to fall back to the
+ *  expression implementation of the caller.
+ */
+template<typename DType>
+inline bool NormBackwardBlocked(mshadow::Stream<cpu> *s, const DType* dy, const DType* x,
+                                const DType* gamma, const DType* mean, const DType* var,
+                                DType* dx, DType* dgamma, DType* dbeta,
+                                const NormLayout& layout, float eps, OpReqType req_data,
+                                OpReqType req_gamma, OpReqType req_beta,
+                                const Resource& temp_space) {
+  typedef typename NormAccType<DType>::type AType;
+  mshadow::Tensor<cpu, 1, AType> workspace = temp_space.get_space_typed<cpu, 1, AType>(
+      mshadow::Shape1(NormBackwardWorkspaceSize(layout)), s);
+  NormBackwardCPU(dy, x, gamma, mean, var, dx, dgamma, dbeta, layout, eps,
+                  req_data, req_gamma, req_beta, workspace.dptr_);
+  return true;
+}
+
+template<typename DType>
+inline bool NormBackwardBlocked(mshadow::Stream<gpu> *s, const DType* dy, const DType* x,
+                                const DType* gamma, const DType* mean, const DType* var,
+                                DType* dx, DType* dgamma, DType* dbeta,
+                                const NormLayout& layout, float eps, OpReqType req_data,
+                                OpReqType req_gamma, OpReqType req_beta,
+                                const Resource& temp_space) {
+  return false;
+}
+}  // namespace norm
+
+struct LayerNormParam : public dmlc::Parameter<LayerNormParam> {
+  int axis;
+  float eps;
+  DMLC_DECLARE_PARAMETER(LayerNormParam) {
+    DMLC_DECLARE_FIELD(axis).set_default(-1)
+      .describe("The first axis of the normalized values: they span the axes from "
+                "`axis` to the last one. Negative values count from the last axis.");
+    DMLC_DECLARE_FIELD(eps).set_default(1e-5f)
+      .describe("An `epsilon` parameter to prevent division by 0.");
+  }
+};
+
+struct GroupNormParam : public dmlc::Parameter<GroupNormParam> {
+  int num_groups;
+  float eps;
+  DMLC_DECLARE_PARAMETER(GroupNormParam) {
+    DMLC_DECLARE_FIELD(num_groups).set_default(1)
+      .describe("Number of groups the channels are divided into.");
+    DMLC_DECLARE_FIELD(eps).set_default(1e-5f)
+      .describe("An `epsilon` parameter to prevent division by 0.");
+  }
+};
+
+inline int LayerNormAxis(const LayerNormParam& param, const TShape& dshape) {
+  const int ndim = static_cast<int>(dshape.ndim());
+  const int axis = param.axis < 0 ? param.axis + ndim : param.axis;
+  CHECK(axis >= 0 && axis < ndim)
+      << "LayerNorm: axis " << param.axis << " out of range for shape " << dshape;
+  return axis;
+}
+
+inline norm::NormLayout LayerNormLayout(const LayerNormParam& param, const TShape& dshape) {
+  const int axis = LayerNormAxis(param, dshape);
+  int rows = 1, row_size = 1;
+  for (int i = 0; i < axis; ++i) rows *= dshape[i];
+  for (int i = axis; i < static_cast<int>(dshape.ndim()); ++i) row_size *= dshape[i];
+  return norm::NormLayout{rows, 1, row_size, 1};
+}
+
+inline norm::NormLayout GroupNormLayout(const GroupNormParam& param, const TShape& dshape) {
+  const int channels = dshape[1];
+  const int inner = static_cast<int>(dshape.Size() / dshape[0] / channels);
+  return norm::NormLayout{static_cast<int>(dshape[0]) * param.num_groups, param.num_groups,
+                          channels / param.num_groups, inner};
+}
+
+inline bool LayerNormShape(const nnvm::NodeAttrs& attrs,
+                           std::vector<TShape> *in_attrs,
+                           std::vector<TShape> *out_attrs) {
+  const LayerNormParam& param = nnvm::get<LayerNormParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 3U) << "Input:[data, gamma, beta]";
+  CHECK_EQ(out_attrs->size(), 3U);
+  const TShape& dshape = in_attrs->at(norm::kData);
+  if (dshape.ndim() == 0) return false;
+  const int axis = LayerNormAxis(param, dshape);
+  const TShape pshape(dshape.begin() + axis, dshape.end());
+  const TShape sshape = axis == 0 ? TShape(mshadow::Shape1(1))
+                                  : TShape(dshape.begin(), dshape.begin() + axis);
+  SHAPE_ASSIGN_CHECK(*in_attrs, norm::kGamma, pshape);
+  SHAPE_ASSIGN_CHECK(*in_attrs, norm::kBeta, pshape);
+  SHAPE_ASSIGN_CHECK(*out_attrs, norm::kOut, dshape);
+  SHAPE_ASSIGN_CHECK(*out_attrs, norm::kMean, sshape);
+  SHAPE_ASSIGN_CHECK(*out_attrs, norm::kVar, sshape);
+  return true;
+}
+
+inline bool GroupNormShape(const nnvm::NodeAttrs& attrs,
+                           std::vector<TShape> *in_attrs,
+                           std::vector<TShape> *out_attrs) {
+  const GroupNormParam& param = nnvm::get<GroupNormParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 3U) << "Input:[data, gamma, beta]";
+  CHECK_EQ(out_attrs->size(), 3U);
+  const TShape& dshape = in_attrs->at(norm::kData);
+  if (dshape.ndim() == 0) return false;
+  CHECK_GE(dshape.ndim(), 2U)
+      << "GroupNorm only supports input tensors of rank >= 2, of the form [batch, channel, ...]";
+  CHECK_GT(param.num_groups, 0);
+  CHECK_EQ(dshape[1] % param.num_groups, 0U)
+      << "GroupNorm: the " << dshape[1] << " channels can not be divided into "
+      << param.num_groups << " groups";
+  SHAPE_ASSIGN_CHECK(*in_attrs, norm::kGamma, TShape(mshadow::Shape1(dshape[1])));
+  SHAPE_ASSIGN_CHECK(*in_attrs, norm::kBeta, TShape(mshadow::Shape1(dshape[1])));
+  SHAPE_ASSIGN_CHECK(*out_attrs, norm::kOut, dshape);
+  SHAPE_ASSIGN_CHECK(*out_attrs, norm::kMean,
+                     TShape(mshadow::Shape2(dshape[0], param.num_groups)));
+  SHAPE_ASSIGN_CHECK(*out_attrs, norm::kVar,
+                     TShape(mshadow::Shape2(dshape[0], param.num_groups)));
+  return true;
+}
+
+template<typename xpu, typename PType, norm::NormLayout (*GetLayout)(const PType&, const TShape&)>
+void NormCompute(const nnvm::NodeAttrs& attrs,
+                 const OpContext& ctx,
+                 const std::vector<TBlob>& inputs,
+                 const std::vector<OpReqType>& req,
+                 const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  CHECK_EQ(inputs.size(), 3U);
+  CHECK_EQ(outputs.size(), 3U);
+  const PType& param = nnvm::get<PType>(attrs.parsed);
+  const norm::NormLayout layout = GetLayout(param, inputs[norm::kData].shape_);
+  Stream<xpu> *s = ctx.get_stream<xpu>();
+  MSHADOW_REAL_TYPE_SWITCH(inputs[norm::kData].type_flag_, DType, {
+    CHECK(norm::NormForwardBlocked(s, inputs[norm::kData].dptr<DType>(),
+                                   inputs[norm::kGamma].dptr<DType>(),
+                                   inputs[norm::kBeta].dptr<DType>(),
+                                   outputs[norm::kOut].dptr<DType>(),
+                                   outputs[norm::kMean].dptr<DType>(),
+                                   outputs[norm::kVar].dptr<DType>(),
+                                   layout, param.eps, req[norm::kOut]))
+        << "Normalization is only implemented on CPU";
+  });
+}
+
+template<typename xpu, typename PType, norm::NormLayout (*GetLayout)(const PType&, const TShape&)>
+void NormGradCompute(const nnvm::NodeAttrs& attrs,
+                     const OpContext& ctx,
+                     const std::vector<TBlob>& inputs,
+                     const std::vector<OpReqType>& req,
+                     const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  CHECK_EQ(inputs.size(), 5U);
+  CHECK_EQ(outputs.size(), 3U);
+  const PType& param = nnvm::get<PType>(attrs.parsed);
+  const norm::NormLayout layout = GetLayout(param, inputs[norm::kInData].shape_);
+  Stream<xpu> *s = ctx.get_stream<xpu>();
+  MSHADOW_REAL_TYPE_SWITCH(inputs[norm::kInData].type_flag_, DType, {
+    CHECK(norm::NormBackwardBlocked(s, inputs[norm::kOutGrad].dptr<DType>(),
+                                    inputs[norm::kInData].dptr<DType>(),
+                                    inputs[norm::kInGamma].dptr<DType>(),
+                                    inputs[norm::kInMean].dptr<DType>(),
+                                    inputs[norm::kInVar].dptr<DType>(),
+                                    outputs[norm::kData].dptr<DType>(),
+                                    outputs[norm::kGamma].dptr<DType>(),
+                                    outputs[norm::kBeta].dptr<DType>(),
+                                    layout, param.eps, req[norm::kData], req[norm::kGamma],
+                                    req[norm::kBeta], ctx.requested[0]))
+        << "Normalization is only implemented on CPU";
+  });
+}
+
+/*! \brief the backward node takes the output gradient, data, gamma, mean and var */
+struct NormGrad {
+  const char *op_name;
+  std::vector<nnvm::NodeEntry> operator()(const nnvm::NodePtr& n,
+                                          const std::vector<nnvm::NodeEntry>& ograds) {
+    std::vector<nnvm::NodeEntry> heads;
+    heads.push_back(ograds[norm::kOut]);
+    heads.push_back(n->inputs[norm::kData]);
+    heads.push_back(n->inputs[norm::kGamma]);
+    heads.push_back(nnvm::NodeEntry{n, norm::kMean, 0});
+    heads.push_back(nnvm::NodeEntry{n, norm::kVar, 0});
+    return MakeGradNode(op_name, n, heads, n->attrs.dict);
+  }
+};
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_NN_LAYER_NORM_INL_H_
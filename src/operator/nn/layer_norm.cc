@@ -0,0 +1,125 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file layer_norm.cc
+ * \brief CPU implementation of layer and group normalization
+ */
+#include "./layer_norm-inl.h"
+
+namespace mxnet {
+namespace op {
+DMLC_REGISTER_PARAMETER(LayerNormParam);
+DMLC_REGISTER_PARAMETER(GroupNormParam);
+
+NNVM_REGISTER_OP(LayerNorm)
+.describe(R"code(Applies layer normalization to the n-dimensional input array.
+
+The values along the axes from `axis` to the last one are normalized together,
+for each index of the leading axes:
+
+.. math::
+
+  out = \frac{data - mean(data, axis)}{\sqrt{var(data, axis) + \epsilon}} * gamma + beta
+
+where `gamma` and `beta` have the shape of the normalized axes. With the default
+`axis=-1`, each vector along the last axis is normalized and `gamma` and `beta`
+are vectors of the size of the last axis.
+
+The mean and variance are computed in a single pass over the data, the values
+are normalized in a second one, and the rows are processed in parallel.
+
+Examples::
+
+  x = [[ 1.,  2.,  3.],
+       [ 2.,  2.,  2.]]
+
+  LayerNorm(x, gamma=[1, 1, 1], beta=[0, 0, 0], eps=0) = [[-1.2247448,  0.,  1.2247448],
+                                                          [ 0.,         0.,  0.       ]]
+
+)code" ADD_FILELINE)
+.set_num_inputs(3)
+.set_num_outputs(3)
+.set_attr_parser(ParamParser<LayerNormParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs)
+  { return std::vector<std::string>{"data", "gamma", "beta"}; })
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", [](const NodeAttrs& attrs)
+  { return std::vector<std::string>{"output", "mean", "var"}; })
+.set_attr<nnvm::FNumVisibleOutputs>("FNumVisibleOutputs", [](const NodeAttrs& attrs)
+  { return 1; })
+.set_attr<nnvm::FInferShape>("FInferShape", LayerNormShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<3, 3>)
+.set_attr<nnvm::FInplaceOption>("FInplaceOption", [](const NodeAttrs& attrs)
+  { return std::vector<std::pair<int, int> >{{0, 0}}; })
+.set_attr<FCompute>("FCompute<cpu>", NormCompute<cpu, LayerNormParam, LayerNormLayout>)
+.set_attr<nnvm::FGradient>("FGradient", NormGrad{"_backward_LayerNorm"})
+.add_argument("data", "NDArray-or-Symbol", "Input data")
+.add_argument("gamma", "NDArray-or-Symbol", "Scale, of the shape of the normalized axes")
+.add_argument("beta", "NDArray-or-Symbol", "Shift, of the shape of the normalized axes")
+.add_arguments(LayerNormParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_LayerNorm)
+.set_num_inputs(5)
+.set_num_outputs(3)
+.set_attr_parser(ParamParser<LayerNormParam>)
+.set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& attrs)
+  { return std::vector<ResourceRequest>{ResourceRequest::kTempSpace}; })
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr<FCompute>("FCompute<cpu>", NormGradCompute<cpu, LayerNormParam, LayerNormLayout>);
+
+NNVM_REGISTER_OP(GroupNorm)
+.describe(R"code(Applies group normalization to the n-dimensional input array.
+
+The input is of the form [batch, channel, spatial_dim1, spatial_dim2, ...]. The
+channels are divided into `num_groups` groups of consecutive channels, and the
+values of each group of each example are normalized together:
+
+.. math::
+
+  out = \frac{data - mean(data, group)}{\sqrt{var(data, group) + \epsilon}} * gamma + beta
+
+where `gamma` and `beta` are vectors of shape [channel]. With `num_groups=1` the
+whole example is normalized, with `num_groups` equal to the number of channels
+this is `InstanceNorm`.
+
+The mean and variance are computed in a single pass over the data, the values
+are normalized in a second one, and the groups are processed in parallel.
+
+This implementation is based on paper:
+
+.. [1] Group Normalization, Y. Wu, K. He, 2018 (arXiv:1803.08494).
+
+)code" ADD_FILELINE)
+.set_num_inputs(3)
+.set_num_outputs(3)
+.set_attr_parser(ParamParser<GroupNormParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames", [](const NodeAttrs& attrs)
+  { return std::vector<std::string>{"data", "gamma", "beta"}; })
+.set_attr<nnvm::FListOutputNames>("FListOutputNames", [](const NodeAttrs& attrs)
+  { return std::vector<std::string>{"output", "mean", "var"}; })
+.set_attr<nnvm::FNumVisibleOutputs>("FNumVisibleOutputs", [](const NodeAttrs& attrs)
+  { return 1; })
+.set_attr<nnvm::FInferShape>("FInferShape", GroupNormShape)
+.set_attr<nnvm::FInferType>("FInferType", ElemwiseType<3, 3>)
+.set_attr<nnvm::FInplaceOption>("FInplaceOption", [](const NodeAttrs& attrs)
+  { return std::vector<std::pair<int, int> >{{0, 0}}; })
+.set_attr<FCompute>("FCompute<cpu>", NormCompute<cpu, GroupNormParam, GroupNormLayout>)
+.set_attr<nnvm::FGradient>("FGradient", NormGrad{"_backward_GroupNorm"})
+.add_argument("data", "NDArray-or-Symbol",
+              "An n-dimensional input array (n > 1) of the form [batch, channel, "
+              "spatial_dim1, spatial_dim2, ...].")
+.add_argument("gamma", "NDArray-or-Symbol", "A vector of length \'channel\', which multiplies "
+              "the normalized input.")
+.add_argument("beta", "NDArray-or-Symbol", "A vector of length \'channel\', which is added to "
+              "the product of the normalized input and the weight.")
+.add_arguments(GroupNormParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_backward_GroupNorm)
+.set_num_inputs(5)
+.set_num_outputs(3)
+.set_attr_parser(ParamParser<GroupNormParam>)
+.set_attr<FResourceRequest>("FResourceRequest", [](const NodeAttrs& attrs)
+  { return std::vector<ResourceRequest>{ResourceRequest::kTempSpace}; })
+.set_attr<nnvm::TIsBackward>("TIsBackward", true)
+.set_attr<FCompute>("FCompute<cpu>", NormGradCompute<cpu, GroupNormParam, GroupNormLayout>);
+
+}  // namespace op
+}  // namespace mxnet
@@ -6,11 +6,13 @@
 #ifndef MXNET_OPERATOR_NN_SOFTMAX_INL_H_
 #define MXNET_OPERATOR_NN_SOFTMAX_INL_H_
 
+#include <type_traits>
 #include <vector>
 
 #include "../mxnet_op.h"
 #include "../operator_common.h"
 #include "../tensor/broadcast_reduce_op.h"
+#include "./blocked_softmax.h"
 
 namespace mxnet {
 namespace op {
@@ -223,7 +225,19 @@ void SoftmaxCompute(const nnvm::NodeAttrs& attrs,
   const SoftmaxParam& param = nnvm::get<SoftmaxParam>(attrs.parsed);
   int axis = CheckAxis(param.axis, inputs[0].ndim());
   TShape shape = AxisShapeCompact(inputs[0].shape_, &axis, true);
+  if (inputs[0].type_flag_ == kBfloat16) {
+    CHECK(SoftmaxBlocked(ctx.get_stream<xpu>(), inputs[0].dptr<bf16_t>(),
+                         outputs[0].dptr<bf16_t>(), shape, axis,
+                         std::is_same<OP, log_softmax_fwd>::value))
+      << "bfloat16 softmax is only supported on cpu";
+    return;
+  }
   MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    if (SoftmaxBlocked(ctx.get_stream<xpu>(), inputs[0].dptr<DType>(),
+                       outputs[0].dptr<DType>(), shape, axis,
+                       std::is_same<OP, log_softmax_fwd>::value)) {
+      return;
+    }
     if (shape.ndim() == 2) {
       Softmax<OP>(ctx.get_stream<xpu>(), inputs[0].dptr<DType>(),
               outputs[0].dptr<DType>(), shape.get<2>(), axis);
@@ -247,7 +261,19 @@ void SoftmaxGradCompute(const nnvm::NodeAttrs& attrs,
   const SoftmaxParam& param = nnvm::get<SoftmaxParam>(attrs.parsed);
   int axis = CheckAxis(param.axis, inputs[0].ndim());
   TShape shape = AxisShapeCompact(inputs[0].shape_, &axis, true);
+  if (inputs[0].type_flag_ == kBfloat16) {
+    CHECK(SoftmaxGradBlocked(ctx.get_stream<xpu>(), inputs[1].dptr<bf16_t>(),
+                             inputs[0].dptr<bf16_t>(), outputs[0].dptr<bf16_t>(), shape, axis,
+                             std::is_same<OP2, log_softmax_bwd>::value))
+      << "bfloat16 softmax is only supported on cpu";
+    return;
+  }
   MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    if (SoftmaxGradBlocked(ctx.get_stream<xpu>(), inputs[1].dptr<DType>(),
+                           inputs[0].dptr<DType>(), outputs[0].dptr<DType>(), shape, axis,
+                           std::is_same<OP2, log_softmax_bwd>::value)) {
+      return;
+    }
     if (shape.ndim() == 2) {
       SoftmaxGrad<OP1, OP2>(ctx.get_stream<xpu>(), inputs[1].dptr<DType>(),
                             inputs[0].dptr<DType>(), outputs[0].dptr<DType>(),
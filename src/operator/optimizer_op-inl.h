@@ -198,7 +198,7 @@ inline void MP_SGDUpdate(const nnvm::NodeAttrs& attrs,
   using namespace mxnet_op;
   const SGDParam& param = nnvm::get<SGDParam>(attrs.parsed);
   Stream<xpu>* s = ctx.get_stream<xpu>();
-  MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+  MXNET_REAL_TYPE_SWITCH_WITH_BF16(inputs[0].type_flag_, DType, {
     Tensor<xpu, 2, DType> weight = inputs[0].FlatTo2D<xpu, DType>(s);
     Tensor<xpu, 2, DType> grad = inputs[1].FlatTo2D<xpu, DType>(s);
     Tensor<xpu, 2, float> weight32 = inputs[2].FlatTo2D<xpu, float>(s);
@@ -232,7 +232,7 @@ struct MP_SGDMomKernel {
     mom_data[i] = mom;
     w = w + mom;
     weight32[i] = w;
-    KERNEL_ASSIGN(out_data[i], req, w);
+    KERNEL_ASSIGN(out_data[i], req, DType(w));
   }
 };
 
@@ -245,7 +245,7 @@ inline void MP_SGDMomUpdate(const nnvm::NodeAttrs& attrs,
   using namespace mxnet_op;
   SGDMomParam param = nnvm::get<SGDMomParam>(attrs.parsed);
   Stream<xpu>* s = ctx.get_stream<xpu>();
-  MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+  MXNET_REAL_TYPE_SWITCH_WITH_BF16(inputs[0].type_flag_, DType, {
     Tensor<xpu, 2, DType> weight = inputs[0].FlatTo2D<xpu, DType>(s);
     Tensor<xpu, 2, DType> grad = inputs[1].FlatTo2D<xpu, DType>(s);
     Tensor<xpu, 2, float> mom = inputs[2].FlatTo2D<xpu, float>(s);
@@ -330,6 +330,50 @@ inline void AdamUpdate(const nnvm::NodeAttrs& attrs,
   });
 }
 
+struct MP_AdamKernel {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, DType* out_data, float* mean_data, float* var_data,
+    const DType* grad_data, float* weight32, const float param_clip_gradient,
+    const float param_beta1, const float param_beta2, const float param_lr,
+    const float param_wd, const float param_epsilon, const float param_rescale_grad,
+    const OpReqType req) {
+    float w = weight32[i];
+    float grad = param_rescale_grad*static_cast<float>(grad_data[i]) + param_wd*w;
+    if (param_clip_gradient >= 0.0f) {
+      grad = mshadow_op::clip::Map(grad, param_clip_gradient);
+    }
+    const float mean = param_beta1*mean_data[i] + (1.f-param_beta1)*grad;
+    const float var = param_beta2*var_data[i] + (1.f-param_beta2)*grad*grad;
+    mean_data[i] = mean;
+    var_data[i] = var;
+    w = w - param_lr*mean/(sqrtf(var) + param_epsilon);
+    weight32[i] = w;
+    KERNEL_ASSIGN(out_data[i], req, DType(w));
+  }
+};
+
+template<typename xpu>
+inline void MP_AdamUpdate(const nnvm::NodeAttrs& attrs,
+                          const OpContext &ctx,
+                          const std::vector<TBlob> &inputs,
+                          const std::vector<OpReqType> &req,
+                          const std::vector<TBlob> &outputs) {
+  using namespace mxnet_op;
+  const AdamParam& param = nnvm::get<AdamParam>(attrs.parsed);
+  Stream<xpu>* s = ctx.get_stream<xpu>();
+  MXNET_REAL_TYPE_SWITCH_WITH_BF16(inputs[0].type_flag_, DType, {
+    Tensor<xpu, 2, DType> weight = inputs[0].FlatTo2D<xpu, DType>(s);
+    Tensor<xpu, 2, DType> grad = inputs[1].FlatTo2D<xpu, DType>(s);
+    Tensor<xpu, 2, float> mean = inputs[2].FlatTo2D<xpu, float>(s);
+    Tensor<xpu, 2, float> var = inputs[3].FlatTo2D<xpu, float>(s);
+    Tensor<xpu, 2, float> weight32 = inputs[4].FlatTo2D<xpu, float>(s);
+    Tensor<xpu, 2, DType> out = outputs[0].FlatTo2D<xpu, DType>(s);
+    Kernel<MP_AdamKernel, xpu>::Launch(s, weight.shape_.Size(), out.dptr_, mean.dptr_,
+      var.dptr_, grad.dptr_, weight32.dptr_, param.clip_gradient, param.beta1, param.beta2,
+      param.lr, param.wd, param.epsilon, param.rescale_grad, req[0]);
+  });
+}
+
 // This RMSProp code follows the version in
 // http://arxiv.org/pdf/1308.0850v5.pdf Eq(38) - Eq(45)
 // by Alex Graves, 2013.
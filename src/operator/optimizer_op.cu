@@ -24,6 +24,9 @@ NNVM_REGISTER_OP(mp_sgd_mom_update)
 NNVM_REGISTER_OP(adam_update)
 .set_attr<FCompute>("FCompute<gpu>", AdamUpdate<gpu>);
 
+NNVM_REGISTER_OP(mp_adam_update)
+.set_attr<FCompute>("FCompute<gpu>", MP_AdamUpdate<gpu>);
+
 NNVM_REGISTER_OP(rmsprop_update)
 .set_attr<FCompute>("FCompute<gpu>", RMSPropUpdate<gpu>);
 
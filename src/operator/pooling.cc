@@ -5,6 +5,7 @@
  * \author Bing Xu, Jun Wu
 */
 #include "./pooling-inl.h"
+#include "./half_cpu_op.h"
 #if MXNET_USE_MKL2017 == 1
 #include <mkl_memory.h>
 #include "./mkl/mkl_memory-inl.h"
@@ -20,6 +21,10 @@ namespace op {
 template<>
 Operator *CreateOp<cpu>(PoolingParam param, int dtype) {
   Operator *op = NULL;
+  if (half_cpu::IsHalfType(dtype)) {
+    // float16 or bfloat16 storage, float32 compute
+    return new HalfCPUOp(CreateOp<cpu>(param, mshadow::kFloat32));
+  }
   // TODO(lingyan): kFull use exclude padding algorithm now
 #if MXNET_USE_MKL2017 == 1
     if (param.kernel.ndim() == 2
@@ -15,6 +15,7 @@ DMLC_REGISTER_PARAMETER(SampleExponentialParam);
 DMLC_REGISTER_PARAMETER(SamplePoissonParam);
 DMLC_REGISTER_PARAMETER(SampleNegBinomialParam);
 DMLC_REGISTER_PARAMETER(SampleGenNegBinomialParam);
+DMLC_REGISTER_PARAMETER(SampleLogUniformParam);
 
 #define MXNET_OPERATOR_REGISTER_SAMPLE(name, ParamType)                 \
   NNVM_REGISTER_OP(name)                                                \
@@ -133,5 +134,26 @@ Example::
 )code" ADD_FILELINE)
 .set_attr<FCompute>("FCompute<cpu>", SampleGenNegBinomial_<cpu>);
 
+MXNET_OPERATOR_REGISTER_SAMPLE(random_log_uniform, SampleLogUniformParam)
+.add_alias("_sample_log_uniform")
+.describe(R"code(Draw random integers from a log-uniform (Zipfian) distribution.
+
+Samples are integers in *[0, range_max)*, returned as a floating point data type,
+and class *c* is drawn with probability
+
+.. math::
+
+   P(c) = \frac{\log(c + 2) - \log(c + 1)}{\log(range\_max + 1)}
+
+This is the usual candidate sampler of sampled softmax for vocabularies whose
+classes are sorted by decreasing frequency.
+
+Example::
+
+   random_log_uniform(range_max=10000, shape=(2,2)) = [[ 3.,  176.],
+                                                       [ 0.,   12.]]
+)code" ADD_FILELINE)
+.set_attr<FCompute>("FCompute<cpu>", SampleLogUniform_<cpu>);
+
 }  // namespace op
 }  // namespace mxnet
@@ -8,9 +8,11 @@
 
 #include <mxnet/operator_util.h>
 #include <mshadow/base.h>
+#include <cmath>
 #include <string>
 #include <vector>
 #include "../mshadow_op.h"
+#include "../mxnet_op.h"
 #include "../elemwise_op_common.h"
 #include "../tensor/init_op.h"
 
@@ -214,6 +216,47 @@ struct SampleGenNegBinomialParam : public dmlc::Parameter<SampleGenNegBinomialPa
   }
 };
 
+struct SampleLogUniformParam : public dmlc::Parameter<SampleLogUniformParam> {
+  int range_max;
+  TShape shape;
+  std::string ctx;
+  int dtype;
+  DMLC_DECLARE_PARAMETER(SampleLogUniformParam) {
+    DMLC_DECLARE_FIELD(range_max).set_lower_bound(1)
+    .describe("The samples are integers in [0, range_max).");
+    DMLC_DECLARE_FIELD(shape)
+    .set_default(TShape())
+    .describe("Shape of the output.");
+    DMLC_DECLARE_FIELD(ctx)
+    .set_default("")
+    .describe("Context of output, in format [cpu|gpu|cpu_pinned](n)."
+              " Only used for imperative calls.");
+    DMLC_DECLARE_FIELD(dtype)
+    .add_enum("None", -1)
+    .add_enum("float32", mshadow::kFloat32)
+    .add_enum("float64", mshadow::kFloat64)
+    .add_enum("float16", mshadow::kFloat16)
+    .set_default(-1)
+    .describe("DType of the output in case this can't be inferred. "
+              "Defaults to float32 if not defined (dtype=None).");
+  }
+};
+
+/*!
+ * \brief Probability of class c under the log-uniform (Zipfian) distribution
+ *  over [0, range_max), P(c) = log((c + 2) / (c + 1)) / log(range_max + 1).
+ *  It suits classes sorted by decreasing frequency, as words of a vocabulary.
+ */
+inline double LogUniformProb(int c, int range_max) {
+  return std::log((c + 2.0) / (c + 1.0)) / std::log(range_max + 1.0);
+}
+
+/*! \brief log-uniform class of a uniform sample u in [0, 1), log_range is log(range_max + 1) */
+MSHADOW_XINLINE int LogUniformClass(float u, float log_range, int range_max) {
+  const int c = static_cast<int>(floorf(expf(u * log_range))) - 1;
+  return c < range_max - 1 ? c : range_max - 1;
+}
+
 template<typename xpu>
 void SampleUniform_(const nnvm::NodeAttrs& attrs,
                     const OpContext& ctx,
@@ -344,6 +387,34 @@ void SampleGenNegBinomial_(const nnvm::NodeAttrs& attrs,
   });
 }
 
+/*! \brief maps uniform samples to log-uniform classes in place */
+struct SampleLogUniformKernel {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, DType* out, float log_range, int range_max) {
+    out[i] = DType(LogUniformClass(static_cast<float>(out[i]), log_range, range_max));
+  }
+};
+
+template<typename xpu>
+void SampleLogUniform_(const nnvm::NodeAttrs& attrs,
+                       const OpContext& ctx,
+                       const std::vector<TBlob>& inputs,
+                       const std::vector<OpReqType>& req,
+                       const std::vector<TBlob>& outputs) {
+  using namespace mxnet::op;
+  using namespace mshadow::expr;
+  mshadow::Stream<xpu> *s = ctx.get_stream<xpu>();
+  const SampleLogUniformParam& param = nnvm::get<SampleLogUniformParam>(attrs.parsed);
+  const float log_range = std::log(param.range_max + 1.0f);
+  MSHADOW_REAL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    mshadow::Random<xpu, DType> *prnd = ctx.requested[0].get_random<xpu, DType>(s);
+    mshadow::Tensor<xpu, 1, DType> out = outputs[0].FlatTo1D<xpu, DType>(s);
+    prnd->SampleUniform(&out, 0, 1);
+    mxnet_op::Kernel<SampleLogUniformKernel, xpu>::Launch(s, out.size(0), out.dptr_,
+                                                          log_range, param.range_max);
+  });
+}
+
 template<typename ParamType>
 inline bool SampleOpType(const nnvm::NodeAttrs& attrs,
                          std::vector<int> *in_type,
@@ -16,6 +16,7 @@
 #include <string>
 #include <utility>
 #include "./operator_common.h"
+#include "./rnn_cpu.h"
 
 namespace mxnet {
 namespace op {
@@ -67,10 +68,15 @@ inline int rnn_param_size(int layerNum,
   return size;
 }
 
+// index of the optional sequence_length input, after the states
+inline int rnn_sequence_length_index(int mode) {
+  return mode == rnn_enum::kLstm ? rnn_enum::kStateCell + 1 : rnn_enum::kState + 1;
+}
+
 struct RNNParam : public dmlc::Parameter<RNNParam> {
   uint32_t state_size;
   uint32_t num_layers;
-  bool bidirectional, state_outputs;
+  bool bidirectional, state_outputs, use_sequence_length;
   int mode;
   float p, pkeep_;
   int seq_length_, batch_size_, input_size_;
@@ -99,13 +105,19 @@ struct RNNParam : public dmlc::Parameter<RNNParam> {
 
     DMLC_DECLARE_FIELD(state_outputs).set_default(false)
     .describe("Whether to have the states as symbol outputs.");
+
+    DMLC_DECLARE_FIELD(use_sequence_length).set_default(false)
+    .describe("If set to true, this layer takes in an extra input parameter `sequence_length` "
+              "to specify variable length sequences. Each sequence stops at its length, "
+              "its output is zero past it and its states are those of its last step. "
+              "Only supported on cpu.");
   }
 };
 
 template<typename xpu, typename DType>
 class RNNOp : public Operator {
  public:
-  explicit RNNOp(RNNParam p) {
+  explicit RNNOp(RNNParam p) : param_(p) {
   }
 
   virtual void Forward(const OpContext &ctx,
@@ -115,7 +127,29 @@ class RNNOp : public Operator {
                        const std::vector<TBlob> &aux_args) {
     using namespace mshadow;
     using namespace mshadow::expr;
-    // TODO(sbodenstein): add MShadow implementation
+    const bool lstm = param_.mode == rnn_enum::kLstm;
+    CHECK_EQ(in_data.size(), (lstm ? 4U : 3U) + param_.use_sequence_length);
+    CHECK_NE(req[rnn_enum::kOut], kAddTo) << "RNN does not support kAddTo";
+    Stream<xpu> *s = ctx.get_stream<xpu>();
+    // dropout only applies at training time, which needs the cuDNN operator
+    Tensor<xpu, 3, DType> x = in_data[rnn_enum::kData].get<xpu, 3, DType>(s);
+    const int T = x.size(0), N = x.size(1), I = x.size(2), H = param_.state_size;
+    const int D = param_.bidirectional ? 2 : 1;
+    Tensor<xpu, 1, DType> workspace =
+      ctx.requested[rnn_enum::kTempSpace].get_space_typed<xpu, 1, DType>(
+        Shape1(rnn_cpu::WorkspaceSize(T, N, I, H, D, param_.mode)), s);
+    const DType *lengths = param_.use_sequence_length ?
+      in_data[rnn_sequence_length_index(param_.mode)].dptr<DType>() : nullptr;
+    DType *hy = nullptr, *cy = nullptr;
+    if (param_.state_outputs) {
+      hy = out_data[rnn_enum::kStateOut].dptr<DType>();
+      if (lstm) cy = out_data[rnn_enum::kStateCellOut].dptr<DType>();
+    }
+    rnn_cpu::Forward(x.dptr_, in_data[rnn_enum::kParams].dptr<DType>(),
+                     in_data[rnn_enum::kState].dptr<DType>(),
+                     lstm ? in_data[rnn_enum::kStateCell].dptr<DType>() : nullptr,
+                     lengths, T, N, I, H, static_cast<int>(param_.num_layers), D, param_.mode,
+                     out_data[rnn_enum::kOut].dptr<DType>(), hy, cy, workspace.dptr_);
   }
 
   virtual void Backward(const OpContext &ctx,
@@ -125,9 +159,7 @@ class RNNOp : public Operator {
                         const std::vector<OpReqType> &req,
                         const std::vector<TBlob> &in_grad,
                         const std::vector<TBlob> &aux_args) {
-    using namespace mshadow;
-    using namespace mshadow::expr;
-    // TODO(sbodenstein): add MShadow implementation
+    LOG(FATAL) << "RNN backward is only available for gpu at the moment.";
   }
 
  private:
@@ -141,11 +173,12 @@ Operator* CreateOp(RNNParam param, int dtype);
 class RNNProp : public OperatorProperty {
  public:
   std::vector<std::string> ListArguments() const override {
-    if (param_.mode == rnn_enum::kLstm) {
-      return {"data", "parameters", "state", "state_cell"};
-    } else {
-      return {"data", "parameters", "state"};
-    }
+    std::vector<std::string> arguments = {"data", "parameters", "state"};
+    if (param_.mode == rnn_enum::kLstm)
+      arguments.push_back("state_cell");
+    if (param_.use_sequence_length)
+      arguments.push_back("sequence_length");
+    return arguments;
   }
 
   std::vector<std::string> ListOutputs() const override {
@@ -178,9 +211,11 @@ class RNNProp : public OperatorProperty {
                   std::vector<TShape> *aux_shape) const override {
     using namespace mshadow;
     if (param_.mode == rnn_enum::kLstm) {
-      CHECK_EQ(in_shape->size(), 4U) << "Input:[data, parameters, state, cell_state]";
+      CHECK_EQ(in_shape->size(), 4U + param_.use_sequence_length)
+          << "Input:[data, parameters, state, cell_state, (sequence_length)]";
     } else {
-      CHECK_EQ(in_shape->size(), 3U) << "Input:[data, parameters, state]";
+      CHECK_EQ(in_shape->size(), 3U + param_.use_sequence_length)
+          << "Input:[data, parameters, state, (sequence_length)]";
     }
     const TShape &dshape = (*in_shape)[rnn_enum::kData];
     if (dshape.ndim() ==  0) return false;
@@ -198,6 +233,10 @@ class RNNProp : public OperatorProperty {
       SHAPE_ASSIGN_CHECK(*in_shape,
                         rnn_enum::kStateCell,
                         Shape3(total_layers, batch_size, param_.state_size));
+    if (param_.use_sequence_length)
+      SHAPE_ASSIGN_CHECK(*in_shape,
+                         rnn_sequence_length_index(param_.mode),
+                         Shape1(batch_size));
 
     // calculate parameter vector length
     int param_size = rnn_param_size(param_.num_layers,
@@ -11,11 +11,18 @@ namespace mxnet {
 namespace op {
 template<>
 Operator *CreateOp<cpu>(RNNParam param, int dtype) {
-  LOG(FATAL) << "RNN is only available for gpu at the moment.";
+  // the cpu operator computes the forward pass for inference
   Operator *op = NULL;
-  MSHADOW_REAL_TYPE_SWITCH(dtype, DType, {
-    op = new RNNOp<cpu, DType>(param);
-  });
+  switch (dtype) {
+    case mshadow::kFloat32:
+      op = new RNNOp<cpu, float>(param);
+      break;
+    case mshadow::kFloat64:
+      op = new RNNOp<cpu, double>(param);
+      break;
+    default:
+      LOG(FATAL) << "RNN only supports float32 and float64 on cpu";
+  }
   return op;
 }
 
@@ -28,13 +35,21 @@ Operator *RNNProp::CreateOperatorEx(Context ctx,
 DMLC_REGISTER_PARAMETER(RNNParam);
 
 MXNET_REGISTER_OP_PROPERTY(RNN, RNNProp)
-.describe("Applies a recurrent layer to input.")
+.describe(R"code(Applies a recurrent layer to input.
+
+On cpu only the forward pass is available, for inference. With `use_sequence_length`,
+the batch is sorted by length and each step only computes the sequences that are still
+running, so that no time is spent on padding.
+)code" ADD_FILELINE)
 .add_argument("data", "NDArray-or-Symbol", "Input data to RNN")
 .add_argument("parameters", "NDArray-or-Symbol",
               "Vector of all RNN trainable parameters concatenated")
 .add_argument("state", "NDArray-or-Symbol", "initial hidden state of the RNN")
 .add_argument("state_cell", "NDArray-or-Symbol",
               "initial cell state for LSTM networks (only for LSTM)")
+.add_argument("sequence_length", "NDArray-or-Symbol",
+              "vector of valid sequence lengths of size batch_size "
+              "(only with use_sequence_length)")
 .add_arguments(RNNParam::__FIELDS__());
 }  // namespace op
 }  // namespace mxnet
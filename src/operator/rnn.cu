@@ -16,6 +16,7 @@ namespace op {
 template<>
 Operator* CreateOp<gpu>(RNNParam param, int dtype) {
   Operator *op = NULL;
+  CHECK(!param.use_sequence_length) << "RNN only supports use_sequence_length on cpu";
 #if MXNET_USE_CUDNN == 1 && CUDNN_MAJOR >= 5
   MSHADOW_REAL_TYPE_SWITCH(dtype, DType, {
     op = new CuDNNRNNOp<DType>(param);
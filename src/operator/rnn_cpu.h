@@ -0,0 +1,205 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file rnn_cpu.h
+ * \brief CPU forward of the fused RNN operator over variable length sequences
+ *
+ * The batch is sorted by decreasing sequence length and packed time step by time
+ * step, so that the sequences still running at step t are the first n_t rows of
+ * the step. The input projections of a layer are then a single GEMM over the
+ * valid rows only, and each recurrent step works on a shrinking active batch:
+ * no work is spent on padding. The parameters follow the cuDNN layout used by
+ * the GPU operator and by FusedRNNCell.
+*/
+#ifndef MXNET_OPERATOR_RNN_CPU_H_
+#define MXNET_OPERATOR_RNN_CPU_H_
+
+#include <mshadow/tensor.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace mxnet {
+namespace op {
+namespace rnn_cpu {
+
+/*! \brief number of gates of an RNN mode, in the order of rnn_enum::RNNModeType */
+inline int NumGates(int mode) {
+  const int gates[] = {1, 1, 4, 3};
+  return gates[mode];
+}
+
+/*! \brief number of elements of the workspace needed by Forward */
+inline size_t WorkspaceSize(int T, int N, int I, int H, int D, int mode) {
+  const size_t rows = static_cast<size_t>(T) * N, G = NumGates(mode);
+  // two layer buffers, the input projections of a direction and the states
+  return rows * (std::max(I, D * H) + D * H + G * H) + N * (2 + G) * H;
+}
+
+template<typename DType>
+inline DType Sigmoid(DType x) {
+  return DType(1) / (DType(1) + std::exp(-x));
+}
+
+/*!
+ * \brief one recurrent step of n active sequences. gates holds the input projections
+ *  plus both biases, except for the GRU: the recurrent bias bh of its candidate gate
+ *  goes with the recurrent projections hh, inside the reset gate.
+ */
+template<typename DType>
+inline void Step(int mode, int n, int H, const DType* gates, const DType* hh,
+                 const DType* bh, DType* h, DType* c, DType* out, int out_stride) {
+  const int G = NumGates(mode);
+  #pragma omp parallel for
+  for (int k = 0; k < n; ++k) {
+    const DType* g = gates + static_cast<size_t>(k) * G * H;
+    DType* hk = h + static_cast<size_t>(k) * H;
+    DType* ok = out + static_cast<size_t>(k) * out_stride;
+    switch (mode) {
+      case 0:  // rnn_relu
+        for (int j = 0; j < H; ++j) ok[j] = hk[j] = std::max(g[j], DType(0));
+        break;
+      case 1:  // rnn_tanh
+        for (int j = 0; j < H; ++j) ok[j] = hk[j] = std::tanh(g[j]);
+        break;
+      case 2: {  // lstm: input, forget, cell and output gates
+        DType* ck = c + static_cast<size_t>(k) * H;
+        for (int j = 0; j < H; ++j) {
+          ck[j] = Sigmoid(g[H + j]) * ck[j] + Sigmoid(g[j]) * std::tanh(g[2 * H + j]);
+          ok[j] = hk[j] = Sigmoid(g[3 * H + j]) * std::tanh(ck[j]);
+        }
+        break;
+      }
+      default: {  // gru: reset, update and candidate gates
+        const DType* r = hh + static_cast<size_t>(k) * G * H;
+        for (int j = 0; j < H; ++j) {
+          const DType reset = Sigmoid(g[j] + r[j]);
+          const DType update = Sigmoid(g[H + j] + r[H + j]);
+          const DType cand = std::tanh(g[2 * H + j] + reset * (r[2 * H + j] + bh[2 * H + j]));
+          ok[j] = hk[j] = (DType(1) - update) * cand + update * hk[j];
+        }
+      }
+    }
+  }
+}
+
+/*!
+ * \brief forward of a stacked, optionally bidirectional RNN for inference.
+ * \param x input of shape (T, N, I)
+ * \param params flat parameters in the cuDNN layout
+ * \param hx, cx initial states of shape (L * D, N, H), cx only for the LSTM
+ * \param lengths valid length of each sequence, all T if nullptr
+ * \param y output of shape (T, N, D * H), zero past the end of each sequence
+ * \param hy, cy final states, the state at the last valid step, skipped if nullptr
+ * \param workspace WorkspaceSize elements
+ */
+template<typename DType>
+inline void Forward(const DType* x, const DType* params, const DType* hx, const DType* cx,
+                    const DType* lengths, int T, int N, int I, int H, int L, int D, int mode,
+                    DType* y, DType* hy, DType* cy, DType* workspace) {
+  using namespace mshadow;
+  using namespace mshadow::expr;
+  const int G = NumGates(mode), GH = G * H, DH = D * H;
+  // sort the batch by decreasing length, active[t] sequences run at step t
+  std::vector<int> len(N, T), order(N);
+  for (int b = 0; b < N && lengths; ++b) {
+    len[b] = std::min(std::max(static_cast<int>(lengths[b]), 0), T);
+  }
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return len[a] > len[b]; });
+  std::vector<int> active(T, 0), offset(T + 1, 0);
+  for (int b = 0; b < N; ++b) {
+    for (int t = 0; t < len[b]; ++t) ++active[t];
+  }
+  for (int t = 0; t < T; ++t) offset[t + 1] = offset[t] + active[t];
+  const int rows = offset[T];
+  // without padding the packed layout is the input layout
+  const bool packed = rows < T * N;
+
+  DType* buffers[2] = {workspace, workspace + static_cast<size_t>(T) * N * std::max(I, DH)};
+  DType* xproj = buffers[1] + static_cast<size_t>(T) * N * DH;
+  DType* h = xproj + static_cast<size_t>(T) * N * GH;
+  DType* c = h + static_cast<size_t>(N) * H;
+  DType* hh = c + static_cast<size_t>(N) * H;
+
+  const DType* in = x;
+  if (packed) {
+    for (int t = 0; t < T; ++t) {
+      for (int k = 0; k < active[t]; ++k) {
+        std::memcpy(buffers[0] + static_cast<size_t>(offset[t] + k) * I,
+                    x + (static_cast<size_t>(t) * N + order[k]) * I, sizeof(DType) * I);
+      }
+    }
+    in = buffers[0];
+  }
+
+  const DType* w = params;
+  const DType* bias = params;
+  for (int l = 0; l < L; ++l) bias += static_cast<size_t>(D) * GH * ((l ? DH : I) + H);
+  std::vector<DType> bsum(GH);
+  for (int l = 0; l < L; ++l) {
+    const int in_size = l ? DH : I;
+    DType* out = l == L - 1 && !packed ? y : buffers[in == buffers[0] ? 1 : 0];
+    for (int d = 0; d < D; ++d, w += static_cast<size_t>(GH) * (in_size + H), bias += 2 * GH) {
+      const int s = l * D + d;
+      Tensor<cpu, 2, DType> wi(const_cast<DType*>(w), Shape2(GH, in_size));
+      Tensor<cpu, 2, DType> wh(const_cast<DType*>(w) + GH * in_size, Shape2(GH, H));
+      const DType* bi = bias;
+      const DType* bh = bias + GH;
+      for (int j = 0; j < GH; ++j) bsum[j] = bi[j] + (mode == 3 && j >= 2 * H ? 0 : bh[j]);
+      // input projections of all valid steps at once
+      if (rows > 0) {
+        Tensor<cpu, 2, DType> proj(xproj, Shape2(rows, GH));
+        proj = dot(Tensor<cpu, 2, DType>(const_cast<DType*>(in), Shape2(rows, in_size)), wi.T());
+      }
+      #pragma omp parallel for
+      for (int r = 0; r < rows; ++r) {
+        DType* p = xproj + static_cast<size_t>(r) * GH;
+        for (int j = 0; j < GH; ++j) p[j] += bsum[j];
+      }
+      for (int k = 0; k < N; ++k) {
+        const size_t src = (static_cast<size_t>(s) * N + order[k]) * H;
+        std::memcpy(h + static_cast<size_t>(k) * H, hx + src, sizeof(DType) * H);
+        if (mode == 2) std::memcpy(c + static_cast<size_t>(k) * H, cx + src, sizeof(DType) * H);
+      }
+      for (int i = 0; i < T; ++i) {
+        const int t = d ? T - 1 - i : i, n = active[t];
+        if (n == 0) continue;
+        Tensor<cpu, 2, DType> hprev(h, Shape2(n, H));
+        Tensor<cpu, 2, DType> gates(xproj + static_cast<size_t>(offset[t]) * GH, Shape2(n, GH));
+        if (mode == 3) {
+          Tensor<cpu, 2, DType> rec(hh, Shape2(n, GH));
+          rec = dot(hprev, wh.T());
+        } else {
+          gates += dot(hprev, wh.T());
+        }
+        Step(mode, n, H, gates.dptr_, hh, bh, h, c,
+             out + static_cast<size_t>(offset[t]) * DH + d * H, DH);
+      }
+      for (int k = 0; k < N && hy; ++k) {
+        const size_t dst = (static_cast<size_t>(s) * N + order[k]) * H;
+        std::memcpy(hy + dst, h + static_cast<size_t>(k) * H, sizeof(DType) * H);
+        if (mode == 2 && cy) std::memcpy(cy + dst, c + static_cast<size_t>(k) * H,
+                                         sizeof(DType) * H);
+      }
+    }
+    in = out;
+  }
+
+  if (packed) {
+    // unpack the last layer, padding steps are zero
+    std::fill(y, y + static_cast<size_t>(T) * N * DH, DType(0));
+    for (int t = 0; t < T; ++t) {
+      for (int k = 0; k < active[t]; ++k) {
+        std::memcpy(y + (static_cast<size_t>(t) * N + order[k]) * DH,
+                    in + static_cast<size_t>(offset[t] + k) * DH, sizeof(DType) * DH);
+      }
+    }
+  }
+}
+
+}  // namespace rnn_cpu
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_RNN_CPU_H_
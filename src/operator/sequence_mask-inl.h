@@ -68,7 +68,9 @@ class SequenceMaskOp : public Operator {
         in_data[seq_mask::kData].get_with_shape<xpu, 3, DType>(s3, s);
     Tensor<xpu, 3, DType> out =
         out_data[seq_mask::kOut].get_with_shape<xpu, 3, DType>(s3, s);
-    Assign(out, req[seq_mask::kOut], F<mshadow_op::identity>(data));
+    // in place only the padding is written
+    if (req[seq_mask::kOut] != kWriteInplace)
+      Assign(out, req[seq_mask::kOut], F<mshadow_op::identity>(data));
     if (param_.use_sequence_length) {
       Tensor<xpu, 1, DType> indices =
           in_data[seq_mask::kSequenceLength].get<xpu, 1, DType>(s);
@@ -102,8 +104,9 @@ class SequenceMaskOp : public Operator {
     Tensor<xpu, 3, DType> output_grad =
         out_grad[seq_mask::kOut].get_with_shape<xpu, 3, DType>(s3, s);
 
-    Assign(data_grad, req[seq_mask::kData],
-           F<mshadow_op::identity>(output_grad));
+    if (req[seq_mask::kData] != kWriteInplace)
+      Assign(data_grad, req[seq_mask::kData],
+             F<mshadow_op::identity>(output_grad));
 
     if (param_.use_sequence_length) {
       Tensor<xpu, 1, DType> indices =
@@ -201,6 +204,20 @@ class SequenceMaskProp : public OperatorProperty {
       return {out_grad[seq_mask::kOut]};
   }
 
+  std::vector<std::pair<int, void*> > ForwardInplaceOption(
+    const std::vector<int> &in_data,
+    const std::vector<void*> &out_data) const override {
+    return {{in_data[seq_mask::kData], out_data[seq_mask::kOut]}};
+  }
+
+  std::vector<std::pair<int, void*> > BackwardInplaceOption(
+    const std::vector<int> &out_grad,
+    const std::vector<int> &in_data,
+    const std::vector<int> &out_data,
+    const std::vector<void*> &in_grad) const override {
+    return {{out_grad[seq_mask::kOut], in_grad[seq_mask::kData]}};
+  }
+
   std::vector<ResourceRequest> BackwardResource(
       const std::vector<TShape> &in_shape) const override {
     return {ResourceRequest::kTempSpace};
@@ -11,10 +11,10 @@ namespace mshadow {
 template <typename DType>
 inline void SequenceMask(const Tensor<cpu, 3, DType> &dst,
                          const Tensor<cpu, 1, DType> label, DType value) {
+  // only the padding of each sequence is visited, a contiguous row at a time
   for (index_t b = 0; b < dst.size(1); ++b)
     for (index_t s = label[b]; s < dst.size(0); ++s)
-      for (index_t r = 0; r < dst.size(2); ++r)
-        dst[s][b][r] = value;
+      std::fill(dst[s][b].dptr_, dst[s][b].dptr_ + dst.size(2), value);
 }
 
 }  // namespace mshadow
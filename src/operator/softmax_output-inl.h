@@ -16,6 +16,7 @@
 #include <vector>
 #include <utility>
 #include "./operator_common.h"
+#include "./nn/blocked_softmax.h"
 
 namespace mxnet {
 namespace op {
@@ -86,12 +87,12 @@ class SoftmaxOutputOp : public Operator {
           in_data[softmaxout_enum::kData].get_with_shape<xpu, 3, DType>(s3, s);
       Tensor<xpu, 3, DType> out =
           out_data[softmaxout_enum::kOut].get_with_shape<xpu, 3, DType>(s3, s);
-      Softmax(out, data);
+      if (!SoftmaxBlocked(out, data)) Softmax(out, data);
     } else {
       if (param_.preserve_shape) {
         Tensor<xpu, 2, DType> data = in_data[softmaxout_enum::kData].FlatTo2D<xpu, DType>(s);
         Tensor<xpu, 2, DType> out = out_data[softmaxout_enum::kOut].FlatTo2D<xpu, DType>(s);
-        Softmax(out, data);
+        if (!SoftmaxBlocked(out, data)) Softmax(out, data);
       } else {
         int n = in_data[softmaxout_enum::kData].size(0);
         int k = in_data[softmaxout_enum::kData].Size()/n;
@@ -100,7 +101,7 @@ class SoftmaxOutputOp : public Operator {
             in_data[softmaxout_enum::kData].get_with_shape<xpu, 2, DType>(s2, s);
         Tensor<xpu, 2, DType> out =
             out_data[softmaxout_enum::kOut].get_with_shape<xpu, 2, DType>(s2, s);
-        Softmax(out, data);
+        if (!SoftmaxBlocked(out, data)) Softmax(out, data);
       }
     }
   }
@@ -5,12 +5,17 @@
  * \author Bing Xu
 */
 #include "./softmax_output-inl.h"
+#include "./half_cpu_op.h"
 
 namespace mxnet {
 namespace op {
 template<>
 Operator *CreateOp<cpu>(SoftmaxOutputParam param, int dtype) {
   Operator *op = NULL;
+  if (half_cpu::IsHalfType(dtype)) {
+    // float16 or bfloat16 storage, float32 compute
+    return new HalfCPUOp(CreateOp<cpu>(param, mshadow::kFloat32));
+  }
   MSHADOW_REAL_TYPE_SWITCH(dtype, DType, {
     op = new SoftmaxOutputOp<cpu, DType>(param);
   })
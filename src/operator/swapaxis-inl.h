@@ -16,6 +16,7 @@
 #include <string>
 #include <utility>
 #include "./operator_common.h"
+#include "./tensor/blocked_transpose.h"
 
 namespace mxnet {
 namespace op {
@@ -99,6 +100,13 @@ class SwapAxisOp : public Operator {
 
     Reshape2Five(&inter_shape, shape_in, dim1, dim2);
 
+    const index_t swap_axes[] = {0, 3, 2, 1, 4};
+    if (TransposeBlocked(s, data_in.dptr<DType>(), data_out.dptr<DType>(),
+                         TShape(inter_shape.shape_, inter_shape.shape_ + 5),
+                         TShape(swap_axes, swap_axes + 5))) {
+      return;
+    }
+
     Tensor<xpu, 5, DType> inter_data_in = data_in.get_with_shape<xpu, 5, DType>(inter_shape, s);
 
     Shape<5> inter_shape2 = inter_shape;
@@ -0,0 +1,414 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file batch_gemm.h
+ * \brief batched multiplication of small and medium matrices on CPU
+ */
+#ifndef MXNET_OPERATOR_TENSOR_BATCH_GEMM_H_
+#define MXNET_OPERATOR_TENSOR_BATCH_GEMM_H_
+
+#include <mxnet/base.h>
+#include <dmlc/logging.h>
+#include <dmlc/omp.h>
+#include <dmlc/parameter.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../algo_registry.h"
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MXNET_BATCH_GEMM_USE_SSE 1
+#else
+#define MXNET_BATCH_GEMM_USE_SSE 0
+#endif
+
+namespace mxnet {
+namespace op {
+
+/*! \brief m * n * k below which a single matrix product is not worth a BLAS call */
+const int64_t kBatchGemmSmallSize = 16 * 16 * 16;
+/*! \brief number of multiply-adds below which a batch runs on one thread */
+const int64_t kBatchGemmParallelSize = 1 << 15;
+/*! \brief m * n * k up to which UseBatchGemmCPU may time the kernels against BLAS */
+const int64_t kBatchGemmTuneMaxSize = 128 * 128 * 128;
+
+namespace batch_gemm {
+/*! \brief rows of op(A) and columns of op(B) held by the register block */
+const int kMR = 4;
+const int kNR = 8;
+
+/*! \brief element (i, p) of op(A), where op(A) is m x k */
+template<bool tA, typename DType>
+inline DType OpA(const DType* A, int m, int k, int i, int p) {
+  return tA ? A[p * m + i] : A[i * k + p];
+}
+
+/*! \brief element (p, j) of op(B), where op(B) is k x n */
+template<bool tB, typename DType>
+inline DType OpB(const DType* B, int k, int n, int p, int j) {
+  return tB ? B[j * k + p] : B[p * n + j];
+}
+
+/*! \brief C = alpha * value + beta * C, C is not read when beta is 0 */
+template<typename DType>
+inline void Store(DType* C, DType value, DType alpha, DType beta) {
+  *C = beta == DType(0) ? alpha * value : alpha * value + beta * (*C);
+}
+
+/*!
+ * \brief C = alpha * op(A) op(B) + beta * C for M x K times K x N matrices,
+ *  the loops have constant bounds and are unrolled by the compiler.
+ */
+template<int M, int N, int K, bool tA, bool tB, typename DType>
+inline void FixedGemm(const DType* A, const DType* B, DType* C, DType alpha, DType beta) {
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      DType sum(0);
+      for (int p = 0; p < K; ++p) {
+        sum += OpA<tA>(A, M, K, i, p) * OpB<tB>(B, K, N, p, j);
+      }
+      Store(C + i * N + j, sum, alpha, beta);
+    }
+  }
+}
+
+/*!
+ * \brief Copy rows [i0, i0 + kMR) of op(A) into a panel stored column after
+ *  column, rows past m are zero.
+ */
+template<bool tA, typename DType>
+inline void PackA(const DType* A, int m, int k, int i0, DType* panel) {
+  const int mr = std::min(kMR, m - i0);
+  for (int p = 0; p < k; ++p) {
+    for (int i = 0; i < kMR; ++i) {
+      panel[p * kMR + i] = i < mr ? OpA<tA>(A, m, k, i0 + i, p) : DType(0);
+    }
+  }
+}
+
+/*!
+ * \brief Copy columns [j0, j0 + kNR) of op(B) into a panel stored row after
+ *  row, columns past n are zero.
+ */
+template<bool tB, typename DType>
+inline void PackB(const DType* B, int k, int n, int j0, DType* panel) {
+  const int nr = std::min(kNR, n - j0);
+  for (int p = 0; p < k; ++p) {
+    for (int j = 0; j < kNR; ++j) {
+      panel[p * kNR + j] = j < nr ? OpB<tB>(B, k, n, p, j0 + j) : DType(0);
+    }
+  }
+}
+
+/*!
+ * \brief kMR x kNR block of the product of two packed panels. Each row of
+ *  the block is accumulated over the whole B panel, which stays in L1.
+ */
+template<typename DType>
+struct MicroKernel {
+  static void Run(const DType* a, const DType* b, int k, DType out[kMR][kNR]) {
+    for (int i = 0; i < kMR; ++i) {
+      DType acc[kNR];
+      for (int j = 0; j < kNR; ++j) acc[j] = DType(0);
+      for (int p = 0; p < k; ++p) {
+        const DType ai = a[p * kMR + i];
+        const DType* bp = b + p * kNR;
+        for (int j = 0; j < kNR; ++j) acc[j] += ai * bp[j];
+      }
+      for (int j = 0; j < kNR; ++j) out[i][j] = acc[j];
+    }
+  }
+};
+
+#if MXNET_BATCH_GEMM_USE_SSE
+// Compilers unroll the loop over the kNR columns and vectorize the loop over k
+// instead, as a reduction with strided loads of A, unless k is a constant. The
+// float and double blocks are therefore written with intrinsics, keeping the
+// whole block in registers.
+template<>
+struct MicroKernel<float> {
+  static void Run(const float* a, const float* b, int k, float out[kMR][kNR]) {
+    __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps();
+    __m128 c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+    __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps();
+    __m128 c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+    for (int p = 0; p < k; ++p, a += kMR, b += kNR) {
+      const __m128 b0 = _mm_loadu_ps(b), b1 = _mm_loadu_ps(b + 4);
+      __m128 ai = _mm_set1_ps(a[0]);
+      c00 = _mm_add_ps(c00, _mm_mul_ps(ai, b0));
+      c01 = _mm_add_ps(c01, _mm_mul_ps(ai, b1));
+      ai = _mm_set1_ps(a[1]);
+      c10 = _mm_add_ps(c10, _mm_mul_ps(ai, b0));
+      c11 = _mm_add_ps(c11, _mm_mul_ps(ai, b1));
+      ai = _mm_set1_ps(a[2]);
+      c20 = _mm_add_ps(c20, _mm_mul_ps(ai, b0));
+      c21 = _mm_add_ps(c21, _mm_mul_ps(ai, b1));
+      ai = _mm_set1_ps(a[3]);
+      c30 = _mm_add_ps(c30, _mm_mul_ps(ai, b0));
+      c31 = _mm_add_ps(c31, _mm_mul_ps(ai, b1));
+    }
+    _mm_storeu_ps(out[0], c00);
+    _mm_storeu_ps(out[0] + 4, c01);
+    _mm_storeu_ps(out[1], c10);
+    _mm_storeu_ps(out[1] + 4, c11);
+    _mm_storeu_ps(out[2], c20);
+    _mm_storeu_ps(out[2] + 4, c21);
+    _mm_storeu_ps(out[3], c30);
+    _mm_storeu_ps(out[3] + 4, c31);
+  }
+};
+
+/*! \brief the block is computed in two halves of 4 columns, to fit in the registers */
+template<>
+struct MicroKernel<double> {
+  static void Run(const double* a, const double* b, int k, double out[kMR][kNR]) {
+    for (int j = 0; j < kNR; j += 4) {
+      __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+      __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+      __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+      __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+      const double* ap = a;
+      const double* bp = b + j;
+      for (int p = 0; p < k; ++p, ap += kMR, bp += kNR) {
+        const __m128d b0 = _mm_loadu_pd(bp), b1 = _mm_loadu_pd(bp + 2);
+        __m128d ai = _mm_set1_pd(ap[0]);
+        c00 = _mm_add_pd(c00, _mm_mul_pd(ai, b0));
+        c01 = _mm_add_pd(c01, _mm_mul_pd(ai, b1));
+        ai = _mm_set1_pd(ap[1]);
+        c10 = _mm_add_pd(c10, _mm_mul_pd(ai, b0));
+        c11 = _mm_add_pd(c11, _mm_mul_pd(ai, b1));
+        ai = _mm_set1_pd(ap[2]);
+        c20 = _mm_add_pd(c20, _mm_mul_pd(ai, b0));
+        c21 = _mm_add_pd(c21, _mm_mul_pd(ai, b1));
+        ai = _mm_set1_pd(ap[3]);
+        c30 = _mm_add_pd(c30, _mm_mul_pd(ai, b0));
+        c31 = _mm_add_pd(c31, _mm_mul_pd(ai, b1));
+      }
+      _mm_storeu_pd(out[0] + j, c00);
+      _mm_storeu_pd(out[0] + j + 2, c01);
+      _mm_storeu_pd(out[1] + j, c10);
+      _mm_storeu_pd(out[1] + j + 2, c11);
+      _mm_storeu_pd(out[2] + j, c20);
+      _mm_storeu_pd(out[2] + j + 2, c21);
+      _mm_storeu_pd(out[3] + j, c30);
+      _mm_storeu_pd(out[3] + j + 2, c31);
+    }
+  }
+};
+#endif  // MXNET_BATCH_GEMM_USE_SSE
+
+/*!
+ * \brief C = alpha * op(A) op(B) + beta * C through packed panels.
+ * \param buffer space for (m + kMR) * k + (n + kNR) * k elements.
+ */
+template<bool tA, bool tB, typename DType>
+inline void PackedGemm(const DType* A, const DType* B, DType* C, int m, int n, int k,
+                       DType alpha, DType beta, DType* buffer) {
+  const int mpanels = (m + kMR - 1) / kMR, npanels = (n + kNR - 1) / kNR;
+  DType* apack = buffer;
+  DType* bpack = buffer + mpanels * kMR * k;
+  for (int jp = 0; jp < npanels; ++jp) PackB<tB>(B, k, n, jp * kNR, bpack + jp * kNR * k);
+  DType acc[kMR][kNR];
+  for (int ip = 0; ip < mpanels; ++ip) {
+    const int i0 = ip * kMR, mr = std::min(kMR, m - i0);
+    PackA<tA>(A, m, k, i0, apack);
+    for (int jp = 0; jp < npanels; ++jp) {
+      const int j0 = jp * kNR, nr = std::min(kNR, n - j0);
+      MicroKernel<DType>::Run(apack, bpack + jp * kNR * k, k, acc);
+      for (int i = 0; i < mr; ++i) {
+        for (int j = 0; j < nr; ++j) Store(C + (i0 + i) * n + j0 + j, acc[i][j], alpha, beta);
+      }
+    }
+  }
+}
+
+/*! \brief kernel of one product of the batch */
+template<typename DType>
+using GemmKernel = void (*)(const DType* A, const DType* B, DType* C, DType alpha, DType beta);
+
+/*! \brief fully unrolled kernel for m = n = k = size, or nullptr */
+template<bool tA, bool tB, typename DType>
+inline GemmKernel<DType> FixedKernel(int size) {
+  switch (size) {
+    case 2: return FixedGemm<2, 2, 2, tA, tB, DType>;
+    case 3: return FixedGemm<3, 3, 3, tA, tB, DType>;
+    case 4: return FixedGemm<4, 4, 4, tA, tB, DType>;
+    case 8: return FixedGemm<8, 8, 8, tA, tB, DType>;
+    default: return nullptr;
+  }
+}
+
+template<bool tA, bool tB, typename DType>
+inline void Run(const DType* A, const DType* B, DType* C, int batch, int m, int n, int k,
+                DType alpha, DType beta) {
+  const int64_t a_size = static_cast<int64_t>(m) * k, b_size = static_cast<int64_t>(k) * n,
+      c_size = static_cast<int64_t>(m) * n;
+  const bool parallel = c_size * k * batch >= kBatchGemmParallelSize;
+  GemmKernel<DType> fixed = (m == n && n == k) ? FixedKernel<tA, tB, DType>(m) : nullptr;
+  if (fixed != nullptr) {
+    #pragma omp parallel for if (parallel)
+    for (int b = 0; b < batch; ++b) {
+      fixed(A + b * a_size, B + b * b_size, C + b * c_size, alpha, beta);
+    }
+    return;
+  }
+  const size_t buffer_size = static_cast<size_t>(m + kMR + n + kNR) * k;
+  #pragma omp parallel if (parallel)
+  {
+    std::vector<DType> buffer(buffer_size);
+    #pragma omp for
+    for (int b = 0; b < batch; ++b) {
+      PackedGemm<tA, tB>(A + b * a_size, B + b * b_size, C + b * c_size, m, n, k,
+                         alpha, beta, buffer.data());
+    }
+  }
+}
+
+/*!
+ * \brief C = A B for a batch of scratch matrices stored one after the other,
+ *  with the kernels of Run when algo is 0 and with BLAS, one matrix at a time,
+ *  when algo is 1.
+ */
+template<typename DType>
+inline void RunCandidate(int algo, DType* scratch, int batch, int m, int n, int k) {
+  using mshadow::Shape3;
+  DType* A = scratch;
+  DType* B = A + static_cast<size_t>(batch) * m * k;
+  DType* C = B + static_cast<size_t>(batch) * k * n;
+  if (algo == 0) {
+    Run<false, false>(A, B, C, batch, m, n, k, DType(1), DType(0));
+    return;
+  }
+  std::vector<DType*> workspace(3 * batch);
+  mshadow::BatchGEMM<false, false>(mshadow::Tensor<cpu, 3, DType>(C, Shape3(batch, m, n)),
+                                   mshadow::Tensor<cpu, 3, DType>(A, Shape3(batch, m, k)),
+                                   mshadow::Tensor<cpu, 3, DType>(B, Shape3(batch, k, n)),
+                                   DType(1), DType(0),
+                                   mshadow::Tensor<cpu, 1, DType*>(workspace.data(),
+                                                                   mshadow::Shape1(3 * batch)));
+}
+
+/*! \brief key of the choice of UseBatchGemmCPU in AlgoRegistry */
+inline std::string TuneKey(int type_flag, int threads, int batch, int m, int n, int k) {
+  std::ostringstream key;
+  key << "batch_gemm;cpu;dtype=" << type_flag << ";threads=" << threads
+      << ";batch=" << batch << ";m=" << m << ";n=" << n << ";k=" << k;
+  return key.str();
+}
+}  // namespace batch_gemm
+
+/*!
+ * \brief Whether BatchGemmCPU computes a batch of m x k times k x n products.
+ *  Larger products are left to BLAS, which may use all the cores on each of
+ *  them and so is called for one matrix at a time.
+ */
+inline bool BatchGemmCPUSupports(int batch, int m, int n, int k) {
+  static const int64_t max_size = dmlc::GetEnv("MXNET_CPU_BATCH_GEMM_MAX_SIZE", 64 * 64 * 64);
+  if (m == n && n == k && batch_gemm::FixedKernel<false, false, float>(m) != nullptr) {
+    return true;
+  }
+  const int64_t size = static_cast<int64_t>(m) * n * k;
+  return size <= max_size && (batch > 1 || size <= kBatchGemmSmallSize);
+}
+
+/*!
+ * \brief Whether BatchGemmCPU computes a batch of DType products: the choice
+ *  registered in AlgoRegistry for the sizes, or BatchGemmCPUSupports. With
+ *  MXNET_CPU_AUTOTUNE set, the first batch of products of up to
+ *  kBatchGemmTuneMaxSize multiply-adds of new sizes times both on scratch
+ *  matrices, up to four per thread so that all the threads have a share.
+ *  Only float and double are tuned, other types have no BLAS on cpu.
+ */
+template<typename DType>
+inline bool UseBatchGemmCPU(int batch, int m, int n, int k) {
+  const bool supported = BatchGemmCPUSupports(batch, m, n, k);
+  if (!std::is_same<DType, float>::value && !std::is_same<DType, double>::value) {
+    return supported;
+  }
+  const int64_t size = static_cast<int64_t>(m) * n * k;
+  AlgoRegistry* reg = AlgoRegistry::Get();
+  if (!reg->Active() || batch == 0 || size == 0 || size > kBatchGemmTuneMaxSize ||
+      (m == n && n == k && batch_gemm::FixedKernel<false, false, DType>(m) != nullptr)) {
+    return supported;
+  }
+  const int threads = omp_get_max_threads();
+  const int tune_batch = std::min(batch, 4 * threads);
+  const std::string key = batch_gemm::TuneKey(mshadow::DataType<DType>::kFlag, threads,
+                                              tune_batch, m, n, k);
+  std::vector<DType> scratch;
+  return reg->Tune(key, 2, supported ? 0 : 1, [&](int algo) {
+      if (scratch.empty()) {
+        scratch.assign(static_cast<size_t>(tune_batch) * (m * k + k * n + m * n), DType(0.5));
+      }
+      batch_gemm::RunCandidate(algo, scratch.data(), tune_batch, m, n, k);
+    }) == 0;
+}
+
+/*!
+ * \brief C[b] = alpha * op(A[b]) op(B[b]) + beta * C[b] for all the b < batch,
+ *  where op(X) is X or its transpose and the matrices are contiguous and
+ *  stored one after the other.
+ *
+ *  Cube sizes 2, 3, 4 and 8 use fully unrolled kernels. Other sizes up to
+ *  MXNET_CPU_BATCH_GEMM_MAX_SIZE multiply-adds per product pack op(A) and
+ *  op(B) into panels of kMR rows and kNR columns, multiplied by a register
+ *  blocked kernel. The batch is distributed over OpenMP threads, each of
+ *  which runs its products sequentially, and no BLAS is called so that the
+ *  threads of a multithreaded BLAS do not compete with them.
+ *
+ * \return false, without computing anything, if UseBatchGemmCPU is false.
+ */
+template<typename DType>
+inline bool BatchGemmCPU(const DType* A, const DType* B, DType* C, int batch,
+                         int m, int n, int k, bool tA, bool tB, DType alpha, DType beta) {
+  if (batch == 0 || m == 0 || n == 0) return true;
+  if (!UseBatchGemmCPU<DType>(batch, m, n, k)) return false;
+  if (tA && tB) {
+    batch_gemm::Run<true, true>(A, B, C, batch, m, n, k, alpha, beta);
+  } else if (tA) {
+    batch_gemm::Run<true, false>(A, B, C, batch, m, n, k, alpha, beta);
+  } else if (tB) {
+    batch_gemm::Run<false, true>(A, B, C, batch, m, n, k, alpha, beta);
+  } else {
+    batch_gemm::Run<false, false>(A, B, C, batch, m, n, k, alpha, beta);
+  }
+  return true;
+}
+
+/*!
+ * \brief dst[b] = alpha * op(lhs[b]) op(rhs[b]) + beta * dst[b] with BatchGemmCPU.
+ * \return whether the product was computed, the GPU overload returns false to
+ *  fall back to mshadow::BatchGEMM.
+ */
+template<typename DType>
+inline bool BatchGemmBlocked(const mshadow::Tensor<cpu, 3, DType>& dst,
+                             const mshadow::Tensor<cpu, 3, DType>& lhs,
+                             const mshadow::Tensor<cpu, 3, DType>& rhs,
+                             bool transpose_left, bool transpose_right,
+                             DType alpha, DType beta) {
+  if (!dst.CheckContiguous() || !lhs.CheckContiguous() || !rhs.CheckContiguous()) return false;
+  const int m = transpose_left ? lhs.size(2) : lhs.size(1);
+  const int k = transpose_left ? lhs.size(1) : lhs.size(2);
+  const int n = transpose_right ? rhs.size(1) : rhs.size(2);
+  CHECK_EQ(lhs.size(0), rhs.size(0)) << "batch size of the operands do not match";
+  CHECK_EQ(k, static_cast<int>(transpose_right ? rhs.size(2) : rhs.size(1)))
+      << "inner dimensions of the operands do not match";
+  CHECK(dst.size(0) == lhs.size(0) && dst.size(1) == static_cast<index_t>(m) &&
+        dst.size(2) == static_cast<index_t>(n)) << "shape of the product does not match";
+  return BatchGemmCPU(lhs.dptr_, rhs.dptr_, dst.dptr_, static_cast<int>(dst.size(0)),
+                      m, n, k, transpose_left, transpose_right, alpha, beta);
+}
+
+template<typename DType>
+inline bool BatchGemmBlocked(const mshadow::Tensor<gpu, 3, DType>& dst,
+                             const mshadow::Tensor<gpu, 3, DType>& lhs,
+                             const mshadow::Tensor<gpu, 3, DType>& rhs,
+                             bool transpose_left, bool transpose_right,
+                             DType alpha, DType beta) {
+  return false;
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_TENSOR_BATCH_GEMM_H_
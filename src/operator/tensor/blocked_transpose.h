@@ -0,0 +1,265 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file blocked_transpose.h
+ * \brief cache-blocked, parallel N-d transpose on CPU
+ */
+#ifndef MXNET_OPERATOR_TENSOR_BLOCKED_TRANSPOSE_H_
+#define MXNET_OPERATOR_TENSOR_BLOCKED_TRANSPOSE_H_
+
+#include <mxnet/base.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define MXNET_TRANSPOSE_USE_SSE 1
+#else
+#define MXNET_TRANSPOSE_USE_SSE 0
+#endif
+
+namespace mxnet {
+namespace op {
+
+/*! \brief side of the square tiles the two innermost transposed axes are copied in */
+const int kTransposeTile = 32;
+/*! \brief number of elements below which a transpose runs on one thread */
+const size_t kTransposeParallelSize = 1 << 15;
+
+namespace transpose {
+/*! \brief an axis of the output, and the stride of the input along it */
+struct Axis {
+  index_t extent;
+  int64_t in_stride;
+  int64_t out_stride;
+};
+
+/*!
+ * \brief Drop the axes of extent 1 and merge the adjacent output axes
+ *  which are also adjacent in the input, then compute the output strides.
+ */
+inline std::vector<Axis> MergeAxes(const TShape& oshape, const std::vector<int64_t>& in_strides) {
+  std::vector<Axis> axes;
+  for (index_t i = 0; i < oshape.ndim(); ++i) {
+    if (oshape[i] == 1) continue;
+    if (axes.size() != 0 &&
+        axes.back().in_stride == in_strides[i] * static_cast<int64_t>(oshape[i])) {
+      axes.back().extent *= oshape[i];
+      axes.back().in_stride = in_strides[i];
+    } else {
+      axes.push_back(Axis{oshape[i], in_strides[i], 0});
+    }
+  }
+  int64_t stride = 1;
+  for (int i = static_cast<int>(axes.size()) - 1; i >= 0; --i) {
+    axes[i].out_stride = stride;
+    stride *= axes[i].extent;
+  }
+  return axes;
+}
+
+/*! \brief input and output offsets of the idx-th combination of the coordinates along dims */
+inline void Offsets(const std::vector<Axis>& axes, const std::vector<int>& dims, int64_t idx,
+                    int64_t* in_offset, int64_t* out_offset) {
+  *in_offset = 0;
+  *out_offset = 0;
+  for (int i = static_cast<int>(dims.size()) - 1; i >= 0; --i) {
+    const Axis& a = axes[dims[i]];
+    const int64_t coord = idx % a.extent;
+    idx /= a.extent;
+    *in_offset += coord * a.in_stride;
+    *out_offset += coord * a.out_stride;
+  }
+}
+
+/*!
+ * \brief Copy a tile: out[i * out_stride + j] = in[i * in_row + j * in_col], for
+ *  i < rows and j < cols. The loop over i is innermost and reads consecutive
+ *  input elements when in_row is 1; the tile is small enough for the strided
+ *  writes to stay in cache.
+ */
+template<typename SrcType, typename DstType>
+inline void TileCopyScalar(const SrcType* in, DstType* out, int64_t rows, int64_t cols,
+                           int64_t in_row, int64_t in_col, int64_t out_stride) {
+  for (int64_t j = 0; j < cols; ++j) {
+    const SrcType* src = in + j * in_col;
+    DstType* dst = out + j;
+    for (int64_t i = 0; i < rows; ++i) {
+      dst[i * out_stride] = static_cast<DstType>(src[i * in_row]);
+    }
+  }
+}
+
+template<typename SrcType, typename DstType>
+struct TileCopy {
+  static void Run(const SrcType* in, DstType* out, int64_t rows, int64_t cols,
+                  int64_t in_row, int64_t in_col, int64_t out_stride) {
+    TileCopyScalar(in, out, rows, cols, in_row, in_col, out_stride);
+  }
+};
+
+#if MXNET_TRANSPOSE_USE_SSE
+/*! \brief 32-bit values are transposed by blocks of 4x4 in registers */
+template<>
+struct TileCopy<float, float> {
+  static void Run(const float* in, float* out, int64_t rows, int64_t cols,
+                  int64_t in_row, int64_t in_col, int64_t out_stride) {
+    if (in_row != 1) {
+      TileCopyScalar(in, out, rows, cols, in_row, in_col, out_stride);
+      return;
+    }
+    const int64_t rows4 = rows / 4 * 4, cols4 = cols / 4 * 4;
+    for (int64_t j = 0; j < cols4; j += 4) {
+      for (int64_t i = 0; i < rows4; i += 4) {
+        // each register holds four consecutive output rows of one output column
+        __m128 r0 = _mm_loadu_ps(in + (j + 0) * in_col + i);
+        __m128 r1 = _mm_loadu_ps(in + (j + 1) * in_col + i);
+        __m128 r2 = _mm_loadu_ps(in + (j + 2) * in_col + i);
+        __m128 r3 = _mm_loadu_ps(in + (j + 3) * in_col + i);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(out + (i + 0) * out_stride + j, r0);
+        _mm_storeu_ps(out + (i + 1) * out_stride + j, r1);
+        _mm_storeu_ps(out + (i + 2) * out_stride + j, r2);
+        _mm_storeu_ps(out + (i + 3) * out_stride + j, r3);
+      }
+    }
+    // borders of the tile
+    TileCopyScalar(in + rows4, out + rows4 * out_stride,
+                   rows - rows4, cols, in_row, in_col, out_stride);
+    TileCopyScalar(in + cols4 * in_col, out + cols4,
+                   rows4, cols - cols4, in_row, in_col, out_stride);
+  }
+};
+
+template<>
+struct TileCopy<int32_t, int32_t> {
+  static void Run(const int32_t* in, int32_t* out, int64_t rows, int64_t cols,
+                  int64_t in_row, int64_t in_col, int64_t out_stride) {
+    TileCopy<float, float>::Run(reinterpret_cast<const float*>(in),
+                                reinterpret_cast<float*>(out),
+                                rows, cols, in_row, in_col, out_stride);
+  }
+};
+#endif  // MXNET_TRANSPOSE_USE_SSE
+}  // namespace transpose
+
+/*!
+ * \brief Copy a strided view of in into the contiguous out, converting the
+ *  values to DstType.
+ *
+ *  Output axes of extent 1 are dropped, and adjacent output axes that are
+ *  also adjacent in the input are merged. If the innermost axis is then
+ *  contiguous in the input, rows are copied. Otherwise the innermost output
+ *  axis and the axis read with the smallest input stride are copied in
+ *  tiles of kTransposeTile x kTransposeTile, so that both the reads and the
+ *  writes of a tile use whole cache lines. Rows or tiles are distributed over
+ *  OpenMP threads.
+ *
+ * \param in the input, strides may be negative.
+ * \param out the output, contiguous with shape oshape.
+ * \param oshape the shape of the output.
+ * \param in_strides the stride of the input along each output axis, in elements.
+ */
+template<typename SrcType, typename DstType>
+inline void StridedCopyCPU(const SrcType* in, DstType* out, const TShape& oshape,
+                           const std::vector<int64_t>& in_strides) {
+  using transpose::Axis;
+  CHECK_EQ(oshape.ndim(), in_strides.size());
+  const size_t size = oshape.Size();
+  if (size == 0) return;
+  const std::vector<Axis> axes = transpose::MergeAxes(oshape, in_strides);
+  if (axes.size() == 0) {
+    out[0] = static_cast<DstType>(in[0]);
+    return;
+  }
+  const bool parallel = size >= kTransposeParallelSize;
+  const int last = static_cast<int>(axes.size()) - 1;
+  if (axes[last].in_stride == 1) {
+    std::vector<int> outer;
+    for (int d = 0; d < last; ++d) outer.push_back(d);
+    const int64_t len = axes[last].extent;
+    const int rows = static_cast<int>(size / len);
+    #pragma omp parallel for if (parallel)
+    for (int r = 0; r < rows; ++r) {
+      int64_t in_offset, out_offset;
+      transpose::Offsets(axes, outer, r, &in_offset, &out_offset);
+      const SrcType* src = in + in_offset;
+      DstType* dst = out + out_offset;
+      for (int64_t j = 0; j < len; ++j) dst[j] = static_cast<DstType>(src[j]);
+    }
+    return;
+  }
+  // the other axis of the tiles is the one read with the smallest stride
+  int row_axis = 0;
+  for (int d = 1; d < last; ++d) {
+    if (std::abs(axes[d].in_stride) < std::abs(axes[row_axis].in_stride)) row_axis = d;
+  }
+  if (last == 0) row_axis = -1;
+  std::vector<int> outer;
+  for (int d = 0; d < last; ++d) {
+    if (d != row_axis) outer.push_back(d);
+  }
+  const Axis col = axes[last];
+  const Axis row = row_axis >= 0 ? axes[row_axis] : Axis{1, 0, 0};
+  const int64_t row_tiles = (row.extent + kTransposeTile - 1) / kTransposeTile;
+  const int64_t col_tiles = (col.extent + kTransposeTile - 1) / kTransposeTile;
+  const int tiles = static_cast<int>(size / (row.extent * col.extent) * row_tiles * col_tiles);
+  #pragma omp parallel for if (parallel)
+  for (int t = 0; t < tiles; ++t) {
+    const int64_t ct = t % col_tiles;
+    const int64_t rt = (t / col_tiles) % row_tiles;
+    int64_t in_offset, out_offset;
+    transpose::Offsets(axes, outer, t / (col_tiles * row_tiles), &in_offset, &out_offset);
+    const int64_t r0 = rt * kTransposeTile, c0 = ct * kTransposeTile;
+    transpose::TileCopy<SrcType, DstType>::Run(
+        in + in_offset + r0 * row.in_stride + c0 * col.in_stride,
+        out + out_offset + r0 * row.out_stride + c0,
+        std::min<int64_t>(kTransposeTile, row.extent - r0),
+        std::min<int64_t>(kTransposeTile, col.extent - c0),
+        row.in_stride, col.in_stride, row.out_stride);
+  }
+}
+
+/*!
+ * \brief Transpose a contiguous CPU array with StridedCopyCPU.
+ * \param in the input of shape ishape.
+ * \param out the output, whose axis i is the axis axes[i] of the input.
+ */
+template<typename DType>
+inline void TransposeCPU(const DType* in, DType* out, const TShape& ishape, const TShape& axes) {
+  CHECK_EQ(ishape.ndim(), axes.ndim());
+  std::vector<int64_t> istrides(ishape.ndim());
+  int64_t stride = 1;
+  for (int i = static_cast<int>(ishape.ndim()) - 1; i >= 0; --i) {
+    istrides[i] = stride;
+    stride *= ishape[i];
+  }
+  TShape oshape(ishape.ndim());
+  std::vector<int64_t> in_strides(ishape.ndim());
+  for (index_t i = 0; i < axes.ndim(); ++i) {
+    oshape[i] = ishape[axes[i]];
+    in_strides[i] = istrides[axes[i]];
+  }
+  StridedCopyCPU(in, out, oshape, in_strides);
+}
+
+/*!
+ * \brief Transpose with TransposeCPU.
+ * \return true, the GPU overload returns false to fall back to mshadow.
+ */
+template<typename DType>
+inline bool TransposeBlocked(mshadow::Stream<cpu> *s, const DType* in, DType* out,
+                             const TShape& ishape, const TShape& axes) {
+  TransposeCPU(in, out, ishape, axes);
+  return true;
+}
+
+template<typename DType>
+inline bool TransposeBlocked(mshadow::Stream<gpu> *s, const DType* in, DType* out,
+                             const TShape& ishape, const TShape& axes) {
+  return false;
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_TENSOR_BLOCKED_TRANSPOSE_H_
@@ -14,6 +14,7 @@
 #include "../mshadow_op.h"
 #include "../elemwise_op_common.h"
 #include "../mxnet_op.h"
+#include "../half_cpu.h"
 
 namespace mxnet {
 namespace op {
@@ -46,12 +47,39 @@ void BinaryCompute_(const nnvm::NodeAttrs& attrs,
   });
 }
 
+/*! \brief float16 and bfloat16 on cpu are computed in float32, a block at a time */
+template<typename OP>
+inline bool BinaryComputeHalf(mshadow::Stream<cpu> *s,
+                              const std::vector<TBlob>& inputs,
+                              const std::vector<OpReqType>& req,
+                              const std::vector<TBlob>& outputs) {
+  if (!half_cpu::IsHalfType(outputs[0].type_flag_)) return false;
+  if (req[0] == kNullOp) return true;
+  MXNET_HALF_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    half_cpu::Blockwise(inputs[0].dptr<DType>(), inputs[1].dptr<DType>(),
+                        outputs[0].dptr<DType>(), outputs[0].Size(), req[0] == kAddTo,
+                        [](float* out, const float* lhs, const float* rhs, int n) {
+                          for (int i = 0; i < n; ++i) out[i] = OP::Map(lhs[i], rhs[i]);
+                        });
+  });
+  return true;
+}
+
+template<typename OP>
+inline bool BinaryComputeHalf(mshadow::Stream<gpu> *s,
+                              const std::vector<TBlob>& inputs,
+                              const std::vector<OpReqType>& req,
+                              const std::vector<TBlob>& outputs) {
+  return false;
+}
+
 template<typename xpu, typename OP>
 void BinaryCompute(const nnvm::NodeAttrs& attrs,
                    const OpContext& ctx,
                    const std::vector<TBlob>& inputs,
                    const std::vector<OpReqType>& req,
                    const std::vector<TBlob>& outputs) {
+  if (BinaryComputeHalf<OP>(ctx.get_stream<xpu>(), inputs, req, outputs)) return;
   MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DType, {
     BinaryCompute_<xpu, OP, DType>(attrs, ctx, inputs, req, outputs);
   });
@@ -68,6 +96,29 @@ void BinaryComputeWithHalf2(const nnvm::NodeAttrs& attrs,
   });
 }
 
+/*! \brief float16 and bfloat16 on cpu are computed in float32, a block at a time */
+template<typename op>
+inline bool BinaryLaunchHalf(mshadow::Stream<cpu> *s,
+                             const std::vector<TBlob>& inputs,
+                             const std::vector<TBlob>& outputs) {
+  if (!half_cpu::IsHalfType(outputs[0].type_flag_)) return false;
+  MXNET_HALF_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    half_cpu::Blockwise(inputs[0].dptr<DType>(), inputs[1].dptr<DType>(),
+                        outputs[0].dptr<DType>(), outputs[0].Size(), false,
+                        [](float* out, const float* lhs, const float* rhs, int n) {
+                          for (int i = 0; i < n; ++i) op::Map(i, out, lhs, rhs);
+                        });
+  });
+  return true;
+}
+
+template<typename op>
+inline bool BinaryLaunchHalf(mshadow::Stream<gpu> *s,
+                             const std::vector<TBlob>& inputs,
+                             const std::vector<TBlob>& outputs) {
+  return false;
+}
+
 template<typename xpu, typename op>
 void BinaryLaunch(const nnvm::NodeAttrs& attrs,
                   const OpContext& ctx,
@@ -80,6 +131,7 @@ void BinaryLaunch(const nnvm::NodeAttrs& attrs,
 
   CHECK_EQ(inputs.size(), 2U);
   CHECK_EQ(outputs.size(), 1U);
+  if (BinaryLaunchHalf<op>(s, inputs, outputs)) return;
   MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DType, {
     Kernel<op, xpu>::Launch(s, outputs[0].Size(),
       outputs[0].dptr<DType>(), inputs[0].dptr<DType>(), inputs[1].dptr<DType>());
@@ -13,9 +13,33 @@
 #include "../mshadow_op.h"
 #include "../elemwise_op_common.h"
 #include "../special_functions-inl.h"
+#include "../half_cpu.h"
 
 namespace mxnet {
 namespace op {
+/*! \brief float16 and bfloat16 on cpu are computed in float32, a block at a time */
+template<typename op>
+inline bool UnaryLaunchHalf(mshadow::Stream<cpu> *s,
+                            const std::vector<TBlob>& inputs,
+                            const std::vector<TBlob>& outputs) {
+  if (!half_cpu::IsHalfType(outputs[0].type_flag_)) return false;
+  MXNET_HALF_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    half_cpu::Blockwise(inputs[0].dptr<DType>(), nullptr, outputs[0].dptr<DType>(),
+                        outputs[0].Size(), false,
+                        [](float* out, const float* in, const float*, int n) {
+                          for (int i = 0; i < n; ++i) op::Map(i, out, in);
+                        });
+  });
+  return true;
+}
+
+template<typename op>
+inline bool UnaryLaunchHalf(mshadow::Stream<gpu> *s,
+                            const std::vector<TBlob>& inputs,
+                            const std::vector<TBlob>& outputs) {
+  return false;
+}
+
 template<typename xpu, typename op>
 void UnaryLaunch(const nnvm::NodeAttrs& attrs,
                         const OpContext& ctx,
@@ -28,6 +52,7 @@ void UnaryLaunch(const nnvm::NodeAttrs& attrs,
 
   CHECK_EQ(inputs.size(), 1U);
   CHECK_EQ(outputs.size(), 1U);
+  if (UnaryLaunchHalf<op>(s, inputs, outputs)) return;
   MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DType, {
     Kernel<op, xpu>::Launch(s, outputs[0].Size(),
       outputs[0].dptr<DType>(), inputs[0].dptr<DType>());
@@ -42,6 +67,32 @@ struct unary_bwd {
   }
 };
 
+/*! \brief float16 and bfloat16 on cpu are computed in float32, a block at a time */
+template<typename OP>
+inline bool UnaryComputeHalf(mshadow::Stream<cpu> *s,
+                             const std::vector<TBlob>& inputs,
+                             const std::vector<OpReqType>& req,
+                             const std::vector<TBlob>& outputs) {
+  if (!half_cpu::IsHalfType(outputs[0].type_flag_)) return false;
+  if (req[0] == kNullOp) return true;
+  MXNET_HALF_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    half_cpu::Blockwise(inputs[0].dptr<DType>(), nullptr, outputs[0].dptr<DType>(),
+                        outputs[0].Size(), req[0] == kAddTo,
+                        [](float* out, const float* in, const float*, int n) {
+                          for (int i = 0; i < n; ++i) out[i] = OP::Map(in[i]);
+                        });
+  });
+  return true;
+}
+
+template<typename OP>
+inline bool UnaryComputeHalf(mshadow::Stream<gpu> *s,
+                             const std::vector<TBlob>& inputs,
+                             const std::vector<OpReqType>& req,
+                             const std::vector<TBlob>& outputs) {
+  return false;
+}
+
 template<typename xpu, typename OP>
 void UnaryCompute(const nnvm::NodeAttrs& attrs,
                   const OpContext& ctx,
@@ -51,6 +102,7 @@ void UnaryCompute(const nnvm::NodeAttrs& attrs,
   using namespace mshadow;
   using namespace mshadow::expr;
   Stream<xpu> *s = ctx.get_stream<xpu>();
+  if (UnaryComputeHalf<OP>(s, inputs, req, outputs)) return;
   MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DType, {
     Tensor<xpu, 1, DType> out = outputs[0].FlatTo1D<xpu, DType>(s);
     ASSIGN_DISPATCH(out, req[0], F<OP>(inputs[0].FlatTo1D<xpu, DType>(s)));
@@ -87,6 +139,7 @@ struct CastParam : public dmlc::Parameter<CastParam> {
     .add_enum("float16", mshadow::kFloat16)
     .add_enum("uint8", mshadow::kUint8)
     .add_enum("int32", mshadow::kInt32)
+    .add_enum("bfloat16", kBfloat16)
     .describe("Output data type.");
   }
 };
@@ -101,6 +154,33 @@ inline bool CastType(const nnvm::NodeAttrs& attrs,
   return (*in_attrs)[0] != -1;
 }
 
+/*! \brief casts from and to bfloat16 on cpu go through float32 */
+inline bool CastBfloat16(mshadow::Stream<cpu> *s, const TBlob& input, OpReqType req,
+                         const TBlob& output) {
+  if (input.type_flag_ != kBfloat16 && output.type_flag_ != kBfloat16) return false;
+  if (req == kNullOp) return true;
+  MXNET_TYPE_SWITCH_WITH_BF16(output.type_flag_, DstDType, {
+    MXNET_TYPE_SWITCH_WITH_BF16(input.type_flag_, SrcDType, {
+      const SrcDType* in = input.dptr<SrcDType>();
+      DstDType* out = output.dptr<DstDType>();
+      const int size = static_cast<int>(output.Size());
+      #pragma omp parallel for if (size > 65536)
+      for (int i = 0; i < size; ++i) {
+        const float value = static_cast<float>(in[i]);
+        out[i] = DstDType(req == kAddTo ? static_cast<float>(out[i]) + value : value);
+      }
+    });
+  });
+  return true;
+}
+
+inline bool CastBfloat16(mshadow::Stream<gpu> *s, const TBlob& input, OpReqType req,
+                         const TBlob& output) {
+  CHECK(input.type_flag_ != kBfloat16 && output.type_flag_ != kBfloat16)
+    << "bfloat16 is only supported on cpu";
+  return false;
+}
+
 template<typename xpu>
 void CastCompute(const nnvm::NodeAttrs& attrs,
                  const OpContext& ctx,
@@ -110,6 +190,7 @@ void CastCompute(const nnvm::NodeAttrs& attrs,
   using namespace mshadow;
   using namespace mshadow::expr;
   Stream<xpu> *s = ctx.get_stream<xpu>();
+  if (CastBfloat16(s, inputs[0], req[0], outputs[0])) return;
   MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DstDType, {
     Tensor<xpu, 1, DstDType> out = outputs[0].FlatTo1D<xpu, DstDType>(s);
     MSHADOW_TYPE_SWITCH(inputs[0].type_flag_, SrcDType, {
@@ -37,6 +37,7 @@ struct InitOpParam : public dmlc::Parameter<InitOpParam> {
     .add_enum("float16", mshadow::kFloat16)
     .add_enum("uint8", mshadow::kUint8)
     .add_enum("int32", mshadow::kInt32)
+    .add_enum("bfloat16", kBfloat16)
     .describe("Target data type.");
   }
 };
@@ -121,6 +122,12 @@ void FillCompute(const nnvm::NodeAttrs& attrs,
   using namespace mshadow;
   using namespace mshadow::expr;
   Stream<xpu> *s = ctx.get_stream<xpu>();
+  if (outputs[0].type_flag_ == kBfloat16 && req[0] != kNullOp) {
+    CHECK_NE(req[0], kAddTo) << "bfloat16 can only be filled";
+    Tensor<xpu, 1, bf16_t> out = outputs[0].FlatTo1D<xpu, bf16_t>(s);
+    out = bf16_t(static_cast<float>(value));
+    return;
+  }
   MSHADOW_TYPE_SWITCH(outputs[0].type_flag_, DType, {
     Tensor<xpu, 1, DType> out = outputs[0].FlatTo1D<xpu, DType>(s);
     ASSIGN_DISPATCH(out, req[0], scalar<DType>(value));
@@ -294,6 +294,20 @@ struct LaOpCaller<xpu, DType, idim, odim, 4, 3, laop> {
 };
 
 
+// Operators that can process all the matrices of a batch at once specialize this.
+// op returns false, without writing the outputs, if the matrices must be processed
+// one after the other.
+template<typename laop>
+struct LaOpBatchCaller {
+  template<typename xpu, typename DType>
+  static bool op(const std::vector<TBlob>& inputs,
+                 const std::vector<TBlob>& outputs,
+                 const nnvm::NodeAttrs& attrs,
+                       mshadow::Stream<xpu> *s) {
+    return false;
+  }
+};
+
 template<typename xpu, int idim, int odim, int inum, int onum, typename laop>
 void LaOpForward(const nnvm::NodeAttrs& attrs,
                  const OpContext& ctx,
@@ -319,8 +333,10 @@ void LaOpForward(const nnvm::NodeAttrs& attrs,
       CHECK_EQ((N == -1 || N == M), true);
       N = M;
     }
-    for ( int i = 0; i < N; ++i ) {
-      LaOpCaller<xpu, OType, idim, odim, inum, onum, laop>::op(inputs, outputs, i, attrs, s);
+    if ( !LaOpBatchCaller<laop>::template op<xpu, OType>(inputs, outputs, attrs, s) ) {
+      for ( int i = 0; i < N; ++i ) {
+        LaOpCaller<xpu, OType, idim, odim, inum, onum, laop>::op(inputs, outputs, i, attrs, s);
+      }
     }
   });
 }
@@ -355,8 +371,10 @@ void LaOpBackward(const nnvm::NodeAttrs& attrs,
                              .get_space_typed<xpu, 1, OType>(Shape1(outputs[i].Size()), s).dptr_;
       }
     }
-    for ( int i = 0; i < N; ++i ) {
-      LaOpCaller<xpu, OType, idim, odim, inum, onum, laop>::op(inputs, tspace, i, attrs, s);
+    if ( !LaOpBatchCaller<laop>::template op<xpu, OType>(inputs, tspace, attrs, s) ) {
+      for ( int i = 0; i < N; ++i ) {
+        LaOpCaller<xpu, OType, idim, odim, inum, onum, laop>::op(inputs, tspace, i, attrs, s);
+      }
     }
     for ( int i = 0; i < onum; ++i ) {
       if ( req[i] == kAddTo ) {
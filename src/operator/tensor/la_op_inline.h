@@ -7,6 +7,8 @@
 #define MXNET_OPERATOR_TENSOR_LA_OP_INLINE_H_
 
 #include <mxnet/c_lapack_api.h>
+#include <type_traits>
+#include "./batch_gemm.h"
 
 namespace mxnet {
 namespace op {
@@ -329,6 +331,98 @@ struct sumlogdiag_backward {
   }
 };
 
+// Batched operators
+
+// Whether BatchGemmCPU computes gemm::op on all the matrices of A and B.
+template<typename xpu, typename DType>
+bool BatchGemmSupported(const Tensor<xpu, 3, DType>& A, const Tensor<xpu, 3, DType>& B,
+                        bool tA, bool tB) {
+  return std::is_same<xpu, cpu>::value &&
+         UseBatchGemmCPU<DType>(A.size(0), (tA ? A.size(2) : A.size(1)),
+                                (tB ? B.size(1) : B.size(2)), (tA ? A.size(1) : A.size(2)));
+}
+
+template<>
+struct LaOpBatchCaller<gemm> {
+  template<typename xpu, typename DType>
+  static bool op(const std::vector<TBlob>& inputs, const std::vector<TBlob>& outputs,
+                 const nnvm::NodeAttrs& attrs, Stream<xpu> *s) {
+    const LaMatrixMacParam& param = nnvm::get<LaMatrixMacParam>(attrs.parsed);
+    Tensor<xpu, 3, DType> A(inputs[0].FlatToKD<xpu, 3, DType>(s));
+    Tensor<xpu, 3, DType> B(inputs[1].FlatToKD<xpu, 3, DType>(s));
+    Tensor<xpu, 3, DType> C(inputs[2].FlatToKD<xpu, 3, DType>(s));
+    Tensor<xpu, 3, DType> D(outputs[0].FlatToKD<xpu, 3, DType>(s));
+    if ( !BatchGemmSupported(A, B, param.transpose_a, param.transpose_b) ) return false;
+    if ( C.dptr_ != D.dptr_ ) Copy(D, C, s);
+    return BatchGemmBlocked(D, A, B, param.transpose_a, param.transpose_b,
+                            DType(param.alpha), DType(param.beta));
+  }
+};
+
+template<>
+struct LaOpBatchCaller<gemm2> {
+  template<typename xpu, typename DType>
+  static bool op(const std::vector<TBlob>& inputs, const std::vector<TBlob>& outputs,
+                 const nnvm::NodeAttrs& attrs, Stream<xpu> *s) {
+    const LaMatrixMultParam& param = nnvm::get<LaMatrixMultParam>(attrs.parsed);
+    return BatchGemmBlocked(outputs[0].FlatToKD<xpu, 3, DType>(s),
+                            inputs[0].FlatToKD<xpu, 3, DType>(s),
+                            inputs[1].FlatToKD<xpu, 3, DType>(s),
+                            param.transpose_a, param.transpose_b,
+                            DType(param.alpha), DType(0));
+  }
+};
+
+// Gradients of A and B of alpha*op(A)*op(B), as computed by gemm_backward.
+template<typename xpu, typename DType>
+bool BatchGemmBackward(const Tensor<xpu, 3, DType>& dD, const Tensor<xpu, 3, DType>& A,
+                       const Tensor<xpu, 3, DType>& B, const Tensor<xpu, 3, DType>& dA,
+                       const Tensor<xpu, 3, DType>& dB, DType alpha, bool tA, bool tB) {
+  if ( !(tA ? BatchGemmSupported(B, dD, tB, true) : BatchGemmSupported(dD, B, false, !tB)) ||
+       !(tB ? BatchGemmSupported(dD, A, true, tA) : BatchGemmSupported(A, dD, !tA, false)) ) {
+    return false;
+  }
+  return (tA ? BatchGemmBlocked(dA, B, dD, tB, true, alpha, DType(0))
+             : BatchGemmBlocked(dA, dD, B, false, !tB, alpha, DType(0))) &&
+         (tB ? BatchGemmBlocked(dB, dD, A, true, tA, alpha, DType(0))
+             : BatchGemmBlocked(dB, A, dD, !tA, false, alpha, DType(0)));
+}
+
+template<>
+struct LaOpBatchCaller<gemm_backward> {
+  template<typename xpu, typename DType>
+  static bool op(const std::vector<TBlob>& inputs, const std::vector<TBlob>& outputs,
+                 const nnvm::NodeAttrs& attrs, Stream<xpu> *s) {
+    const LaMatrixMacParam& param = nnvm::get<LaMatrixMacParam>(attrs.parsed);
+    Tensor<xpu, 3, DType> dD(inputs[0].FlatToKD<xpu, 3, DType>(s));
+    if ( !BatchGemmBackward(dD, inputs[1].FlatToKD<xpu, 3, DType>(s),
+                            inputs[2].FlatToKD<xpu, 3, DType>(s),
+                            outputs[0].FlatToKD<xpu, 3, DType>(s),
+                            outputs[1].FlatToKD<xpu, 3, DType>(s),
+                            DType(param.alpha), param.transpose_a, param.transpose_b) ) {
+      return false;
+    }
+    Tensor<xpu, 1, DType> dC(outputs[2].FlatTo1D<xpu, DType>(s));
+    dC = expr::scalar<DType>(DType(param.beta)) * inputs[0].FlatTo1D<xpu, DType>(s);
+    return true;
+  }
+};
+
+template<>
+struct LaOpBatchCaller<gemm2_backward> {
+  template<typename xpu, typename DType>
+  static bool op(const std::vector<TBlob>& inputs, const std::vector<TBlob>& outputs,
+                 const nnvm::NodeAttrs& attrs, Stream<xpu> *s) {
+    const LaMatrixMultParam& param = nnvm::get<LaMatrixMultParam>(attrs.parsed);
+    return BatchGemmBackward(inputs[0].FlatToKD<xpu, 3, DType>(s),
+                             inputs[1].FlatToKD<xpu, 3, DType>(s),
+                             inputs[2].FlatToKD<xpu, 3, DType>(s),
+                             outputs[0].FlatToKD<xpu, 3, DType>(s),
+                             outputs[1].FlatToKD<xpu, 3, DType>(s),
+                             DType(param.alpha), param.transpose_a, param.transpose_b);
+  }
+};
+
 }  // namespace op
 }  // namespace mxnet
 
@@ -14,6 +14,8 @@
 #include "../elemwise_op_common.h"
 #include "../mxnet_op.h"
 #include "broadcast_reduce_op.h"
+#include "./blocked_transpose.h"
+#include "./batch_gemm.h"
 
 #if MXNET_USE_CUDA
 #include <thrust/device_vector.h>
@@ -200,6 +202,7 @@ void TransposeImpl(RunContext ctx,
   CHECK_EQ(src.type_flag_, ret.type_flag_);
   Stream<xpu> *s = ctx.get_stream<xpu>();
   MSHADOW_TYPE_SWITCH(ret.type_flag_, DType, {
+    if (TransposeBlocked(s, src.dptr<DType>(), ret.dptr<DType>(), src.shape_, axes)) return;
     switch (axes.ndim()) {
      case 0:
       break;
@@ -551,6 +554,29 @@ inline bool DotShape(const nnvm::NodeAttrs& attrs,
   return true;
 }
 
+/*!
+ * \brief dst = alpha * op(lhs) op(rhs) + beta * dst for a batch of matrices,
+ *  with BatchGemmBlocked if it handles the sizes and mshadow::BatchGEMM otherwise.
+ */
+template<typename xpu, typename DType>
+inline void BatchGEMMDispatch(const mshadow::Tensor<xpu, 3, DType>& dst,
+                              const mshadow::Tensor<xpu, 3, DType>& lhs,
+                              const mshadow::Tensor<xpu, 3, DType>& rhs,
+                              bool transpose_left, bool transpose_right,
+                              DType alpha, DType beta,
+                              const mshadow::Tensor<xpu, 1, DType*>& workspace) {
+  if (BatchGemmBlocked(dst, lhs, rhs, transpose_left, transpose_right, alpha, beta)) return;
+  if (transpose_left && transpose_right) {
+    mshadow::BatchGEMM<true, true>(dst, lhs, rhs, alpha, beta, workspace);
+  } else if (!transpose_left && transpose_right) {
+    mshadow::BatchGEMM<false, true>(dst, lhs, rhs, alpha, beta, workspace);
+  } else if (transpose_left && !transpose_right) {
+    mshadow::BatchGEMM<true, false>(dst, lhs, rhs, alpha, beta, workspace);
+  } else {
+    mshadow::BatchGEMM<false, false>(dst, lhs, rhs, alpha, beta, workspace);
+  }
+}
+
 template<typename xpu>
 void BatchDotForward_(const nnvm::NodeAttrs& attrs,
                       const OpContext& ctx,
@@ -574,23 +600,8 @@ void BatchDotForward_(const nnvm::NodeAttrs& attrs,
     mshadow::Tensor<xpu, 1, DType*> workspace =
       ctx.requested[0].get_space_typed<xpu, 1, DType*>(mshadow::Shape1(3 * out.size(0)), s);
     if (kNullOp != req[0]) {
-      if (param.transpose_a && param.transpose_b) {
-        mshadow::BatchGEMM<true, true>(out, mlhs, mrhs, (DType)1.0f,
-                                       (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f,
-                                       workspace);
-      } else if (!param.transpose_a && param.transpose_b) {
-        mshadow::BatchGEMM<false, true>(out, mlhs, mrhs, (DType)1.0f,
-                                       (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f,
-                                       workspace);
-      } else if (param.transpose_a && !param.transpose_b) {
-        mshadow::BatchGEMM<true, false>(out, mlhs, mrhs, (DType)1.0f,
-                                       (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f,
-                                       workspace);
-      } else {
-        mshadow::BatchGEMM<false, false>(out, mlhs, mrhs, (DType)1.0f,
-                                       (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f,
-                                       workspace);
-      }
+      BatchGEMMDispatch(out, mlhs, mrhs, param.transpose_a, param.transpose_b, (DType)1.0f,
+                        (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f, workspace);
     }
   });
 }
@@ -620,61 +631,55 @@ void BatchDotBackward_(const nnvm::NodeAttrs& attrs,
         mshadow::Shape2(2, 3 * mout_grad.size(0)), s);
     mshadow::Tensor<xpu, 1, DType*> rhs_workspace = workspace[0];
     mshadow::Tensor<xpu, 1, DType*> lhs_workspace = workspace[1];
+    const DType rhs_beta = (kAddTo == req[1]) ? (DType)1.0f : (DType)0.0f;
+    const DType lhs_beta = (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f;
     if (param.transpose_a && param.transpose_b) {
       // Gradient of z = dot(x.T, y.T)
       // dy = dot(x, dz).T = dot(dz.T, x.T)
       // dx = dot(dz, y).T = dot(y.T, dz.T)
       if (kNullOp != req[1]) {
-        mshadow::BatchGEMM<true, true>(mrhs_grad, mout_grad, mlhs_data, (DType)1.0f,
-                                        (kAddTo == req[1]) ? (DType)1.0f :  (DType)0.0f,
-                                        rhs_workspace);
+        BatchGEMMDispatch(mrhs_grad, mout_grad, mlhs_data, true, true, (DType)1.0f,
+                          rhs_beta, rhs_workspace);
       }
       if (kNullOp != req[0]) {
-        mshadow::BatchGEMM<true, true>(mlhs_grad, mrhs_data, mout_grad, (DType)1.0f,
-                                        (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f,
-                                        lhs_workspace);
+        BatchGEMMDispatch(mlhs_grad, mrhs_data, mout_grad, true, true, (DType)1.0f,
+                          lhs_beta, lhs_workspace);
       }
     } else if (!param.transpose_a && param.transpose_b) {
       // Gradient of z = dot(x, y.T)
       // dy = dot(x.T, dz).T = dot(dz.T, x)
       // dx = dot(dz, y)
       if (kNullOp != req[1]) {
-        mshadow::BatchGEMM<true, false>(mrhs_grad, mout_grad, mlhs_data, (DType)1.0f,
-                                        (kAddTo == req[1]) ? (DType)1.0f : (DType)0.0f,
-                                        rhs_workspace);
+        BatchGEMMDispatch(mrhs_grad, mout_grad, mlhs_data, true, false, (DType)1.0f,
+                          rhs_beta, rhs_workspace);
       }
       if (kNullOp != req[0]) {
-        mshadow::BatchGEMM<false, false>(mlhs_grad, mout_grad, mrhs_data, (DType)1.0f,
-                                        (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f,
-                                        lhs_workspace);
+        BatchGEMMDispatch(mlhs_grad, mout_grad, mrhs_data, false, false, (DType)1.0f,
+                          lhs_beta, lhs_workspace);
       }
     } else if (param.transpose_a && !param.transpose_b) {
       // Gradient of z = dot(x.T, y)
       // dy = dot(x, dz)
       // dx = dot(dz, y.T).T = dot(y, dz.T)
       if (kNullOp != req[1]) {
-        mshadow::BatchGEMM<false, false>(mrhs_grad, mlhs_data, mout_grad, (DType)1.0f,
-                                        (kAddTo == req[1]) ? (DType)1.0f : (DType)0.0f,
-                                        rhs_workspace);
+        BatchGEMMDispatch(mrhs_grad, mlhs_data, mout_grad, false, false, (DType)1.0f,
+                          rhs_beta, rhs_workspace);
       }
       if (kNullOp != req[0]) {
-        mshadow::BatchGEMM<false, true>(mlhs_grad, mrhs_data, mout_grad, (DType)1.0f,
-                                        (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f,
-                                        lhs_workspace);
+        BatchGEMMDispatch(mlhs_grad, mrhs_data, mout_grad, false, true, (DType)1.0f,
+                          lhs_beta, lhs_workspace);
       }
     } else {
       // Gradient of z = dot(x, y)
       // dy = dot(x.T, dz)
       // dx = dot(dz, y.T)
       if (kNullOp != req[1]) {
-        mshadow::BatchGEMM<true, false>(mrhs_grad, mlhs_data, mout_grad, (DType)1.0f,
-                                        (kAddTo == req[1]) ? (DType)1.0f : (DType)0.0f,
-                                        rhs_workspace);
+        BatchGEMMDispatch(mrhs_grad, mlhs_data, mout_grad, true, false, (DType)1.0f,
+                          rhs_beta, rhs_workspace);
       }
       if (kNullOp != req[0]) {
-        mshadow::BatchGEMM<false, true>(mlhs_grad, mout_grad, mrhs_data, (DType)1.0f,
-                                        (kAddTo == req[0]) ? (DType)1.0f : (DType)0.0f,
-                                        lhs_workspace);
+        BatchGEMMDispatch(mlhs_grad, mout_grad, mrhs_data, false, true, (DType)1.0f,
+                          lhs_beta, lhs_workspace);
       }
     }
   });
@@ -0,0 +1,59 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file stash_op.cc
+ * \brief CPU Implementation of the activation stash operators
+ */
+#include "./stash_op.h"
+
+namespace mxnet {
+namespace op {
+
+DMLC_REGISTER_PARAMETER(StashParam);
+
+NNVM_REGISTER_OP(_stash_encode)
+.describe(R"code(Encode an array into a compressed storage type.
+
+Inserted by the executor between the forward and the backward pass when
+MXNET_BACKWARD_COMPRESS_ACTIVATION is set. With dtype float16 the relative error
+is bounded by 2^-11. With dtype uint8 the absolute error of every value is
+bounded by max(abs(block))/254, where block are the block_size values sharing
+its scale.
+)code" ADD_FILELINE)
+.set_num_inputs(1)
+.set_num_outputs(StashNumEncoded)
+.set_attr_parser(ParamParser<StashParam>)
+.set_attr<nnvm::FListOutputNames>("FListOutputNames",
+  [](const NodeAttrs& attrs) {
+    if (StashNumEncoded(attrs) == 2) {
+      return std::vector<std::string>{"data", "scale"};
+    }
+    return std::vector<std::string>{"data"};
+  })
+.set_attr<nnvm::FInferShape>("FInferShape", StashEncodeShape)
+.set_attr<nnvm::FInferType>("FInferType", StashEncodeType)
+.set_attr<FCompute>("FCompute<cpu>", StashEncodeCompute<cpu>)
+.add_argument("data", "NDArray-or-Symbol", "The array to encode.")
+.add_arguments(StashParam::__FIELDS__());
+
+NNVM_REGISTER_OP(_stash_decode)
+.describe(R"code(Decode an array encoded by _stash_encode.
+)code" ADD_FILELINE)
+.set_num_inputs(StashNumEncoded)
+.set_num_outputs(1)
+.set_attr_parser(ParamParser<StashParam>)
+.set_attr<nnvm::FListInputNames>("FListInputNames",
+  [](const NodeAttrs& attrs) {
+    if (StashNumEncoded(attrs) == 2) {
+      return std::vector<std::string>{"data", "scale"};
+    }
+    return std::vector<std::string>{"data"};
+  })
+.set_attr<nnvm::FInferShape>("FInferShape", StashDecodeShape)
+.set_attr<nnvm::FInferType>("FInferType", StashDecodeType)
+.set_attr<FCompute>("FCompute<cpu>", StashDecodeCompute<cpu>)
+.add_argument("data", "NDArray-or-Symbol", "The encoded array.")
+.add_argument("scale", "NDArray-or-Symbol", "Scale of each block, only used by uint8.")
+.add_arguments(StashParam::__FIELDS__());
+
+}  // namespace op
+}  // namespace mxnet
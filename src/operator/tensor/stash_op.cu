@@ -0,0 +1,18 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file stash_op.cu
+ * \brief GPU Implementation of the activation stash operators
+ */
+#include "./stash_op.h"
+
+namespace mxnet {
+namespace op {
+
+NNVM_REGISTER_OP(_stash_encode)
+.set_attr<FCompute>("FCompute<gpu>", StashEncodeCompute<gpu>);
+
+NNVM_REGISTER_OP(_stash_decode)
+.set_attr<FCompute>("FCompute<gpu>", StashDecodeCompute<gpu>);
+
+}  // namespace op
+}  // namespace mxnet
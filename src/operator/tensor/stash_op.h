@@ -0,0 +1,209 @@
+/*!
+ *  Copyright (c) 2017 by Contributors
+ * \file stash_op.h
+ * \brief Encode and decode activations kept for the backward pass
+ *  into a compressed storage type.
+ */
+#ifndef MXNET_OPERATOR_TENSOR_STASH_OP_H_
+#define MXNET_OPERATOR_TENSOR_STASH_OP_H_
+
+#include <mxnet/base.h>
+#include <mxnet/operator_util.h>
+#include <mxnet/op_attr_types.h>
+#include <dmlc/parameter.h>
+#include <algorithm>
+#include <vector>
+#include "../mxnet_op.h"
+#include "../operator_common.h"
+
+namespace mxnet {
+namespace op {
+
+struct StashParam : public dmlc::Parameter<StashParam> {
+  int dtype;
+  int block_size;
+  dmlc::optional<int> out_dtype;
+  DMLC_DECLARE_PARAMETER(StashParam) {
+    DMLC_DECLARE_FIELD(dtype)
+    .add_enum("float16", mshadow::kFloat16)
+    .add_enum("uint8", mshadow::kUint8)
+    .describe("Storage type. uint8 stores each value in 8 bits with "
+              "a float32 scale for every block of block_size values.");
+    DMLC_DECLARE_FIELD(block_size).set_default(256)
+    .set_lower_bound(1)
+    .describe("Number of consecutive values sharing a scale, only used by uint8.");
+    DMLC_DECLARE_FIELD(out_dtype)
+    .add_enum("float32", mshadow::kFloat32)
+    .add_enum("float64", mshadow::kFloat64)
+    .add_enum("float16", mshadow::kFloat16)
+    .add_enum("bfloat16", kBfloat16)
+    .set_default(dmlc::optional<int>())
+    .describe("Type of the encoded array, which _stash_decode restores.");
+  }
+};
+
+inline uint32_t StashNumEncoded(const nnvm::NodeAttrs& attrs) {
+  const StashParam& param = nnvm::get<StashParam>(attrs.parsed);
+  return param.dtype == mshadow::kUint8 ? 2 : 1;
+}
+
+inline bool StashEncodeShape(const nnvm::NodeAttrs& attrs,
+                             std::vector<TShape> *in_attrs,
+                             std::vector<TShape> *out_attrs) {
+  const StashParam& param = nnvm::get<StashParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 1U);
+  CHECK_EQ(out_attrs->size(), StashNumEncoded(attrs));
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, (*in_attrs)[0]);
+  SHAPE_ASSIGN_CHECK(*in_attrs, 0, (*out_attrs)[0]);
+  const TShape& dshape = (*in_attrs)[0];
+  if (dshape.ndim() == 0) return false;
+  if (param.dtype == mshadow::kUint8) {
+    const index_t nblock = (dshape.Size() + param.block_size - 1) / param.block_size;
+    SHAPE_ASSIGN_CHECK(*out_attrs, 1, mshadow::Shape1(std::max<index_t>(nblock, 1)));
+  }
+  return true;
+}
+
+inline bool StashEncodeType(const nnvm::NodeAttrs& attrs,
+                            std::vector<int> *in_attrs,
+                            std::vector<int> *out_attrs) {
+  const StashParam& param = nnvm::get<StashParam>(attrs.parsed);
+  CHECK_EQ(in_attrs->size(), 1U);
+  TYPE_ASSIGN_CHECK(*out_attrs, 0, param.dtype);
+  if (param.dtype == mshadow::kUint8) {
+    TYPE_ASSIGN_CHECK(*out_attrs, 1, mshadow::kFloat32);
+  }
+  return (*in_attrs)[0] != -1;
+}
+
+inline bool StashDecodeShape(const nnvm::NodeAttrs& attrs,
+                             std::vector<TShape> *in_attrs,
+                             std::vector<TShape> *out_attrs) {
+  CHECK_EQ(in_attrs->size(), StashNumEncoded(attrs));
+  CHECK_EQ(out_attrs->size(), 1U);
+  SHAPE_ASSIGN_CHECK(*out_attrs, 0, (*in_attrs)[0]);
+  SHAPE_ASSIGN_CHECK(*in_attrs, 0, (*out_attrs)[0]);
+  return (*out_attrs)[0].ndim() != 0;
+}
+
+inline bool StashDecodeType(const nnvm::NodeAttrs& attrs,
+                            std::vector<int> *in_attrs,
+                            std::vector<int> *out_attrs) {
+  const StashParam& param = nnvm::get<StashParam>(attrs.parsed);
+  CHECK_EQ(out_attrs->size(), 1U);
+  TYPE_ASSIGN_CHECK(*in_attrs, 0, param.dtype);
+  if (param.dtype == mshadow::kUint8) {
+    TYPE_ASSIGN_CHECK(*in_attrs, 1, mshadow::kFloat32);
+  }
+  // the decoded type is the type of the original array, recorded by the
+  // pass that inserts the node
+  if (param.out_dtype.has_value()) {
+    TYPE_ASSIGN_CHECK(*out_attrs, 0, param.out_dtype.value());
+  }
+  return (*out_attrs)[0] != -1;
+}
+
+struct stash_half_encode {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, mshadow::half::half_t *out, const DType *in) {
+    out[i] = mshadow::half::half_t(static_cast<float>(in[i]));
+  }
+};
+
+struct stash_half_decode {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, DType *out, const mshadow::half::half_t *in) {
+    out[i] = DType(static_cast<float>(in[i]));
+  }
+};
+
+/*! \brief scale of a block, such that its largest magnitude maps to 127 */
+struct stash_uint8_scale {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int b, float *scale, const DType *in,
+                                  int size, int block_size) {
+    const int begin = b * block_size;
+    const int end = begin + block_size < size ? begin + block_size : size;
+    float amax = 0.0f;
+    for (int j = begin; j < end; ++j) {
+      const float v = fabsf(static_cast<float>(in[j]));
+      amax = v > amax ? v : amax;
+    }
+    scale[b] = amax / 127.0f;
+  }
+};
+
+struct stash_uint8_encode {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, uint8_t *out, const DType *in,
+                                  const float *scale, int block_size) {
+    const float s = scale[i / block_size];
+    float q = s > 0.0f ? roundf(static_cast<float>(in[i]) / s) : 0.0f;
+    q = q < -127.0f ? -127.0f : (q > 127.0f ? 127.0f : q);
+    out[i] = static_cast<uint8_t>(q + 128.0f);
+  }
+};
+
+struct stash_uint8_decode {
+  template<typename DType>
+  MSHADOW_XINLINE static void Map(int i, DType *out, const uint8_t *in,
+                                  const float *scale, int block_size) {
+    out[i] = DType((static_cast<float>(in[i]) - 128.0f) * scale[i / block_size]);
+  }
+};
+
+template<typename xpu>
+void StashEncodeCompute(const nnvm::NodeAttrs& attrs,
+                        const OpContext& ctx,
+                        const std::vector<TBlob>& inputs,
+                        const std::vector<OpReqType>& req,
+                        const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  using namespace mxnet_op;
+  const StashParam& param = nnvm::get<StashParam>(attrs.parsed);
+  Stream<xpu> *s = ctx.get_stream<xpu>();
+  if (req[0] == kNullOp) return;
+  CHECK_NE(req[0], kAddTo) << "stash encode does not support kAddTo";
+  const int size = static_cast<int>(inputs[0].Size());
+  MSHADOW_REAL_TYPE_SWITCH(inputs[0].type_flag_, DType, {
+    if (param.dtype == kFloat16) {
+      Kernel<stash_half_encode, xpu>::Launch(s, size,
+        outputs[0].dptr<half::half_t>(), inputs[0].dptr<DType>());
+    } else {
+      float *scale = outputs[1].dptr<float>();
+      Kernel<stash_uint8_scale, xpu>::Launch(s, static_cast<int>(outputs[1].Size()),
+        scale, inputs[0].dptr<DType>(), size, param.block_size);
+      Kernel<stash_uint8_encode, xpu>::Launch(s, size,
+        outputs[0].dptr<uint8_t>(), inputs[0].dptr<DType>(), scale, param.block_size);
+    }
+  });
+}
+
+template<typename xpu>
+void StashDecodeCompute(const nnvm::NodeAttrs& attrs,
+                        const OpContext& ctx,
+                        const std::vector<TBlob>& inputs,
+                        const std::vector<OpReqType>& req,
+                        const std::vector<TBlob>& outputs) {
+  using namespace mshadow;
+  using namespace mxnet_op;
+  const StashParam& param = nnvm::get<StashParam>(attrs.parsed);
+  Stream<xpu> *s = ctx.get_stream<xpu>();
+  if (req[0] == kNullOp) return;
+  CHECK_NE(req[0], kAddTo) << "stash decode does not support kAddTo";
+  const int size = static_cast<int>(outputs[0].Size());
+  MSHADOW_REAL_TYPE_SWITCH(outputs[0].type_flag_, DType, {
+    if (param.dtype == kFloat16) {
+      Kernel<stash_half_decode, xpu>::Launch(s, size,
+        outputs[0].dptr<DType>(), inputs[0].dptr<half::half_t>());
+    } else {
+      Kernel<stash_uint8_decode, xpu>::Launch(s, size,
+        outputs[0].dptr<DType>(), inputs[0].dptr<uint8_t>(),
+        inputs[1].dptr<float>(), param.block_size);
+    }
+  });
+}
+
+}  // namespace op
+}  // namespace mxnet
+#endif  // MXNET_OPERATOR_TENSOR_STASH_OP_H_
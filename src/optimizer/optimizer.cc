@@ -0,0 +1,210 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file optimizer.cc
+ * \brief optimizers run by KVStore, on the update operators of optimizer_op
+ */
+#include <dmlc/logging.h>
+#include <dmlc/registry.h>
+#include <mxnet/optimizer.h>
+#include <mxnet/engine.h>
+#include <mxnet/op_attr_types.h>
+#include <nnvm/op.h>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../operator/optimizer_op-inl.h"
+
+namespace dmlc {
+DMLC_REGISTRY_ENABLE(::mxnet::OptimizerReg);
+}  // namespace dmlc
+
+namespace mxnet {
+Optimizer *Optimizer::Create(const char *type_name) {
+  auto *creator = dmlc::Registry<OptimizerReg>::Find(type_name);
+  if (creator == nullptr) {
+    LOG(FATAL) << "Cannot find Optimizer " << type_name << " in registry";
+  }
+  return creator->body();
+}
+
+namespace opt {
+/*!
+ * \brief Base of the optimizers that update a weight with one of the update
+ *  operators, such as sgd_update. The operator is pushed to the engine as
+ *  imperative calls do, with the weight, the gradient and the states of the key
+ *  as inputs and the weight as output.
+ */
+class UpdateOpOptimizer : public Optimizer {
+ public:
+  void Init(const std::vector<std::pair<std::string, std::string> >& kwargs) override {
+    std::unordered_map<std::string, std::string> dict;
+    for (const auto& kv : kwargs) {
+      // the frontend names the learning rate learning_rate, the operators lr
+      dict[kv.first == "learning_rate" ? "lr" : kv.first] = kv.second;
+    }
+    if (!dict.count("lr")) dict["lr"] = default_lr_;
+    Configure(&dict);
+    attrs_ = nnvm::NodeAttrs();
+    attrs_.op = CHECK_NOTNULL(nnvm::Op::Get(op_name_));
+    attrs_.name = op_name_;
+    attrs_.dict = std::move(dict);
+    CHECK(attrs_.op->attr_parser != nullptr);
+    attrs_.op->attr_parser(&attrs_);
+  }
+
+  void Update(int key, const NDArray& grad, NDArray* weight) override {
+    CHECK(attrs_.op != nullptr) << "Init the optimizer before updating";
+    std::vector<NDArray>& states = states_[key];
+    if (states.size() != num_states_) {
+      states.clear();
+      for (size_t i = 0; i < num_states_; ++i) {
+        states.emplace_back(weight->shape(), weight->ctx(), false, weight->dtype());
+        states.back() = 0.0f;
+      }
+    }
+    nnvm::NodeAttrs attrs = attrs_;
+    Step(key, &attrs);
+    const Context ctx = weight->ctx();
+    NDArray g = grad.ctx() == ctx ? grad : grad.Copy(ctx);
+    std::vector<NDArray> inputs = {*weight, g};
+    inputs.insert(inputs.end(), states.begin(), states.end());
+    std::vector<engine::VarHandle> write_vars = {weight->var()};
+    for (const auto& s : states) write_vars.push_back(s.var());
+    Push(attrs, ctx, {g.var()}, write_vars, inputs);
+  }
+
+ protected:
+  explicit UpdateOpOptimizer(const char *default_lr) : default_lr_(default_lr) {}
+  /*!
+   * \brief choose the operator and the number of states for the parameters, and
+   *  remove those that are not parameters of the operator from dict
+   */
+  virtual void Configure(std::unordered_map<std::string, std::string> *dict) = 0;
+  /*! \brief change the parsed parameters of the operator for an update of key */
+  virtual void Step(int key, nnvm::NodeAttrs *attrs) {}
+
+  /*!
+   * \brief remove a parameter of the optimizer that is not passed to the operator
+   * \return whether it was given
+   */
+  static bool Take(std::unordered_map<std::string, std::string> *dict,
+                   const std::string& name, std::string *value) {
+    auto it = dict->find(name);
+    if (it == dict->end()) return false;
+    *value = it->second;
+    dict->erase(it);
+    return true;
+  }
+
+  std::string op_name_;
+  size_t num_states_ = 0;
+
+ private:
+  static void Push(const nnvm::NodeAttrs& attrs, const Context& ctx,
+                   const std::vector<engine::VarHandle>& read_vars,
+                   const std::vector<engine::VarHandle>& write_vars,
+                   const std::vector<NDArray>& inputs) {
+    static auto& fcompute_cpu = nnvm::Op::GetAttr<FCompute>("FCompute<cpu>");
+    static auto& fcompute_gpu = nnvm::Op::GetAttr<FCompute>("FCompute<gpu>");
+    FCompute fn = ctx.dev_mask() == gpu::kDevMask ?
+        fcompute_gpu.get(attrs.op, nullptr) : fcompute_cpu.get(attrs.op, nullptr);
+    CHECK(fn != nullptr) << "Operator " << attrs.op->name << " is not implemented for "
+                         << (ctx.dev_mask() == gpu::kDevMask ? "GPU." : "CPU.");
+    Engine::Get()->PushSync(
+      [attrs, ctx, fn, inputs](RunContext rctx) {
+        std::vector<TBlob> input_blobs, output_blobs;
+        for (auto& i : inputs) {
+          input_blobs.push_back(i.data());
+        }
+        output_blobs.push_back(input_blobs[0]);
+        OpContext opctx{false, rctx, engine::CallbackOnComplete(), {}};
+        fn(attrs, opctx, input_blobs, {kWriteTo}, output_blobs);
+        if (ctx.dev_mask() == gpu::kDevMask) {
+          rctx.get_stream<gpu>()->Wait();
+        }
+      }, ctx, read_vars, write_vars, FnProperty::kNormal,
+      0, PROFILER_MESSAGE(attrs.op->name.c_str()));
+  }
+
+  const char *default_lr_;
+  nnvm::NodeAttrs attrs_;
+  std::unordered_map<int, std::vector<NDArray> > states_;
+};
+
+/*! \brief sgd_update, or sgd_mom_update with a momentum state */
+class SGDOptimizer : public UpdateOpOptimizer {
+ public:
+  SGDOptimizer() : UpdateOpOptimizer("0.01") {}
+
+ protected:
+  void Configure(std::unordered_map<std::string, std::string> *dict) override {
+    std::string momentum;
+    if (Take(dict, "momentum", &momentum) && std::stof(momentum) != 0.0f) {
+      (*dict)["momentum"] = momentum;
+      op_name_ = "sgd_mom_update";
+      num_states_ = 1;
+    } else {
+      op_name_ = "sgd_update";
+      num_states_ = 0;
+    }
+  }
+};
+
+/*! \brief adam_update, with the learning rate bias corrected by the step of each key */
+class AdamOptimizer : public UpdateOpOptimizer {
+ public:
+  AdamOptimizer() : UpdateOpOptimizer("0.001") {}
+
+ protected:
+  void Configure(std::unordered_map<std::string, std::string> *dict) override {
+    op_name_ = "adam_update";
+    num_states_ = 2;
+  }
+
+  void Step(int key, nnvm::NodeAttrs *attrs) override {
+    op::AdamParam param = nnvm::get<op::AdamParam>(attrs->parsed);
+    const int t = ++steps_[key];
+    param.lr *= std::sqrt(1.0 - std::pow(param.beta2, t)) / (1.0 - std::pow(param.beta1, t));
+    attrs->parsed = param;
+  }
+
+ private:
+  std::unordered_map<int, int> steps_;
+};
+
+/*! \brief rmsprop_update, or rmspropalex_update when centered */
+class RMSPropOptimizer : public UpdateOpOptimizer {
+ public:
+  RMSPropOptimizer() : UpdateOpOptimizer("0.001") {}
+
+ protected:
+  void Configure(std::unordered_map<std::string, std::string> *dict) override {
+    std::string centered, gamma2;
+    const bool alex = Take(dict, "centered", &centered) &&
+                      (centered == "1" || centered == "True" || centered == "true");
+    // the defaults of the frontend optimizer, which differ from the operators'
+    if (!dict->count("gamma1")) (*dict)["gamma1"] = "0.9";
+    if (alex) {
+      if (!dict->count("gamma2")) (*dict)["gamma2"] = "0.9";
+      op_name_ = "rmspropalex_update";
+      num_states_ = 3;
+    } else {
+      Take(dict, "gamma2", &gamma2);
+      op_name_ = "rmsprop_update";
+      num_states_ = 1;
+    }
+  }
+};
+
+MXNET_REGISTER_OPTIMIZER(sgd, SGDOptimizer)
+.describe("Stochastic gradient descent, with momentum when momentum is not 0.");
+
+MXNET_REGISTER_OPTIMIZER(adam, AdamOptimizer)
+.describe("Adam, with the learning rate bias corrected by the step of each key.");
+
+MXNET_REGISTER_OPTIMIZER(rmsprop, RMSPropOptimizer)
+.describe("RMSProp, centered as in Graves 2013 when centered is true.");
+}  // namespace opt
+}  // namespace mxnet
@@ -0,0 +1,166 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file cpu_shared_storage_manager.h
+ * \brief CPU storage backed by POSIX shared memory, which can be
+ *  attached by other processes.
+ */
+#ifndef MXNET_STORAGE_CPU_SHARED_STORAGE_MANAGER_H_
+#define MXNET_STORAGE_CPU_SHARED_STORAGE_MANAGER_H_
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // _WIN32
+
+#include <dmlc/logging.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+
+namespace mxnet {
+namespace storage {
+
+/*!
+ * \brief Storage manager of shared memory segments.
+ *
+ *  Every allocation is a separate segment named after the id of the creating
+ *  process and a per-process counter. The segment starts with a header holding
+ *  the number of processes that have it mapped, the name is removed when the
+ *  last of them frees it. Another process can attach a segment as long as one
+ *  process still has it mapped.
+ */
+class CPUSharedStorageManager {
+ public:
+  /*! \brief size of the header, keeps the data aligned */
+  static const size_t kHeaderSize = 64;
+
+  CPUSharedStorageManager() : next_id_(0) {}
+  /*!
+   * \brief Create a new segment.
+   * \param size Size to allocate.
+   * \param shared_pid Set to the id of the current process.
+   * \param shared_id Set to the id of the segment in the current process.
+   * \return Pointer to the storage.
+   */
+  inline void* Alloc(size_t size, int* shared_pid, int* shared_id);
+  /*!
+   * \brief Map a segment created by another process.
+   * \param size Size of the storage.
+   * \param shared_pid Id of the process which created the segment.
+   * \param shared_id Id of the segment in that process.
+   * \return Pointer to the storage.
+   */
+  inline void* Attach(size_t size, int shared_pid, int shared_id);
+  /*!
+   * \brief Unmap a segment, removes it when no process uses it anymore.
+   * \param ptr Pointer returned by Alloc or Attach.
+   */
+  inline void Free(void* ptr);
+
+ private:
+  struct Segment {
+    std::string name;
+    size_t mapped_size;
+  };
+  static std::string SegmentName(int shared_pid, int shared_id) {
+    char name[64];
+    snprintf(name, sizeof(name), "/mx_%08x_%08x",
+             static_cast<unsigned>(shared_pid), static_cast<unsigned>(shared_id));
+    return std::string(name);
+  }
+  static std::atomic<int>* RefCount(void* base) {
+    return static_cast<std::atomic<int>*>(base);
+  }
+  inline void* Map(const std::string& name, size_t size, bool create);
+  /*! \brief mutex of segments_ */
+  std::mutex mutex_;
+  /*! \brief mapped segments, indexed by their data pointer */
+  std::unordered_map<void*, Segment> segments_;
+  /*! \brief id of the next segment created by this process */
+  std::atomic<int> next_id_;
+};
+
+#ifndef _WIN32
+inline void* CPUSharedStorageManager::Map(const std::string& name, size_t size, bool create) {
+  const size_t mapped_size = size + kHeaderSize;
+  int fd = shm_open(name.c_str(), create ? O_CREAT | O_EXCL | O_RDWR : O_RDWR, 0600);
+  CHECK_NE(fd, -1) << "Failed to open shared memory " << name << ": " << strerror(errno)
+                   << (create ? "" : ", it may have been freed by all the processes using it");
+  if (create) {
+    CHECK_EQ(ftruncate(fd, mapped_size), 0)
+        << "Failed to allocate " << size << " bytes of shared memory: " << strerror(errno);
+  } else {
+    struct stat st;
+    CHECK_EQ(fstat(fd, &st), 0) << strerror(errno);
+    CHECK_EQ(static_cast<size_t>(st.st_size), mapped_size)
+        << "Size of shared memory " << name << " does not match";
+  }
+  void* base = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  CHECK_NE(base, MAP_FAILED) << "Failed to map shared memory " << name << ": " << strerror(errno);
+  if (create) {
+    new (base) std::atomic<int>(1);
+  } else {
+    RefCount(base)->fetch_add(1);
+  }
+  void* ptr = static_cast<char*>(base) + kHeaderSize;
+  std::lock_guard<std::mutex> lock(mutex_);
+  segments_[ptr] = Segment{name, mapped_size};
+  return ptr;
+}
+
+inline void* CPUSharedStorageManager::Alloc(size_t size, int* shared_pid, int* shared_id) {
+  *shared_pid = static_cast<int>(getpid());
+  *shared_id = next_id_++;
+  return Map(SegmentName(*shared_pid, *shared_id), size, true);
+}
+
+inline void* CPUSharedStorageManager::Attach(size_t size, int shared_pid, int shared_id) {
+  return Map(SegmentName(shared_pid, shared_id), size, false);
+}
+
+inline void CPUSharedStorageManager::Free(void* ptr) {
+  Segment seg;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = segments_.find(ptr);
+    CHECK(it != segments_.end()) << "Free of unknown shared memory";
+    seg = it->second;
+    segments_.erase(it);
+  }
+  void* base = static_cast<char*>(ptr) - kHeaderSize;
+  if (RefCount(base)->fetch_sub(1) == 1) {
+    shm_unlink(seg.name.c_str());
+  }
+  munmap(base, seg.mapped_size);
+}
+#else
+inline void* CPUSharedStorageManager::Map(const std::string& name, size_t size, bool create) {
+  LOG(FATAL) << "Shared memory storage is not supported on Windows";
+  return nullptr;
+}
+
+inline void* CPUSharedStorageManager::Alloc(size_t size, int* shared_pid, int* shared_id) {
+  return Map("", size, true);
+}
+
+inline void* CPUSharedStorageManager::Attach(size_t size, int shared_pid, int shared_id) {
+  return Map("", size, false);
+}
+
+inline void CPUSharedStorageManager::Free(void* ptr) {
+  LOG(FATAL) << "Shared memory storage is not supported on Windows";
+}
+#endif  // _WIN32
+
+}  // namespace storage
+}  // namespace mxnet
+
+#endif  // MXNET_STORAGE_CPU_SHARED_STORAGE_MANAGER_H_
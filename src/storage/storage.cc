@@ -10,6 +10,7 @@
 #include "./pooled_storage_manager.h"
 #include "./cpu_device_storage.h"
 #include "./pinned_memory_storage.h"
+#include "./cpu_shared_storage_manager.h"
 #include "../common/cuda_utils.h"
 #include "../common/lazy_alloc_array.h"
 
@@ -19,6 +20,7 @@ namespace mxnet {
 class StorageImpl : public Storage {
  public:
   Handle Alloc(size_t size, Context ctx) override;
+  Handle AttachShared(size_t size, int shared_pid, int shared_id) override;
   void Free(Handle handle) override;
   void DirectFree(Handle handle) override;
   StorageImpl() {}
@@ -34,6 +36,7 @@ class StorageImpl : public Storage {
   static void ActivateDevice(Context ctx) {
     switch (ctx.dev_type) {
       case Context::kCPU: break;
+      case Context::kCPUShared: break;
       case Context::kGPU:
       case Context::kCPUPinned: {
 #if MXNET_USE_CUDA
@@ -50,6 +53,8 @@ class StorageImpl : public Storage {
   // internal storage managers
   std::array<common::LazyAllocArray<storage::StorageManager>,
              kMaxNumberOfDevices> storage_managers_;
+  // shared memory segments, which are not pooled
+  storage::CPUSharedStorageManager shared_manager_;
 };  // struct Storage::Impl
 #if MXNET_USE_CUDA
 int StorageImpl::num_gpu_device = 0;
@@ -60,6 +65,10 @@ Storage::Handle StorageImpl::Alloc(size_t size, Context ctx) {
   Handle hd;
   hd.ctx = ctx;
   hd.size = size;
+  if (ctx.dev_type == Context::kCPUShared) {
+    hd.dptr = shared_manager_.Alloc(size, &hd.shared_pid, &hd.shared_id);
+    return hd;
+  }
   auto&& device = storage_managers_.at(ctx.dev_type);
   std::shared_ptr<storage::StorageManager> manager = device.Get(
       ctx.dev_id, [ctx]() {
@@ -105,8 +114,22 @@ Storage::Handle StorageImpl::Alloc(size_t size, Context ctx) {
   return hd;
 }
 
+Storage::Handle StorageImpl::AttachShared(size_t size, int shared_pid, int shared_id) {
+  Handle hd;
+  hd.ctx = Context::CPUShared(0);
+  hd.size = size;
+  hd.shared_pid = shared_pid;
+  hd.shared_id = shared_id;
+  hd.dptr = shared_manager_.Attach(size, shared_pid, shared_id);
+  return hd;
+}
+
 void StorageImpl::Free(Storage::Handle handle) {
   const Context &ctx = handle.ctx;
+  if (ctx.dev_type == Context::kCPUShared) {
+    shared_manager_.Free(handle.dptr);
+    return;
+  }
   auto&& device = storage_managers_.at(ctx.dev_type);
   std::shared_ptr<storage::StorageManager> manager = device.Get(
       ctx.dev_id, []() {
@@ -119,6 +142,10 @@ void StorageImpl::Free(Storage::Handle handle) {
 
 void StorageImpl::DirectFree(Storage::Handle handle) {
   const Context &ctx = handle.ctx;
+  if (ctx.dev_type == Context::kCPUShared) {
+    shared_manager_.Free(handle.dptr);
+    return;
+  }
   auto&& device = storage_managers_.at(ctx.dev_type);
   std::shared_ptr<storage::StorageManager> manager = device.Get(
       ctx.dev_id, []() {
@@ -0,0 +1,87 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file server_merge_test.cc
+ * \brief correctness and performance of the sums of the pushes of simulated workers,
+ *  as a server of dist_sync does them
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../../src/kvstore/comm.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+
+namespace {
+/*! \brief sum the pushes into merged in batches, the first one overwriting it */
+void MergeInBatches(const std::vector<std::vector<float> >& pushes, std::vector<float>* merged,
+                    size_t batch, size_t bound, int nthreads) {
+  for (size_t begin = 0; begin < pushes.size(); begin += batch) {
+    std::vector<float*> dptr = {merged->data()};
+    for (size_t w = begin; w < std::min(begin + batch, pushes.size()); ++w) {
+      dptr.push_back(const_cast<float*>(pushes[w].data()));
+    }
+    kvstore::ReduceSumCPUParallel(dptr, merged->size(), bound, nthreads, begin == 0);
+  }
+}
+
+/*! \brief the pushes of the workers, with worker w pushing w + 1 */
+std::vector<std::vector<float> > Pushes(int num_workers, size_t size) {
+  std::vector<std::vector<float> > pushes;
+  for (int w = 0; w < num_workers; ++w) {
+    pushes.emplace_back(size, static_cast<float>(w + 1));
+  }
+  return pushes;
+}
+}  // namespace
+
+TEST(SERVER_MERGE, Correctness) {
+  for (int num_workers : {1, 2, 5, 9}) {
+    const auto pushes = Pushes(num_workers, 10007);
+    const float expected = num_workers * (num_workers + 1) / 2.0f;
+    for (size_t batch : {1, 3, 4, 16}) {
+      // stale values of the previous round are overwritten
+      std::vector<float> merged(10007, -1.0f);
+      MergeInBatches(pushes, &merged, batch, 1000, 3);
+      for (float v : merged) ASSERT_EQ(expected, v) << num_workers << " workers, batch " << batch;
+    }
+  }
+}
+
+/*! \brief sums of pushes of 64K floats one by one on one thread, and in striped batches */
+TEST(SERVER_MERGE, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 20;
+  const size_t size = 1 << 16;
+#else
+  const size_t COUNT = 2;
+  const size_t size = 1 << 12;
+#endif
+  const int nthreads = 4;
+  std::cout << std::endl << std::setw(10) << "workers" << std::setw(16) << "one by one (ms)"
+            << std::setw(16) << "batched (ms)" << std::setw(12) << "speedup" << std::endl;
+  for (int num_workers : {4, 16, 64}) {
+    const auto pushes = Pushes(num_workers, size);
+    std::vector<float> merged(size);
+    uint64_t single = 0, batched = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      uint64_t start = test::perf::getMicroTickCount();
+      MergeInBatches(pushes, &merged, 1, size + 1, 1);
+      single += test::perf::getMicroTickCount() - start;
+      start = test::perf::getMicroTickCount();
+      // a bound below size, for the striped sums of big arrays at this smaller size
+      MergeInBatches(pushes, &merged, 4, size / nthreads, nthreads);
+      batched += test::perf::getMicroTickCount() - start;
+    }
+    EXPECT_EQ(num_workers * (num_workers + 1) / 2.0f, merged[size - 1]);
+    std::cout << std::setw(10) << num_workers
+              << std::setw(16) << MICRO2MSF(single) / COUNT
+              << std::setw(16) << MICRO2MSF(batched) / COUNT
+              << std::setw(12) << static_cast<float>(single) / std::max(batched, uint64_t(1))
+              << std::endl;
+  }
+}
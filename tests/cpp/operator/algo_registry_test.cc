@@ -0,0 +1,62 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file algo_registry_test.cc
+ * \brief registry of the implementations chosen by operators
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../../src/operator/algo_registry.h"
+#include "../../src/operator/tensor/batch_gemm.h"
+
+using namespace mxnet;
+using op::AlgoRegistry;
+
+TEST(ALGO_REGISTRY, SaveAndLoad) {
+  const std::string fname = "algo_registry_test.txt";
+  AlgoRegistry* reg = AlgoRegistry::Get();
+  // keys hold shapes and parameters, with spaces
+  reg->Register("test;inputs=(2, 3);kernel=(3, 3);", {1, 2, 3});
+  {
+    std::ofstream os(fname);
+    os << "# mxnet algorithm registry 1\n" << "test;saved by another process\t7\n";
+  }
+  ASSERT_TRUE(reg->Save(fname));
+  reg->Register("test;inputs=(2, 3);kernel=(3, 3);", {4});
+  reg->Register("test;registered after saving", {5});
+  ASSERT_TRUE(reg->Load(fname));
+  std::remove(fname.c_str());
+
+  std::vector<int> algo;
+  // the entries registered in this process are kept
+  ASSERT_TRUE(reg->Find("test;inputs=(2, 3);kernel=(3, 3);", &algo));
+  EXPECT_EQ(std::vector<int>({4}), algo);
+  ASSERT_TRUE(reg->Find("test;registered after saving", &algo));
+  EXPECT_EQ(std::vector<int>({5}), algo);
+  // the ones found in the file when saving were merged into it
+  ASSERT_TRUE(reg->Find("test;saved by another process", &algo));
+  EXPECT_EQ(std::vector<int>({7}), algo);
+  EXPECT_FALSE(reg->Find("test;unknown", &algo));
+}
+
+TEST(ALGO_REGISTRY, BatchGemmFollowsTheRegisteredChoice) {
+  const int threads = omp_get_max_threads();
+  const int batch = std::min(16, 4 * threads);
+  EXPECT_TRUE(op::BatchGemmCPUSupports(batch, 20, 20, 20));
+  AlgoRegistry::Get()->Register(
+      op::batch_gemm::TuneKey(mshadow::kFloat32, threads, batch, 20, 20, 20), {1});
+  EXPECT_FALSE(op::UseBatchGemmCPU<float>(batch, 20, 20, 20));
+  // sizes with fixed kernels are not tuned
+  AlgoRegistry::Get()->Register(
+      op::batch_gemm::TuneKey(mshadow::kFloat32, threads, batch, 4, 4, 4), {1});
+  EXPECT_TRUE(op::UseBatchGemmCPU<float>(batch, 4, 4, 4));
+  // float16 has no BLAS on cpu to choose
+  AlgoRegistry::Get()->Register(
+      op::batch_gemm::TuneKey(mshadow::kFloat16, threads, batch, 20, 20, 20), {1});
+  EXPECT_TRUE(op::UseBatchGemmCPU<mshadow::half::half_t>(batch, 20, 20, 20));
+}
@@ -0,0 +1,288 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file approx_softmax_test.cc
+ * \brief correctness and performance of sampled and hierarchical softmax on CPU
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../../src/operator/contrib/approx_softmax-inl.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+
+namespace {
+using mshadow::Shape1;
+using mshadow::Shape2;
+typedef mshadow::Tensor<cpu, 1, double> Tensor1;
+typedef mshadow::Tensor<cpu, 2, double> Tensor2;
+
+/*! \brief inputs of a linear output layer with deterministic values */
+struct OutputLayer {
+  int n, dim, rows;
+  std::vector<double> data, weight, bias, label;
+  OutputLayer(int n, int dim, int rows, int num_classes)
+    : n(n), dim(dim), rows(rows), data(n * dim), weight(rows * dim), bias(rows), label(n) {
+    for (int i = 0; i < n * dim; ++i) data[i] = std::sin(0.37 * i);
+    for (int i = 0; i < rows * dim; ++i) weight[i] = 0.5 * std::cos(0.23 * i);
+    for (int i = 0; i < rows; ++i) bias[i] = 0.1 * std::sin(1.3 * i);
+    for (int i = 0; i < n; ++i) label[i] = (i * 7 + 3) % num_classes;
+  }
+  Tensor2 Data() { return Tensor2(data.data(), Shape2(n, dim)); }
+  Tensor2 Weight() { return Tensor2(weight.data(), Shape2(rows, dim)); }
+  Tensor1 Bias() { return Tensor1(bias.data(), Shape1(rows)); }
+  Tensor1 Label() { return Tensor1(label.data(), Shape1(n)); }
+};
+
+/*! \brief sampled softmax loss with a full loop over the classes of each row */
+double NaiveSampledSoftmaxLoss(const OutputLayer& l, const std::vector<int>& samples,
+                               const std::vector<double>& log_q) {
+  const int num_sampled = samples.size();
+  double total = 0;
+  for (int i = 0; i < l.n; ++i) {
+    std::vector<double> z;
+    const int label = static_cast<int>(l.label[i]);
+    for (int j = -1; j < num_sampled; ++j) {
+      const int c = j < 0 ? label : samples[j];
+      if (j >= 0 && c == label) continue;
+      double v = l.bias[c] - log_q[j < 0 ? num_sampled + i : j];
+      for (int k = 0; k < l.dim; ++k) v += l.data[i * l.dim + k] * l.weight[c * l.dim + k];
+      z.push_back(v);
+    }
+    double sum = 0;
+    for (double v : z) sum += std::exp(v);
+    total += (i + 1) * (std::log(sum) - z[0]);  // ograd[i] = i + 1
+  }
+  return total;
+}
+
+/*! \brief gradient of loss with respect to each value of x by central differences */
+template<typename Loss>
+std::vector<double> FiniteDifferences(std::vector<double>* x, Loss loss) {
+  const double eps = 1e-6;
+  std::vector<double> grad(x->size());
+  for (size_t k = 0; k < x->size(); ++k) {
+    const double v = (*x)[k];
+    (*x)[k] = v + eps;
+    const double up = loss();
+    (*x)[k] = v - eps;
+    grad[k] = (up - loss()) / (2 * eps);
+    (*x)[k] = v;
+  }
+  return grad;
+}
+
+/*! \brief paths and codes of a balanced tree whose node k has children 2k + 1 and 2k + 2 */
+void BalancedTree(int num_classes, std::vector<double>* path, std::vector<double>* code,
+                  int* depth) {
+  *depth = 0;
+  while ((1 << *depth) < num_classes) ++*depth;
+  path->assign(num_classes * *depth, -1);
+  code->assign(num_classes * *depth, 0);
+  // the leaves are numbered after the num_classes - 1 inner nodes
+  for (int c = 0; c < num_classes; ++c) {
+    std::vector<int> nodes, codes;
+    for (int node = num_classes - 1 + c; node > 0; node = (node - 1) / 2) {
+      nodes.push_back((node - 1) / 2);
+      codes.push_back(node % 2 == 0);
+    }
+    for (size_t k = 0; k < nodes.size(); ++k) {
+      (*path)[c * *depth + k] = nodes[nodes.size() - 1 - k];
+      (*code)[c * *depth + k] = codes[nodes.size() - 1 - k];
+    }
+  }
+}
+}  // namespace
+
+TEST(APPROX_SOFTMAX, SampledMatchesReference) {
+  const int n = 6, dim = 5, num_classes = 40;
+  OutputLayer l(n, dim, num_classes, num_classes);
+  // the label of the first example is also sampled, an accidental hit
+  const std::vector<int> samples = {10, 2, 31, 0, 17, 5, 24};
+  l.label[0] = 10;
+  const int num_sampled = samples.size();
+  std::vector<double> log_q(num_sampled + n);
+  for (size_t k = 0; k < log_q.size(); ++k) log_q[k] = -0.3 * (k % 4);
+  std::vector<double> prob(n * (num_sampled + 1)), loss(n), ograd(n);
+  std::vector<double> workspace(num_sampled * (2 * dim + n));
+  for (int i = 0; i < n; ++i) ograd[i] = i + 1;
+  Tensor2 tprob(prob.data(), Shape2(n, num_sampled + 1));
+  auto forward = [&]() {
+    op::SampledSoftmaxForwardCPU(l.Data(), l.Weight(), l.Bias(), l.Label(), samples, log_q,
+                                 true, workspace.data(), tprob, loss.data(), kWriteTo);
+    double total = 0;
+    for (int i = 0; i < n; ++i) total += ograd[i] * loss[i];
+    return total;
+  };
+  EXPECT_NEAR(NaiveSampledSoftmaxLoss(l, samples, log_q), forward(), 1e-10);
+  EXPECT_EQ(0, prob[1]);
+
+  std::vector<double> gdata(n * dim), gweight(num_classes * dim, 7), gbias(num_classes, 7);
+  const std::vector<OpReqType> req = {kWriteTo, kWriteTo, kWriteTo, kNullOp};
+  op::SampledSoftmaxBackwardCPU(Tensor1(ograd.data(), Shape1(n)), l.Data(), l.Weight(),
+                                l.Label(), samples, tprob, workspace.data(),
+                                Tensor2(gdata.data(), Shape2(n, dim)),
+                                Tensor2(gweight.data(), Shape2(num_classes, dim)),
+                                Tensor1(gbias.data(), Shape1(num_classes)), req);
+  const std::vector<double> expected_data = FiniteDifferences(&l.data, forward);
+  const std::vector<double> expected_weight = FiniteDifferences(&l.weight, forward);
+  const std::vector<double> expected_bias = FiniteDifferences(&l.bias, forward);
+  for (int k = 0; k < n * dim; ++k) EXPECT_NEAR(expected_data[k], gdata[k], 1e-6);
+  for (int k = 0; k < num_classes * dim; ++k) EXPECT_NEAR(expected_weight[k], gweight[k], 1e-6);
+  for (int k = 0; k < num_classes; ++k) EXPECT_NEAR(expected_bias[k], gbias[k], 1e-6);
+
+  // the gradients are added to the rows touched by the batch
+  std::vector<double> gweight2(gweight), gbias2(gbias);
+  op::SampledSoftmaxBackwardCPU(Tensor1(ograd.data(), Shape1(n)), l.Data(), l.Weight(),
+                                l.Label(), samples, tprob, workspace.data(),
+                                Tensor2(gdata.data(), Shape2(n, dim)),
+                                Tensor2(gweight2.data(), Shape2(num_classes, dim)),
+                                Tensor1(gbias2.data(), Shape1(num_classes)),
+                                {kNullOp, kAddTo, kAddTo, kNullOp});
+  for (int k = 0; k < num_classes * dim; ++k) EXPECT_NEAR(2 * gweight[k], gweight2[k], 1e-12);
+  for (int k = 0; k < num_classes; ++k) EXPECT_NEAR(2 * gbias[k], gbias2[k], 1e-12);
+}
+
+TEST(APPROX_SOFTMAX, LogUniformSamples) {
+  const int range_max = 1000;
+  const float log_range = std::log(range_max + 1.0f);
+  double total = 0;
+  for (int c = 0; c < range_max; ++c) total += op::LogUniformProb(c, range_max);
+  EXPECT_NEAR(1.0, total, 1e-9);
+  // class c is drawn for u in [log(c + 1), log(c + 2)) / log(range_max + 1)
+  for (int c : {0, 1, 9, 500, 999}) {
+    const float u = (std::log(c + 1.5f)) / log_range;
+    EXPECT_EQ(c, op::LogUniformClass(u, log_range, range_max));
+  }
+  EXPECT_EQ(range_max - 1, op::LogUniformClass(0.99999994f, log_range, range_max));
+}
+
+TEST(APPROX_SOFTMAX, HierarchicalMatchesReference) {
+  for (int num_classes : {2, 8, 13}) {
+    const int n = 2 * num_classes, dim = 4;
+    std::vector<double> path, code;
+    int depth;
+    BalancedTree(num_classes, &path, &code, &depth);
+    OutputLayer l(n, dim, num_classes - 1, num_classes);
+    for (int i = 0; i < n; ++i) l.label[i] = i % num_classes;
+    Tensor2 tpath(path.data(), Shape2(num_classes, depth));
+    Tensor2 tcode(code.data(), Shape2(num_classes, depth));
+    std::vector<double> loss(n), ograd(n);
+    for (int i = 0; i < n; ++i) ograd[i] = 1 + 0.1 * i;
+    auto forward = [&]() {
+      op::HierarchicalSoftmaxForwardCPU(l.Data(), l.Weight(), l.Bias(), l.Label(), tpath, tcode,
+                                        loss.data(), kWriteTo);
+      double total = 0;
+      for (int i = 0; i < n; ++i) total += ograd[i] * loss[i];
+      return total;
+    };
+    // the probabilities of the classes of an example sum to one
+    std::vector<double> probs(n, 0);
+    for (int c = 0; c < num_classes; ++c) {
+      for (int i = 0; i < n; ++i) l.label[i] = c;
+      forward();
+      for (int i = 0; i < n; ++i) probs[i] += std::exp(-loss[i]);
+    }
+    for (int i = 0; i < n; ++i) EXPECT_NEAR(1.0, probs[i], 1e-12);
+
+    for (int i = 0; i < n; ++i) l.label[i] = (i * 5) % num_classes;
+    std::vector<double> gdata(n * dim, 3), gweight((num_classes - 1) * dim, 3);
+    std::vector<double> gbias(num_classes - 1, 3);
+    op::HierarchicalSoftmaxBackwardCPU(Tensor1(ograd.data(), Shape1(n)), l.Data(), l.Weight(),
+                                       l.Bias(), l.Label(), tpath, tcode,
+                                       Tensor2(gdata.data(), Shape2(n, dim)),
+                                       Tensor2(gweight.data(), Shape2(num_classes - 1, dim)),
+                                       Tensor1(gbias.data(), Shape1(num_classes - 1)),
+                                       {kWriteTo, kWriteTo, kWriteTo, kNullOp, kNullOp, kNullOp});
+    const std::vector<double> expected_data = FiniteDifferences(&l.data, forward);
+    const std::vector<double> expected_weight = FiniteDifferences(&l.weight, forward);
+    const std::vector<double> expected_bias = FiniteDifferences(&l.bias, forward);
+    for (size_t k = 0; k < gdata.size(); ++k) EXPECT_NEAR(expected_data[k], gdata[k], 1e-6);
+    for (size_t k = 0; k < gweight.size(); ++k) EXPECT_NEAR(expected_weight[k], gweight[k], 1e-6);
+    for (size_t k = 0; k < gbias.size(); ++k) EXPECT_NEAR(expected_bias[k], gbias[k], 1e-6);
+  }
+}
+
+/*! \brief Performance tests of sampled and hierarchical softmax against the full softmax */
+TEST(APPROX_SOFTMAX, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 5;
+  const int num_classes = 32768, n = 64, dim = 128, num_sampled = 512;
+#else
+  const size_t COUNT = 2;
+  const int num_classes = 1024, n = 4, dim = 16, num_sampled = 32;
+#endif
+  typedef mshadow::Tensor<cpu, 1, float> TensorF1;
+  typedef mshadow::Tensor<cpu, 2, float> TensorF2;
+  std::vector<float> data(n * dim), weight(num_classes * dim), bias(num_classes), label(n);
+  std::vector<float> loss(n), ograd(n, 1), gdata(n * dim), gweight(num_classes * dim);
+  std::vector<float> gbias(num_classes), logits(n * num_classes);
+  std::vector<float> workspace(num_sampled * (2 * dim + n));
+  std::vector<float> prob(n * (num_sampled + 1));
+  for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<float>(i % 13) * 0.01f;
+  for (size_t i = 0; i < weight.size(); ++i) weight[i] = static_cast<float>(i % 11) * 0.01f;
+  for (int i = 0; i < n; ++i) label[i] = static_cast<float>((i * 37) % (num_classes - 1));
+  std::vector<int> samples(num_sampled);
+  std::vector<double> log_q(num_sampled + n, 0);
+  for (int j = 0; j < num_sampled; ++j) samples[j] = (j * 61) % num_classes;
+  int depth;
+  std::vector<double> path_d, code_d;
+  BalancedTree(num_classes, &path_d, &code_d, &depth);
+  std::vector<float> path(path_d.begin(), path_d.end()), code(code_d.begin(), code_d.end());
+  const std::vector<OpReqType> req = {kWriteTo, kWriteTo, kWriteTo, kNullOp, kNullOp, kNullOp};
+  TensorF2 tdata(data.data(), Shape2(n, dim)), tgdata(gdata.data(), Shape2(n, dim));
+  TensorF2 tweight(weight.data(), Shape2(num_classes, dim));
+  TensorF2 tgweight(gweight.data(), Shape2(num_classes, dim));
+  TensorF1 tbias(bias.data(), Shape1(num_classes)), tgbias(gbias.data(), Shape1(num_classes));
+  TensorF1 tlabel(label.data(), Shape1(n)), tograd(ograd.data(), Shape1(n));
+  TensorF2 tprob(prob.data(), Shape2(n, num_sampled + 1));
+  uint64_t full = 0, sampled = 0, hierarchical = 0;
+  for (size_t i = 0; i < COUNT; ++i) {
+    // full softmax: logits of all the classes and the dense weight gradient
+    uint64_t start = test::perf::getMicroTickCount();
+    TensorF2 tlogits(logits.data(), Shape2(n, num_classes));
+    tlogits = mshadow::expr::dot(tdata, tweight.T());
+    for (int r = 0; r < n; ++r) {
+      float* z = logits.data() + r * num_classes;
+      const float m = *std::max_element(z, z + num_classes);
+      float sum = 0;
+      for (int c = 0; c < num_classes; ++c) sum += (z[c] = std::exp(z[c] - m));
+      for (int c = 0; c < num_classes; ++c) z[c] /= sum;
+      z[static_cast<int>(label[r])] -= 1;
+    }
+    tgweight = mshadow::expr::dot(tlogits.T(), tdata);
+    full += test::perf::getMicroTickCount() - start;
+
+    start = test::perf::getMicroTickCount();
+    op::SampledSoftmaxForwardCPU(tdata, tweight, tbias, tlabel, samples, log_q, true,
+                                 workspace.data(), tprob, loss.data(), kWriteTo);
+    op::SampledSoftmaxBackwardCPU(tograd, tdata, tweight, tlabel, samples, tprob,
+                                  workspace.data(), tgdata, tgweight, tgbias, req);
+    sampled += test::perf::getMicroTickCount() - start;
+
+    start = test::perf::getMicroTickCount();
+    TensorF2 tpath(path.data(), Shape2(num_classes, depth));
+    TensorF2 tcode(code.data(), Shape2(num_classes, depth));
+    TensorF2 tnodes(weight.data(), Shape2(num_classes - 1, dim));
+    TensorF2 tgnodes(gweight.data(), Shape2(num_classes - 1, dim));
+    TensorF1 tnode_bias(bias.data(), Shape1(num_classes - 1));
+    TensorF1 tgnode_bias(gbias.data(), Shape1(num_classes - 1));
+    op::HierarchicalSoftmaxForwardCPU(tdata, tnodes, tnode_bias, tlabel, tpath, tcode,
+                                      loss.data(), kWriteTo);
+    op::HierarchicalSoftmaxBackwardCPU(tograd, tdata, tnodes, tnode_bias, tlabel, tpath, tcode,
+                                       tgdata, tgnodes, tgnode_bias, req);
+    hierarchical += test::perf::getMicroTickCount() - start;
+  }
+  std::cout << std::endl << "forward and backward of " << n << " examples, " << num_classes
+            << " classes of dim " << dim << std::endl
+            << std::setw(16) << "full (ms)" << std::setw(16) << "sampled (ms)"
+            << std::setw(20) << "hierarchical (ms)" << std::endl
+            << std::setw(16) << MICRO2MSF(full) / COUNT
+            << std::setw(16) << MICRO2MSF(sampled) / COUNT
+            << std::setw(20) << MICRO2MSF(hierarchical) / COUNT << std::endl;
+}
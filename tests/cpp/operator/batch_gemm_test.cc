@@ -0,0 +1,111 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file batch_gemm_test.cc
+ * \brief correctness and performance of the batched small matrix products on CPU
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../../src/operator/tensor/batch_gemm.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+
+namespace {
+/*! \brief one product after the other with a triple loop */
+template<typename DType>
+void NaiveBatchGemm(const DType* A, const DType* B, DType* C, int batch, int m, int n, int k,
+                    bool tA, bool tB, DType alpha, DType beta) {
+  for (int b = 0; b < batch; ++b) {
+    const DType* a = A + b * m * k;
+    const DType* bb = B + b * k * n;
+    DType* c = C + b * m * n;
+    for (int i = 0; i < m; ++i) {
+      for (int j = 0; j < n; ++j) {
+        DType sum = 0;
+        for (int p = 0; p < k; ++p) {
+          sum += (tA ? a[p * m + i] : a[i * k + p]) * (tB ? bb[j * k + p] : bb[p * n + j]);
+        }
+        c[i * n + j] = alpha * sum + beta * c[i * n + j];
+      }
+    }
+  }
+}
+
+template<typename DType>
+void CheckBatchGemm(int batch, int m, int n, int k) {
+  std::vector<DType> A(batch * m * k), B(batch * k * n), C(batch * m * n);
+  for (size_t i = 0; i < A.size(); ++i) A[i] = static_cast<DType>(static_cast<int>(i % 7) - 3);
+  for (size_t i = 0; i < B.size(); ++i) B[i] = static_cast<DType>(static_cast<int>(i % 5) - 2);
+  for (size_t i = 0; i < C.size(); ++i) C[i] = static_cast<DType>(i % 3);
+  for (int tA = 0; tA < 2; ++tA) {
+    for (int tB = 0; tB < 2; ++tB) {
+      for (DType beta : {DType(0), DType(0.5)}) {
+        std::vector<DType> expected(C), out(C);
+        NaiveBatchGemm(A.data(), B.data(), expected.data(), batch, m, n, k,
+                       tA != 0, tB != 0, DType(2), beta);
+        ASSERT_TRUE(op::BatchGemmCPU(A.data(), B.data(), out.data(), batch, m, n, k,
+                                     tA != 0, tB != 0, DType(2), beta));
+        EXPECT_EQ(expected, out) << batch << "x" << m << "x" << n << "x" << k;
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST(BATCH_GEMM, BlockedMatchesReference) {
+  // products of small integers are exact, the results must be equal
+  const std::vector<std::vector<int> > sizes = {
+    {5, 2, 2, 2}, {5, 3, 3, 3}, {5, 4, 4, 4}, {5, 8, 8, 8}, {3, 5, 7, 3},
+    {2, 1, 9, 17}, {4, 33, 20, 11}, {2, 64, 64, 64}, {3, 13, 1, 5}, {1, 12, 12, 12},
+  };
+  for (const auto& s : sizes) {
+    CheckBatchGemm<float>(s[0], s[1], s[2], s[3]);
+    CheckBatchGemm<double>(s[0], s[1], s[2], s[3]);
+  }
+}
+
+TEST(BATCH_GEMM, LargeProductsAreLeftToBLAS) {
+  EXPECT_FALSE(op::BatchGemmCPUSupports(1, 64, 64, 64));
+  EXPECT_FALSE(op::BatchGemmCPUSupports(16, 128, 128, 128));
+  EXPECT_TRUE(op::BatchGemmCPUSupports(1, 8, 8, 8));
+  EXPECT_TRUE(op::BatchGemmCPUSupports(16, 64, 64, 64));
+}
+
+/*! \brief Performance tests of batches of small products */
+TEST(BATCH_GEMM, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 10;
+  const int total = 1 << 20;
+#else
+  const size_t COUNT = 2;
+  const int total = 1 << 14;
+#endif
+  std::cout << std::endl << std::setw(24) << "batch x m x n x k" << std::setw(16) << "naive (ms)"
+            << std::setw(16) << "blocked (ms)" << std::setw(12) << "speedup" << std::endl;
+  for (int size : {3, 4, 8, 16, 32, 48}) {
+    const int batch = std::max(1, total / (size * size));
+    std::vector<float> A(batch * size * size, 1.0f), B(A), C(A);
+    uint64_t naive = 0, blocked = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      uint64_t start = test::perf::getMicroTickCount();
+      NaiveBatchGemm(A.data(), B.data(), C.data(), batch, size, size, size,
+                     false, true, 1.0f, 0.0f);
+      naive += test::perf::getMicroTickCount() - start;
+      start = test::perf::getMicroTickCount();
+      op::BatchGemmCPU(A.data(), B.data(), C.data(), batch, size, size, size,
+                       false, true, 1.0f, 0.0f);
+      blocked += test::perf::getMicroTickCount() - start;
+    }
+    std::cout << std::setw(10) << batch << " x " << size << " x " << size << " x " << size
+              << std::setw(16) << MICRO2MSF(naive) / COUNT
+              << std::setw(16) << MICRO2MSF(blocked) / COUNT
+              << std::setw(12) << static_cast<float>(naive) / std::max(blocked, uint64_t(1))
+              << std::endl;
+  }
+}
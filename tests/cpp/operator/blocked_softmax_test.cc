@@ -0,0 +1,159 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file blocked_softmax_test.cc
+ * \brief correctness and performance of the vectorized softmax on CPU
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../../src/operator/nn/blocked_softmax.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+
+namespace {
+/*! \brief max, exp-sum and normalization passes with strided accesses and std::exp */
+template<typename DType>
+void NaiveSoftmax(const DType* in, DType* out, int outer, int M, int inner, bool log) {
+  for (int i = 0; i < outer; ++i) {
+    for (int c = 0; c < inner; ++c) {
+      const DType* x = in + i * M * inner + c;
+      DType* y = out + i * M * inner + c;
+      double m = x[0], sum = 0;
+      for (int j = 1; j < M; ++j) m = std::max(m, static_cast<double>(x[j * inner]));
+      for (int j = 0; j < M; ++j) sum += std::exp(x[j * inner] - m);
+      for (int j = 0; j < M; ++j) {
+        y[j * inner] = static_cast<DType>(log ? x[j * inner] - m - std::log(sum) :
+                                          std::exp(x[j * inner] - m) / sum);
+      }
+    }
+  }
+}
+
+template<typename DType>
+void NaiveSoftmaxGrad(const DType* out, const DType* ograd, DType* igrad,
+                      int outer, int M, int inner, bool log) {
+  for (int i = 0; i < outer; ++i) {
+    for (int c = 0; c < inner; ++c) {
+      const int base = i * M * inner + c;
+      double sum = 0;
+      for (int j = 0; j < M; ++j) {
+        sum += log ? ograd[base + j * inner] : ograd[base + j * inner] * out[base + j * inner];
+      }
+      for (int j = 0; j < M; ++j) {
+        const double g = ograd[base + j * inner], o = out[base + j * inner];
+        igrad[base + j * inner] = static_cast<DType>(log ? g - std::exp(o) * sum : o * (g - sum));
+      }
+    }
+  }
+}
+
+template<bool fast, typename DType>
+void CheckSoftmax(int outer, int M, int inner, double tol) {
+  const int size = outer * M * inner;
+  std::vector<DType> x(size), og(size);
+  for (int i = 0; i < size; ++i) {
+    x[i] = static_cast<DType>(std::sin(0.7 * i) * 8);
+    og[i] = static_cast<DType>(std::cos(0.3 * i));
+  }
+  for (bool log : {false, true}) {
+    std::vector<DType> expected(size), out(size), expected_grad(size), grad(size);
+    NaiveSoftmax(x.data(), expected.data(), outer, M, inner, log);
+    op::softmax_cpu::Softmax<fast>(x.data(), out.data(), outer, M, inner, log);
+    for (int i = 0; i < size; ++i) {
+      EXPECT_NEAR(expected[i], out[i], tol * std::max(1.0, std::fabs(1.0 * expected[i])));
+    }
+    NaiveSoftmaxGrad(expected.data(), og.data(), expected_grad.data(), outer, M, inner, log);
+    op::softmax_cpu::SoftmaxGrad<fast>(expected.data(), og.data(), grad.data(),
+                                       outer, M, inner, log);
+    for (int i = 0; i < size; ++i) {
+      const double scale = std::max(1.0, std::fabs(1.0 * expected_grad[i]));
+      EXPECT_NEAR(expected_grad[i], grad[i], tol * scale);
+    }
+    // in place
+    op::softmax_cpu::Softmax<fast>(x.data(), x.data(), outer, M, inner, log);
+    EXPECT_EQ(out, x);
+    for (int i = 0; i < size; ++i) x[i] = static_cast<DType>(std::sin(0.7 * i) * 8);
+  }
+}
+}  // namespace
+
+TEST(SOFTMAX, BlockedMatchesReference) {
+  const std::vector<std::vector<int> > shapes = {
+    {1, 1, 1}, {3, 7, 1}, {5, 1000, 1}, {2, 5, 3}, {3, 17, 70}, {2, 300, 129},
+  };
+  for (const auto& s : shapes) {
+    CheckSoftmax<false, float>(s[0], s[1], s[2], 1e-5);
+    CheckSoftmax<true, float>(s[0], s[1], s[2], 2e-4);
+    CheckSoftmax<false, double>(s[0], s[1], s[2], 1e-12);
+  }
+}
+
+TEST(SOFTMAX, CrossEntropyMatchesReference) {
+  const int n = 7, k = 1003;
+  std::vector<float> data(n * k), label(n), prob(n * k), grad(n * k);
+  for (int i = 0; i < n * k; ++i) data[i] = static_cast<float>(std::sin(0.37 * i) * 6);
+  for (int i = 0; i < n; ++i) label[i] = static_cast<float>((i * 131) % k);
+  data[3 * k + static_cast<int>(label[3])] = -100.0f;  // loss clipped at -log(1e-8)
+  NaiveSoftmax(data.data(), prob.data(), n, k, 1, false);
+  double expected = 0;
+  for (int i = 0; i < n; ++i) {
+    expected -= std::log(std::max(prob[i * k + static_cast<int>(label[i])], 1e-8f));
+  }
+  EXPECT_NEAR(expected, op::softmax_cpu::SoftmaxCrossEntropy<false>(data.data(), label.data(),
+                                                                    n, k), 1e-4 * expected);
+  op::softmax_cpu::SoftmaxCrossEntropyGrad<false>(data.data(), label.data(), 0.5f,
+                                                  grad.data(), n, k);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < k; ++j) {
+      const float onehot = j == static_cast<int>(label[i]) ? 1.0f : 0.0f;
+      EXPECT_NEAR(0.5f * (prob[i * k + j] - onehot), grad[i * k + j], 1e-6);
+    }
+  }
+}
+
+/*! \brief Performance tests of the vectorized softmax */
+TEST(SOFTMAX, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 10;
+  const int batch = 64;
+#else
+  const size_t COUNT = 2;
+  const int batch = 2;
+#endif
+  const std::vector<std::vector<int> > shapes = {
+    {batch, 32768, 1},      // large vocabulary output layer
+    {batch * 32, 128, 1},   // attention scores
+    {batch, 21, 64 * 64},   // per pixel classes, channel axis
+  };
+  std::cout << std::endl << std::setw(24) << "outer x M x inner" << std::setw(14) << "naive (ms)"
+            << std::setw(14) << "blocked (ms)" << std::setw(14) << "fast exp (ms)"
+            << std::setw(10) << "speedup" << std::endl;
+  for (const auto& s : shapes) {
+    std::vector<float> x(static_cast<size_t>(s[0]) * s[1] * s[2]), out(x.size());
+    for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<float>(i % 17) * 0.25f;
+    uint64_t naive = 0, blocked = 0, fast = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      uint64_t start = test::perf::getMicroTickCount();
+      NaiveSoftmax(x.data(), out.data(), s[0], s[1], s[2], false);
+      naive += test::perf::getMicroTickCount() - start;
+      start = test::perf::getMicroTickCount();
+      op::softmax_cpu::Softmax<false>(x.data(), out.data(), s[0], s[1], s[2], false);
+      blocked += test::perf::getMicroTickCount() - start;
+      start = test::perf::getMicroTickCount();
+      op::softmax_cpu::Softmax<true>(x.data(), out.data(), s[0], s[1], s[2], false);
+      fast += test::perf::getMicroTickCount() - start;
+    }
+    std::cout << std::setw(10) << s[0] << " x " << s[1] << " x " << s[2]
+              << std::setw(14) << MICRO2MSF(naive) / COUNT
+              << std::setw(14) << MICRO2MSF(blocked) / COUNT
+              << std::setw(14) << MICRO2MSF(fast) / COUNT
+              << std::setw(10) << static_cast<float>(naive) / std::max(blocked, uint64_t(1))
+              << std::endl;
+  }
+}
@@ -0,0 +1,181 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file ctc_loss_test.cc
+ * \brief correctness and performance of the CPU CTC loss against warp-ctc
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../../src/operator/contrib/ctc_cpu.h"
+#include "../../src/operator/contrib/ctc_include/detail/cpu_ctc.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+
+namespace {
+/*! \brief a batch of activations of shape (max_time, minibatch, alphabet_size) and labels */
+struct CTCBatch {
+  int alphabet_size, minibatch, max_time;
+  std::vector<float> activations;
+  std::vector<int> labels, label_lengths, input_lengths;
+  CTCBatch(int alphabet_size, const std::vector<int>& input_lengths,
+           const std::vector<int>& label_lengths, bool repeats)
+    : alphabet_size(alphabet_size), minibatch(input_lengths.size()),
+      label_lengths(label_lengths), input_lengths(input_lengths) {
+    max_time = *std::max_element(input_lengths.begin(), input_lengths.end());
+    activations.resize(static_cast<size_t>(max_time) * minibatch * alphabet_size);
+    for (size_t i = 0; i < activations.size(); ++i) {
+      activations[i] = static_cast<float>(std::sin(0.37 * i) * 3);
+    }
+    for (int b = 0; b < minibatch; ++b) {
+      for (int i = 0; i < label_lengths[b]; ++i) {
+        // labels in [1, alphabet_size), 0 is the blank
+        const int step = repeats && i % 3 == 2 ? 0 : 1;
+        labels.push_back(i == 0 ? 1 + b % (alphabet_size - 1)
+                                : 1 + (labels.back() - 1 + step * (b + i)) % (alphabet_size - 1));
+      }
+    }
+  }
+
+  /*! \brief loss and gradient with the warp-ctc CPU implementation */
+  void WarpCTC(std::vector<float>* costs, std::vector<float>* grads) const {
+    const int max_label_length = *std::max_element(label_lengths.begin(), label_lengths.end());
+    const int S = 2 * max_label_length + 1;
+    const size_t per_minibatch = sizeof(float) * (alphabet_size + S * max_time + S) +
+                                 3 * sizeof(int) * S;
+    std::vector<char> workspace(per_minibatch * minibatch +
+                                sizeof(float) * alphabet_size * max_time * minibatch);
+    mxnet_warpctc::CpuCTC<float> ctc(alphabet_size, minibatch, workspace.data(), 0);
+    ctc.cost_and_grad(activations.data(), grads->data(), costs->data(), labels.data(),
+                      label_lengths.data(), input_lengths.data());
+  }
+
+  void CTC(std::vector<float>* costs, std::vector<float>* grads) const {
+    const int max_label_length = *std::max_element(label_lengths.begin(), label_lengths.end());
+    const int num_slots = op::ctc_cpu::NumSlots(minibatch);
+    std::vector<float> workspace(op::ctc_cpu::WorkspaceSize(alphabet_size, minibatch, max_time,
+                                                            max_label_length, num_slots));
+    op::ctc_cpu::CTCLoss(activations.data(), costs->data(), grads ? grads->data() : nullptr,
+                         labels.data(), label_lengths.data(), input_lengths.data(),
+                         alphabet_size, minibatch, workspace.data(), num_slots);
+  }
+};
+}  // namespace
+
+TEST(CTC_LOSS, MatchesWarpCTC) {
+  for (bool repeats : {false, true}) {
+    CTCBatch batch(12, {30, 7, 64, 64, 1, 45, 20, 33}, {10, 3, 25, 1, 1, 0, 9, 16}, repeats);
+    const size_t size = batch.activations.size();
+    std::vector<float> expected_costs(batch.minibatch), expected_grads(size, 0);
+    std::vector<float> costs(batch.minibatch), grads(size, 7), scores(batch.minibatch);
+    batch.WarpCTC(&expected_costs, &expected_grads);
+    batch.CTC(&costs, &grads);
+    batch.CTC(&scores, nullptr);
+    for (int b = 0; b < batch.minibatch; ++b) {
+      EXPECT_NEAR(expected_costs[b], costs[b], 1e-4 * std::max(1.0f, expected_costs[b]));
+      EXPECT_EQ(costs[b], scores[b]);
+      for (int t = 0; t < batch.max_time; ++t) {
+        for (int k = 0; k < batch.alphabet_size; ++k) {
+          const size_t i = (static_cast<size_t>(t) * batch.minibatch + b) *
+                           batch.alphabet_size + k;
+          // warp-ctc leaves the steps past the end of the input as they are. Both
+          // gradients are within 5e-5 of the one computed in double precision
+          EXPECT_NEAR(t < batch.input_lengths[b] ? expected_grads[i] : 0.0f, grads[i], 1e-4);
+        }
+      }
+    }
+  }
+}
+
+TEST(CTC_LOSS, MatchesFiniteDifferences) {
+  // labels with a repeat and with no label at all, in double precision
+  const int A = 5, T = 6;
+  const std::vector<int> labels = {2, 2, 4}, label_lengths = {3, 0}, input_lengths = {T, T - 2};
+  std::vector<double> act(T * 2 * A), costs(2), grads(act.size());
+  for (size_t i = 0; i < act.size(); ++i) act[i] = std::cos(1.7 * i);
+  const int num_slots = op::ctc_cpu::NumSlots(2);
+  std::vector<double> workspace(op::ctc_cpu::WorkspaceSize(A, 2, T, 3, num_slots));
+  auto loss = [&](std::vector<double>* g) {
+    op::ctc_cpu::CTCLoss(act.data(), costs.data(), g ? g->data() : nullptr, labels.data(),
+                         label_lengths.data(), input_lengths.data(), A, 2, workspace.data(),
+                         num_slots);
+    return costs[0] + costs[1];
+  };
+  loss(&grads);
+  // no label: the blank is emitted at each step
+  double blank = 0;
+  for (int t = 0; t < T - 2; ++t) {
+    const double* x = act.data() + (t * 2 + 1) * A;
+    double sum = 0;
+    for (int k = 0; k < A; ++k) sum += std::exp(x[k]);
+    blank += std::log(sum) - x[0];
+  }
+  EXPECT_NEAR(blank, costs[1], 1e-12);
+  const double eps = 1e-6;
+  for (size_t i = 0; i < act.size(); ++i) {
+    const double v = act[i];
+    act[i] = v + eps;
+    const double up = loss(nullptr);
+    act[i] = v - eps;
+    const double down = loss(nullptr);
+    act[i] = v;
+    EXPECT_NEAR((up - down) / (2 * eps), grads[i], 1e-7);
+  }
+}
+
+TEST(CTC_LOSS, EmptyInput) {
+  CTCBatch batch(6, {0, 0, 5}, {0, 2, 1}, false);
+  std::vector<float> costs(batch.minibatch), grads(batch.activations.size(), 7);
+  batch.CTC(&costs, &grads);
+  EXPECT_EQ(0.0f, costs[0]);
+  EXPECT_TRUE(std::isinf(costs[1]) && costs[1] > 0);
+  EXPECT_TRUE(std::isfinite(costs[2]) && costs[2] > 0);
+  for (int t = 0; t < batch.max_time; ++t) {
+    for (int b = 0; b < 2; ++b) {
+      for (int k = 0; k < batch.alphabet_size; ++k) {
+        EXPECT_EQ(0.0f, grads[(t * batch.minibatch + b) * batch.alphabet_size + k]);
+      }
+    }
+  }
+}
+
+/*! \brief Performance tests of the CPU CTC loss against warp-ctc, with uneven lengths */
+TEST(CTC_LOSS, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 5;
+  const int minibatch = 32, max_time = 400;
+#else
+  const size_t COUNT = 2;
+  const int minibatch = 4, max_time = 40;
+#endif
+  std::vector<int> input_lengths(minibatch), label_lengths(minibatch);
+  for (int b = 0; b < minibatch; ++b) {
+    // a few long utterances among short ones
+    input_lengths[b] = b % 8 == 0 ? max_time : max_time / 4 + (b * 7) % (max_time / 4);
+    label_lengths[b] = input_lengths[b] / 5;
+  }
+  CTCBatch batch(30, input_lengths, label_lengths, true);
+  std::vector<float> costs(minibatch), grads(batch.activations.size());
+  uint64_t warp = 0, blocked = 0;
+  for (size_t i = 0; i < COUNT; ++i) {
+    uint64_t start = test::perf::getMicroTickCount();
+    batch.WarpCTC(&costs, &grads);
+    warp += test::perf::getMicroTickCount() - start;
+    start = test::perf::getMicroTickCount();
+    batch.CTC(&costs, &grads);
+    blocked += test::perf::getMicroTickCount() - start;
+  }
+  std::cout << std::endl << "CTC loss and gradient of " << minibatch << " sequences of up to "
+            << max_time << " steps" << std::endl
+            << std::setw(16) << "warp-ctc (ms)" << std::setw(16) << "blocked (ms)"
+            << std::setw(10) << "speedup" << std::endl
+            << std::setw(16) << MICRO2MSF(warp) / COUNT
+            << std::setw(16) << MICRO2MSF(blocked) / COUNT
+            << std::setw(10) << static_cast<float>(warp) / std::max(blocked, uint64_t(1))
+            << std::endl;
+}
@@ -0,0 +1,127 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file elemwise_sum_test.cc
+ * \brief correctness and performance of the cache-blocked CPU elementwise sum
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../../src/operator/tensor/elemwise_sum.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+
+namespace {
+mshadow::Stream<cpu> *cpu_stream = nullptr;
+
+/*! \brief the previous add_n: fused kernels up to four inputs, then one pass per input */
+void UnblockedSum(const std::vector<const float*>& in, float *out, size_t size) {
+  using op::mxnet_op::Kernel;
+  const int n = static_cast<int>(size);
+  std::vector<float*> a;
+  for (const float *p : in) a.push_back(const_cast<float*>(p));
+  switch (in.size()) {
+    case 2:
+      Kernel<op::Sum, cpu>::Launch(cpu_stream, n, out, kWriteTo, a[0], a[1]);
+      break;
+    case 3:
+      Kernel<op::Sum, cpu>::Launch(cpu_stream, n, out, kWriteTo, a[0], a[1], a[2]);
+      break;
+    case 4:
+      Kernel<op::Sum, cpu>::Launch(cpu_stream, n, out, kWriteTo, a[0], a[1], a[2], a[3]);
+      break;
+    default:
+      Kernel<op::Sum, cpu>::Launch(cpu_stream, n, out, kWriteTo, a[0]);
+      for (size_t k = 1; k < in.size(); ++k) {
+        Kernel<op::Sum, cpu>::Launch(cpu_stream, n, out, kWriteTo, out, a[k]);
+      }
+      break;
+  }
+}
+
+std::vector<std::vector<float> > MakeInputs(size_t num, size_t size) {
+  std::vector<std::vector<float> > data(num, std::vector<float>(size));
+  for (size_t k = 0; k < num; ++k) {
+    for (size_t j = 0; j < size; ++j) {
+      data[k][j] = static_cast<float>((k * 7 + j * 13) % 17) - 8.0f;
+    }
+  }
+  return data;
+}
+
+std::vector<const float*> Pointers(const std::vector<std::vector<float> >& data) {
+  std::vector<const float*> ptrs;
+  for (const auto& d : data) ptrs.push_back(d.data());
+  return ptrs;
+}
+}  // namespace
+
+TEST(ELEMWISE_SUM, BlockedMatchesReference) {
+  // sizes around the block size, including partial blocks
+  const size_t block = op::kElementwiseSumBlockBytes / sizeof(float);
+  for (size_t size : {size_t(1), size_t(1000), block, block * 3 + 17}) {
+    for (size_t num : {1, 2, 3, 4, 5, 8, 13}) {
+      auto data = MakeInputs(num, size);
+      std::vector<float> expected(size), out(size, 1.0f);
+      UnblockedSum(Pointers(data), expected.data(), size);
+      EXPECT_TRUE(op::ElementwiseSumBlocked<float>(cpu_stream, Pointers(data),
+                                                   out.data(), size, kWriteTo));
+      EXPECT_EQ(expected, out);
+      // accumulate into the output
+      EXPECT_TRUE(op::ElementwiseSumBlocked<float>(cpu_stream, Pointers(data),
+                                                   out.data(), size, kAddTo));
+      for (size_t j = 0; j < size; ++j) EXPECT_EQ(expected[j] * 2, out[j]);
+    }
+  }
+}
+
+TEST(ELEMWISE_SUM, BlockedInplace) {
+  const size_t size = 100000;
+  for (size_t pos : {0, 3, 6}) {
+    auto data = MakeInputs(7, size);
+    std::vector<float> expected(size);
+    UnblockedSum(Pointers(data), expected.data(), size);
+    std::vector<const float*> ptrs = Pointers(data);
+    float *out = data[pos].data();
+    EXPECT_TRUE(op::ElementwiseSumBlocked<float>(cpu_stream, ptrs, out, size, kWriteTo));
+    EXPECT_EQ(expected, data[pos]);
+    // accumulating into one of the inputs is left to the generic path
+    EXPECT_FALSE(op::ElementwiseSumBlocked<float>(cpu_stream, ptrs, out, size, kAddTo));
+  }
+}
+
+/*! \brief Performance tests for 2 to 64 inputs of 32K floats, against the previous add_n */
+TEST(ELEMWISE_SUM, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 50;
+  const size_t size = 1 << 15;
+#else
+  const size_t COUNT = 5;
+  const size_t size = 1 << 12;
+#endif
+  std::cout << std::endl << std::setw(8) << "inputs" << std::setw(16) << "unblocked (ms)"
+            << std::setw(16) << "blocked (ms)" << std::setw(12) << "speedup" << std::endl;
+  for (size_t num : {2, 4, 8, 16, 32, 64}) {
+    auto data = MakeInputs(num, size);
+    std::vector<const float*> ptrs = Pointers(data);
+    std::vector<float> out(size);
+    uint64_t unblocked = 0, blocked = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      uint64_t start = test::perf::getMicroTickCount();
+      UnblockedSum(ptrs, out.data(), size);
+      unblocked += test::perf::getMicroTickCount() - start;
+      start = test::perf::getMicroTickCount();
+      op::ElementwiseSumBlocked<float>(cpu_stream, ptrs, out.data(), size, kWriteTo);
+      blocked += test::perf::getMicroTickCount() - start;
+    }
+    std::cout << std::setw(8) << num
+              << std::setw(16) << MICRO2MSF(unblocked) / COUNT
+              << std::setw(16) << MICRO2MSF(blocked) / COUNT
+              << std::setw(12) << static_cast<float>(unblocked) / std::max(blocked, uint64_t(1))
+              << std::endl;
+  }
+}
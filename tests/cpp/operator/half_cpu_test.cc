@@ -0,0 +1,150 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file half_cpu_test.cc
+ * \brief float16 and bfloat16 storage with float32 compute on cpu
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "../../src/operator/half_cpu.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+using op::half_cpu::half_t;
+using op::half_cpu::bf16_t;
+
+TEST(HALF_CPU, ConversionRoundTrip) {
+  std::vector<uint16_t> bits(1 << 16), back(bits.size());
+  for (size_t i = 0; i < bits.size(); ++i) bits[i] = static_cast<uint16_t>(i);
+  std::vector<float> f(bits.size());
+  op::half_cpu::HalfToFloat(reinterpret_cast<half_t*>(bits.data()), f.data(), f.size());
+  op::half_cpu::FloatToHalf(f.data(), reinterpret_cast<half_t*>(back.data()), f.size());
+  for (size_t i = 0; i < bits.size(); ++i) {
+    const float expected = op::half_cpu::HalfBitsToFloat(bits[i]);
+    if (std::isnan(expected)) {
+      // nan payloads are not kept
+      EXPECT_TRUE(std::isnan(f[i])) << i;
+      EXPECT_EQ(0x7c00, back[i] & 0x7c00) << i;
+    } else {
+      EXPECT_EQ(expected, f[i]) << i;
+      EXPECT_EQ(bits[i], back[i]) << i;
+    }
+  }
+}
+
+TEST(HALF_CPU, RoundToNearestEven) {
+  std::vector<float> f(100003);
+  for (size_t i = 0; i < f.size(); ++i) {
+    f[i] = static_cast<float>(std::sin(0.71 * i) * std::exp(std::fmod(0.37 * i, 40.0) - 25));
+  }
+  f[0] = 65520.0f;  // rounds to infinity
+  f[1] = 2049.0f;  // a tie, rounds to the even 2048
+  std::vector<uint16_t> h(f.size());
+  op::half_cpu::FloatToHalfParallel(f.data(), reinterpret_cast<half_t*>(h.data()), f.size());
+  EXPECT_EQ(0x7c00, h[0]);
+  EXPECT_EQ(2048.0f, op::half_cpu::HalfBitsToFloat(h[1]));
+  for (size_t i = 0; i < f.size(); ++i) {
+    EXPECT_EQ(op::half_cpu::FloatToHalfBits(f[i]), h[i]) << f[i];
+  }
+}
+
+TEST(HALF_CPU, Bfloat16RoundTrip) {
+  std::vector<uint16_t> bits(1 << 16), back(bits.size());
+  for (size_t i = 0; i < bits.size(); ++i) bits[i] = static_cast<uint16_t>(i);
+  std::vector<float> f(bits.size());
+  op::half_cpu::HalfToFloat(reinterpret_cast<bf16_t*>(bits.data()), f.data(), f.size());
+  op::half_cpu::FloatToHalf(f.data(), reinterpret_cast<bf16_t*>(back.data()), f.size());
+  for (size_t i = 0; i < bits.size(); ++i) {
+    const float expected = op::half_cpu::BitsFloat(static_cast<uint32_t>(bits[i]) << 16);
+    if (std::isnan(expected)) {
+      EXPECT_TRUE(std::isnan(f[i])) << i;
+      EXPECT_EQ(bits[i] | 0x40, back[i]) << i;
+    } else {
+      EXPECT_EQ(expected, f[i]) << i;
+      EXPECT_EQ(bits[i], back[i]) << i;
+    }
+  }
+}
+
+TEST(HALF_CPU, Bfloat16RoundToNearestEven) {
+  const float values[] = {1.0f + 1.0f / 256, 1.0f + 3.0f / 256, 1.0f + 1.0f / 256 + 1e-6f,
+                          3.4e38f, -2.5e-39f};
+  const float expected[] = {1.0f, 1.0f + 4.0f / 256, 1.0f + 2.0f / 256,
+                            std::numeric_limits<float>::infinity(), -2.5e-39f};
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+    bf16_t b;
+    op::half_cpu::FloatToHalf(&values[i], &b, 1);
+    EXPECT_EQ(b.bits_, bf16_t(values[i]).bits_) << values[i];
+    if (i + 1 < sizeof(values) / sizeof(values[0])) {
+      EXPECT_EQ(expected[i], static_cast<float>(b)) << values[i];
+    } else {
+      // subnormal, within half of the spacing 2^-133
+      EXPECT_NEAR(expected[i], static_cast<float>(b), std::ldexp(1.0f, -134)) << values[i];
+    }
+  }
+}
+
+TEST(HALF_CPU, LinearMatchesFloat) {
+  const int n = 5, k = 300, m = 700;  // several panels of weights
+  std::vector<half_t> x(n * k), w(m * k), bias(m), y(n * m);
+  for (size_t i = 0; i < x.size(); ++i) x[i] = half_t(static_cast<float>(std::sin(0.3 * i)));
+  for (size_t i = 0; i < w.size(); ++i) w[i] = half_t(static_cast<float>(std::cos(0.7 * i) / 16));
+  for (size_t i = 0; i < bias.size(); ++i) bias[i] = half_t(static_cast<float>(i % 7) - 3);
+  std::vector<float> workspace(op::half_cpu::LinearWorkspaceSize(n, k, m));
+  op::half_cpu::Linear(x.data(), w.data(), bias.data(), y.data(), n, k, m, workspace.data());
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < m; ++j) {
+      double expected = static_cast<float>(bias[j]);
+      for (int l = 0; l < k; ++l) {
+        expected += static_cast<float>(x[i * k + l]) * static_cast<float>(w[j * k + l]);
+      }
+      EXPECT_NEAR(expected, static_cast<float>(y[i * m + j]), 1e-3 * (1 + std::fabs(expected)));
+    }
+  }
+}
+
+/*! \brief Performance of a fully connected layer with float16 weights against float32 */
+TEST(HALF_CPU, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 20;
+  const int n = 16, k = 2048, m = 2048;
+#else
+  const size_t COUNT = 2;
+  const int n = 4, k = 64, m = 64;
+#endif
+  using namespace mshadow;
+  using namespace mshadow::expr;
+  std::vector<float> xf(n * k), wf(m * k), yf(n * m);
+  for (size_t i = 0; i < xf.size(); ++i) xf[i] = static_cast<float>(std::sin(0.3 * i));
+  for (size_t i = 0; i < wf.size(); ++i) wf[i] = static_cast<float>(std::cos(0.7 * i));
+  std::vector<half_t> x(xf.size()), w(wf.size()), y(yf.size());
+  op::half_cpu::FloatToHalf(xf.data(), x.data(), x.size());
+  op::half_cpu::FloatToHalf(wf.data(), w.data(), w.size());
+  std::vector<float> workspace(op::half_cpu::LinearWorkspaceSize(n, k, m));
+  Tensor<cpu, 2, float> data(xf.data(), Shape2(n, k)), weight(wf.data(), Shape2(m, k));
+  Tensor<cpu, 2, float> out(yf.data(), Shape2(n, m));
+  uint64_t single = 0, half = 0;
+  for (size_t i = 0; i < COUNT; ++i) {
+    uint64_t start = test::perf::getMicroTickCount();
+    out = dot(data, weight.T());
+    single += test::perf::getMicroTickCount() - start;
+    start = test::perf::getMicroTickCount();
+    op::half_cpu::Linear<half_t>(x.data(), w.data(), nullptr, y.data(), n, k, m, workspace.data());
+    half += test::perf::getMicroTickCount() - start;
+  }
+  std::cout << std::endl << "FullyConnected of " << n << "x" << k << " by " << m << "x" << k
+            << (op::half_cpu::HasF16C() ? " with" : " without") << " F16C" << std::endl
+            << std::setw(16) << "float32 (ms)" << std::setw(16) << "float16 (ms)"
+            << std::setw(10) << "ratio" << std::endl
+            << std::setw(16) << MICRO2MSF(single) / COUNT
+            << std::setw(16) << MICRO2MSF(half) / COUNT
+            << std::setw(10) << static_cast<float>(single) / std::max(half, uint64_t(1))
+            << std::endl;
+}
@@ -0,0 +1,160 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file layer_norm_test.cc
+ * \brief correctness and performance of the fused normalization kernels on CPU
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../src/operator/nn/layer_norm-inl.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+using op::norm::NormLayout;
+
+namespace {
+/*! \brief mean, then variance, then normalization, each in its own pass */
+template<typename DType>
+void NaiveNorm(const DType* x, const DType* gamma, const DType* beta, DType* out,
+               const NormLayout& l, double eps) {
+  const int n = l.row_size();
+  for (int r = 0; r < l.rows; ++r) {
+    const DType* xr = x + r * n;
+    double mean = 0, var = 0;
+    for (int i = 0; i < n; ++i) mean += xr[i];
+    mean /= n;
+    for (int i = 0; i < n; ++i) var += (xr[i] - mean) * (xr[i] - mean);
+    var /= n;
+    for (int i = 0; i < n; ++i) {
+      const int c = (r % l.groups) * l.channels_per_row + i / l.inner;
+      out[r * n + i] = static_cast<DType>((xr[i] - mean) / std::sqrt(var + eps) * gamma[c]
+                                          + beta[c]);
+    }
+  }
+}
+
+/*! \brief sum(w * out), whose gradients the backward kernel computes with dy = w */
+double WeightedNorm(const std::vector<double>& x, const std::vector<double>& gamma,
+                    const std::vector<double>& beta, const std::vector<double>& w,
+                    const NormLayout& l, double eps) {
+  std::vector<double> out(x.size());
+  NaiveNorm(x.data(), gamma.data(), beta.data(), out.data(), l, eps);
+  double sum = 0;
+  for (size_t i = 0; i < out.size(); ++i) sum += w[i] * out[i];
+  return sum;
+}
+
+const std::vector<NormLayout> layouts = {
+  {6, 1, 37, 1},     // layer norm of (6, 37)
+  {3, 1, 1000, 1},   // rows longer than a moments chunk
+  {12, 3, 1, 29},    // instance norm of (4, 3, 29)
+  {4, 2, 3, 7},      // group norm of (2, 6, 7) with 2 groups
+};
+}  // namespace
+
+TEST(LAYER_NORM, ForwardMatchesReference) {
+  const double eps = 1e-5;
+  for (const auto& l : layouts) {
+    const int size = l.rows * l.row_size();
+    // values far from zero, the one pass moments must not lose their variance
+    std::vector<float> x(size), gamma(l.channels()), beta(l.channels());
+    for (int i = 0; i < size; ++i) x[i] = 100.0f + static_cast<float>((i * 37) % 23) * 0.25f;
+    for (int c = 0; c < l.channels(); ++c) {
+      gamma[c] = 0.5f + 0.1f * (c % 5);
+      beta[c] = 0.2f * (c % 3) - 0.2f;
+    }
+    std::vector<float> expected(size), out(size), mean(l.rows), var(l.rows);
+    NaiveNorm(x.data(), gamma.data(), beta.data(), expected.data(), l, eps);
+    op::norm::NormForwardCPU(x.data(), gamma.data(), beta.data(), out.data(),
+                             mean.data(), var.data(), l, eps, kWriteTo);
+    for (int i = 0; i < size; ++i) EXPECT_NEAR(expected[i], out[i], 1e-3);
+  }
+}
+
+TEST(LAYER_NORM, BackwardMatchesFiniteDifferences) {
+  const double eps = 1e-5, h = 1e-6;
+  for (const auto& l : layouts) {
+    const int size = l.rows * l.row_size(), channels = l.channels();
+    std::vector<double> x(size), w(size), gamma(channels), beta(channels);
+    for (int i = 0; i < size; ++i) {
+      x[i] = std::sin(0.37 * i) * 3 + 5;
+      w[i] = std::cos(0.11 * i);
+    }
+    for (int c = 0; c < channels; ++c) {
+      gamma[c] = 1.0 + 0.3 * std::sin(c);
+      beta[c] = 0.5 * std::cos(c);
+    }
+    std::vector<double> out(size), mean(l.rows), var(l.rows);
+    std::vector<double> dx(size), dgamma(channels), dbeta(channels);
+    std::vector<double> workspace(op::norm::NormBackwardWorkspaceSize(l));
+    op::norm::NormForwardCPU(x.data(), gamma.data(), beta.data(), out.data(),
+                             mean.data(), var.data(), l, eps, kWriteTo);
+    op::norm::NormBackwardCPU(w.data(), x.data(), gamma.data(), mean.data(), var.data(),
+                              dx.data(), dgamma.data(), dbeta.data(), l, eps,
+                              kWriteTo, kWriteTo, kWriteTo, workspace.data());
+    for (int i = 0; i < size; i += std::max(1, size / 50)) {
+      std::vector<double> xp(x), xm(x);
+      xp[i] += h;
+      xm[i] -= h;
+      const double numeric = (WeightedNorm(xp, gamma, beta, w, l, eps) -
+                              WeightedNorm(xm, gamma, beta, w, l, eps)) / (2 * h);
+      EXPECT_NEAR(numeric, dx[i], 1e-5);
+    }
+    for (int c = 0; c < channels; ++c) {
+      std::vector<double> gp(gamma), gm(gamma), bp(beta), bm(beta);
+      gp[c] += h;
+      gm[c] -= h;
+      bp[c] += h;
+      bm[c] -= h;
+      EXPECT_NEAR((WeightedNorm(x, gp, beta, w, l, eps) -
+                   WeightedNorm(x, gm, beta, w, l, eps)) / (2 * h), dgamma[c], 1e-5);
+      EXPECT_NEAR((WeightedNorm(x, gamma, bp, w, l, eps) -
+                   WeightedNorm(x, gamma, bm, w, l, eps)) / (2 * h), dbeta[c], 1e-5);
+    }
+  }
+}
+
+/*! \brief Performance tests of the fused normalization */
+TEST(LAYER_NORM, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 10;
+  const int batch = 64;
+#else
+  const size_t COUNT = 2;
+  const int batch = 4;
+#endif
+  const std::vector<std::pair<std::string, NormLayout> > cases = {
+    {"layer (64 x 128, 1024)", {batch * 128, 1, 1024, 1}},
+    {"instance (64, 64, 56, 56)", {batch * 64, 64, 1, 56 * 56}},
+    {"group 32 (64, 64, 56, 56)", {batch * 32, 32, 2, 56 * 56}},
+  };
+  std::cout << std::endl << std::setw(28) << "normalization" << std::setw(16) << "naive (ms)"
+            << std::setw(16) << "fused (ms)" << std::setw(12) << "speedup" << std::endl;
+  for (const auto& c : cases) {
+    const NormLayout& l = c.second;
+    std::vector<float> x(static_cast<size_t>(l.rows) * l.row_size(), 1.0f), out(x.size());
+    std::vector<float> gamma(l.channels(), 1.0f), beta(l.channels()), mean(l.rows), var(l.rows);
+    uint64_t naive = 0, fused = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      uint64_t start = test::perf::getMicroTickCount();
+      NaiveNorm(x.data(), gamma.data(), beta.data(), out.data(), l, 1e-5);
+      naive += test::perf::getMicroTickCount() - start;
+      start = test::perf::getMicroTickCount();
+      op::norm::NormForwardCPU(x.data(), gamma.data(), beta.data(), out.data(),
+                               mean.data(), var.data(), l, 1e-5f, kWriteTo);
+      fused += test::perf::getMicroTickCount() - start;
+    }
+    std::cout << std::setw(28) << c.first
+              << std::setw(16) << MICRO2MSF(naive) / COUNT
+              << std::setw(16) << MICRO2MSF(fused) / COUNT
+              << std::setw(12) << static_cast<float>(naive) / std::max(fused, uint64_t(1))
+              << std::endl;
+  }
+}
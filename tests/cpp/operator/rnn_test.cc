@@ -0,0 +1,126 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file rnn_test.cc
+ * \brief variable length sequences in the CPU RNN forward
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../../src/operator/rnn-inl.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+
+namespace {
+/*! \brief a stacked RNN with inputs of shape (max_time, batch, input_size) */
+struct RNNBatch {
+  int mode, T, N, I, H, L, D;
+  std::vector<float> x, params, hx, cx;
+  RNNBatch(int mode, int T, int N, int I, int H, int L, bool bidirectional)
+    : mode(mode), T(T), N(N), I(I), H(H), L(L), D(bidirectional ? 2 : 1),
+      x(static_cast<size_t>(T) * N * I), hx(L * D * N * H), cx(hx.size()) {
+    params.resize(op::rnn_param_size(L, I, H, bidirectional, mode));
+    for (size_t i = 0; i < x.size(); ++i) x[i] = static_cast<float>(std::sin(0.37 * i));
+    for (size_t i = 0; i < params.size(); ++i) {
+      params[i] = static_cast<float>(std::cos(1.3 * i) / std::sqrt(H));
+    }
+    for (size_t i = 0; i < hx.size(); ++i) {
+      hx[i] = static_cast<float>(std::sin(0.11 * i) / 2);
+      cx[i] = static_cast<float>(std::cos(0.23 * i) / 2);
+    }
+  }
+
+  /*! \brief forward of the whole batch, with the given lengths if any */
+  void Forward(const std::vector<float>* lengths, std::vector<float>* y,
+               std::vector<float>* hy, std::vector<float>* cy) const {
+    std::vector<float> workspace(op::rnn_cpu::WorkspaceSize(T, N, I, H, D, mode));
+    op::rnn_cpu::Forward(x.data(), params.data(), hx.data(), cx.data(),
+                         lengths ? lengths->data() : nullptr, T, N, I, H, L, D, mode,
+                         y->data(), hy->data(), cy->data(), workspace.data());
+  }
+
+  /*! \brief forward of sequence b alone, cut to its first len steps */
+  RNNBatch Sequence(int b, int len) const {
+    RNNBatch seq(mode, len, 1, I, H, L, D == 2);
+    seq.params = params;
+    for (int t = 0; t < len; ++t) {
+      std::copy_n(x.begin() + (static_cast<size_t>(t) * N + b) * I, I, seq.x.begin() + t * I);
+    }
+    for (int s = 0; s < L * D; ++s) {
+      std::copy_n(hx.begin() + (s * N + b) * H, H, seq.hx.begin() + s * H);
+      std::copy_n(cx.begin() + (s * N + b) * H, H, seq.cx.begin() + s * H);
+    }
+    return seq;
+  }
+};
+}  // namespace
+
+TEST(RNN, SequenceLengthMatchesSequences) {
+  const std::vector<float> lengths = {5, 9, 1, 9, 0, 3};
+  for (int mode : {op::rnn_enum::kRnnRelu, op::rnn_enum::kRnnTanh,
+                   op::rnn_enum::kLstm, op::rnn_enum::kGru}) {
+    for (bool bidirectional : {false, true}) {
+      RNNBatch batch(mode, 9, lengths.size(), 7, 6, 2, bidirectional);
+      const int DH = batch.D * batch.H;
+      std::vector<float> y(batch.T * batch.N * DH, 7), hy(batch.hx.size()), cy(hy.size());
+      batch.Forward(&lengths, &y, &hy, &cy);
+      for (int b = 0; b < batch.N; ++b) {
+        const int len = lengths[b];
+        std::vector<float> seq_y(len * DH), seq_hy(batch.L * DH), seq_cy(seq_hy.size());
+        if (len > 0) batch.Sequence(b, len).Forward(nullptr, &seq_y, &seq_hy, &seq_cy);
+        for (int t = 0; t < batch.T; ++t) {
+          for (int j = 0; j < DH; ++j) {
+            EXPECT_NEAR(t < len ? seq_y[t * DH + j] : 0.0f, y[(t * batch.N + b) * DH + j], 1e-5);
+          }
+        }
+        for (int s = 0; s < batch.L * batch.D; ++s) {
+          for (int j = 0; j < batch.H; ++j) {
+            const size_t i = (s * batch.N + b) * batch.H + j;
+            // an empty sequence keeps its initial states
+            EXPECT_NEAR(len ? seq_hy[s * batch.H + j] : batch.hx[i], hy[i], 1e-5);
+            if (mode == op::rnn_enum::kLstm) {
+              EXPECT_NEAR(len ? seq_cy[s * batch.H + j] : batch.cx[i], cy[i], 1e-5);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/*! \brief Performance of an LSTM over a bucket of uneven sequences, padded and by length */
+TEST(RNN, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 5;
+  const int N = 64, T = 100, H = 256;
+#else
+  const size_t COUNT = 2;
+  const int N = 8, T = 20, H = 16;
+#endif
+  RNNBatch batch(op::rnn_enum::kLstm, T, N, H, H, 2, false);
+  std::vector<float> lengths(N);
+  for (int b = 0; b < N; ++b) lengths[b] = T / 4 + (b * 37) % (3 * T / 4 + 1);
+  std::vector<float> y(T * N * H), hy(batch.hx.size()), cy(hy.size());
+  uint64_t padded = 0, packed = 0;
+  for (size_t i = 0; i < COUNT; ++i) {
+    uint64_t start = test::perf::getMicroTickCount();
+    batch.Forward(nullptr, &y, &hy, &cy);
+    padded += test::perf::getMicroTickCount() - start;
+    start = test::perf::getMicroTickCount();
+    batch.Forward(&lengths, &y, &hy, &cy);
+    packed += test::perf::getMicroTickCount() - start;
+  }
+  std::cout << std::endl << "LSTM forward of " << N << " sequences of up to " << T
+            << " steps" << std::endl
+            << std::setw(16) << "padded (ms)" << std::setw(16) << "by length (ms)"
+            << std::setw(10) << "speedup" << std::endl
+            << std::setw(16) << MICRO2MSF(padded) / COUNT
+            << std::setw(16) << MICRO2MSF(packed) / COUNT
+            << std::setw(10) << static_cast<float>(padded) / std::max(packed, uint64_t(1))
+            << std::endl;
+}
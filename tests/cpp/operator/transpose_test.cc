@@ -0,0 +1,114 @@
+/*!
+ * Copyright (c) 2017 by Contributors
+ * \file transpose_test.cc
+ * \brief correctness and performance of the blocked CPU transpose
+ */
+
+#include <gtest/gtest.h>
+#include <dmlc/logging.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../../src/operator/tensor/blocked_transpose.h"
+#include "test_perf.h"
+
+using namespace mxnet;
+
+namespace {
+/*! \brief element by element transpose with strided reads, as the mshadow expression does */
+template<typename DType>
+void NaiveTranspose(const DType *in, DType *out, const TShape& ishape, const TShape& axes) {
+  const int ndim = ishape.ndim();
+  std::vector<size_t> istrides(ndim, 1);
+  for (int i = ndim - 2; i >= 0; --i) istrides[i] = istrides[i + 1] * ishape[i + 1];
+  std::vector<size_t> coord(ndim, 0);
+  const size_t size = ishape.Size();
+  for (size_t k = 0; k < size; ++k) {
+    size_t offset = 0;
+    for (int i = 0; i < ndim; ++i) offset += coord[i] * istrides[axes[i]];
+    out[k] = in[offset];
+    for (int i = ndim - 1; i >= 0; --i) {
+      if (++coord[i] < ishape[axes[i]]) break;
+      coord[i] = 0;
+    }
+  }
+}
+
+TShape MakeShape(const std::vector<index_t>& dims) {
+  return TShape(dims.begin(), dims.end());
+}
+}  // namespace
+
+TEST(TRANSPOSE, BlockedMatchesReference) {
+  const std::vector<std::pair<std::vector<index_t>, std::vector<index_t> > > cases = {
+    {{7}, {0}}, {{33, 70}, {1, 0}}, {{1, 45, 1}, {2, 0, 1}},
+    {{4, 33, 70}, {0, 2, 1}}, {{2, 64, 31, 37}, {0, 2, 3, 1}},
+    {{2, 31, 37, 64}, {0, 3, 1, 2}}, {{3, 5, 7, 9, 11}, {4, 2, 0, 3, 1}},
+    {{2, 3, 4, 5, 6, 7}, {5, 4, 3, 2, 1, 0}}, {{6, 5, 4, 3}, {0, 1, 3, 2}},
+  };
+  for (const auto& c : cases) {
+    const TShape ishape = MakeShape(c.first), axes = MakeShape(c.second);
+    std::vector<float> in(ishape.Size()), expected(in.size()), out(in.size());
+    for (size_t i = 0; i < in.size(); ++i) in[i] = static_cast<float>(i);
+    NaiveTranspose(in.data(), expected.data(), ishape, axes);
+    op::TransposeCPU(in.data(), out.data(), ishape, axes);
+    EXPECT_EQ(expected, out);
+    std::vector<double> ind(in.begin(), in.end()), expectedd(in.size()), outd(in.size());
+    NaiveTranspose(ind.data(), expectedd.data(), ishape, axes);
+    op::TransposeCPU(ind.data(), outd.data(), ishape, axes);
+    EXPECT_EQ(expectedd, outd);
+  }
+}
+
+TEST(TRANSPOSE, StridedCopyConverts) {
+  // BGR interleaved image to RGB planes
+  const int rows = 37, cols = 45;
+  std::vector<uint8_t> image(rows * cols * 3);
+  for (size_t i = 0; i < image.size(); ++i) image[i] = static_cast<uint8_t>(i * 7);
+  TShape oshape = MakeShape({3, static_cast<index_t>(rows), static_cast<index_t>(cols)});
+  std::vector<float> out(image.size());
+  op::StridedCopyCPU(image.data() + 2, out.data(), oshape, {-1, cols * 3, 3});
+  for (int k = 0; k < 3; ++k) {
+    for (int p = 0; p < rows * cols; ++p) {
+      EXPECT_EQ(out[k * rows * cols + p], image[p * 3 + 2 - k]);
+    }
+  }
+}
+
+/*! \brief Performance tests of layout conversions */
+TEST(TRANSPOSE, TestTiming) {
+#ifdef NDEBUG
+  const size_t COUNT = 10;
+  const index_t batch = 32;
+#else
+  const size_t COUNT = 2;
+  const index_t batch = 2;
+#endif
+  const std::vector<std::pair<std::vector<index_t>, std::vector<index_t> > > cases = {
+    {{batch, 64, 56, 56}, {0, 2, 3, 1}},   // NCHW -> NHWC
+    {{batch, 56, 56, 64}, {0, 3, 1, 2}},   // NHWC -> NCHW
+    {{batch, 128, 8, 64}, {0, 2, 1, 3}},   // attention heads
+    {{batch, 8, 128, 64}, {0, 1, 3, 2}},   // keys transposed
+  };
+  std::cout << std::endl << std::setw(24) << "shape" << std::setw(16) << "naive (ms)"
+            << std::setw(16) << "blocked (ms)" << std::setw(12) << "speedup" << std::endl;
+  for (const auto& c : cases) {
+    const TShape ishape = MakeShape(c.first), axes = MakeShape(c.second);
+    std::vector<float> in(ishape.Size(), 1.0f), out(in.size());
+    uint64_t naive = 0, blocked = 0;
+    for (size_t i = 0; i < COUNT; ++i) {
+      uint64_t start = test::perf::getMicroTickCount();
+      NaiveTranspose(in.data(), out.data(), ishape, axes);
+      naive += test::perf::getMicroTickCount() - start;
+      start = test::perf::getMicroTickCount();
+      op::TransposeCPU(in.data(), out.data(), ishape, axes);
+      blocked += test::perf::getMicroTickCount() - start;
+    }
+    std::cout << std::setw(24) << ishape
+              << std::setw(16) << MICRO2MSF(naive) / COUNT
+              << std::setw(16) << MICRO2MSF(blocked) / COUNT
+              << std::setw(12) << static_cast<float>(naive) / std::max(blocked, uint64_t(1))
+              << std::endl;
+  }
+}
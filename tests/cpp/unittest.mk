@@ -35,6 +35,11 @@ build/tests/cpp/engine/%.o : tests/cpp/engine/%.cc
 	$(CXX) -std=c++0x $(TEST_CFLAGS) -MM -MT tests/cpp/engine/$* $< > build/tests/cpp/engine/$*.d
 	$(CXX) -c -std=c++0x $(TEST_CFLAGS) -I$(GTEST_INC) -o build/tests/cpp/engine/$*.o $(filter %.cc %.a, $^)
 
+build/tests/cpp/kvstore/%.o : tests/cpp/kvstore/%.cc
+	@mkdir -p $(@D)
+	$(CXX) -std=c++0x $(TEST_CFLAGS) -MM -MT tests/cpp/kvstore/$* $< > build/tests/cpp/kvstore/$*.d
+	$(CXX) -c -std=c++0x $(TEST_CFLAGS) -I$(GTEST_INC) -o build/tests/cpp/kvstore/$*.o $(filter %.cc %.a, $^)
+
 $(TEST): $(TEST_OBJ) lib/libmxnet.so
 	$(CXX) -std=c++0x $(TEST_CFLAGS) -I$(GTEST_INC) -o $@ $^ $(TEST_LDFLAGS) -L$(GTEST_LIB) -lgtest
 
@@ -47,4 +52,5 @@ testclean:
 -include build/tests/cpp/*.d
 -include build/tests/cpp/operator/*.d
 -include build/tests/cpp/storage/*.d
--include build/tests/cpp/engine/*.d
\ No newline at end of file
+-include build/tests/cpp/engine/*.d
+-include build/tests/cpp/kvstore/*.d
@@ -0,0 +1,50 @@
+#!/usr/bin/env python
+# pylint: skip-file
+# run with: ../../tools/launch.py -n 4 python dist_ssp_kvstore.py
+import os
+import sys
+sys.path.insert(0, "../../python/")
+import mxnet as mx
+import numpy as np
+import time
+
+staleness = 2
+os.environ['MXNET_KVSTORE_SSP_STALENESS'] = str(staleness)
+
+# setup
+key = 3
+rate = 2
+shape = (2, 2)
+nrepeat = 8
+delay = 0.5
+
+kv = mx.kv.create('dist_ssp')
+
+# init kv
+kv.init(key, mx.nd.ones(shape))
+# init updater on servers
+kv.set_optimizer(mx.optimizer.create('test', rate))
+
+my_rank = kv.rank
+nworker = kv.num_workers
+
+def test_ssp_push_pull():
+    slow = my_rank == nworker - 1
+    start = time.time()
+    val = mx.nd.zeros(shape)
+    for i in range(1, nrepeat + 1):
+        if slow:
+            time.sleep(delay)
+        kv.push(key, mx.nd.ones(shape))
+        kv.pull(key, out=val)
+        v = val.asnumpy()
+        assert np.all(v == v.flat[0]), v
+        # every worker has pushed at least i - staleness times
+        assert v.flat[0] >= 1 + rate * nworker * max(0, i - staleness), (my_rank, i, v)
+        assert v.flat[0] <= 1 + rate * nworker * nrepeat, (my_rank, i, v)
+    elapsed = time.time() - start
+    # the fast workers cannot finish more than staleness pushes before the slow one
+    assert elapsed >= (nrepeat - staleness - 1) * delay, (my_rank, elapsed)
+
+if __name__ == "__main__":
+    test_ssp_push_pull()
@@ -0,0 +1,55 @@
+#!/usr/bin/env python
+# run with: python shm_kvstore.py
+# starts the processes of a local_shm kvstore and checks that they stay in sync
+import os
+import subprocess
+import sys
+sys.path.insert(0, "../../python/")
+import mxnet as mx
+import numpy as np
+
+keys = [3, 5, 7]
+# let the last shape exceed MXNET_KVSTORE_SHM_SLOT_SIZE
+shapes = [(4, 4), (100, 100), (1000, 1100)]
+nproc = 4
+nrepeat = 3
+rate = 2
+
+def check_diff_to_scalar(A, x, rank=None):
+    """ assert A == x"""
+    assert(np.sum(np.abs((A - x).asnumpy())) == 0), (rank, A.asnumpy(), x)
+
+def run_worker():
+    kv = mx.kv.create('local_shm')
+    rank = kv.rank
+    nworker = kv.num_workers
+    assert nworker == nproc
+    # only the values of rank 0 are used
+    kv.init(keys, [mx.nd.ones(s) * (rank + 1) for s in shapes])
+    for k, s in zip(keys, shapes):
+        val = mx.nd.empty(s)
+        kv.pull(k, out=val)
+        check_diff_to_scalar(val, 1, rank)
+
+    kv._set_updater(lambda key, recv, stored: stored.__iadd__(recv * rate))
+    for _ in range(nrepeat):
+        kv.push(keys, [mx.nd.ones(s) * (rank + 1) for s in shapes])
+    num = (nworker + 1) * nworker / 2 * rate * nrepeat + 1
+    for k, s in zip(keys, shapes):
+        val = mx.nd.empty(s)
+        kv.pull(k, out=val)
+        check_diff_to_scalar(val, num, rank)
+    kv._barrier()
+    print('worker %d of %d is done' % (rank, nworker))
+
+if __name__ == "__main__":
+    if 'MXNET_KVSTORE_SHM_RANK' in os.environ:
+        run_worker()
+    else:
+        procs = []
+        for rank in range(nproc):
+            env = dict(os.environ, MXNET_KVSTORE_SHM_RANK=str(rank),
+                       MXNET_KVSTORE_SHM_NUM_PROCS=str(nproc),
+                       MXNET_KVSTORE_SHM_NAME='/mxnet_shm_kvstore_test')
+            procs.append(subprocess.Popen([sys.executable, __file__], env=env))
+        assert all(p.wait() == 0 for p in procs)
@@ -40,6 +40,7 @@ def test_kvstore(kv_type):
 test_kvstore('local_update_cpu')
 test_kvstore('local_allreduce_cpu')
 test_kvstore('local_allreduce_device')
+test_kvstore('local_allreduce_ring')
 
 ## group keys interface
 def test_group_kvstore(kv_type):
@@ -64,3 +65,4 @@ def test_group_kvstore(kv_type):
 test_group_kvstore('local_update_cpu')
 test_group_kvstore('local_allreduce_cpu')
 test_group_kvstore('local_allreduce_device')
+test_group_kvstore('local_allreduce_ring')
@@ -136,7 +136,191 @@ def test_reshape():
     exe.forward(is_train=False)
     assert np.all(exe.outputs[0].asnumpy() == 4)
 
+def test_static_schedule():
+    def run(static_schedule):
+        prev = mx.test_utils.set_env_var("MXNET_EXEC_STATIC_SCHEDULE", static_schedule, "0")
+        data = mx.sym.Variable('data')
+        fc1 = mx.sym.FullyConnected(data, num_hidden=8, name='fc1')
+        fc2 = mx.sym.FullyConnected(data, num_hidden=8, name='fc2')
+        act = mx.sym.Activation(fc1, act_type='tanh') * mx.sym.Activation(fc2, act_type='sigmoid')
+        out = mx.sym.sum(act + fc1, axis=1)
+        exe = out.simple_bind(mx.cpu(), data=(6, 5))
+        np.random.seed(1)
+        for arr in exe.arg_arrays:
+            arr[:] = np.random.uniform(-1, 1, arr.shape)
+        results = []
+        for _ in range(3):
+            exe.forward(is_train=True)
+            exe.backward([mx.nd.ones((6,))])
+            results.append([exe.outputs[0].asnumpy()] + [g.asnumpy() for g in exe.grad_arrays])
+        mx.test_utils.set_env_var("MXNET_EXEC_STATIC_SCHEDULE", prev)
+        return results
+
+    expected = run("0")
+    actual = run("1")
+    for exp_iter, act_iter in zip(expected, actual):
+        for e, a in zip(exp_iter, act_iter):
+            assert reldiff(e, a) < 1e-6
+
+def test_monitor_stats():
+    data = mx.sym.Variable('data')
+    fc = mx.sym.FullyConnected(data, num_hidden=4, name='fc')
+    out = mx.sym.Activation(fc, act_type='relu', name='relu')
+    exe = out.simple_bind(mx.cpu(), data=(3, 5), grad_req='null')
+    for arr in exe.arg_arrays:
+        arr[:] = np.random.uniform(-1, 1, arr.shape)
+    exe.set_monitor_stats(['norm', 'mean', 'min', 'max', 'nan'], interval=2)
+    for i in range(3):
+        exe.arg_dict['data'][:] = np.random.uniform(-1, 1, (3, 5))
+        exe.forward(is_train=False)
+        names, values = exe.get_monitor_stats()
+        values = values.asnumpy()
+        if i == 1:
+            # not sampled, statistics of the previous iteration are kept
+            assert np.allclose(values, expected)
+            continue
+        expected = values
+        assert names == ['fc_output', 'relu_output']
+        for name, row in zip(names, values):
+            if name == 'fc_output':
+                ref = exe.arg_dict['data'].asnumpy().dot(exe.arg_dict['fc_weight'].asnumpy().T) \
+                    + exe.arg_dict['fc_bias'].asnumpy()
+            else:
+                ref = exe.outputs[0].asnumpy()
+            assert np.allclose(row, [np.linalg.norm(ref), ref.mean(), ref.min(), ref.max(), 0],
+                               rtol=1e-4, atol=1e-5)
+    # switched off, the forward passes are not sampled
+    exe.enable_monitor_stats(False)
+    for i in range(2):
+        exe.arg_dict['data'][:] = np.random.uniform(-1, 1, (3, 5))
+        exe.forward(is_train=False)
+        assert np.allclose(exe.get_monitor_stats()[1].asnumpy(), expected)
+    exe.enable_monitor_stats(True)
+    exe.forward(is_train=False)
+    assert not np.allclose(exe.get_monitor_stats()[1].asnumpy(), expected)
+
+def test_monitor_stats_interval():
+    data = mx.sym.Variable('data')
+    out = mx.sym.Activation(data, act_type='relu', name='relu')
+    exe = out.simple_bind(mx.cpu(), data=(2, 3), grad_req='null')
+    mon = mx.mon.Monitor(2, stats=['max'])
+    mon.install(exe)
+    for step in range(4):
+        mon.tic()
+        exe.arg_dict['data'][:] = step + 1
+        exe.forward(is_train=False)
+        res = mon.toc()
+        if step % 2:
+            assert res == []
+        else:
+            assert ('relu_output', 'max=%s' % float(step + 1)) in [r[1:] for r in res]
+        # evaluation forwards between the batches are not sampled
+        exe.arg_dict['data'][:] = 100
+        exe.forward(is_train=False)
+
+def test_backward_checkpoint():
+    def run(checkpoint):
+        prev = mx.test_utils.set_env_var("MXNET_BACKWARD_CHECKPOINT", checkpoint, "0")
+        net = mx.sym.Variable('data')
+        for i in range(6):
+            net = mx.sym.FullyConnected(net, num_hidden=8, name='fc%d' % i)
+            net = mx.sym.Activation(net, act_type='tanh', name='act%d' % i)
+        out = mx.sym.sum(net, axis=1)
+        exe = out.simple_bind(mx.cpu(), data=(4, 5))
+        np.random.seed(2)
+        for arr in exe.arg_arrays:
+            arr[:] = np.random.uniform(-1, 1, arr.shape)
+        exe.forward(is_train=True)
+        exe.backward([mx.nd.ones((4,))])
+        debug_str = exe.debug_str()
+        mx.test_utils.set_env_var("MXNET_BACKWARD_CHECKPOINT", prev)
+        return [g.asnumpy() for g in exe.grad_arrays], debug_str
+
+    expected, _ = run("0")
+    actual, debug_str = run("1")
+    assert '_mirror' in debug_str
+    for e, a in zip(expected, actual):
+        assert reldiff(e, a) < 1e-6
+
+def test_backward_compress_activation():
+    def run(compress):
+        prev = mx.test_utils.set_env_var("MXNET_BACKWARD_COMPRESS_ACTIVATION", compress, "0")
+        net = mx.sym.Variable('data')
+        for i in range(3):
+            net = mx.sym.FullyConnected(net, num_hidden=16, name='fc%d' % i)
+            net = mx.sym.Activation(net, act_type='tanh', name='act%d' % i)
+        out = mx.sym.sum(net * net, axis=1)
+        exe = out.simple_bind(mx.cpu(), data=(8, 10))
+        np.random.seed(3)
+        for arr in exe.arg_arrays:
+            arr[:] = np.random.uniform(-1, 1, arr.shape)
+        exe.forward(is_train=True)
+        exe.backward([mx.nd.ones((8,))])
+        debug_str = exe.debug_str()
+        mx.test_utils.set_env_var("MXNET_BACKWARD_COMPRESS_ACTIVATION", prev)
+        return [exe.outputs[0].asnumpy()] + [g.asnumpy() for g in exe.grad_arrays], debug_str
+
+    expected, _ = run("0")
+    for compress, tol in [("1", 1e-2), ("2", 5e-2)]:
+        actual, debug_str = run(compress)
+        assert '_stash_decode' in debug_str
+        # forward is computed in full precision
+        assert reldiff(expected[0], actual[0]) < 1e-6
+        for e, a in zip(expected[1:], actual[1:]):
+            assert reldiff(e, a) < tol
+
+def test_backward_compress_activation_dtype():
+    # the decoded activations keep the type of the original ones
+    prev = mx.test_utils.set_env_var("MXNET_BACKWARD_COMPRESS_ACTIVATION", "1", "0")
+    data = mx.sym.Variable('data')
+    net = mx.sym.Activation(data, act_type='tanh', name='act0')
+    net = mx.sym.Activation(net, act_type='sigmoid', name='act1')
+    out = mx.sym.sum(net * net, axis=1)
+    for dtype in [np.float64, np.float32]:
+        exe = out.simple_bind(mx.cpu(), data=(4, 6), type_dict={'data': dtype})
+        exe.arg_arrays[0][:] = np.random.uniform(-1, 1, (4, 6))
+        exe.forward(is_train=True)
+        exe.backward([mx.nd.ones((4,), dtype=dtype)])
+        assert '_stash_decode' in exe.debug_str()
+        assert exe.grad_arrays[0].dtype == dtype
+        assert np.all(np.isfinite(exe.grad_arrays[0].asnumpy()))
+    mx.test_utils.set_env_var("MXNET_BACKWARD_COMPRESS_ACTIVATION", prev)
+
+def test_cpu_float16():
+    def run(cpu_float16):
+        prev = mx.test_utils.set_env_var("MXNET_EXEC_CPU_FLOAT16", cpu_float16, "0")
+        net = mx.sym.Variable('data')
+        net = mx.sym.Convolution(net, kernel=(3, 3), num_filter=4, name='conv')
+        net = mx.sym.Activation(net, act_type='relu')
+        net = mx.sym.Pooling(net, kernel=(2, 2), stride=(2, 2), pool_type='max')
+        net = mx.sym.FullyConnected(mx.sym.Flatten(net), num_hidden=10, name='fc')
+        net = mx.sym.softmax(net + mx.sym.sigmoid(net))
+        exe = net.simple_bind(mx.cpu(), data=(2, 3, 8, 8), type_dict={'data': np.float32},
+                              grad_req='null')
+        mx.test_utils.set_env_var("MXNET_EXEC_CPU_FLOAT16", prev)
+        np.random.seed(5)
+        for name in net.list_arguments():
+            # float32 parameters are converted on copy
+            exe.arg_dict[name][:] = mx.nd.array(np.random.uniform(-1, 1, exe.arg_dict[name].shape))
+        exe.forward(is_train=False)
+        return exe
+
+    expected = run("0")
+    actual = run("1")
+    assert actual.arg_dict['data'].dtype == np.float32
+    assert actual.arg_dict['fc_weight'].dtype == np.float16
+    assert actual.arg_dict['conv_weight'].dtype == np.float16
+    assert actual.outputs[0].dtype == np.float32
+    assert reldiff(expected.outputs[0].asnumpy(), actual.outputs[0].asnumpy()) < 1e-2
+
 if __name__ == "__main__":
     test_bind(disable_bulk_exec=False)
     test_bind(disable_bulk_exec=True)
     test_reshape()
+    test_static_schedule()
+    test_monitor_stats()
+    test_monitor_stats_interval()
+    test_backward_checkpoint()
+    test_backward_compress_activation()
+    test_backward_compress_activation_dtype()
+    test_cpu_float16()
@@ -1,4 +1,5 @@
 # pylint: skip-file
+import os
 import mxnet as mx
 import numpy as np
 
@@ -93,6 +94,97 @@ def test_aggregator():
     check_aggregator(init_kv_with_str(), 'a', str_keys)
 
 
+def test_ring_aggregator():
+    """reduce and broadcast over a ring of cpu contexts"""
+    big_shape = (7, 5)
+    def init_ring_kv():
+        # reduce all arrays but the ones of shape over the ring
+        os.environ['MXNET_KVSTORE_BIGARRAY_BOUND'] = '20'
+        try:
+            kv = mx.kv.create('local_allreduce_ring')
+        finally:
+            del os.environ['MXNET_KVSTORE_BIGARRAY_BOUND']
+        kv.init([3, 5], [mx.nd.zeros(shape), mx.nd.ones(big_shape)])
+        return kv
+
+    kv = init_ring_kv()
+    for num_devs in [3, 4]:
+        devs = [mx.Context('cpu', i) for i in range(num_devs)]
+        out = [mx.nd.empty(big_shape, d) for d in devs]
+        kv.pull(5, out=out)
+        for v in out:
+            check_diff_to_scalar(v, 1)
+
+    devs = [mx.Context('cpu', i) for i in range(3)]
+    vals = [mx.nd.array(np.random.uniform(size=big_shape), d) for d in devs]
+    expected = sum(v.asnumpy() for v in vals)
+    out = [mx.nd.empty(big_shape, d) for d in devs]
+    kv.push(5, vals)
+    kv.pull(5, out=out)
+    for v in out:
+        assert np.allclose(v.asnumpy(), expected)
+
+    kv = init_ring_kv()
+    kv._set_updater(updater)
+    for _ in range(2):
+        kv.push(5, vals)
+        kv.push(3, [mx.nd.ones(shape, d) for d in devs])
+    kv.pull(5, out=out)
+    for v in out:
+        assert np.allclose(v.asnumpy(), 1 + expected * 2)
+    val = mx.nd.empty(shape)
+    kv.pull(3, out=val)
+    check_diff_to_scalar(val, 6)
+
+def test_fusion():
+    """push and pull small keys in buckets"""
+    shapes = [(3,), (2, 5), (4,), (100, 100), (7,), (1, 3)]
+    fused_keys = list(range(len(shapes)))
+    for kv_type in ['local', 'device']:
+        os.environ['MXNET_KVSTORE_FUSION_BUCKET_SIZE'] = '16'
+        try:
+            kv = mx.kv.create(kv_type)
+        finally:
+            del os.environ['MXNET_KVSTORE_FUSION_BUCKET_SIZE']
+        # init one by one, as the training loops do
+        for k, s in zip(fused_keys, shapes):
+            kv.init(k, mx.nd.ones(s) * k)
+        devs = [mx.Context('cpu', i) for i in range(3)]
+        out = [[mx.nd.empty(s, d) for d in devs] for s in shapes]
+        kv.pull(fused_keys, out=out)
+        for k, vv in zip(fused_keys, out):
+            for v in vv:
+                check_diff_to_scalar(v, k)
+
+        vals = [[mx.nd.array(np.random.uniform(size=s), d) for d in devs] for s in shapes]
+        expected = [sum(v.asnumpy() for v in vv) for vv in vals]
+        kv.push(fused_keys, vals)
+        kv.pull(fused_keys, out=out)
+        for e, vv in zip(expected, out):
+            for v in vv:
+                assert np.allclose(v.asnumpy(), e)
+
+        kv._set_updater(updater)
+        kv.push(fused_keys, vals)
+        # buckets of 16 elements: keys 0 and 1, then 2, 4 and 5. the first bucket is
+        # pushed fused, the part of the second not
+        kv.push(fused_keys[:3], vals[:3])
+        kv.pull(fused_keys, out=out)
+        for k, e, vv in zip(fused_keys, expected, out):
+            for v in vv:
+                assert np.allclose(v.asnumpy(), e * (3 if k < 3 else 2))
+
+    # the training loops group the parameters as the buckets
+    os.environ['MXNET_KVSTORE_FUSION_BUCKET_SIZE'] = '16'
+    try:
+        args = [[mx.nd.zeros(s)] for s in shapes]
+        grads = [[mx.nd.zeros(s)] for s in shapes]
+        assert mx.model._fusion_groups(args, grads) == [[0, 1], [2, 4, 5], [3]]
+        grads[4] = [None]
+        assert mx.model._fusion_groups(args, grads) == [[0, 1], [2, 5], [3]]
+    finally:
+        del os.environ['MXNET_KVSTORE_FUSION_BUCKET_SIZE']
+
 def updater(key, recv, local):
     """use updater: +="""
     local += recv
@@ -136,6 +228,39 @@ def test_updater(dev = 'cpu'):
     check_updater(str_kv, 'a', str_keys)
 
 
+def test_native_optimizer():
+    """native optimizers update as the python ones do"""
+    def check_native_optimizer(name, py_opt, **kwargs):
+        np.random.seed(0)
+        weight = mx.nd.array(np.random.uniform(-1, 1, shape))
+        grads = [mx.nd.array(np.random.uniform(-1, 1, shape)) for _ in range(3)]
+        kv_py = mx.kv.create()
+        kv_py.init(3, weight)
+        kv_py.set_optimizer(py_opt)
+        kv_native = mx.kv.create()
+        kv_native.init(3, weight)
+        kv_native.set_optimizer(name, **kwargs)
+        for g in grads:
+            kv_py.push(3, g)
+            kv_native.push(3, g)
+        expected = mx.nd.empty(shape)
+        actual = mx.nd.empty(shape)
+        kv_py.pull(3, out=expected)
+        kv_native.pull(3, out=actual)
+        assert np.allclose(expected.asnumpy(), actual.asnumpy(), rtol=1e-5, atol=1e-6)
+
+    check_native_optimizer('sgd', mx.optimizer.SGD(learning_rate=0.1, wd=0.01),
+                           learning_rate=0.1, wd=0.01)
+    check_native_optimizer('sgd', mx.optimizer.SGD(learning_rate=0.1, momentum=0.9),
+                           learning_rate=0.1, momentum=0.9)
+    check_native_optimizer('adam', mx.optimizer.Adam(learning_rate=0.01, clip_gradient=0.5),
+                           learning_rate=0.01, clip_gradient=0.5)
+    check_native_optimizer('rmsprop', mx.optimizer.RMSProp(learning_rate=0.01),
+                           learning_rate=0.01)
+    check_native_optimizer('rmsprop', mx.optimizer.RMSProp(learning_rate=0.01, centered=True),
+                           learning_rate=0.01, centered=True)
+
+
 def test_get_type():
     kvtype = 'local_allreduce_cpu'
     kv = mx.kv.create(kvtype)
@@ -147,4 +272,7 @@ if __name__ == '__main__':
     test_single_kv_pair()
     test_list_kv_pair()
     test_aggregator()
+    test_ring_aggregator()
+    test_fusion()
     test_updater()
+    test_native_optimizer()
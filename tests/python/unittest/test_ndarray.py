@@ -1,4 +1,6 @@
 import os
+import subprocess
+import sys
 import mxnet as mx
 import numpy as np
 import pickle as pkl
@@ -230,6 +232,28 @@ def test_ndarray_saveload():
             assert np.sum(x.asnumpy() != y.asnumpy()) == 0
     os.remove(fname)
 
+def test_ndarray_bfloat16():
+    np.random.seed(0)
+    a = np.random.uniform(-100, 100, (7, 13)).astype(np.float32)
+    b = mx.nd.array(a, dtype='bfloat16')
+    assert b.dtype == mx.nd.bfloat16
+    rounded = b.astype(np.float32).asnumpy()
+    assert_almost_equal(rounded, a, rtol=2.0 ** -8, atol=0)
+    # asnumpy gives the upper 16 bits of the float32 values
+    assert same(b.asnumpy()['bfloat16'], (rounded.view(np.uint32) >> 16).astype(np.uint16))
+    assert same(mx.nd.Cast(mx.nd.array(a), dtype='bfloat16').asnumpy(), b.asnumpy())
+    assert same(mx.nd.array(rounded).astype('bfloat16').asnumpy(), b.asnumpy())
+    fname = 'tmp_bfloat16.bin'
+    mx.nd.save(fname, [b])
+    c = mx.nd.load(fname)[0]
+    os.remove(fname)
+    assert c.dtype == mx.nd.bfloat16
+    assert same(c.asnumpy(), b.asnumpy())
+    c[:] = 2.5
+    assert same(c.astype(np.float32).asnumpy(), np.full(a.shape, 2.5, np.float32))
+    assert same(mx.nd.ones((3, 4), dtype='bfloat16').astype(np.float32).asnumpy(),
+                np.ones((3, 4), np.float32))
+
 def test_ndarray_legacy_load():
     data = []
     for i in range(6):
@@ -240,6 +264,43 @@ def test_ndarray_legacy_load():
     for i in range(len(data)):
         assert same(data[i].asnumpy(), legacy_data[i].asnumpy())
 
+def test_ndarray_saveload_formats():
+    def save(fname, data, fmt, compress='0'):
+        prev_fmt = set_env_var('MXNET_NDARRAY_SAVE_FORMAT', fmt, '1')
+        prev_compress = set_env_var('MXNET_NDARRAY_SAVE_COMPRESS', compress, '0')
+        mx.nd.save(fname, data)
+        set_env_var('MXNET_NDARRAY_SAVE_FORMAT', prev_fmt)
+        set_env_var('MXNET_NDARRAY_SAVE_COMPRESS', prev_compress)
+
+    fname = 'tmp_formats.bin'
+    data = {'a': mx.nd.array(np.random.uniform(-1, 1, (5, 7))),
+            'b': mx.nd.array(np.arange(12).reshape((3, 4)), dtype=np.int32),
+            'c': mx.nd.zeros((1000, 30)),
+            # larger than a piece read by one thread
+            'd': mx.nd.array(np.random.uniform(-1, 1, (3, 2000000)))}
+    for fmt, compress in [('1', '0'), ('2', '0'), ('2', '1')]:
+        save(fname, data, fmt, compress)
+        loaded = mx.nd.load(fname)
+        assert sorted(loaded.keys()) == sorted(data.keys())
+        for k, x in data.items():
+            assert loaded[k].dtype == x.dtype
+            assert same(loaded[k].asnumpy(), x.asnumpy())
+        subset = mx.nd.load(fname, names=['d', 'b'])
+        assert sorted(subset.keys()) == ['b', 'd']
+        assert same(subset['d'].asnumpy(), data['d'].asnumpy())
+        assert same(subset['b'].asnumpy(), data['b'].asnumpy())
+    # the zero array is stored compressed
+    size = os.path.getsize(fname)
+    save(fname, data, '2')
+    assert size < os.path.getsize(fname)
+    # lists and empty lists
+    for fmt in ['1', '2']:
+        save(fname, [data['a'], data['b']], fmt)
+        assert len(mx.nd.load(fname)) == 2
+        save(fname, [], fmt)
+        assert len(mx.nd.load(fname)) == 0
+    os.remove(fname)
+
 def test_ndarray_slice():
     shape = (10,)
     A = mx.nd.array(np.random.uniform(-10, 10, shape))
@@ -662,6 +723,99 @@ def test_output():
     assert_almost_equal(out.asnumpy(), ones.asnumpy() * 2)
 
 
+def test_ndarray_async_copy():
+    import ctypes
+    from mxnet.base import _LIB, check_call, c_array, NDArrayHandle
+    shapes = [(3, 4), (7,), (2, 2, 5)]
+    arrays = [mx.nd.zeros(s) for s in shapes]
+    srcs = [np.random.uniform(-1, 1, s).astype(np.float32) for s in shapes]
+    handles = c_array(NDArrayHandle, [a.handle for a in arrays])
+    sizes = c_array(ctypes.c_size_t, [a.size for a in srcs])
+    copy = ctypes.c_void_p()
+    check_call(_LIB.MXNDArrayAsyncCopyFromCPU(
+        len(arrays), handles, c_array(ctypes.c_void_p, [a.ctypes.data for a in srcs]),
+        sizes, ctypes.byref(copy)))
+    check_call(_LIB.MXNDArrayWaitCopy(copy))
+    # the copy is ordered before later operations on the arrays
+    for a in arrays:
+        a += 1
+    dsts = [np.empty(s, dtype=np.float32) for s in shapes]
+    check_call(_LIB.MXNDArrayAsyncCopyToCPU(
+        len(arrays), handles, c_array(ctypes.c_void_p, [a.ctypes.data for a in dsts]),
+        sizes, ctypes.byref(copy)))
+    check_call(_LIB.MXNDArrayWaitCopy(copy))
+    for src, dst in zip(srcs, dsts):
+        assert same(src + 1, dst)
+
+
+def test_ndarray_shared_mem():
+    shape = (4, 5)
+    a = mx.nd.zeros(shape, ctx=mx.Context('cpu_shared', 0))
+    assert a.context.device_type == 'cpu_shared'
+    a[:] = np.arange(20).reshape(shape)
+    a.wait_to_read()
+    shared_pid, shared_id, s, dtype = a._to_shared_mem()
+    b = mx.nd.NDArray(mx.nd._new_from_shared_mem(shared_pid, shared_id, s, dtype))
+    assert b.context.device_type == 'cpu_shared'
+    assert same(a.asnumpy(), b.asnumpy())
+    # both arrays map the same memory
+    b[:] = 7
+    b.wait_to_read()
+    assert same(a.asnumpy(), np.full(shape, 7, dtype=np.float32))
+    # the memory stays valid after the creator is freed
+    del a
+    assert same(b.asnumpy(), np.full(shape, 7, dtype=np.float32))
+    c = mx.nd.ones(shape, ctx=mx.Context('cpu_shared', 0)) + b
+    assert same(c.asnumpy(), np.full(shape, 8, dtype=np.float32))
+
+
+def test_ndarray_dlpack():
+    x = mx.nd.array(np.random.uniform(-1, 1, (3, 4)))
+    y = mx.nd.from_dlpack(x.to_dlpack_for_read())
+    assert y.shape == x.shape and y.dtype == x.dtype
+    assert same(x.asnumpy(), y.asnumpy())
+    # no copy: writes through one array are seen by the other
+    z = mx.nd.from_dlpack(x.to_dlpack_for_write())
+    z[:] = 3
+    # z has its own engine variable, reads of x and y are not ordered after its writes
+    z.wait_to_read()
+    assert same(x.asnumpy(), np.full((3, 4), 3, dtype=np.float32))
+    # a slice is exported with its offset
+    s = mx.nd.from_dlpack(x[1:3].to_dlpack_for_read())
+    assert same(s.asnumpy(), x[1:3].asnumpy())
+    # the memory is kept alive by the imported array
+    del x
+    z.wait_to_read()
+    assert same(y.asnumpy(), np.full((3, 4), 3, dtype=np.float32))
+    # a capsule can only be consumed once, an unconsumed one is released
+    pack = y.to_dlpack_for_read()
+    mx.nd.from_dlpack(pack)
+    try:
+        mx.nd.from_dlpack(pack)
+        assert False
+    except ValueError:
+        pass
+    del pack
+    pack = mx.nd.ones((2,), dtype=np.int32).to_dlpack_for_read()
+    del pack
+
+
+def test_ndarray_shared_mem_multiprocess():
+    shape = (3, 7)
+    a = mx.nd.array(np.arange(21).reshape(shape), ctx=mx.Context('cpu_shared', 0))
+    a.wait_to_read()
+    # another process attaches to the exported handle, reads and writes the array
+    script = ("import mxnet as mx\n"
+              "import numpy as np\n"
+              "b = mx.nd.NDArray(mx.nd._new_from_shared_mem(*%r))\n"
+              "assert (b.asnumpy() == np.arange(21).reshape(%r)).all(), b.asnumpy()\n"
+              "b[:] = b + 1\n"
+              "b.wait_to_read()\n" % (a._to_shared_mem()[:3] + ('float32',), shape))
+    env = dict(os.environ, PYTHONPATH=os.pathsep.join(sys.path))
+    subprocess.check_call([sys.executable, '-c', script], env=env)
+    assert same(a.asnumpy(), np.arange(1, 22, dtype=np.float32).reshape(shape))
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
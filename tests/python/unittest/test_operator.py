@@ -2,7 +2,10 @@
 from __future__ import print_function
 import numpy as np
 import mxnet as mx
+import os
 import random
+import subprocess
+import sys
 import itertools
 from numpy.testing import assert_allclose, assert_array_equal
 from mxnet.test_utils import *
@@ -1436,6 +1439,21 @@ def test_transpose():
             y = mx.nd.transpose(x)
             assert_allclose(np.transpose(x.asnumpy()), y.asnumpy())
 
+def test_transpose_blocked():
+    # shapes crossing the tile borders and the parallel threshold
+    for dims, axes in [((4, 33, 70), (0, 2, 1)), ((2, 64, 31, 37), (0, 2, 3, 1)),
+                       ((2, 31, 37, 64), (0, 3, 1, 2)), ((130, 1, 260), (2, 1, 0)),
+                       ((3, 5, 7, 9, 11), (4, 2, 0, 3, 1))]:
+        for dtype in [np.float32, np.float64, np.float16, np.int32, np.uint8]:
+            x = np.random.randint(0, 100, size=dims).astype(dtype)
+            y = mx.nd.transpose(mx.nd.array(x, dtype=dtype), axes=axes)
+            assert y.dtype == dtype
+            assert same(np.transpose(x, axes=axes), y.asnumpy())
+    for dim1, dim2 in [(0, 3), (1, 2), (3, 1)]:
+        x = np.random.normal(size=(3, 40, 50, 6)).astype(np.float32)
+        y = mx.nd.SwapAxis(mx.nd.array(x), dim1=dim1, dim2=dim2)
+        assert same(np.swapaxes(x, dim1, dim2), y.asnumpy())
+
 
 def test_expand_dims():
     for ndim in range(1, 6):
@@ -1688,6 +1706,49 @@ def test_batch_dot():
                             assert_almost_equal(exe_add.grad_dict['b'].asnumpy(),
                                 bgrad_npy + b_init_grad_npy, rtol=1e-3, atol=1e-4)
 
+def test_batch_dot_autotune_float16():
+    # tuning times the kernels against BLAS, which float16 does not have on cpu
+    script = ("import mxnet as mx\n"
+              "a = mx.nd.ones((4, 5, 7), dtype='float16')\n"
+              "b = mx.nd.ones((4, 7, 3), dtype='float16')\n"
+              "c = mx.nd.batch_dot(a, b).asnumpy()\n"
+              "assert (c == 7).all(), c\n")
+    env = dict(os.environ, MXNET_CPU_AUTOTUNE='1', MXNET_AUTOTUNE_FILE='',
+               PYTHONPATH=os.pathsep.join(sys.path))
+    subprocess.check_call([sys.executable, '-c', script], env=env)
+
+def test_batch_dot_blocked():
+    # unrolled sizes, packed panels with partial blocks, a single small product,
+    # and products large enough to be left to BLAS
+    sizes = [(5, 2, 2, 2), (7, 3, 3, 3), (3, 4, 4, 4), (9, 8, 8, 8), (4, 5, 7, 3),
+             (3, 33, 20, 11), (1, 6, 9, 5), (2, 70, 70, 70)]
+    for dtype in ['float32', 'float64']:
+        for batch, m, n, k in sizes:
+            for transpose_a in [False, True]:
+                for transpose_b in [False, True]:
+                    a = np.random.uniform(-1, 1, (batch, m, k)).astype(dtype)
+                    b = np.random.uniform(-1, 1, (batch, k, n)).astype(dtype)
+                    ograd = np.random.uniform(-1, 1, (batch, m, n)).astype(dtype)
+                    c = np.matmul(a, b)
+                    agrad = np.matmul(ograd, b.transpose(0, 2, 1))
+                    bgrad = np.matmul(a.transpose(0, 2, 1), ograd)
+                    if transpose_a:
+                        a, agrad = a.transpose(0, 2, 1), agrad.transpose(0, 2, 1)
+                    if transpose_b:
+                        b, bgrad = b.transpose(0, 2, 1), bgrad.transpose(0, 2, 1)
+                    location = {'a': a, 'b': b}
+                    dot = mx.sym.batch_dot(mx.sym.Variable('a'), mx.sym.Variable('b'),
+                                           transpose_a=transpose_a, transpose_b=transpose_b)
+                    check_symbolic_forward(dot, location, [c], rtol=1e-3, atol=1e-4)
+                    check_symbolic_backward(dot, location, [ograd], [agrad, bgrad],
+                                            rtol=1e-3, atol=1e-4)
+                    gemm2 = mx.sym.linalg_gemm2(mx.sym.Variable('a'), mx.sym.Variable('b'),
+                                                transpose_a=transpose_a,
+                                                transpose_b=transpose_b, alpha=2.0)
+                    check_symbolic_forward(gemm2, location, [2 * c], rtol=1e-3, atol=1e-4)
+                    check_symbolic_backward(gemm2, location, [ograd], [2 * agrad, 2 * bgrad],
+                                            rtol=1e-3, atol=1e-4)
+
 def get_correlation(data1,data2,kernel_size,max_displacement,stride1,stride2,pad_size,is_multiply):
 
     img1 = mx.sym.Variable('img1')
@@ -1983,6 +2044,50 @@ def test_instance_normalization():
     check_instance_norm_with_shape((2,4,5,6), default_context())
     check_instance_norm_with_shape((3,3,2,3,2,1,1), default_context())
 
+def np_group_norm(data, gamma, beta, num_groups, eps):
+    s = data.shape
+    grouped = data.reshape((s[0], num_groups, -1))
+    mean = grouped.mean(axis=2, keepdims=True)
+    var = grouped.var(axis=2, keepdims=True)
+    out = ((grouped - mean) / np.sqrt(var + eps)).reshape(s)
+    bshape = (1, s[1]) + (1,) * (data.ndim - 2)
+    return out * gamma.reshape(bshape) + beta.reshape(bshape)
+
+def test_layer_norm():
+    # LayerNorm and GroupNorm are only implemented on CPU
+    eps = 1e-3
+    for shape, axis in [((2, 10), -1), ((3, 4, 5), -1), ((3, 4, 5), 1), ((2, 3, 4, 5), 0),
+                        ((4, 600), -1)]:
+        data = mx.symbol.Variable('data')
+        out = mx.symbol.LayerNorm(data=data, axis=axis, eps=eps, name='ln')
+        x = np.random.normal(3, 2, shape)
+        nshape = shape[axis % len(shape):]
+        gamma = np.random.normal(1, 0.5, nshape)
+        beta = np.random.normal(0, 1, nshape)
+        axes = tuple(range(axis % len(shape), len(shape)))
+        np_out = (x - x.mean(axis=axes, keepdims=True)) / \
+            np.sqrt(x.var(axis=axes, keepdims=True) + eps) * gamma + beta
+        check_symbolic_forward(out, [x, gamma, beta], [np_out], rtol=1e-4, atol=1e-4,
+                               ctx=mx.cpu())
+        if np.prod(shape) <= 200:
+            check_numeric_gradient(out, [x, gamma, beta], numeric_eps=1e-2, rtol=1e-2, atol=1e-2,
+                                   ctx=mx.cpu())
+
+def test_group_norm():
+    eps = 1e-3
+    for shape, num_groups in [((2, 4, 5), 2), ((2, 6, 3, 4), 3), ((3, 4, 2, 2), 4),
+                              ((1, 3, 7), 1)]:
+        data = mx.symbol.Variable('data')
+        out = mx.symbol.GroupNorm(data=data, num_groups=num_groups, eps=eps, name='gn')
+        x = np.random.normal(0, 1, shape)
+        gamma = np.random.normal(1, 0.5, shape[1])
+        beta = np.random.normal(0, 1, shape[1])
+        np_out = np_group_norm(x, gamma, beta, num_groups, eps)
+        check_symbolic_forward(out, [x, gamma, beta], [np_out], rtol=1e-4, atol=1e-4,
+                               ctx=mx.cpu())
+        check_numeric_gradient(out, [x, gamma, beta], numeric_eps=1e-2, rtol=1e-2, atol=1e-2,
+                               ctx=mx.cpu())
+
 def check_l2_normalization(in_shape, mode, ctx=default_context(), norm_eps=1e-10):
     data = mx.symbol.Variable('data')
     out = mx.symbol.L2Normalization(data=data, mode=mode, eps=norm_eps)
@@ -3152,6 +3257,126 @@ def test_log_softmax():
             check_numeric_gradient(sym, [data], rtol=0.05, atol=1e-3)
 
 
+def test_softmax_large_axis():
+    # rows and column blocks longer than the vector width of the CPU kernels
+    for shape, axis in [((3, 1000), -1), ((2, 37, 130), 1), ((4, 70, 3), 1), ((70, 5, 2), 0)]:
+        data = np.random.uniform(-10, 10, size=shape)
+        ograd = np.random.uniform(-1, 1, size=shape)
+        out = np_softmax(data, axis=axis)
+        sym = mx.sym.softmax(axis=axis)
+        check_symbolic_forward(sym, [data], [out], rtol=1e-4, atol=1e-6)
+        dot = np.sum(ograd * out, axis=axis, keepdims=True)
+        check_symbolic_backward(sym, [data], [ograd], [out * (ograd - dot)], rtol=1e-3, atol=1e-6)
+        sym = mx.sym.log_softmax(axis=axis)
+        check_symbolic_forward(sym, [data], [np.log(out)], rtol=1e-4, atol=1e-5)
+        check_symbolic_backward(sym, [data], [ograd],
+                                [ograd - out * np.sum(ograd, axis=axis, keepdims=True)],
+                                rtol=1e-3, atol=1e-5)
+
+
+def test_softmax_cross_entropy():
+    for n, k in [(3, 5), (16, 1000)]:
+        data = np.random.uniform(-5, 5, size=(n, k))
+        label = np.random.randint(0, k, size=(n,))
+        prob = np_softmax(data)
+        loss = -np.sum(np.log(np.maximum(prob[np.arange(n), label], 1e-8)))
+        sym = mx.sym.softmax_cross_entropy(mx.sym.Variable('data'), mx.sym.Variable('label'))
+        check_symbolic_forward(sym, [data, label], [np.array([loss])], rtol=1e-4)
+        onehot = np.zeros((n, k))
+        onehot[np.arange(n), label] = 1
+        data_grad = mx.nd.zeros((n, k))
+        exe = sym.bind(default_context(), args=[mx.nd.array(data), mx.nd.array(label)],
+                       args_grad={'data': data_grad})
+        exe.forward(is_train=True)
+        exe.backward([mx.nd.array([2.0])])
+        assert_almost_equal(data_grad.asnumpy(), 2.0 * (prob - onehot), rtol=1e-3, atol=1e-6)
+
+
+def test_sampled_softmax():
+    n, dim, num_classes, num_sampled = 8, 6, 100, 20
+    data = np.random.uniform(-1, 1, size=(n, dim))
+    weight = np.random.uniform(-1, 1, size=(num_classes, dim))
+    bias = np.random.uniform(-1, 1, size=(num_classes,))
+    label = np.random.randint(0, num_classes, size=(n,))
+    sym = mx.sym.contrib.SampledSoftmax(mx.sym.Variable('data'), mx.sym.Variable('weight'),
+                                        mx.sym.Variable('bias'), mx.sym.Variable('label'),
+                                        num_classes=num_classes, num_sampled=num_sampled)
+    args = {'data': data, 'weight': weight, 'bias': bias, 'label': label}
+    grads = {k: mx.nd.zeros(v.shape, ctx=mx.cpu()) for k, v in args.items() if k != 'label'}
+    exe = sym.bind(mx.cpu(), args={k: mx.nd.array(v, ctx=mx.cpu()) for k, v in args.items()},
+                   args_grad=grads)
+    ograd = np.random.uniform(0.5, 1, size=(n,))
+
+    def run():
+        # the same seed draws the same classes
+        mx.random.seed(7)
+        exe.forward(is_train=True)
+        return exe.outputs[0].asnumpy()
+
+    loss = run()
+    assert np.all(loss > 0)
+    assert_almost_equal(loss, run())
+    exe.backward([mx.nd.array(ograd, ctx=mx.cpu())])
+    # the rows of the classes neither sampled nor labels have no gradient
+    touched = np.abs(grads['weight'].asnumpy()).sum(axis=1) > 0
+    assert touched.sum() <= num_sampled + n
+    assert np.all(touched[label])
+    eps = 1e-3
+    for name in ['data', 'bias']:
+        value = args[name]
+        expected = np.zeros(value.shape)
+        for idx in np.ndindex(*value.shape):
+            old = value[idx]
+            value[idx] = old + eps
+            exe.arg_dict[name][:] = value
+            up = np.dot(run(), ograd)
+            value[idx] = old - eps
+            exe.arg_dict[name][:] = value
+            expected[idx] = (up - np.dot(run(), ograd)) / (2 * eps)
+            value[idx] = old
+            exe.arg_dict[name][:] = value
+        assert_almost_equal(grads[name].asnumpy(), expected, rtol=1e-2, atol=1e-3)
+
+
+def test_hierarchical_softmax():
+    n, dim, num_classes, depth = 12, 5, 8, 3
+    # balanced tree, inner node k has children 2k + 1 and 2k + 2 and the leaves
+    # are the nodes num_classes - 1 to 2 * num_classes - 2
+    path = np.zeros((num_classes, depth))
+    code = np.zeros((num_classes, depth))
+    for c in range(num_classes):
+        node = num_classes - 1 + c
+        for k in range(depth - 1, -1, -1):
+            path[c, k] = (node - 1) // 2
+            code[c, k] = node % 2 == 0
+            node = (node - 1) // 2
+    data = np.random.uniform(-1, 1, size=(n, dim))
+    weight = np.random.uniform(-1, 1, size=(num_classes - 1, dim))
+    bias = np.random.uniform(-1, 1, size=(num_classes - 1,))
+    label = np.random.randint(0, num_classes, size=(n,))
+    nodes = path[label].astype(np.int64)
+    sign = 2 * code[label] - 1
+    z = sign * (np.einsum('nd,nkd->nk', data, weight[nodes]) + bias[nodes])
+    loss = np.log1p(np.exp(-z)).sum(axis=1)
+    sym = mx.sym.contrib.HierarchicalSoftmax(*[mx.sym.Variable(name) for name in
+                                               ['data', 'weight', 'bias', 'label', 'path', 'code']],
+                                             num_classes=num_classes)
+    location = [data, weight, bias, label, path, code]
+    check_symbolic_forward(sym, location, [loss], ctx=mx.cpu())
+    ograd = np.random.uniform(0.5, 1, size=(n,))
+    dz = -sign * ograd[:, None] / (1 + np.exp(z))
+    gdata = np.einsum('nk,nkd->nd', dz, weight[nodes])
+    gweight = np.zeros(weight.shape)
+    gbias = np.zeros(bias.shape)
+    for i in range(n):
+        for k in range(depth):
+            gweight[nodes[i, k]] += dz[i, k] * data[i]
+            gbias[nodes[i, k]] += dz[i, k]
+    check_symbolic_backward(sym, location, [ograd],
+                            [gdata, gweight, gbias] + [np.zeros(x.shape) for x in location[3:]],
+                            ctx=mx.cpu())
+
+
 def test_pick():
     def test_pick_helper(index_type=np.int32):
         for _ in range(100):
@@ -3226,6 +3451,10 @@ def test_ctc_loss():
     labels2 = np.array([[2, 3, 1], [2, 0, 0]], dtype=np.float32)
     true_loss = np.array([7.3557, 5.4091], dtype=np.float32) # from Torch
     check_ctc_loss(acts2, labels2, true_loss)
+    # Test 3: repeated labels, which need a blank in between, and uneven lengths
+    acts3 = np.random.uniform(-2, 2, size=(8, 3, 5)).astype(np.float32)
+    labels3 = np.array([[2, 2, 1, 1], [3, 0, 0, 0], [4, 1, 4, 0]], dtype=np.float32)
+    check_ctc_loss(acts3, labels3, None)
 
 
 def test_quantization_op():
@@ -3642,6 +3871,53 @@ def test_laop():
       check_numeric_gradient(test_sumlogdiag, [a])
 
 
+def test_float16_cpu():
+    # float16 storage with float32 compute on cpu against float32
+    def check(sym, data_shape, grad_req):
+        ctx_list = [{'ctx': mx.cpu(0), 'data': data_shape, 'type_dict': {'data': np.float32}},
+                    {'ctx': mx.cpu(0), 'data': data_shape, 'type_dict': {'data': np.float16}}]
+        check_consistency(sym, ctx_list, scale=0.5, grad_req=grad_req)
+
+    data = mx.sym.Variable('data')
+    check(mx.sym.FullyConnected(data, num_hidden=33, name='fc'), (5, 40), 'write')
+    check(mx.sym.FullyConnected(data, num_hidden=7, no_bias=True), (3, 2, 9), 'write')
+    check(mx.sym.Convolution(data, kernel=(3, 3), num_filter=4, pad=(1, 1)), (2, 3, 6, 6), 'write')
+    for pool_type in ['max', 'avg']:
+        check(mx.sym.Pooling(data, kernel=(2, 2), stride=(2, 2), pool_type=pool_type),
+              (2, 3, 6, 6), 'write')
+    for act_type in ['relu', 'sigmoid', 'tanh']:
+        check(mx.sym.Activation(data, act_type=act_type), (4, 1000), 'write')
+        check(getattr(mx.sym, act_type)(data), (4, 1000), 'null')
+    check(mx.sym.SoftmaxOutput(data), (6, 11), 'null')
+    check(mx.sym.softmax(data, axis=1), (3, 7, 5), 'null')
+    check(mx.sym.log_softmax(data), (3, 7, 5), 'null')
+    check(data * data + mx.sym.exp(data) - data, (5, 1001), 'null')
+
+
+def test_bfloat16_cpu():
+    # bfloat16 storage with float32 compute on cpu against float32 on the rounded inputs
+    def check(op, shapes, **kwargs):
+        args = [mx.nd.array(np.random.uniform(-1, 1, s)).astype('bfloat16') for s in shapes]
+        expected = op(*[x.astype(np.float32) for x in args], **kwargs).asnumpy()
+        out = op(*args, **kwargs)
+        assert out.dtype == mx.nd.bfloat16
+        assert_almost_equal(out.astype(np.float32).asnumpy(), expected, rtol=1e-2, atol=1e-2)
+
+    check(mx.nd.FullyConnected, [(5, 40), (33, 40), (33,)], num_hidden=33)
+    check(mx.nd.FullyConnected, [(3, 2, 9), (7, 18)], num_hidden=7, no_bias=True)
+    check(mx.nd.Convolution, [(2, 3, 6, 6), (4, 3, 3, 3), (4,)],
+          kernel=(3, 3), num_filter=4, pad=(1, 1))
+    for pool_type in ['max', 'avg']:
+        check(mx.nd.Pooling, [(2, 3, 6, 6)], kernel=(2, 2), stride=(2, 2), pool_type=pool_type)
+    for act_type in ['relu', 'sigmoid', 'tanh']:
+        check(mx.nd.Activation, [(4, 1000)], act_type=act_type)
+        check(getattr(mx.nd, act_type), [(4, 1000)])
+    check(mx.nd.softmax, [(3, 7, 5)], axis=1)
+    check(mx.nd.log_softmax, [(3, 7, 5)])
+    check(mx.nd.elemwise_add, [(5, 1001), (5, 1001)])
+    check(mx.nd.elemwise_mul, [(5, 1001), (5, 1001)])
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()
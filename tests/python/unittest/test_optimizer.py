@@ -390,6 +390,30 @@ def test_rms():
     for kwarg in kwargs:
         compare_optimizer(opt1(**kwarg), opt2(**kwarg), shape, np.float32)
 
+def test_multi_precision_bfloat16():
+    # the float32 copy of bfloat16 weights follows the float32 optimizer
+    mx.random.seed(0)
+    shape = (3, 4, 5)
+    for opt, kwarg in [(mx.optimizer.Adam, {'clip_gradient': 0.4, 'wd': 0.03}),
+                       (mx.optimizer.SGD, {'momentum': 0.9, 'wd': 0.05}),
+                       (mx.optimizer.SGD, {'rescale_grad': 0.8})]:
+        w = mx.random.uniform(shape=shape).astype('bfloat16')
+        g = mx.random.uniform(shape=shape).astype('bfloat16')
+        w32 = w.astype(np.float32)
+        opt1 = opt(**kwarg)
+        opt2 = opt(multi_precision=True, **kwarg)
+        state1 = opt1.create_state(0, w32)
+        state2 = opt2.create_state(0, w)
+        for _ in range(3):
+            # adam_update overwrites the gradient
+            opt1.update(0, w32, g.astype(np.float32), state1)
+            opt2.update(0, w, g, state2)
+        assert w.dtype == mx.nd.bfloat16
+        weight32 = state2[-1]
+        assert_almost_equal(weight32.asnumpy(), w32.asnumpy(), rtol=1e-5, atol=1e-6)
+        assert same(w.astype(np.float32).asnumpy(),
+                    weight32.astype('bfloat16').astype(np.float32).asnumpy())
+
 if __name__ == '__main__':
     test_adam()
     test_rms()
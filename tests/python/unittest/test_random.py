@@ -194,6 +194,17 @@ def test_sample_multinomial():
         mx.test_utils.assert_almost_equal(real_dx, dx.asnumpy()[i])
 
 
+def test_log_uniform():
+    range_max = 50
+    y = mx.nd.random_log_uniform(range_max=range_max, shape=(100000,), ctx=mx.cpu()).asnumpy()
+    assert y.min() >= 0 and y.max() < range_max
+    c = np.arange(range_max)
+    prob = np.log((c + 2.0) / (c + 1.0)) / np.log(range_max + 1.0)
+    freq = np.bincount(y.astype(np.int64), minlength=range_max) / float(y.size)
+    mx.test_utils.assert_almost_equal(freq, prob, rtol=0.1, atol=2e-3)
+
+
 if __name__ == '__main__':
     test_random()
     test_sample_multinomial()
+    test_log_uniform()
@@ -279,6 +279,66 @@ def test_convgru():
     args, outs, auxs = outputs.infer_shape(rnn_t0_data=(1, 3, 16, 10), rnn_t1_data=(1, 3, 16, 10), rnn_t2_data=(1, 3, 16, 10))
     assert outs == [(1, 10, 16, 10), (1, 10, 16, 10), (1, 10, 16, 10)]
 
+def check_fused_cpu(mode, bidirectional):
+    fused = mx.rnn.FusedRNNCell(20, num_layers=2, mode=mode, prefix='',
+                                bidirectional=bidirectional)
+    stack = fused.unfuse()
+    dshape = (8, 5, 10)
+    data = mx.sym.Variable('data')
+    mods = []
+    for cell in [fused, stack]:
+        sym, _ = cell.unroll(5, data, merge_outputs=True)
+        mod = mx.mod.Module(sym, label_names=None, context=mx.cpu())
+        mod.bind(data_shapes=[('data', dshape)], label_shapes=None, for_training=False)
+        mods.append(mod)
+    mods[0].init_params()
+    args, auxs = mods[0].get_params()
+    mods[1].set_params(stack.pack_weights(fused.unpack_weights(args)), auxs)
+    batch = mx.io.DataBatch(data=[mx.random.uniform(shape=dshape)], label=[])
+    for mod in mods:
+        mod.forward(batch, is_train=False)
+    assert_allclose(mods[0].get_outputs()[0].asnumpy(), mods[1].get_outputs()[0].asnumpy(),
+                    rtol=1e-4, atol=1e-5)
+
+
+def test_fused_cpu():
+    for mode in ['rnn_relu', 'rnn_tanh', 'lstm', 'gru']:
+        for bidirectional in [False, True]:
+            check_fused_cpu(mode, bidirectional)
+
+
+def test_fused_sequence_length():
+    T, N, I, H, L = 6, 4, 5, 8, 2
+    lengths = [6, 2, 0, 4]
+    for mode in ['rnn_tanh', 'lstm', 'gru']:
+        lstm = mode == 'lstm'
+        kwargs = dict(state_size=H, num_layers=L, mode=mode, bidirectional=True,
+                      state_outputs=True)
+        _, shapes, _ = mx.sym.RNN(data=mx.sym.Variable('data'), **kwargs).infer_shape(data=(T, N, I))
+        params = mx.nd.array(np.random.uniform(-0.5, 0.5, shapes[1]))
+        data = np.random.uniform(-1, 1, (T, N, I))
+        state = np.random.uniform(-1, 1, (2 * L, N, H))
+        cell = np.random.uniform(-1, 1, (2 * L, N, H))
+        def forward(data, state, cell, **extra):
+            inputs = dict(data=mx.nd.array(data), parameters=params, state=mx.nd.array(state))
+            if lstm:
+                inputs['state_cell'] = mx.nd.array(cell)
+            inputs.update(extra)
+            return [out.asnumpy() for out in mx.nd.RNN(**dict(inputs, **kwargs))]
+        outs = forward(data, state, cell, use_sequence_length=True,
+                       sequence_length=mx.nd.array(lengths))
+        for b, length in enumerate(lengths):
+            # padding steps are zero and the states are those of the last valid step
+            assert_allclose(outs[0][length:, b], 0)
+            if length == 0:
+                expected = [None, state[:, b:b+1], cell[:, b:b+1]]
+            else:
+                expected = forward(data[:length, b:b+1], state[:, b:b+1], cell[:, b:b+1])
+                assert_allclose(outs[0][:length, b:b+1], expected[0], rtol=1e-4, atol=1e-5)
+            for i in range(1, len(outs)):
+                assert_allclose(outs[i][:, b:b+1], expected[i], rtol=1e-4, atol=1e-5)
+
+
 if __name__ == '__main__':
     import nose
     nose.runmodule()